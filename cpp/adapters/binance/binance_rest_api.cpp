@@ -88,6 +88,7 @@ BinanceRestAPI::BinanceRestAPI(
     , market_type_(market_type)
     , is_testnet_(is_testnet)
     , proxy_config_(proxy_config)
+    , http_pool_(std::make_unique<core::HttpConnectionPool>("binance"))
 {
     // 设置基础URL
     if (is_testnet) {
@@ -129,6 +130,17 @@ BinanceRestAPI::BinanceRestAPI(
     }
 }
 
+int BinanceRestAPI::warm_up_connections(int count) {
+    std::string endpoint = "/fapi/v1/time";
+    if (market_type_ == MarketType::SPOT) {
+        endpoint = "/api/v3/time";
+    } else if (market_type_ == MarketType::COIN_FUTURES) {
+        endpoint = "/dapi/v1/time";
+    }
+    std::string proxy_url = proxy_config_.use_proxy ? proxy_config_.get_proxy_url() : "";
+    return http_pool_->warm_up(base_url_ + endpoint, count, proxy_url, proxy_config_.use_proxy);
+}
+
 std::string BinanceRestAPI::create_signature(const std::string& query_string) {
     return hmac_sha256(secret_key_, query_string);
 }
@@ -189,10 +201,14 @@ nlohmann::json BinanceRestAPI::send_request(
     const nlohmann::json& params,
     bool need_signature
 ) {
-    CURL* curl = curl_easy_init();
+    // 从连接池取 handle（复用已建立的 TCP/TLS 连接）
+    auto handle = http_pool_->acquire();
+    CURL* curl = handle.get();
     if (!curl) {
         throw std::runtime_error("Failed to initialize CURL");
     }
+    // 经代理时强制 HTTP/1.1（某些代理可能不支持 HTTP/2），直连时 ALPN 协商 HTTP/2
+    http_pool_->apply_defaults(curl, proxy_config_.use_proxy);
     
     std::string response_string;
     std::string url = base_url_ + endpoint;
@@ -273,9 +289,6 @@ nlohmann::json BinanceRestAPI::send_request(
         curl_easy_setopt(curl, CURLOPT_HTTPPROXYTUNNEL, 1L);
     }
     
-    // 禁用 HTTP/2，强制使用 HTTP/1.1（某些代理可能不支持 HTTP/2）
-    curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_1_1);
-    
     // SSL设置
     curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 1L);
     curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 2L);
@@ -283,6 +296,8 @@ nlohmann::json BinanceRestAPI::send_request(
     // 超时设置
     curl_easy_setopt(curl, CURLOPT_TIMEOUT, 30L);
     curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 10L);
+    // 禁用信号：多线程并发请求时基于 SIGALRM 的 DNS 超时不是线程安全的
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
     
     // 禁用进度显示（避免干扰输出）
     curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 1L);
@@ -292,6 +307,7 @@ nlohmann::json BinanceRestAPI::send_request(
     std::cout.flush();  // 确保输出立即刷新
     
     CURLcode res = curl_easy_perform(curl);
+    http_pool_->record_result(curl, res);
     
     std::cout << "[BinanceRestAPI] 请求执行完成，结果: " << curl_easy_strerror(res) << std::endl;
     
@@ -301,7 +317,6 @@ nlohmann::json BinanceRestAPI::send_request(
     std::cout << "[BinanceRestAPI] HTTP 状态码: " << http_code << std::endl;
     
     curl_slist_free_all(headers);
-    curl_easy_cleanup(curl);
     
     if (res != CURLE_OK) {
         std::cerr << "[BinanceRestAPI] ❌ CURL 错误: " << curl_easy_strerror(res) << std::endl;
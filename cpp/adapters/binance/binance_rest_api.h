@@ -23,6 +23,7 @@
 #include <optional>
 #include <nlohmann/json.hpp>
 #include "../../network/proxy_config.h"
+#include "../../network/http_connection_pool.h"
 
 namespace trading {
 namespace binance {
@@ -118,6 +119,20 @@ public:
     
     ~BinanceRestAPI() = default;
     
+    // ==================== 连接池 ====================
+    
+    /**
+     * @brief 预热连接（请求服务器时间接口建立长连接）
+     * @param count 预热连接数
+     * @return 成功建立的连接数
+     */
+    int warm_up_connections(int count = 2);
+    
+    /**
+     * @brief 连接池统计（handle 命中率、连接复用率）
+     */
+    core::HttpPoolStats get_pool_stats() const { return http_pool_->get_stats(); }
+    
     // ==================== 市场数据接口（无需签名） ====================
     
     /**
@@ -451,6 +466,7 @@ private:
     MarketType market_type_;
     bool is_testnet_;
     core::ProxyConfig proxy_config_;
+    std::unique_ptr<core::HttpConnectionPool> http_pool_;  // 本账户的 REST 长连接池
     int64_t time_offset_ms_ = 0;  // 本地时间与Binance服务器时间的偏移量
 };
 
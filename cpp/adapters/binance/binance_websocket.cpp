@@ -402,6 +402,12 @@ bool BinanceWebSocket::send_message(const nlohmann::json& msg) {
 }
 
 void BinanceWebSocket::on_message(const std::string& message) {
+    // 行情推送优先走类型化快速路径（不构建 DOM），不支持的消息继续走下面的通用解析
+    if (has_push_callbacks_ && !raw_callback_ && conn_type_ != WsConnectionType::USER &&
+        dispatch_market_push(message)) {
+        return;
+    }
+
     try {
         auto data = nlohmann::json::parse(message);
 
@@ -661,14 +667,15 @@ std::string BinanceWebSocket::place_order_ws(
     const std::string& price,
     TimeInForce time_in_force,
     PositionSide position_side,
-    const std::string& client_order_id
+    const std::string& client_order_id,
+    const std::string& request_id
 ) {
     if (conn_type_ != WsConnectionType::TRADING) {
         std::cerr << "[BinanceWebSocket] 错误：非交易API连接无法下单" << std::endl;
         return "";
     }
     
-    std::string req_id = generate_request_id();
+    std::string req_id = request_id.empty() ? generate_request_id() : request_id;
     
     // 构造请求参数
     nlohmann::json params = {
@@ -729,7 +736,9 @@ std::string BinanceWebSocket::place_order_ws(
         {"params", params}
     };
     
-    send_message(request);
+    if (!send_message(request)) {
+        return "";
+    }
     
     return req_id;
 }
@@ -737,14 +746,15 @@ std::string BinanceWebSocket::place_order_ws(
 std::string BinanceWebSocket::cancel_order_ws(
     const std::string& symbol,
     int64_t order_id,
-    const std::string& client_order_id
+    const std::string& client_order_id,
+    const std::string& request_id
 ) {
     if (conn_type_ != WsConnectionType::TRADING) {
         std::cerr << "[BinanceWebSocket] 错误：非交易API连接无法撤单" << std::endl;
         return "";
     }
     
-    std::string req_id = generate_request_id();
+    std::string req_id = request_id.empty() ? generate_request_id() : request_id;
     
     nlohmann::json params = {
         {"apiKey", api_key_},               // ⭐ 必填
@@ -788,7 +798,9 @@ std::string BinanceWebSocket::cancel_order_ws(
         {"params", params}
     };
     
-    send_message(request);
+    if (!send_message(request)) {
+        return "";
+    }
     
     return req_id;
 }
@@ -859,14 +871,15 @@ std::string BinanceWebSocket::modify_order_ws(
     const std::string& price,
     int64_t order_id,
     const std::string& client_order_id,
-    PositionSide position_side
+    PositionSide position_side,
+    const std::string& request_id
 ) {
     if (conn_type_ != WsConnectionType::TRADING) {
         std::cerr << "[BinanceWebSocket] 错误：非交易API连接无法修改订单" << std::endl;
         return "";
     }
     
-    std::string req_id = generate_request_id();
+    std::string req_id = request_id.empty() ? generate_request_id() : request_id;
     
     nlohmann::json params = {
         {"apiKey", api_key_},                    // ⭐ 必填
@@ -920,7 +933,9 @@ std::string BinanceWebSocket::modify_order_ws(
         {"params", params}
     };
     
-    send_message(request);
+    if (!send_message(request)) {
+        return "";
+    }
     
     return req_id;
 }
@@ -1131,6 +1146,29 @@ void BinanceWebSocket::subscribe_depth(
     std::cout << "[BinanceWebSocket] 订阅深度: " << stream << std::endl;
 }
 
+void BinanceWebSocket::subscribe_diff_depth(const std::string& symbol, int update_speed) {
+    // Binance增量深度流格式: <symbol>@depth（250ms）或 <symbol>@depth@<update_speed>ms
+    std::string stream = symbol + "@depth";
+    if (update_speed != 250) {
+        stream += "@" + std::to_string(update_speed) + "ms";
+    }
+
+    // 记录订阅状态
+    {
+        std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+        subscriptions_[stream] = stream;
+    }
+
+    nlohmann::json sub_msg = {
+        {"method", "SUBSCRIBE"},
+        {"params", {stream}},
+        {"id", request_id_counter_.fetch_add(1)}
+    };
+
+    send_message(sub_msg);
+    std::cout << "[BinanceWebSocket] 订阅增量深度: " << stream << std::endl;
+}
+
 void BinanceWebSocket::subscribe_book_ticker(const std::string& symbol) {
     std::string stream = symbol + "@bookTicker";
 
@@ -1211,6 +1249,35 @@ void BinanceWebSocket::unsubscribe(const std::string& stream_name) {
 
 // ==================== 消息解析（已测试的行情推送） ====================
 
+bool BinanceWebSocket::dispatch_market_push(const std::string& message) {
+    thread_local core::MarketPushBatch batch;  // 按线程复用，避免每条消息分配
+
+    core::PushParseStatus status = core::parse_binance_push(message, batch);
+    if (status == core::PushParseStatus::UNSUPPORTED) {
+        return false;
+    }
+    // 批内每类数据都要有类型化回调，否则整条交给通用路径（避免部分分发后重复处理）
+    if (status != core::PushParseStatus::OK ||
+        (!batch.trades.empty() && !trade_push_callback_) ||
+        (!batch.klines.empty() && !kline_push_callback_) ||
+        (!batch.tickers.empty() && !ticker_push_callback_) ||
+        (!batch.mark_prices.empty() && !mark_price_push_callback_)) {
+        core::count_push_parse(false);
+        return false;
+    }
+    core::count_push_parse(true);
+
+    try {
+        for (const auto& trade : batch.trades) trade_push_callback_(trade);
+        for (const auto& kline : batch.klines) kline_push_callback_(kline);
+        for (const auto& ticker : batch.tickers) ticker_push_callback_(ticker);
+        for (const auto& mark : batch.mark_prices) mark_price_push_callback_(mark);
+    } catch (const std::exception& e) {
+        std::cerr << "[BinanceWebSocket] 行情回调异常: " << e.what() << std::endl;
+    }
+    return true;
+}
+
 void BinanceWebSocket::parse_trade(const nlohmann::json& data) {
     if (!trade_callback_) return;
 
@@ -29,6 +29,7 @@
 #include "../../core/data.h"
 #include "../../trading/order.h"
 #include "../../network/ws_client.h"
+#include "../../network/market_push.h"
 
 // 前向声明
 namespace trading {
@@ -216,7 +217,8 @@ public:
      * @param time_in_force 时间有效性
      * @param position_side 持仓方向（合约）
      * @param client_order_id 客户自定义订单ID
-     * @return 请求ID（用于匹配响应）
+     * @param request_id 请求ID（可选，为空时自动生成）
+     * @return 请求ID（用于匹配响应），发送失败返回空字符串
      */
     std::string place_order_ws(
         const std::string& symbol,
@@ -226,7 +228,8 @@ public:
         const std::string& price = "",
         TimeInForce time_in_force = TimeInForce::GTC,
         PositionSide position_side = PositionSide::BOTH,
-        const std::string& client_order_id = ""
+        const std::string& client_order_id = "",
+        const std::string& request_id = ""
     );
     
     /**
@@ -235,12 +238,14 @@ public:
      * @param symbol 交易对
      * @param order_id 订单ID
      * @param client_order_id 客户自定义订单ID
-     * @return 请求ID
+     * @param request_id 请求ID（可选，为空时自动生成）
+     * @return 请求ID，发送失败返回空字符串
      */
     std::string cancel_order_ws(
         const std::string& symbol,
         int64_t order_id = 0,
-        const std::string& client_order_id = ""
+        const std::string& client_order_id = "",
+        const std::string& request_id = ""
     );
     
     /**
@@ -269,7 +274,8 @@ public:
      * @param order_id 订单ID
      * @param client_order_id 客户自定义订单ID
      * @param position_side 持仓方向（合约）
-     * @return 请求ID
+     * @param request_id 请求ID（可选，为空时自动生成）
+     * @return 请求ID，发送失败返回空字符串
      */
     std::string modify_order_ws(
         const std::string& symbol,
@@ -278,7 +284,8 @@ public:
         const std::string& price,
         int64_t order_id = 0,
         const std::string& client_order_id = "",
-        PositionSide position_side = PositionSide::BOTH
+        PositionSide position_side = PositionSide::BOTH,
+        const std::string& request_id = ""
     );
 
     std::string start_user_data_stream_ws();
@@ -376,6 +383,14 @@ public:
         int update_speed = 1000
     );
     
+    /**
+     * @brief 订阅增量深度（diff depth，需配合 REST 快照维护本地订单簿）
+     * 
+     * @param symbol 交易对（小写）
+     * @param update_speed 更新速度（100 / 250 / 500ms）
+     */
+    void subscribe_diff_depth(const std::string& symbol, int update_speed = 100);
+    
     /**
      * @brief 订阅最优挂单
      * 
@@ -432,6 +447,32 @@ public:
         raw_callback_ = std::move(callback); 
     }
 
+    // ==================== 类型化行情回调 ====================
+    //
+    // 设置后 trade / kline / 24hrTicker / markPriceUpdate 推送直接从报文提取字段（不构建 JSON DOM），
+    // 见 network/market_push.h。报文不支持或解析失败时回退通用路径，调用上面的原始 JSON 回调，
+    // 因此两类回调应同时设置。设置了 raw_message_callback 时不走快速路径。
+
+    void set_trade_push_callback(core::TradePushCallback callback) {
+        trade_push_callback_ = std::move(callback);
+        has_push_callbacks_ = true;
+    }
+
+    void set_kline_push_callback(core::KlinePushCallback callback) {
+        kline_push_callback_ = std::move(callback);
+        has_push_callbacks_ = true;
+    }
+
+    void set_ticker_push_callback(core::TickerPushCallback callback) {
+        ticker_push_callback_ = std::move(callback);
+        has_push_callbacks_ = true;
+    }
+
+    void set_mark_price_push_callback(core::MarkPricePushCallback callback) {
+        mark_price_push_callback_ = std::move(callback);
+        has_push_callbacks_ = true;
+    }
+
     void set_account_update_callback(AccountUpdateCallback callback) {
         account_update_callback_ = std::move(callback);
     }
@@ -468,6 +509,16 @@ public:
      */
     WsConnectionType get_connection_type() const { return conn_type_; }
 
+    /**
+     * @brief 获取市场类型（现货/合约）
+     */
+    MarketType get_market_type() const { return market_type_; }
+
+    /**
+     * @brief 是否连接测试网
+     */
+    bool is_testnet() const { return is_testnet_; }
+
     /**
      * @brief 获取WebSocket URL
      */
@@ -482,6 +533,7 @@ private:
     std::string build_ws_url() const;
     void run();
     void on_message(const std::string& message);
+    bool dispatch_market_push(const std::string& message);  // 快速路径，false 表示走通用路径
     bool send_message(const nlohmann::json& msg);
     
     // 消息解析
@@ -551,6 +603,13 @@ private:
     RawMessageCallback raw_callback_;
     AccountUpdateCallback account_update_callback_;
     OrderTradeUpdateCallback order_trade_update_callback_;  // 订单成交更新
+
+    // 类型化行情回调（快速路径）
+    core::TradePushCallback trade_push_callback_;
+    core::KlinePushCallback kline_push_callback_;
+    core::TickerPushCallback ticker_push_callback_;
+    core::MarkPricePushCallback mark_price_push_callback_;
+    bool has_push_callbacks_ = false;  // 连接前设置，接收线程只读
     
     // 请求ID计数器（用于订阅消息）
     std::atomic<uint64_t> request_id_counter_{0};
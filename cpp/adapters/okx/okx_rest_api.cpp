@@ -544,6 +544,7 @@ OKXRestAPI::OKXRestAPI(
     , secret_key_(secret_key)
     , passphrase_(passphrase)
     , proxy_config_(proxy_config)
+    , http_pool_(std::make_unique<core::HttpConnectionPool>("okx"))
 {
     // REST API基础URL（实盘和模拟盘使用相同URL，通过header区分）
     base_url_ = "https://www.okx.com";
@@ -552,6 +553,11 @@ OKXRestAPI::OKXRestAPI(
     is_testnet_ = is_testnet;
 }
 
+int OKXRestAPI::warm_up_connections(int count) {
+    std::string proxy_url = proxy_config_.use_proxy ? proxy_config_.get_proxy_url() : "";
+    return http_pool_->warm_up(base_url_ + "/api/v5/public/time", count, proxy_url);
+}
+
 std::string OKXRestAPI::create_signature(
     const std::string& timestamp,
     const std::string& method,
@@ -582,10 +588,13 @@ nlohmann::json OKXRestAPI::send_request(
     const std::string& endpoint,
     const nlohmann::json& params
 ) {
-    CURL* curl = curl_easy_init();
+    // 从连接池取 handle（复用已建立的 TCP/TLS 连接）
+    auto handle = http_pool_->acquire();
+    CURL* curl = handle.get();
     if (!curl) {
         throw std::runtime_error("Failed to initialize CURL");
     }
+    http_pool_->apply_defaults(curl);
     
     std::string response_string;
     std::string url = base_url_ + endpoint;
@@ -692,12 +701,9 @@ nlohmann::json OKXRestAPI::send_request(
     curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, curl_progress_callback);
     curl_easy_setopt(curl, CURLOPT_XFERINFODATA, nullptr);
     
-    // 允许信号中断（默认 CURL 会屏蔽信号）
-    // 注意：多线程环境下可能有问题，但配合进度回调使用是安全的
-    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 0L);
-    
-    // 设置TCP keepalive
-    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+    // 禁用信号：请求在订单网关多个工作线程上并发执行，基于 SIGALRM 的 DNS 超时不是线程安全的
+    // （中断由上面的进度回调负责，不依赖信号）
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
     
     // 跟随重定向
     curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
@@ -717,9 +723,9 @@ nlohmann::json OKXRestAPI::send_request(
     
     // 执行请求
     CURLcode res = curl_easy_perform(curl);
+    http_pool_->record_result(curl, res);
     
     curl_slist_free_all(headers);
-    curl_easy_cleanup(curl);
     
     if (res != CURLE_OK) {
         throw std::runtime_error(
@@ -7,6 +7,7 @@
 #include <atomic>
 #include <nlohmann/json.hpp>
 #include "../../network/proxy_config.h"
+#include "../../network/http_connection_pool.h"
 
 namespace trading {
 namespace okx {
@@ -303,6 +304,20 @@ public:
     
     ~OKXRestAPI() = default;
     
+    // ==================== 连接池 ====================
+    
+    /**
+     * @brief 预热连接（请求 /api/v5/public/time 建立长连接）
+     * @param count 预热连接数
+     * @return 成功建立的连接数
+     */
+    int warm_up_connections(int count = 2);
+    
+    /**
+     * @brief 连接池统计（handle 命中率、连接复用率）
+     */
+    core::HttpPoolStats get_pool_stats() const { return http_pool_->get_stats(); }
+    
     // ==================== 下单接口 ====================
     
     /**
@@ -707,6 +722,7 @@ private:
     std::string base_url_;
     bool is_testnet_;
     core::ProxyConfig proxy_config_;
+    std::unique_ptr<core::HttpConnectionPool> http_pool_;  // 本账户的 REST 长连接池
 };
 
 } // namespace okx
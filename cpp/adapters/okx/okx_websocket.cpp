@@ -1481,6 +1481,90 @@ std::string OKXWebSocket::place_batch_orders_ws(
     return req_id;
 }
 
+std::string OKXWebSocket::cancel_order_ws(
+    const std::string& inst_id,
+    const std::string& ord_id,
+    const std::string& cl_ord_id,
+    const std::string& request_id
+) {
+    if (ord_id.empty() && cl_ord_id.empty()) {
+        std::cerr << "[WebSocket] ❌ 撤单需要 ordId 或 clOrdId" << std::endl;
+        return "";
+    }
+    
+    std::string req_id = request_id;
+    if (req_id.empty()) {
+        req_id = std::to_string(request_id_counter_.fetch_add(1));
+    }
+    
+    nlohmann::json cancel_arg = {{"instId", inst_id}};
+    if (!ord_id.empty()) {
+        cancel_arg["ordId"] = ord_id;
+    }
+    if (!cl_ord_id.empty()) {
+        cancel_arg["clOrdId"] = cl_ord_id;
+    }
+    
+    nlohmann::json msg = {
+        {"id", req_id},
+        {"op", "cancel-order"},
+        {"args", {cancel_arg}}
+    };
+    
+    if (!send_message(msg)) {
+        std::cerr << "[WebSocket] ❌ 发送撤单请求失败" << std::endl;
+        return "";
+    }
+    
+    return req_id;
+}
+
+std::string OKXWebSocket::amend_order_ws(
+    const std::string& inst_id,
+    const std::string& ord_id,
+    const std::string& cl_ord_id,
+    const std::string& new_sz,
+    const std::string& new_px,
+    const std::string& request_id
+) {
+    if (ord_id.empty() && cl_ord_id.empty()) {
+        std::cerr << "[WebSocket] ❌ 改单需要 ordId 或 clOrdId" << std::endl;
+        return "";
+    }
+    
+    std::string req_id = request_id;
+    if (req_id.empty()) {
+        req_id = std::to_string(request_id_counter_.fetch_add(1));
+    }
+    
+    nlohmann::json amend_arg = {{"instId", inst_id}};
+    if (!ord_id.empty()) {
+        amend_arg["ordId"] = ord_id;
+    }
+    if (!cl_ord_id.empty()) {
+        amend_arg["clOrdId"] = cl_ord_id;
+    }
+    if (!new_sz.empty()) {
+        amend_arg["newSz"] = new_sz;
+    }
+    if (!new_px.empty()) {
+        amend_arg["newPx"] = new_px;
+    }
+    
+    nlohmann::json msg = {
+        {"id", req_id},
+        {"op", "amend-order"},
+        {"args", {amend_arg}}
+    };
+    
+    if (!send_message(msg)) {
+        std::cerr << "[WebSocket] ❌ 发送改单请求失败" << std::endl;
+        return "";
+    }
+    
+    return req_id;
+}
+
 std::vector<std::string> OKXWebSocket::get_subscribed_channels() const {
     std::lock_guard<std::mutex> lock(subscriptions_mutex_);
     std::vector<std::string> result;
@@ -1508,6 +1592,11 @@ void OKXWebSocket::on_message(const std::string& message) {
         return;
     }
 
+    // 行情推送优先走类型化快速路径（不构建 DOM），不支持的消息继续走下面的通用解析
+    if (has_push_callbacks_ && !raw_callback_ && dispatch_market_push(message)) {
+        return;
+    }
+
     try {
         nlohmann::json data = nlohmann::json::parse(message);
         
@@ -1556,6 +1645,17 @@ void OKXWebSocket::on_message(const std::string& message) {
                 }
                 return;
             }
+            
+            if (op == "cancel-order" || op == "amend-order") {
+                if (code != "0") {
+                    std::cerr << "[WebSocket] ❌ " << op << " 失败 (ID=" << id << "): "
+                              << msg << " (code=" << code << ")" << std::endl;
+                }
+                if (place_order_callback_) {
+                    place_order_callback_(data);
+                }
+                return;
+            }
         }
         
         // 处理事件消息（订阅响应/错误）
@@ -1637,6 +1737,37 @@ void OKXWebSocket::on_message(const std::string& message) {
     }
 }
 
+bool OKXWebSocket::dispatch_market_push(const std::string& message) {
+    thread_local core::MarketPushBatch batch;  // 按线程复用，避免每条消息分配
+
+    core::PushParseStatus status = core::parse_okx_push(message, batch);
+    if (status == core::PushParseStatus::UNSUPPORTED) {
+        return false;
+    }
+    // 批内每类数据都要有类型化回调，否则整条交给通用路径（避免部分分发后重复处理）
+    if (status != core::PushParseStatus::OK ||
+        (!batch.tickers.empty() && !ticker_push_callback_) ||
+        (!batch.trades.empty() && !trade_push_callback_) ||
+        (batch.has_book && !orderbook_push_callback_) ||
+        (!batch.klines.empty() && !kline_push_callback_) ||
+        (!batch.funding_rates.empty() && !funding_rate_push_callback_)) {
+        core::count_push_parse(false);
+        return false;
+    }
+    core::count_push_parse(true);
+
+    try {
+        for (const auto& ticker : batch.tickers) ticker_push_callback_(ticker);
+        for (const auto& trade : batch.trades) trade_push_callback_(trade);
+        if (batch.has_book) orderbook_push_callback_(batch.book);
+        for (const auto& kline : batch.klines) kline_push_callback_(kline);
+        for (const auto& rate : batch.funding_rates) funding_rate_push_callback_(rate);
+    } catch (const std::exception& e) {
+        std::cerr << "[WebSocket] 行情回调异常: " << e.what() << std::endl;
+    }
+    return true;
+}
+
 void OKXWebSocket::parse_ticker(const nlohmann::json& data, const std::string& inst_id) {
     if (!ticker_callback_ || !data.is_array() || data.empty()) return;
 
@@ -1812,7 +1943,7 @@ void OKXWebSocket::parse_order(const nlohmann::json& data) {
             double px = safe_stod(item, "px", 0.0);
             
             // 创建订单对象
-            auto order = std::make_shared<Order>(
+            auto order = make_event<Order>(
                 item.value("instId", ""),
                 order_type,
                 side,
@@ -2149,7 +2280,7 @@ void OKXWebSocket::parse_sprd_order(const nlohmann::json& data) {
             double px = safe_stod(item, "px", 0.0);
             
             // 创建订单对象（使用sprdId作为symbol）
-            auto order = std::make_shared<Order>(
+            auto order = make_event<Order>(
                 sprd_id,
                 order_type,
                 side,
@@ -29,6 +29,7 @@
 #include "../../core/data.h"
 #include "../../trading/order.h"
 #include "../../network/ws_client.h"
+#include "../../network/market_push.h"
 #include <string>
 #include <functional>
 #include <memory>
@@ -923,10 +924,53 @@ public:
     );
     
     /**
-     * @brief 设置下单响应回调
+     * @brief WebSocket撤单
+     * 
+     * ⚠️ 注意：需要使用 WsEndpointType::PRIVATE 端点并登录
+     * 限速：60次/2s
+     * 
+     * @param inst_id 产品ID
+     * @param ord_id 订单ID（与 cl_ord_id 二选一）
+     * @param cl_ord_id 客户自定义订单ID
+     * @param request_id 请求ID（可选）
+     * @return 请求ID，发送失败返回空字符串
+     */
+    std::string cancel_order_ws(
+        const std::string& inst_id,
+        const std::string& ord_id = "",
+        const std::string& cl_ord_id = "",
+        const std::string& request_id = ""
+    );
+    
+    /**
+     * @brief WebSocket修改订单
+     * 
+     * ⚠️ 注意：需要使用 WsEndpointType::PRIVATE 端点并登录
+     * 限速：60次/2s
+     * 
+     * @param inst_id 产品ID
+     * @param ord_id 订单ID（与 cl_ord_id 二选一）
+     * @param cl_ord_id 客户自定义订单ID
+     * @param new_sz 新数量（可选）
+     * @param new_px 新价格（可选）
+     * @param request_id 请求ID（可选）
+     * @return 请求ID，发送失败返回空字符串
+     */
+    std::string amend_order_ws(
+        const std::string& inst_id,
+        const std::string& ord_id = "",
+        const std::string& cl_ord_id = "",
+        const std::string& new_sz = "",
+        const std::string& new_px = "",
+        const std::string& request_id = ""
+    );
+    
+    /**
+     * @brief 设置交易请求响应回调（order / batch-orders / cancel-order / amend-order）
      * 
      * 回调参数：
      * - id: 请求ID
+     * - op: 请求类型
      * - code: 响应代码（"0"表示成功）
      * - msg: 响应消息
      * - data: 订单数据数组（包含ordId, clOrdId, sCode, sMsg等）
@@ -954,8 +998,21 @@ public:
     
     /**
      * @brief 设置原始消息回调（调试用）
+     *
+     * 设置后所有消息都构建 JSON DOM，不再走类型化快速路径
      */
     void set_raw_message_callback(RawMessageCallback callback) { raw_callback_ = std::move(callback); }
+
+    // ==================== 类型化行情回调 ====================
+    //
+    // 设置后对应频道的推送直接从报文提取字段（不构建 JSON DOM），见 network/market_push.h。
+    // 报文不支持或解析失败时回退通用路径，调用上面的原始 JSON 回调，因此两类回调应同时设置。
+
+    void set_ticker_push_callback(core::TickerPushCallback callback) { set_push_callback(ticker_push_callback_, std::move(callback)); }
+    void set_trade_push_callback(core::TradePushCallback callback) { set_push_callback(trade_push_callback_, std::move(callback)); }
+    void set_orderbook_push_callback(core::OrderBookPushCallback callback) { set_push_callback(orderbook_push_callback_, std::move(callback)); }
+    void set_kline_push_callback(core::KlinePushCallback callback) { set_push_callback(kline_push_callback_, std::move(callback)); }
+    void set_funding_rate_push_callback(core::FundingRatePushCallback callback) { set_push_callback(funding_rate_push_callback_, std::move(callback)); }
     
     // ==================== 状态查询 ====================
     
@@ -991,6 +1048,18 @@ private:
      * @brief 处理接收到的消息
      */
     void on_message(const std::string& message);
+
+    /**
+     * @brief 行情推送快速路径：解析并分发到类型化回调
+     * @return false 表示未处理（不支持或缺少对应回调），调用方走通用路径
+     */
+    bool dispatch_market_push(const std::string& message);
+
+    template <typename Callback>
+    void set_push_callback(Callback& slot, Callback callback) {
+        slot = std::move(callback);
+        has_push_callbacks_ = true;
+    }
     
     /**
      * @brief 发送WebSocket消息
@@ -1093,6 +1162,14 @@ private:
     RawMessageCallback raw_callback_;
     PlaceOrderCallback place_order_callback_;
     LoginCallback login_callback_;
+
+    // 类型化行情回调（快速路径）
+    core::TickerPushCallback ticker_push_callback_;
+    core::TradePushCallback trade_push_callback_;
+    core::OrderBookPushCallback orderbook_push_callback_;
+    core::KlinePushCallback kline_push_callback_;
+    core::FundingRatePushCallback funding_rate_push_callback_;
+    bool has_push_callbacks_ = false;  // 连接前设置，接收线程只读
     
     // 请求ID计数器（用于生成唯一的请求ID）
     std::atomic<uint64_t> request_id_counter_{0};
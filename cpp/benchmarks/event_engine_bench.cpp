@@ -0,0 +1,193 @@
+/**
+ * @file event_engine_bench.cpp
+ * @brief EventEngine 派发基准：类型ID派发表 vs 原 type_index 哈希表派发
+ *
+ * 用法：
+ *   event_engine_bench              默认 2,000,000 个事件
+ *   event_engine_bench 5000000
+ *
+ * 场景：4 种事件类型（Ticker/Trade/Kline/Order）轮流推送，每种类型 2 个类型监听器，
+ * 另有 1 个 senior、1 个 junior 全局监听器。事件预先创建并重复推送，只测量派发本身。
+ *
+ * LegacyEventEngine 保留了改造前 drain() 的做法（每个事件按 typeid 查
+ * unordered_map<type_index>，再把三段监听器拷贝进临时 vector）作为对照组。
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <queue>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+#include "core/data.h"
+#include "core/event_engine.h"
+#include "trading/order.h"
+
+using namespace trading;
+
+namespace {
+
+// ==================== 对照组：改造前的派发方式 ====================
+
+class LegacyEventEngine {
+public:
+    using Listener = Event::ListenerFunc;
+
+    void register_listener(const std::type_index& event_type, Listener listener, bool ignore_self = true) {
+        listener_dict_[event_type].push_back(ListenerInfo{listener, ignore_self, next_listener_id_++});
+    }
+
+    void register_global_listener(Listener listener, bool ignore_self = false, bool is_senior = false) {
+        ListenerInfo info{listener, ignore_self, next_listener_id_++};
+        (is_senior ? senior_global_listeners_ : junior_global_listeners_).push_back(info);
+    }
+
+    void put(Event::Ptr event) {
+        int64_t ts = event->timestamp();
+        if (ts == 0) {
+            event->set_timestamp(timestamp_);
+        } else if (ts > timestamp_) {
+            timestamp_ = ts;
+        }
+        event->set_producer_id(current_listener_id_);
+        queue_.push(event);
+        if (!dispatching_) drain();
+    }
+
+private:
+    struct ListenerInfo {
+        Listener listener;
+        bool ignore_self;
+        size_t id;
+    };
+
+    void drain() {
+        dispatching_ = true;
+        while (!queue_.empty()) {
+            Event::Ptr event = queue_.front();
+            queue_.pop();
+
+            std::type_index event_type = typeid(*event);
+            std::vector<ListenerInfo> listeners;
+            listeners.insert(listeners.end(), senior_global_listeners_.begin(), senior_global_listeners_.end());
+            auto it = listener_dict_.find(event_type);
+            if (it != listener_dict_.end()) {
+                listeners.insert(listeners.end(), it->second.begin(), it->second.end());
+            }
+            listeners.insert(listeners.end(), junior_global_listeners_.begin(), junior_global_listeners_.end());
+
+            for (const auto& info : listeners) {
+                if (info.ignore_self && event->producer_id() == info.id) continue;
+                current_listener_id_ = info.id;
+                info.listener(event);
+                current_listener_id_ = 0;
+            }
+        }
+        dispatching_ = false;
+    }
+
+    int64_t timestamp_ = 0;
+    std::queue<Event::Ptr> queue_;
+    bool dispatching_ = false;
+    size_t current_listener_id_ = 0;
+    size_t next_listener_id_ = 1;
+    std::unordered_map<std::type_index, std::vector<ListenerInfo>> listener_dict_;
+    std::vector<ListenerInfo> senior_global_listeners_;
+    std::vector<ListenerInfo> junior_global_listeners_;
+};
+
+// ==================== 公共部分 ====================
+
+std::vector<Event::Ptr> make_events() {
+    std::vector<Event::Ptr> events;
+    events.push_back(make_event<TickerData>("BTC-USDT-SWAP", 97123.4));
+    events.push_back(make_event<TradeData>("BTC-USDT-SWAP", "1283746512", 97123.4, 0.12));
+    events.push_back(make_event<KlineData>("BTC-USDT-SWAP", "1m", 1.0, 2.0, 0.5, 1.5, 100.0));
+    events.push_back(Order::buy_limit("BTC-USDT-SWAP", 1.0, 97000.0));
+    return events;
+}
+
+struct Result {
+    double events_per_sec = 0.0;
+    double ns_per_event = 0.0;
+};
+
+template <typename Engine>
+Result run(Engine& engine, const std::vector<Event::Ptr>& events, size_t count) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        engine.put(events[i & 3]);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    Result r;
+    r.ns_per_event = ns / count;
+    r.events_per_sec = count / (ns / 1e9);
+    return r;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t count = argc > 1 ? static_cast<size_t>(std::max(1L, std::atol(argv[1]))) : 2000000;
+    std::vector<Event::Ptr> events = make_events();
+
+    volatile double sink = 0.0;
+    auto generic = [&sink](const Event::Ptr& e) { sink = sink + e->timestamp(); };
+
+    // 对照组
+    LegacyEventEngine legacy;
+    legacy.register_global_listener(generic, false, true);
+    legacy.register_global_listener(generic, false, false);
+    for (const auto& e : events) {
+        legacy.register_listener(typeid(*e), generic);
+        legacy.register_listener(typeid(*e), generic);
+    }
+
+    // 派发表（按 typeid 注册，与旧接口相同）
+    EventEngine table;
+    table.register_global_listener(generic, false, true);
+    table.register_global_listener(generic, false, false);
+    for (const auto& e : events) {
+        table.register_listener(typeid(*e), generic);
+        table.register_listener(typeid(*e), generic);
+    }
+
+    // 派发表 + 类型化监听器（回调直接拿到 const T&）
+    EventEngine typed;
+    typed.register_global_listener(generic, false, true);
+    typed.register_global_listener(generic, false, false);
+    for (int i = 0; i < 2; ++i) {
+        typed.register_listener<TickerData>([&sink](const TickerData& t) { sink = sink + t.last_price(); });
+        typed.register_listener<TradeData>([&sink](const TradeData& t) { sink = sink + t.price(); });
+        typed.register_listener<KlineData>([&sink](const KlineData& k) { sink = sink + k.close(); });
+        typed.register_listener<Order>([&sink](const Order& o) { sink = sink + o.price(); });
+    }
+
+    // 预热（解析类型ID、填充对象池）
+    run(legacy, events, 10000);
+    run(table, events, 10000);
+    run(typed, events, 10000);
+
+    Result r_legacy = run(legacy, events, count);
+    Result r_table = run(table, events, count);
+    Result r_typed = run(typed, events, count);
+
+    std::cout << "[Bench] 事件数: " << count << "  (4 种类型, 每事件 4 个监听器)\n"
+              << std::fixed << std::setprecision(1)
+              << "  type_index 哈希表 : " << r_legacy.ns_per_event << " ns/事件  "
+              << std::setprecision(0) << r_legacy.events_per_sec << " 事件/秒\n"
+              << std::setprecision(1)
+              << "  类型ID派发表      : " << r_table.ns_per_event << " ns/事件  "
+              << std::setprecision(0) << r_table.events_per_sec << " 事件/秒\n"
+              << std::setprecision(1)
+              << "  派发表 + 类型监听 : " << r_typed.ns_per_event << " ns/事件  "
+              << std::setprecision(0) << r_typed.events_per_sec << " 事件/秒\n"
+              << "  加速比            : " << std::setprecision(2)
+              << r_legacy.ns_per_event / r_table.ns_per_event << "x / "
+              << r_legacy.ns_per_event / r_typed.ns_per_event << "x\n";
+    return 0;
+}
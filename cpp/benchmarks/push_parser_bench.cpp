@@ -0,0 +1,202 @@
+/**
+ * @file push_parser_bench.cpp
+ * @brief 行情推送解析基准：快速路径（market_push）vs nlohmann::json DOM
+ *
+ * 用法：
+ *   push_parser_bench                 使用内置的录制报文
+ *   push_parser_bench frames.txt      从文件读取报文（每行一条，自动识别 OKX / Binance）
+ *   push_parser_bench frames.txt 20000
+ *
+ * DOM 路径模拟现有回调的做法：parse 整条报文后逐字段 contains() + 取值转换。
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "network/market_push.h"
+
+using json = nlohmann::json;
+using trading::core::MarketPushBatch;
+using trading::core::PushParseStatus;
+
+namespace {
+
+// ==================== 内置录制报文 ====================
+
+const char* const kSampleFrames[] = {
+    R"({"arg":{"channel":"tickers","instId":"BTC-USDT-SWAP"},"data":[{"instType":"SWAP","instId":"BTC-USDT-SWAP","last":"97123.4","lastSz":"0.12","askPx":"97123.5","askSz":"310","bidPx":"97123.4","bidSz":"85","open24h":"95880.1","high24h":"97650","low24h":"95500.2","volCcy24h":"105332.25","vol24h":"10533225.5","ts":"1734000000123","sodUtc0":"96010.3","sodUtc8":"96500.7"}]})",
+    R"({"arg":{"channel":"trades","instId":"ETH-USDT-SWAP"},"data":[{"instId":"ETH-USDT-SWAP","tradeId":"1283746512","px":"3890.12","sz":"4","side":"buy","ts":"1734000000456","count":"2"},{"instId":"ETH-USDT-SWAP","tradeId":"1283746513","px":"3890.11","sz":"12","side":"sell","ts":"1734000000457","count":"1"}]})",
+    R"({"arg":{"channel":"books5","instId":"BTC-USDT-SWAP"},"data":[{"asks":[["97123.5","310","0","7"],["97123.6","12","0","2"],["97123.8","40","0","3"],["97124","155","0","9"],["97124.3","2","0","1"]],"bids":[["97123.4","85","0","4"],["97123.2","20","0","2"],["97123","301","0","11"],["97122.9","7","0","1"],["97122.5","64","0","5"]],"instId":"BTC-USDT-SWAP","ts":"1734000000789","seqId":123456789}]})",
+    R"({"arg":{"channel":"candle1m","instId":"SOL-USDT-SWAP"},"data":[["1734000000000","228.41","228.77","228.3","228.69","18234","182.34","41684.2","1"]]})",
+    R"({"arg":{"channel":"funding-rate","instId":"BTC-USDT-SWAP"},"data":[{"formulaType":"withRate","fundingRate":"0.0001","fundingTime":"1734019200000","impactValue":"20000","instId":"BTC-USDT-SWAP","instType":"SWAP","interestRate":"0.0001","maxFundingRate":"0.0075","method":"current_period","minFundingRate":"-0.0075","nextFundingRate":"","nextFundingTime":"1734048000000","premium":"0.0002","settFundingRate":"0.0001","settState":"settled","ts":"1734000000999"}]})",
+    R"({"e":"trade","E":1734000000123,"s":"BTCUSDT","t":5432109876,"p":"97120.10","q":"0.015","T":1734000000120,"m":true})",
+    R"({"e":"kline","E":1734000060001,"s":"ETHUSDT","k":{"t":1734000000000,"T":1734000059999,"s":"ETHUSDT","i":"1m","f":100,"L":200,"o":"3888.10","c":"3890.45","h":"3891.00","l":"3887.50","v":"1523.412","n":101,"x":true,"q":"5921034.12","V":"800.1","Q":"3110000.5","B":"0"}})",
+    R"([{"e":"24hrTicker","E":1734000000123,"s":"BTCUSDT","p":"1200.1","P":"1.25","w":"96500.3","c":"97120.1","Q":"0.010","o":"95920.0","h":"97650.0","l":"95500.0","v":"201234.5","q":"19400000000.1","O":1733913600000,"C":1734000000000,"F":1,"L":1000,"n":1000},{"e":"24hrTicker","E":1734000000124,"s":"ETHUSDT","p":"30.2","P":"0.78","w":"3870.1","c":"3890.4","Q":"1.2","o":"3860.2","h":"3910.0","l":"3840.5","v":"1523412.2","q":"5900000000.4","O":1733913600000,"C":1734000000000,"F":1,"L":1000,"n":1000}])",
+    R"({"stream":"!markPrice@arr","data":[{"e":"markPriceUpdate","E":1734000000000,"s":"BTCUSDT","p":"97121.50000000","P":"97110.2","i":"97118.30000000","r":"0.00010000","T":1734019200000},{"e":"markPriceUpdate","E":1734000000000,"s":"ETHUSDT","p":"3890.30000000","P":"3889.1","i":"3889.90000000","r":"0.00008000","T":1734019200000}]})",
+};
+
+bool is_okx_frame(const std::string& frame) {
+    return frame.find("\"arg\"") != std::string::npos;
+}
+
+double to_double(const json& v) {
+    if (v.is_string()) {
+        const auto& s = v.get_ref<const std::string&>();
+        return s.empty() ? 0.0 : std::stod(s);
+    }
+    return v.is_number() ? v.get<double>() : 0.0;
+}
+
+// ==================== DOM 路径 ====================
+
+// 与现有 json 回调相同的取值方式，返回值用于防止编译器消除
+double dom_extract_okx_item(const json& item) {
+    double acc = 0.0;
+    if (item.is_array()) {
+        for (const auto& field : item) acc += to_double(field);
+        return acc;
+    }
+    for (const char* key : {"last", "px", "sz", "ts", "fundingRate", "bidPx", "askPx",
+                            "open24h", "high24h", "low24h", "vol24h"}) {
+        if (item.contains(key)) acc += to_double(item[key]);
+    }
+    for (const char* side : {"bids", "asks"}) {
+        if (item.contains(side)) {
+            for (const auto& level : item[side]) {
+                acc += to_double(level[0]) + to_double(level[1]);
+            }
+        }
+    }
+    if (item.contains("instId")) acc += item["instId"].get_ref<const std::string&>().size();
+    return acc;
+}
+
+double dom_extract_binance_event(const json& ev) {
+    double acc = 0.0;
+    const json& src = ev.contains("k") ? ev["k"] : ev;
+    for (const char* key : {"p", "q", "c", "o", "h", "l", "v", "i", "r", "T", "t"}) {
+        if (src.contains(key)) acc += to_double(src[key]);
+    }
+    if (ev.contains("s")) acc += ev["s"].get_ref<const std::string&>().size();
+    return acc;
+}
+
+double dom_parse(const std::string& frame, bool okx) {
+    json doc = json::parse(frame);
+    double acc = 0.0;
+    if (okx) {
+        if (doc.contains("data")) {
+            for (const auto& item : doc["data"]) acc += dom_extract_okx_item(item);
+        }
+        return acc;
+    }
+    const json& body = doc.contains("data") ? doc["data"] : doc;
+    if (body.is_array()) {
+        for (const auto& ev : body) acc += dom_extract_binance_event(ev);
+    } else {
+        acc += dom_extract_binance_event(body);
+    }
+    return acc;
+}
+
+// ==================== 快速路径 ====================
+
+double fast_parse(const std::string& frame, bool okx, MarketPushBatch& batch) {
+    PushParseStatus status = okx ? trading::core::parse_okx_push(frame, batch)
+                                 : trading::core::parse_binance_push(frame, batch);
+    if (status != PushParseStatus::OK) {
+        return dom_parse(frame, okx);  // 与适配器一致：失败回退 DOM
+    }
+    double acc = 0.0;
+    for (const auto& t : batch.tickers) acc += t.last + t.bid_price + t.ask_price + t.symbol.size();
+    for (const auto& t : batch.trades) acc += t.price + t.quantity + t.symbol.size();
+    for (const auto& k : batch.klines) acc += k.open + k.close + k.volume;
+    for (const auto& f : batch.funding_rates) acc += f.funding_rate + f.symbol.size();
+    for (const auto& m : batch.mark_prices) acc += m.mark_price + m.funding_rate;
+    if (batch.has_book) {
+        for (const auto& level : batch.book.bids) acc += level.price + level.size;
+        for (const auto& level : batch.book.asks) acc += level.price + level.size;
+    }
+    return acc;
+}
+
+struct Result {
+    double ns_per_frame = 0.0;
+    double checksum = 0.0;
+};
+
+template <typename Fn>
+Result run(const std::vector<std::string>& frames, const std::vector<bool>& okx,
+           int iterations, Fn&& fn) {
+    Result r;
+    auto start = std::chrono::steady_clock::now();
+    for (int it = 0; it < iterations; ++it) {
+        for (size_t i = 0; i < frames.size(); ++i) {
+            r.checksum += fn(frames[i], okx[i]);
+        }
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    r.ns_per_frame = static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) /
+        (static_cast<double>(iterations) * frames.size());
+    return r;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> frames;
+    if (argc > 1) {
+        std::ifstream in(argv[1]);
+        if (!in) {
+            std::cerr << "[Bench] 无法打开文件: " << argv[1] << "\n";
+            return 1;
+        }
+        std::string line;
+        while (std::getline(in, line)) {
+            if (!line.empty()) frames.push_back(line);
+        }
+    } else {
+        frames.assign(std::begin(kSampleFrames), std::end(kSampleFrames));
+    }
+    if (frames.empty()) {
+        std::cerr << "[Bench] 没有可用的报文\n";
+        return 1;
+    }
+    int iterations = argc > 2 ? std::max(1, std::atoi(argv[2])) : 20000;
+
+    std::vector<bool> okx;
+    size_t fast_ok = 0;
+    MarketPushBatch batch;
+    for (const auto& frame : frames) {
+        okx.push_back(is_okx_frame(frame));
+        PushParseStatus status = okx.back() ? trading::core::parse_okx_push(frame, batch)
+                                            : trading::core::parse_binance_push(frame, batch);
+        if (status == PushParseStatus::OK) ++fast_ok;
+    }
+
+    std::cout << "[Bench] 报文数: " << frames.size() << " (快速路径可解析: " << fast_ok
+              << ")  迭代: " << iterations << "\n";
+
+    Result dom = run(frames, okx, iterations, [](const std::string& f, bool o) {
+        return dom_parse(f, o);
+    });
+    Result fast = run(frames, okx, iterations, [&batch](const std::string& f, bool o) {
+        return fast_parse(f, o, batch);
+    });
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "  nlohmann DOM : " << dom.ns_per_frame << " ns/报文\n"
+              << "  快速路径     : " << fast.ns_per_frame << " ns/报文\n"
+              << "  加速比       : " << std::setprecision(2)
+              << dom.ns_per_frame / fast.ns_per_frame << "x\n"
+              << "  (checksum " << std::setprecision(0) << dom.checksum << " / "
+              << fast.checksum << ")\n";
+    return 0;
+}
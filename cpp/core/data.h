@@ -1,6 +1,8 @@
 #pragma once
 
 #include "event.h"
+#include "instrument_registry.h"
+#include "inline_vector.h"
 #include <string>
 #include <memory>
 #include <vector>
@@ -20,7 +22,7 @@ namespace trading {
  */
 class Data : public Event {
 public:
-    using Ptr = std::shared_ptr<Data>;
+    using Ptr = IntrusivePtr<Data>;
     
     Data(
         const std::string& name,
@@ -29,7 +31,9 @@ public:
     ) 
         : name_(name)
         , symbol_(symbol)
-        , exchange_(exchange) {
+        , exchange_(exchange)
+        , instrument_id_(symbol.empty() ? INVALID_INSTRUMENT
+                                        : InstrumentRegistry::instance().intern(exchange, symbol)) {
     }
     
     virtual ~Data() noexcept = default;
@@ -41,11 +45,17 @@ public:
     const std::string& name() const { return name_; }
     const std::string& symbol() const { return symbol_; }
     const std::string& exchange() const { return exchange_; }
+    
+    /**
+     * @brief 品种ID（构造时登记，下游按ID索引数组，无需再比较字符串）
+     */
+    InstrumentId instrument_id() const { return instrument_id_; }
 
 protected:
     std::string name_;      // 数据类型名称
     std::string symbol_;    // 交易对
     std::string exchange_;  // 交易所
+    InstrumentId instrument_id_ = INVALID_INSTRUMENT;  // 品种ID（见 instrument_registry.h）
 };
 
 /**
@@ -55,7 +65,7 @@ protected:
  */
 class TickerData : public Data {
 public:
-    using Ptr = std::shared_ptr<TickerData>;
+    using Ptr = IntrusivePtr<TickerData>;
     
     TickerData(
         const std::string& symbol,
@@ -138,7 +148,7 @@ private:
  */
 class TradeData : public Data {
 public:
-    using Ptr = std::shared_ptr<TradeData>;
+    using Ptr = IntrusivePtr<TradeData>;
     
     TradeData(
         const std::string& symbol,
@@ -193,12 +203,18 @@ private:
 
 /**
  * @brief 订单簿数据
+ *
+ * 档位内联存储（INLINE_LEVELS 档以内随事件对象一起从池中分配），
+ * 更深的订单簿才会使用堆内存。
  */
 class OrderBookData : public Data {
 public:
-    using Ptr = std::shared_ptr<OrderBookData>;
+    using Ptr = IntrusivePtr<OrderBookData>;
     using PriceLevel = std::pair<double, double>;  // (price, size)
     
+    static constexpr size_t INLINE_LEVELS = 25;    // 覆盖 books5 / bbo-tbt / depth20
+    using Levels = InlineVector<PriceLevel, INLINE_LEVELS>;
+    
     OrderBookData(
         const std::string& symbol,
         const std::vector<PriceLevel>& bids,
@@ -210,6 +226,20 @@ public:
         , asks_(asks) {
     }
     
+    /**
+     * @brief 从连续档位构造（不经过临时 std::vector）
+     */
+    OrderBookData(
+        const std::string& symbol,
+        const PriceLevel* bids, size_t bid_count,
+        const PriceLevel* asks, size_t ask_count,
+        const std::string& exchange = "okx"
+    )
+        : Data("orderbook", symbol, exchange)
+        , bids_(bids, bid_count)
+        , asks_(asks, ask_count) {
+    }
+    
     virtual ~OrderBookData() noexcept override = default;
     
     virtual std::string type_name() const override {
@@ -217,8 +247,8 @@ public:
     }
     
     // Getters
-    const std::vector<PriceLevel>& bids() const { return bids_; }
-    const std::vector<PriceLevel>& asks() const { return asks_; }
+    const Levels& bids() const { return bids_; }
+    const Levels& asks() const { return asks_; }
     
     // 最优买卖价
     std::optional<PriceLevel> best_bid() const {
@@ -262,8 +292,8 @@ public:
     }
 
 private:
-    std::vector<PriceLevel> bids_;  // 买盘 [(price, size), ...] 按价格从高到低
-    std::vector<PriceLevel> asks_;  // 卖盘 [(price, size), ...] 按价格从低到高
+    Levels bids_;  // 买盘 [(price, size), ...] 按价格从高到低
+    Levels asks_;  // 卖盘 [(price, size), ...] 按价格从低到高
 };
 
 /**
@@ -271,7 +301,7 @@ private:
  */
 class KlineData : public Data {
 public:
-    using Ptr = std::shared_ptr<KlineData>;
+    using Ptr = IntrusivePtr<KlineData>;
     
     KlineData(
         const std::string& symbol,
@@ -1,15 +1,77 @@
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <functional>
 #include <chrono>
+#include <mutex>
+#include <new>
 #include <string>
+#include <type_traits>
 #include <typeindex>
+#include <unordered_map>
+
+#include "intrusive_ptr.h"
+#include "object_pool.h"
 
 namespace trading {
 
 // 前向声明
 class EventEngine;
+class Event;
+
+template <typename T, typename... Args>
+IntrusivePtr<T> make_event(Args&&... args);
+
+/**
+ * @brief 事件类型注册表：事件类 -> 稠密整数ID（从 1 开始，0 表示未解析）
+ *
+ * EventEngine 用该ID直接索引派发表，派发时不再按 std::type_index 查哈希表。
+ * - id<T>() 每个类型只在首次调用时加锁登记，之后是函数内静态变量
+ * - id_of(type_index) 供按 typeid 注册监听器、以及非 make_event 创建的事件回退使用
+ */
+class EventTypeRegistry {
+public:
+    static constexpr uint32_t UNRESOLVED = 0;
+    
+    template <typename T>
+    static uint32_t id() {
+        static const uint32_t type_id = id_of(typeid(T));
+        return type_id;
+    }
+    
+    static uint32_t id_of(const std::type_index& type) {
+        State& state = instance();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        auto it = state.ids.find(type);
+        if (it != state.ids.end()) {
+            return it->second;
+        }
+        uint32_t type_id = static_cast<uint32_t>(state.ids.size()) + 1;
+        state.ids.emplace(type, type_id);
+        return type_id;
+    }
+    
+    /**
+     * @brief 已登记的类型数（ID 范围为 [1, size()]）
+     */
+    static size_t size() {
+        State& state = instance();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        return state.ids.size();
+    }
+
+private:
+    struct State {
+        std::mutex mutex;
+        std::unordered_map<std::type_index, uint32_t> ids;
+    };
+    
+    static State& instance() {
+        static State state;
+        return state;
+    }
+};
 
 /**
  * @brief 事件基类
@@ -18,10 +80,15 @@ class EventEngine;
  * 1. timestamp: 事件发生时间戳（毫秒）
  * 2. source: 事件来源（事件引擎ID）
  * 3. producer: 事件产生者（监听器函数的标识）
+ *
+ * 内存管理：
+ * - 引用计数在对象内部（IntrusivePtr），不需要 shared_ptr 控制块
+ * - 通过 make_event<T>() 创建的事件从线程本地对象池分配，
+ *   最后一个引用释放时析构并归还到释放线程的池中，稳态下不调用 operator new
  */
 class Event {
 public:
-    using Ptr = std::shared_ptr<Event>;
+    using Ptr = IntrusivePtr<Event>;
     using ListenerFunc = std::function<void(const Event::Ptr&)>;
     
     Event() 
@@ -30,6 +97,20 @@ public:
         , producer_id_(0) {
     }
     
+    // 拷贝只复制事件字段，引用计数和回收方式属于对象本身
+    Event(const Event& other)
+        : timestamp_(other.timestamp_)
+        , source_(other.source_)
+        , producer_id_(other.producer_id_) {
+    }
+    
+    Event& operator=(const Event& other) {
+        timestamp_ = other.timestamp_;
+        source_ = other.source_;
+        producer_id_ = other.producer_id_;
+        return *this;
+    }
+    
     virtual ~Event() noexcept = default;
     
     // 获取事件类型名称（用于调试）
@@ -49,10 +130,19 @@ public:
     size_t producer_id() const { return producer_id_; }
     void set_producer_id(size_t id) { producer_id_ = id; }
     
+    // 事件类型ID（见 EventTypeRegistry；make_event 创建时已填好，否则首次调用时按 typeid 解析）
+    uint32_t type_id() const {
+        uint32_t id = type_id_.load(std::memory_order_relaxed);
+        if (id == EventTypeRegistry::UNRESOLVED) {
+            id = EventTypeRegistry::id_of(typeid(*this));
+            type_id_.store(id, std::memory_order_relaxed);
+        }
+        return id;
+    }
+    
     // 浅拷贝事件
     virtual Event::Ptr copy() const {
-        auto e = std::make_shared<Event>(*this);
-        return e;
+        return make_event<Event>(*this);
     }
     
     // 派生新事件（清空时间戳、来源、产生者）
@@ -72,11 +162,78 @@ public:
         ).count();
     }
 
+    // 侵入式引用计数（IntrusivePtr 通过 ADL 调用）
+    friend void intrusive_add_ref(const Event* event) noexcept {
+        event->ref_count_.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    friend void intrusive_release(const Event* event) noexcept {
+        if (event->ref_count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            Event* self = const_cast<Event*>(event);
+            if (self->recycle_) {
+                self->recycle_(self);
+            } else {
+                delete self;
+            }
+        }
+    }
+
 protected:
     int64_t timestamp_;          // Unix时间戳（毫秒）
     const EventEngine* source_;  // 事件引擎
     size_t producer_id_;         // 产生者ID
+
+private:
+    template <typename T, typename... Args>
+    friend IntrusivePtr<T> make_event(Args&&... args);
+    
+    mutable std::atomic<uint32_t> ref_count_{0};  // 引用计数
+    mutable std::atomic<uint32_t> type_id_{EventTypeRegistry::UNRESOLVED};  // 动态类型ID（缓存）
+    void (*recycle_)(Event*) = nullptr;           // 计数归零时的回收函数（nullptr 表示 delete）
 };
 
+/**
+ * @brief 析构事件并把内存块还给对应大小的池
+ */
+template <size_t BlockSize>
+void recycle_pooled_event(Event* event) noexcept {
+    event->~Event();
+    BlockPool<BlockSize>::deallocate(event);
+}
+
+/**
+ * @brief 创建事件（替代 std::make_shared）
+ *
+ * 按对象大小选择 64 字节对齐的池块，大于 MAX_POOLED_OBJECT_SIZE 的对象退回 new。
+ *
+ * 用法：
+ *   auto order = make_event<Order>("BTC-USDT-SWAP", OrderType::LIMIT, OrderSide::BUY, 1.0, 50000.0);
+ *   engine.put(order);
+ */
+template <typename T, typename... Args>
+IntrusivePtr<T> make_event(Args&&... args) {
+    static_assert(std::is_base_of<Event, T>::value, "make_event 只能创建 Event 派生类");
+    static_assert(alignof(T) <= BlockPool<64>::ALIGNMENT, "事件对齐要求超过池块对齐");
+    
+    constexpr size_t block_size = pool_block_size(sizeof(T));
+    if constexpr (block_size > MAX_POOLED_OBJECT_SIZE) {
+        T* event = new T(std::forward<Args>(args)...);
+        static_cast<Event*>(event)->type_id_.store(EventTypeRegistry::id<T>(), std::memory_order_relaxed);
+        return IntrusivePtr<T>(event);
+    } else {
+        void* block = BlockPool<block_size>::allocate();
+        T* event;
+        try {
+            event = new (block) T(std::forward<Args>(args)...);
+        } catch (...) {
+            BlockPool<block_size>::deallocate(block);
+            throw;
+        }
+        static_cast<Event*>(event)->recycle_ = &recycle_pooled_event<block_size>;
+        static_cast<Event*>(event)->type_id_.store(EventTypeRegistry::id<T>(), std::memory_order_relaxed);
+        return IntrusivePtr<T>(event);
+    }
+}
+
 } // namespace trading
 
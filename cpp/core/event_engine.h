@@ -8,6 +8,8 @@
 #include <memory>
 #include <functional>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
 #include <mutex>
 #include <any>
 #include <cstdio>
@@ -57,13 +59,35 @@ public:
         Listener listener,
         bool ignore_self = true
     ) {
-        if (dispatching_) {
-            throw std::runtime_error("Cannot register while dispatching events");
+        add_typed_listener(EventTypeRegistry::id_of(event_type), std::move(listener), ignore_self);
+    }
+    
+    /**
+     * @brief 注册类型化监听器（回调直接拿到派生类型，无需 dynamic_pointer_cast）
+     * 
+     * 派发表按事件的精确类型匹配，因此这里用 static_cast 即可。
+     * 回调可以接收 const T::Ptr&（持有引用）或 const T&（不增减引用计数）。
+     * 
+     * 用法：
+     *   engine.register_listener<Order>([](const Order::Ptr& order) { ... });
+     *   engine.register_listener<TickerData>([](const TickerData& ticker) { ... });
+     */
+    template <typename T, typename Fn>
+    void register_listener(Fn&& fn, bool ignore_self = true) {
+        static_assert(std::is_base_of<Event, T>::value, "监听类型必须是 Event 派生类");
+        Listener listener;
+        if constexpr (std::is_invocable<Fn&, const IntrusivePtr<T>&>::value) {
+            listener = [fn = std::forward<Fn>(fn)](const Event::Ptr& event) mutable {
+                fn(static_pointer_cast<T>(event));
+            };
+        } else {
+            static_assert(std::is_invocable<Fn&, const T&>::value,
+                          "回调参数必须是 const T::Ptr& 或 const T&");
+            listener = [fn = std::forward<Fn>(fn)](const Event::Ptr& event) mutable {
+                fn(static_cast<const T&>(*event));
+            };
         }
-        
-        size_t listener_id = next_listener_id_++;
-        ListenerInfo info{listener, ignore_self, listener_id};
-        listener_dict_[event_type].push_back(info);
+        add_typed_listener(EventTypeRegistry::id<T>(), std::move(listener), ignore_self);
     }
     
     /**
@@ -83,13 +107,14 @@ public:
         }
         
         size_t listener_id = next_listener_id_++;
-        ListenerInfo info{listener, ignore_self, listener_id};
+        ListenerInfo info{std::move(listener), ignore_self, listener_id};
         
         if (is_senior) {
-            senior_global_listeners_.push_back(info);
+            senior_global_listeners_.push_back(std::move(info));
         } else {
-            junior_global_listeners_.push_back(info);
+            junior_global_listeners_.push_back(std::move(info));
         }
+        rebuild_dispatch_table();
     }
     
     /**
@@ -103,6 +128,18 @@ public:
      * 5. 如果不在派发中，立即派发
      */
     void put(Event::Ptr event) {
+        put_with_producer(std::move(event), current_listener_id_);
+    }
+    
+    /**
+     * @brief 以指定产生者推送事件
+     * 
+     * 供 ShardedEventEngine 把监听器跨分片投递的事件转交给目标分片：
+     * 目标分片的工作线程不在监听器内（current_listener_id_ == 0），
+     * 需要沿用来源分片的监听器ID，ignore_self 才能生效。
+     * 各分片按相同顺序注册监听器，监听器ID在分片之间一致。
+     */
+    void put_with_producer(Event::Ptr event, size_t producer_id) {
         if (!event) {
             throw std::invalid_argument("Event cannot be null");
         }
@@ -123,10 +160,10 @@ public:
         }
         
         // 标注产生者
-        event->set_producer_id(current_listener_id_);
+        event->set_producer_id(producer_id);
         
         // 入队
-        queue_.push(event);
+        queue_.push(std::move(event));
         
         // 如果不在派发中，立即开始派发
         if (!dispatching_) {
@@ -134,6 +171,13 @@ public:
         }
     }
     
+    /**
+     * @brief 正在执行的监听器ID（不在监听器内时为 0）
+     */
+    size_t current_listener_id() const {
+        return current_listener_id_;
+    }
+    
     /**
      * @brief 手动更新引擎时间戳
      */
@@ -181,37 +225,20 @@ protected:
      * 1. Senior全局监听器
      * 2. 类型特定监听器
      * 3. Junior全局监听器
+     * 
+     * 三段监听器在注册时已按类型合并进派发表（dispatch_table_[type_id]），
+     * 这里只做一次数组下标访问。派发期间禁止注册，因此可以直接引用表项。
      */
     void drain() {
         dispatching_ = true;
         
         while (!queue_.empty()) {
-            Event::Ptr event = queue_.front();
+            Event::Ptr event = std::move(queue_.front());
             queue_.pop();
             
-            // 获取事件类型
-            std::type_index event_type = typeid(*event);
-            
-            // 收集所有要执行的监听器
-            std::vector<ListenerInfo> listeners;
-            
-            // 1. Senior全局监听器
-            listeners.insert(listeners.end(), 
-                senior_global_listeners_.begin(), 
-                senior_global_listeners_.end());
-            
-            // 2. 类型特定监听器
-            auto it = listener_dict_.find(event_type);
-            if (it != listener_dict_.end()) {
-                listeners.insert(listeners.end(), 
-                    it->second.begin(), 
-                    it->second.end());
-            }
-            
-            // 3. Junior全局监听器
-            listeners.insert(listeners.end(), 
-                junior_global_listeners_.begin(), 
-                junior_global_listeners_.end());
+            uint32_t type_id = event->type_id();
+            const std::vector<ListenerInfo>& listeners =
+                type_id < dispatch_table_.size() ? dispatch_table_[type_id] : global_listeners_;
             
             // 执行监听器
             for (const auto& info : listeners) {
@@ -245,19 +272,62 @@ private:
         size_t id;
     };
     
+    void add_typed_listener(uint32_t type_id, Listener listener, bool ignore_self) {
+        if (dispatching_) {
+            throw std::runtime_error("Cannot register while dispatching events");
+        }
+        
+        size_t listener_id = next_listener_id_++;
+        if (typed_listeners_.size() <= type_id) {
+            typed_listeners_.resize(type_id + 1);
+        }
+        typed_listeners_[type_id].push_back(ListenerInfo{std::move(listener), ignore_self, listener_id});
+        rebuild_dispatch_table();
+    }
+    
+    /**
+     * @brief 重建派发表（仅在注册时调用）
+     * 
+     * dispatch_table_[id] = senior + typed_listeners_[id] + junior，
+     * 没有类型监听器的类型（id 超出表长）走 global_listeners_ = senior + junior。
+     */
+    void rebuild_dispatch_table() {
+        global_listeners_.clear();
+        global_listeners_.insert(global_listeners_.end(),
+            senior_global_listeners_.begin(), senior_global_listeners_.end());
+        global_listeners_.insert(global_listeners_.end(),
+            junior_global_listeners_.begin(), junior_global_listeners_.end());
+        
+        dispatch_table_.assign(typed_listeners_.size(), {});
+        for (size_t type_id = 0; type_id < typed_listeners_.size(); ++type_id) {
+            auto& entry = dispatch_table_[type_id];
+            entry.reserve(global_listeners_.size() + typed_listeners_[type_id].size());
+            entry.insert(entry.end(),
+                senior_global_listeners_.begin(), senior_global_listeners_.end());
+            entry.insert(entry.end(),
+                typed_listeners_[type_id].begin(), typed_listeners_[type_id].end());
+            entry.insert(entry.end(),
+                junior_global_listeners_.begin(), junior_global_listeners_.end());
+        }
+    }
+    
     int64_t timestamp_;                                      // 当前引擎时间戳
     std::queue<Event::Ptr> queue_;                           // 事件队列
     bool dispatching_;                                       // 是否正在派发
     size_t current_listener_id_;                             // 当前监听器ID
     size_t next_listener_id_ = 1;                            // 下一个监听器ID
     
-    // 监听器字典：{事件类型: [监听器列表]}
-    std::unordered_map<std::type_index, std::vector<ListenerInfo>> listener_dict_;
+    // 类型监听器：{事件类型ID: [监听器列表]}
+    std::vector<std::vector<ListenerInfo>> typed_listeners_;
     
     // 全局监听器
     std::vector<ListenerInfo> senior_global_listeners_;      // 高优先级
     std::vector<ListenerInfo> junior_global_listeners_;      // 低优先级
     
+    // 派发表（注册时由上面三者合并生成）
+    std::vector<std::vector<ListenerInfo>> dispatch_table_;  // 按事件类型ID索引
+    std::vector<ListenerInfo> global_listeners_;             // 无类型监听器的事件
+    
     // 动态注入的函数
     std::unordered_map<std::string, std::any> injected_functions_;
 };
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace trading {
+
+/**
+ * @brief 字符串驻留表（名称 -> 稠密整数ID，0 ~ Capacity-1）
+ *
+ * 用于把 symbol / strategy_id 等字符串映射为数组下标，热路径按下标访问预分配槽位，
+ * 避免 std::map<std::string, ...> 的查找和加锁。
+ *
+ * 实现：
+ * - 开放寻址哈希表，槽位数为 2 * Capacity，条目只增不删
+ * - find() 无锁：acquire 读取已发布的条目指针，不分配内存
+ * - intern() 仅在首次出现时加锁插入（每个名称只发生一次）
+ * - 容量固定，已满时 intern() 返回 -1
+ *
+ * 用法：
+ *   IdInterner<1024> ids;
+ *   int id = ids.intern("BTC-USDT-SWAP");   // 首次分配
+ *   int same = ids.find("BTC-USDT-SWAP");   // 无锁查找，未登记返回 -1
+ */
+template <size_t Capacity>
+class IdInterner {
+public:
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity 必须是 2 的幂");
+    static constexpr size_t TABLE_SIZE = Capacity * 2;
+
+    IdInterner() {
+        for (auto& slot : slots_) {
+            slot.store(nullptr, std::memory_order_relaxed);
+        }
+        entries_.reserve(Capacity);
+    }
+
+    IdInterner(const IdInterner&) = delete;
+    IdInterner& operator=(const IdInterner&) = delete;
+
+    /**
+     * @brief 无锁查找
+     * @return ID，未登记返回 -1
+     */
+    int find(std::string_view name) const {
+        size_t i = slot_of(name);
+        for (size_t probe = 0; probe < TABLE_SIZE; ++probe) {
+            const Entry* entry = slots_[i].load(std::memory_order_acquire);
+            if (!entry) {
+                return -1;
+            }
+            if (entry->name == name) {
+                return entry->id;
+            }
+            i = (i + 1) & (TABLE_SIZE - 1);
+        }
+        return -1;
+    }
+
+    /**
+     * @brief 查找，未登记则分配新ID
+     * @return ID，表已满返回 -1
+     */
+    int intern(std::string_view name) {
+        int id = find(name);
+        if (id >= 0) {
+            return id;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        id = find(name);  // 加锁后复查，避免并发重复分配
+        if (id >= 0) {
+            return id;
+        }
+        if (entries_.size() >= Capacity) {
+            return -1;
+        }
+
+        auto entry = std::make_unique<Entry>();
+        entry->name = std::string(name);
+        entry->id = static_cast<int>(entries_.size());
+
+        size_t i = slot_of(name);
+        while (slots_[i].load(std::memory_order_relaxed)) {
+            i = (i + 1) & (TABLE_SIZE - 1);
+        }
+        // release：读者看到指针时条目内容已完整
+        slots_[i].store(entry.get(), std::memory_order_release);
+
+        id = entry->id;
+        entries_.push_back(std::move(entry));
+        size_.store(entries_.size(), std::memory_order_release);
+        return id;
+    }
+
+    /**
+     * @brief 已分配的ID数（ID 范围为 [0, size())）
+     */
+    size_t size() const {
+        return size_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief ID 对应的名称（冷路径：统计输出）
+     */
+    std::string name(int id) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (id < 0 || static_cast<size_t>(id) >= entries_.size()) {
+            return "";
+        }
+        return entries_[id]->name;
+    }
+
+    static constexpr size_t capacity() { return Capacity; }
+
+private:
+    struct Entry {
+        std::string name;
+        int id = -1;
+    };
+
+    static size_t slot_of(std::string_view name) {
+        return std::hash<std::string_view>{}(name) & (TABLE_SIZE - 1);
+    }
+
+    std::array<std::atomic<const Entry*>, TABLE_SIZE> slots_;
+    std::vector<std::unique_ptr<Entry>> entries_;  // 条目所有权（仅在 mutex_ 下修改）
+    std::atomic<size_t> size_{0};
+    mutable std::mutex mutex_;
+};
+
+/**
+ * @brief 按名称索引的对象表（IdInterner + 稠密指针数组）
+ *
+ * find() 无锁：驻留表查到 ID 后 acquire 读取槽位指针。对象在首次出现时创建，
+ * 之后不再删除（生命周期与表相同），读者拿到的指针始终有效。
+ *
+ * 用法：
+ *   IdTable<KlineBuffer, 2048> buffers;
+ *   KlineBuffer* buf = buffers.get_or_create("BTC-USDT-SWAP", max_bars);  // 表满返回 nullptr
+ *   const KlineBuffer* same = buffers.find("BTC-USDT-SWAP");             // 未创建返回 nullptr
+ */
+template <typename T, size_t Capacity>
+class IdTable {
+public:
+    IdTable() {
+        for (auto& slot : slots_) {
+            slot.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    IdTable(const IdTable&) = delete;
+    IdTable& operator=(const IdTable&) = delete;
+
+    T* find(std::string_view name) const {
+        int id = ids_.find(name);
+        return id < 0 ? nullptr : slots_[id].load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief 查找，不存在则用 args 构造
+     * @return 表已满返回 nullptr
+     */
+    template <typename... Args>
+    T* get_or_create(std::string_view name, Args&&... args) {
+        T* object = find(name);
+        if (object) {
+            return object;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        int id = ids_.intern(name);
+        if (id < 0) {
+            return nullptr;
+        }
+        object = slots_[id].load(std::memory_order_relaxed);
+        if (!object) {
+            owned_.push_back(std::make_unique<T>(std::forward<Args>(args)...));
+            object = owned_.back().get();
+            slots_[id].store(object, std::memory_order_release);
+        }
+        return object;
+    }
+
+    /**
+     * @brief 已创建对象的名称（冷路径）
+     */
+    std::vector<std::string> names() const {
+        std::vector<std::string> result;
+        size_t count = ids_.size();
+        result.reserve(count);
+        for (size_t id = 0; id < count; ++id) {
+            if (slots_[id].load(std::memory_order_acquire)) {
+                result.push_back(ids_.name(static_cast<int>(id)));
+            }
+        }
+        return result;
+    }
+
+    static constexpr size_t capacity() { return Capacity; }
+
+private:
+    IdInterner<Capacity> ids_;
+    std::array<std::atomic<T*>, Capacity> slots_;
+    std::vector<std::unique_ptr<T>> owned_;  // 对象所有权（仅在 mutex_ 下修改）
+    std::mutex mutex_;
+};
+
+} // namespace trading
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace trading {
+
+/**
+ * @brief 工作线程空闲策略
+ *
+ * 工作线程每轮处理完消息后调用 idle(work_count)：
+ * - POLL:    阻塞在 zmq::poll 上，有消息立即唤醒（低 CPU，唤醒延迟约 10-30μs）
+ * - SPIN:    忙轮询，不让出 CPU（需绑核，延迟最低，独占一个核心）
+ * - BACKOFF: 先自旋，再 yield，最后指数退避睡眠（兼顾突发流量与空闲 CPU）
+ *
+ * 用法：
+ *   IdleStrategy idle(IdleMode::POLL);
+ *   while (running) {
+ *       int n = drain();
+ *       idle.idle(n, [&](int timeout_ms) { server.wait_orders(timeout_ms); });
+ *   }
+ */
+enum class IdleMode {
+    POLL,
+    SPIN,
+    BACKOFF
+};
+
+/**
+ * @brief 解析空闲策略名称（poll / spin / backoff）
+ */
+inline bool parse_idle_mode(const std::string& name, IdleMode& mode) {
+    if (name == "poll") {
+        mode = IdleMode::POLL;
+    } else if (name == "spin") {
+        mode = IdleMode::SPIN;
+    } else if (name == "backoff") {
+        mode = IdleMode::BACKOFF;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+inline const char* idle_mode_name(IdleMode mode) {
+    switch (mode) {
+        case IdleMode::POLL: return "poll";
+        case IdleMode::SPIN: return "spin";
+        case IdleMode::BACKOFF: return "backoff";
+    }
+    return "unknown";
+}
+
+/**
+ * @brief 自旋等待提示（降低超线程争用和功耗）
+ */
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+class IdleStrategy {
+public:
+    /**
+     * @param mode 空闲模式
+     * @param poll_timeout_ms POLL 模式单次阻塞上限（用于及时检查退出标志）
+     */
+    explicit IdleStrategy(IdleMode mode, int poll_timeout_ms = 100)
+        : mode_(mode)
+        , poll_timeout_ms_(poll_timeout_ms) {}
+
+    IdleMode mode() const { return mode_; }
+
+    /**
+     * @brief 一轮处理结束后调用
+     *
+     * @param work_count 本轮处理的消息数（> 0 时重置退避状态，不等待）
+     * @param wait POLL 模式下的阻塞等待函数，参数为超时毫秒
+     */
+    template <typename WaitFn>
+    void idle(int work_count, WaitFn&& wait) {
+        if (work_count > 0) {
+            reset();
+            return;
+        }
+
+        switch (mode_) {
+            case IdleMode::POLL:
+                wait(poll_timeout_ms_);
+                break;
+
+            case IdleMode::SPIN:
+                cpu_relax();
+                break;
+
+            case IdleMode::BACKOFF:
+                backoff();
+                break;
+        }
+    }
+
+    void reset() {
+        spins_ = 0;
+        yields_ = 0;
+        park_ns_ = MIN_PARK_NS;
+    }
+
+private:
+    // 退避参数：约 10μs 自旋 + 100 次 yield 后进入睡眠，睡眠时间 1μs 起步翻倍至 1ms
+    static constexpr int MAX_SPINS = 1000;
+    static constexpr int MAX_YIELDS = 100;
+    static constexpr int64_t MIN_PARK_NS = 1000;
+    static constexpr int64_t MAX_PARK_NS = 1000000;
+
+    void backoff() {
+        if (spins_ < MAX_SPINS) {
+            ++spins_;
+            cpu_relax();
+        } else if (yields_ < MAX_YIELDS) {
+            ++yields_;
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::nanoseconds(park_ns_));
+            park_ns_ = park_ns_ * 2 < MAX_PARK_NS ? park_ns_ * 2 : MAX_PARK_NS;
+        }
+    }
+
+    IdleMode mode_;
+    int poll_timeout_ms_;
+    int spins_ = 0;
+    int yields_ = 0;
+    int64_t park_ns_ = MIN_PARK_NS;
+};
+
+} // namespace trading
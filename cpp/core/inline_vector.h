@@ -0,0 +1,109 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+
+namespace trading {
+
+/**
+ * @brief 内联存储的小向量
+ *
+ * 前 N 个元素存放在对象内部（随对象一起从池中分配），超过 N 时整体搬到堆上的 std::vector。
+ * 用于订单簿档位等通常很短、偶尔很长的数组，常见深度（books5 / depth20）不产生堆分配。
+ *
+ * T 需要可默认构造、可拷贝（档位、价格等简单类型）。
+ */
+template <typename T, size_t N>
+class InlineVector {
+public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    InlineVector() = default;
+
+    InlineVector(const T* items, size_t count) {
+        assign(items, count);
+    }
+
+    InlineVector(const std::vector<T>& items) {  // 允许隐式转换，兼容原 std::vector 接口
+        assign(items.data(), items.size());
+    }
+
+    InlineVector(std::initializer_list<T> items) {
+        assign(items.begin(), items.size());
+    }
+
+    InlineVector(const InlineVector& other) {
+        assign(other.data(), other.size());
+    }
+
+    InlineVector& operator=(const InlineVector& other) {
+        if (this != &other) assign(other.data(), other.size());
+        return *this;
+    }
+
+    void assign(const T* items, size_t count) {
+        clear();
+        reserve(count);
+        std::copy(items, items + count, data());
+        size_ = count;
+    }
+
+    void push_back(const T& item) {
+        if (size_ == capacity()) {
+            reserve(size_ * 2);
+        }
+        data()[size_++] = item;
+    }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
+        push_back(T(std::forward<Args>(args)...));
+        return back();
+    }
+
+    void reserve(size_t count) {
+        if (count <= capacity()) return;
+        if (heap_.empty()) {
+            heap_.assign(inline_, inline_ + size_);
+        }
+        heap_.resize(count);
+    }
+
+    void clear() { size_ = 0; }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    size_t capacity() const { return heap_.empty() ? N : heap_.size(); }
+    bool is_inline() const { return heap_.empty(); }
+
+    T* data() { return heap_.empty() ? inline_ : heap_.data(); }
+    const T* data() const { return heap_.empty() ? inline_ : heap_.data(); }
+
+    T& operator[](size_t i) { return data()[i]; }
+    const T& operator[](size_t i) const { return data()[i]; }
+    T& front() { return data()[0]; }
+    const T& front() const { return data()[0]; }
+    T& back() { return data()[size_ - 1]; }
+    const T& back() const { return data()[size_ - 1]; }
+
+    iterator begin() { return data(); }
+    iterator end() { return data() + size_; }
+    const_iterator begin() const { return data(); }
+    const_iterator end() const { return data() + size_; }
+
+    std::vector<T> to_vector() const {
+        return std::vector<T>(begin(), end());
+    }
+
+private:
+    T inline_[N];
+    std::vector<T> heap_;  // 溢出后使用（resize 到容量，元素个数以 size_ 为准）
+    size_t size_ = 0;
+};
+
+} // namespace trading
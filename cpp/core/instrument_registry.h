@@ -0,0 +1,159 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "id_interner.h"
+
+namespace trading {
+
+/**
+ * @brief 进程内稠密品种ID（0 ~ InstrumentRegistry::CAPACITY-1，-1 表示无效）
+ */
+using InstrumentId = int32_t;
+constexpr InstrumentId INVALID_INSTRUMENT = -1;
+
+/**
+ * @brief 品种信息（登记后不可变）
+ */
+struct Instrument {
+    InstrumentId id = INVALID_INSTRUMENT;
+    std::string exchange;         // "okx" / "binance"
+    std::string symbol;           // 交易所原始代码，如 BTC-USDT-SWAP / BTCUSDT
+    std::string display_symbol;   // 前端显示代码（OKX 去掉 -SWAP 后缀）
+};
+
+/**
+ * @brief 全局品种注册表：(exchange, symbol) -> 稠密整数ID
+ *
+ * 字符串只在边界（WebSocket 解析、ZMQ 主题、Python 接口）出现，
+ * 内部按 ID 索引预分配的数组（持仓、缓冲区、统计）。
+ *
+ * - find() / get() 无锁、不分配内存（键在栈上拼接）
+ * - intern() 首次出现时加锁登记，之后与 find() 相同
+ * - 条目只增不删，get() 返回的指针在进程生命周期内有效
+ *
+ * 注意：ID 只在本进程内有效。服务端把自己的 ID 写入二进制帧头，
+ * 策略端只能把它当作缓存键（见 WireHeader::instrument_id），不能与本地 ID 混用。
+ */
+class InstrumentRegistry {
+public:
+    static constexpr size_t CAPACITY = 8192;
+
+    static InstrumentRegistry& instance() {
+        static InstrumentRegistry registry;
+        return registry;
+    }
+
+    InstrumentRegistry(const InstrumentRegistry&) = delete;
+    InstrumentRegistry& operator=(const InstrumentRegistry&) = delete;
+
+    /**
+     * @brief 无锁查找
+     * @return 未登记返回 INVALID_INSTRUMENT
+     */
+    InstrumentId find(std::string_view exchange, std::string_view symbol) const {
+        KeyBuffer key;
+        if (!key.assign(exchange, symbol)) return INVALID_INSTRUMENT;
+        return ids_.find(key.view());
+    }
+
+    /**
+     * @brief 查找，未登记则分配ID
+     * @return 注册表已满或名称过长返回 INVALID_INSTRUMENT
+     */
+    InstrumentId intern(std::string_view exchange, std::string_view symbol) {
+        KeyBuffer key;
+        if (!key.assign(exchange, symbol)) return INVALID_INSTRUMENT;
+        InstrumentId id = ids_.find(key.view());
+        if (id >= 0) return id;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        id = ids_.intern(key.view());
+        if (id < 0) {
+            std::cerr << "[品种] 注册表已满（" << CAPACITY << "），忽略: "
+                      << exchange << " " << symbol << std::endl;
+            return INVALID_INSTRUMENT;
+        }
+        if (!instruments_[id].load(std::memory_order_relaxed)) {
+            auto instrument = std::make_unique<Instrument>();
+            instrument->id = id;
+            instrument->exchange = std::string(exchange);
+            instrument->symbol = std::string(symbol);
+            instrument->display_symbol = make_display_symbol(symbol);
+            instruments_[id].store(instrument.get(), std::memory_order_release);
+            owned_.push_back(std::move(instrument));
+        }
+        return id;
+    }
+
+    /**
+     * @brief 按ID取品种信息（无锁），无效ID返回 nullptr
+     */
+    const Instrument* get(InstrumentId id) const {
+        if (id < 0 || static_cast<size_t>(id) >= CAPACITY) return nullptr;
+        return instruments_[id].load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief 登记并返回品种信息（表满返回 nullptr）
+     */
+    const Instrument* resolve(std::string_view exchange, std::string_view symbol) {
+        return get(intern(exchange, symbol));
+    }
+
+    size_t size() const { return ids_.size(); }
+
+    /**
+     * @brief 前端显示代码：OKX 永续去掉 -SWAP 后缀
+     */
+    static std::string make_display_symbol(std::string_view symbol) {
+        constexpr std::string_view suffix = "-SWAP";
+        if (symbol.size() > suffix.size() &&
+            symbol.compare(symbol.size() - suffix.size(), suffix.size(), suffix) == 0) {
+            symbol.remove_suffix(suffix.size());
+        }
+        return std::string(symbol);
+    }
+
+private:
+    InstrumentRegistry() {
+        for (auto& slot : instruments_) {
+            slot.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief 栈上拼接的键 "exchange|symbol"
+     */
+    struct KeyBuffer {
+        char data[96];
+        size_t size = 0;
+
+        bool assign(std::string_view exchange, std::string_view symbol) {
+            if (exchange.size() + symbol.size() + 1 > sizeof(data)) return false;
+            std::memcpy(data, exchange.data(), exchange.size());
+            data[exchange.size()] = '|';
+            std::memcpy(data + exchange.size() + 1, symbol.data(), symbol.size());
+            size = exchange.size() + symbol.size() + 1;
+            return true;
+        }
+
+        std::string_view view() const { return std::string_view(data, size); }
+    };
+
+    IdInterner<CAPACITY> ids_;
+    std::array<std::atomic<const Instrument*>, CAPACITY> instruments_;
+    std::vector<std::unique_ptr<Instrument>> owned_;  // 所有权（仅在 mutex_ 下修改）
+    std::mutex mutex_;
+};
+
+} // namespace trading
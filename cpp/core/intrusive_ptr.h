@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+namespace trading {
+
+/**
+ * @brief 侵入式智能指针
+ *
+ * 引用计数存放在对象自身（见 Event），与 std::shared_ptr 相比：
+ * - 不需要单独的控制块，对象可以直接从对象池分配
+ * - 从裸指针重新构造 Ptr 是安全的（计数在对象里）
+ *
+ * T 需要通过 ADL 提供：
+ *   void intrusive_add_ref(const T*);
+ *   void intrusive_release(const T*);   // 计数归零时负责回收对象
+ */
+template <typename T>
+class IntrusivePtr {
+public:
+    using element_type = T;
+
+    IntrusivePtr() noexcept = default;
+    IntrusivePtr(std::nullptr_t) noexcept {}
+
+    explicit IntrusivePtr(T* ptr) noexcept : ptr_(ptr) {
+        if (ptr_) intrusive_add_ref(ptr_);
+    }
+
+    IntrusivePtr(const IntrusivePtr& other) noexcept : ptr_(other.ptr_) {
+        if (ptr_) intrusive_add_ref(ptr_);
+    }
+
+    IntrusivePtr(IntrusivePtr&& other) noexcept : ptr_(other.ptr_) {
+        other.ptr_ = nullptr;
+    }
+
+    // 派生类指针 -> 基类指针
+    template <typename U, typename = std::enable_if_t<std::is_convertible<U*, T*>::value>>
+    IntrusivePtr(const IntrusivePtr<U>& other) noexcept : ptr_(other.get()) {
+        if (ptr_) intrusive_add_ref(ptr_);
+    }
+
+    template <typename U, typename = std::enable_if_t<std::is_convertible<U*, T*>::value>>
+    IntrusivePtr(IntrusivePtr<U>&& other) noexcept : ptr_(other.detach()) {}
+
+    ~IntrusivePtr() {
+        if (ptr_) intrusive_release(ptr_);
+    }
+
+    IntrusivePtr& operator=(const IntrusivePtr& other) noexcept {
+        IntrusivePtr(other).swap(*this);
+        return *this;
+    }
+
+    IntrusivePtr& operator=(IntrusivePtr&& other) noexcept {
+        IntrusivePtr(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    IntrusivePtr& operator=(std::nullptr_t) noexcept {
+        reset();
+        return *this;
+    }
+
+    void reset() noexcept {
+        IntrusivePtr().swap(*this);
+    }
+
+    void swap(IntrusivePtr& other) noexcept {
+        std::swap(ptr_, other.ptr_);
+    }
+
+    /**
+     * @brief 放弃所有权（不减计数），返回裸指针
+     */
+    T* detach() noexcept {
+        T* ptr = ptr_;
+        ptr_ = nullptr;
+        return ptr;
+    }
+
+    T* get() const noexcept { return ptr_; }
+    T& operator*() const noexcept { return *ptr_; }
+    T* operator->() const noexcept { return ptr_; }
+    explicit operator bool() const noexcept { return ptr_ != nullptr; }
+
+private:
+    T* ptr_ = nullptr;
+};
+
+template <typename T, typename U>
+bool operator==(const IntrusivePtr<T>& a, const IntrusivePtr<U>& b) noexcept { return a.get() == b.get(); }
+template <typename T, typename U>
+bool operator!=(const IntrusivePtr<T>& a, const IntrusivePtr<U>& b) noexcept { return a.get() != b.get(); }
+template <typename T>
+bool operator==(const IntrusivePtr<T>& a, std::nullptr_t) noexcept { return !a; }
+template <typename T>
+bool operator!=(const IntrusivePtr<T>& a, std::nullptr_t) noexcept { return static_cast<bool>(a); }
+template <typename T>
+bool operator==(std::nullptr_t, const IntrusivePtr<T>& a) noexcept { return !a; }
+template <typename T>
+bool operator!=(std::nullptr_t, const IntrusivePtr<T>& a) noexcept { return static_cast<bool>(a); }
+
+/**
+ * @brief 对应 std::static_pointer_cast / std::dynamic_pointer_cast
+ */
+template <typename T, typename U>
+IntrusivePtr<T> static_pointer_cast(const IntrusivePtr<U>& ptr) noexcept {
+    return IntrusivePtr<T>(static_cast<T*>(ptr.get()));
+}
+
+template <typename T, typename U>
+IntrusivePtr<T> dynamic_pointer_cast(const IntrusivePtr<U>& ptr) noexcept {
+    return IntrusivePtr<T>(dynamic_cast<T*>(ptr.get()));
+}
+
+} // namespace trading
+
+namespace std {
+template <typename T>
+struct hash<trading::IntrusivePtr<T>> {
+    size_t operator()(const trading::IntrusivePtr<T>& ptr) const noexcept {
+        return hash<T*>()(ptr.get());
+    }
+};
+} // namespace std
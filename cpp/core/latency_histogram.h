@@ -0,0 +1,146 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace trading {
+
+/**
+ * @brief 延迟直方图（对数-线性分桶，无锁记录）
+ *
+ * 分桶方式：
+ * - 每个 2 的幂区间再均分为 SUB_BUCKETS 个子桶，相对误差 < 1/SUB_BUCKETS
+ * - 覆盖 1ns ~ 2^40ns（约 18 分钟），超出部分计入最后一个桶
+ *
+ * 线程安全：
+ * - record() 可被多个线程并发调用（relaxed 原子计数）
+ * - percentile()/summary() 读取的是近似快照，用于监控输出
+ *
+ * 用法：
+ *   LatencyHistogram hist;
+ *   hist.record(latency_ns);
+ *   std::cout << hist.summary() << std::endl;  // n=.. p50=.. p99=.. p999=.. max=..
+ */
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 3;
+    static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static constexpr int MAX_EXPONENT = 40;
+    static constexpr int BUCKET_COUNT = (MAX_EXPONENT + 1) * SUB_BUCKETS;
+
+    LatencyHistogram() { reset(); }
+
+    /**
+     * @brief 记录一次延迟（纳秒），负值按 0 处理
+     */
+    void record(int64_t latency_ns) {
+        uint64_t v = latency_ns > 0 ? static_cast<uint64_t>(latency_ns) : 0;
+        buckets_[bucket_index(v)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(v, std::memory_order_relaxed);
+
+        uint64_t prev_max = max_.load(std::memory_order_relaxed);
+        while (v > prev_max && !max_.compare_exchange_weak(prev_max, v, std::memory_order_relaxed)) {
+        }
+    }
+
+    /**
+     * @brief 清空统计
+     */
+    void reset() {
+        for (auto& b : buckets_) {
+            b.store(0, std::memory_order_relaxed);
+        }
+        count_.store(0, std::memory_order_relaxed);
+        sum_.store(0, std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+    }
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+
+    uint64_t mean() const {
+        uint64_t n = count();
+        return n ? sum_.load(std::memory_order_relaxed) / n : 0;
+    }
+
+    /**
+     * @brief 分位数（纳秒，返回所在桶的上界）
+     * @param p 0.0 ~ 1.0，如 0.99
+     */
+    uint64_t percentile(double p) const {
+        uint64_t n = count();
+        if (n == 0) return 0;
+
+        uint64_t target = static_cast<uint64_t>(p * static_cast<double>(n));
+        if (target >= n) target = n - 1;
+
+        uint64_t seen = 0;
+        for (int i = 0; i < BUCKET_COUNT; ++i) {
+            seen += buckets_[i].load(std::memory_order_relaxed);
+            if (seen > target) {
+                uint64_t upper = bucket_upper(i);
+                uint64_t m = max();
+                return upper < m ? upper : m;
+            }
+        }
+        return max();
+    }
+
+    /**
+     * @brief 单行摘要，单位自动选择 ns/μs/ms
+     */
+    std::string summary() const {
+        std::string s = "n=" + std::to_string(count());
+        s += " p50=" + format_ns(percentile(0.50));
+        s += " p99=" + format_ns(percentile(0.99));
+        s += " p999=" + format_ns(percentile(0.999));
+        s += " max=" + format_ns(max());
+        return s;
+    }
+
+    static std::string format_ns(uint64_t ns) {
+        char buf[32];
+        if (ns < 1000) {
+            std::snprintf(buf, sizeof(buf), "%lluns", static_cast<unsigned long long>(ns));
+        } else if (ns < 1000000) {
+            std::snprintf(buf, sizeof(buf), "%.1fus", ns / 1e3);
+        } else {
+            std::snprintf(buf, sizeof(buf), "%.2fms", ns / 1e6);
+        }
+        return buf;
+    }
+
+private:
+    static int bucket_index(uint64_t v) {
+        if (v < SUB_BUCKETS) {
+            return static_cast<int>(v);
+        }
+        int exp = 63 - __builtin_clzll(v);  // v 的最高位
+        if (exp > MAX_EXPONENT) {
+            return BUCKET_COUNT - 1;
+        }
+        int sub = static_cast<int>((v >> (exp - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1));
+        return (exp - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + sub;
+    }
+
+    static uint64_t bucket_upper(int index) {
+        if (index < SUB_BUCKETS) {
+            return static_cast<uint64_t>(index);
+        }
+        int exp = index / SUB_BUCKETS + SUB_BUCKET_BITS - 1;
+        int sub = index % SUB_BUCKETS;
+        uint64_t base = 1ULL << exp;
+        uint64_t step = base >> SUB_BUCKET_BITS;
+        return base + step * (sub + 1) - 1;
+    }
+
+    std::atomic<uint64_t> buckets_[BUCKET_COUNT];
+    std::atomic<uint64_t> count_;
+    std::atomic<uint64_t> sum_;
+    std::atomic<uint64_t> max_;
+};
+
+} // namespace trading
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace trading {
+
+/**
+ * @brief 有界多写者单读者队列（进程内，无锁）
+ *
+ * 与 ShmMpscQueue 相同的槽位序号算法，元素为任意可移动类型：
+ * - try_push() 多线程并发安全，队列满时立即返回 false（由调用方决定丢弃或重试）
+ * - try_pop() 只允许一个消费线程调用
+ * - 容量向上取整为 2 的幂，槽位在构造时一次性分配
+ *
+ * 用法：
+ *   BoundedMpscQueue<Task> queue(65536);
+ *   if (!queue.try_push(std::move(task))) { 丢弃并计数 }
+ *   Task t;
+ *   while (queue.try_pop(t)) { ... }
+ */
+template <typename T>
+class BoundedMpscQueue {
+public:
+    explicit BoundedMpscQueue(size_t capacity) {
+        size_t cap = 2;
+        while (cap < capacity) cap <<= 1;
+        capacity_ = cap;
+        mask_ = cap - 1;
+        cells_.reset(new Cell[cap]);
+        for (size_t i = 0; i < cap; ++i) {
+            cells_[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    BoundedMpscQueue(const BoundedMpscQueue&) = delete;
+    BoundedMpscQueue& operator=(const BoundedMpscQueue&) = delete;
+
+    /**
+     * @brief 写入一个元素（多写者安全）
+     * @return false 队列已满，value 保持不变
+     */
+    bool try_push(T&& value) {
+        uint64_t pos = tail_.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells_[pos & mask_];
+            uint64_t seq = cell->seq.load(std::memory_order_acquire);
+            int64_t diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;  // 队列已满
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->value = std::move(value);
+        cell->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief 取出一个元素（仅单个消费线程调用）
+     * @return false 队列为空
+     */
+    bool try_pop(T& out) {
+        uint64_t pos = head_.load(std::memory_order_relaxed);
+        Cell* cell = &cells_[pos & mask_];
+        uint64_t seq = cell->seq.load(std::memory_order_acquire);
+        if (static_cast<int64_t>(seq) - static_cast<int64_t>(pos + 1) < 0) {
+            return false;
+        }
+
+        out = std::move(cell->value);
+        cell->value = T();  // 释放元素持有的内存，避免积压在槽位中
+        cell->seq.store(pos + capacity_, std::memory_order_release);
+        head_.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * @brief 近似排队深度（监控用）
+     */
+    size_t size_approx() const {
+        uint64_t tail = tail_.load(std::memory_order_relaxed);
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        return tail > head ? static_cast<size_t>(tail - head) : 0;
+    }
+
+    size_t capacity() const { return capacity_; }
+
+private:
+    struct alignas(64) Cell {
+        std::atomic<uint64_t> seq{0};
+        T value{};
+    };
+
+    std::unique_ptr<Cell[]> cells_;
+    size_t capacity_ = 0;
+    uint64_t mask_ = 0;
+    alignas(64) std::atomic<uint64_t> tail_{0};  // 写者位置
+    alignas(64) std::atomic<uint64_t> head_{0};  // 读者位置
+};
+
+} // namespace trading
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace trading {
+
+/**
+ * @brief 定长内存块池（线程缓存 + 全局仓库）
+ *
+ * 每个线程维护一个空闲块链表，分配/释放都在本线程完成，不加锁、无原子操作；
+ * 线程缓存为空时从全局仓库整批取回 BATCH 个块，超过上限时整批归还，
+ * 因此跨线程释放（行情线程分配、策略线程释放）也只在每 BATCH 次操作时加一次锁。
+ *
+ * 仓库也为空时按 BATCH 个块一次性向系统申请一整片（slab），稳态下不再调用 operator new。
+ * slab 在进程生命周期内不释放（块可能仍缓存在其他线程中）。
+ *
+ * 用法：
+ *   void* p = BlockPool<256>::allocate();
+ *   ... placement new / 析构 ...
+ *   BlockPool<256>::deallocate(p);
+ */
+template <size_t BlockSize>
+class BlockPool {
+public:
+    static constexpr size_t ALIGNMENT = 64;
+    static constexpr size_t BATCH = 64;                  // 线程缓存与仓库之间每次搬运的块数
+    static constexpr size_t CACHE_LIMIT = BATCH * 4;     // 线程缓存上限
+
+    static_assert(BlockSize >= sizeof(void*) && BlockSize % ALIGNMENT == 0,
+                  "BlockSize 必须是 64 的倍数");
+
+    static void* allocate() {
+        if (cache_gone()) {
+            return allocate_from_depot();
+        }
+        ThreadCache& cache = thread_cache();
+        if (!cache.head) {
+            Chain chain = depot().take();
+            if (!chain.head) {
+                chain = carve_slab();
+            }
+            cache.head = chain.head;
+            cache.count = chain.count;
+        }
+        Node* node = cache.head;
+        cache.head = node->next;
+        --cache.count;
+        return node;
+    }
+
+    static void deallocate(void* block) {
+        Node* node = static_cast<Node*>(block);
+        if (cache_gone()) {
+            // 线程退出阶段：线程缓存已析构，直接交给仓库
+            node->next = nullptr;
+            depot().give(Chain{node, 1});
+            return;
+        }
+        ThreadCache& cache = thread_cache();
+        node->next = cache.head;
+        cache.head = node;
+        if (++cache.count > CACHE_LIMIT) {
+            depot().give(cache.split(BATCH));
+        }
+    }
+
+    /**
+     * @brief 已向系统申请的块总数（诊断用，稳态下不再增长）
+     */
+    static size_t capacity() {
+        return depot().capacity.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Node {
+        Node* next;
+    };
+
+    struct Chain {
+        Node* head = nullptr;
+        size_t count = 0;
+    };
+
+    struct ThreadCache {
+        Node* head = nullptr;
+        size_t count = 0;
+
+        // 从链表头部切下 n 个块
+        Chain split(size_t n) {
+            Chain chain{head, 0};
+            Node* tail = nullptr;
+            while (head && chain.count < n) {
+                tail = head;
+                head = head->next;
+                ++chain.count;
+            }
+            if (tail) tail->next = nullptr;
+            count -= chain.count;
+            return chain;
+        }
+
+        ~ThreadCache() {
+            if (head) {
+                depot().give(split(count));
+            }
+            cache_gone() = true;
+        }
+    };
+
+    struct Depot {
+        std::mutex mutex;
+        std::vector<Chain> chains;
+        std::atomic<size_t> capacity{0};
+
+        Chain take() {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (chains.empty()) return Chain{};
+            Chain chain = chains.back();
+            chains.pop_back();
+            return chain;
+        }
+
+        void give(Chain chain) {
+            if (!chain.head) return;
+            std::lock_guard<std::mutex> lock(mutex);
+            chains.push_back(chain);
+        }
+    };
+
+    static ThreadCache& thread_cache() {
+        thread_local ThreadCache cache;
+        return cache;
+    }
+
+    /**
+     * @brief 本线程的 ThreadCache 是否已析构
+     *
+     * 单独的 thread_local bool 没有析构函数，线程退出期间（其他 thread_local 的析构函数里）
+     * 仍可访问；不能用 ThreadCache 的成员记录，析构后再读它是未定义行为
+     */
+    static bool& cache_gone() {
+        thread_local bool gone = false;
+        return gone;
+    }
+
+    // 线程缓存不可用时（线程退出阶段）直接从仓库取一个块，其余归还
+    static void* allocate_from_depot() {
+        Chain chain = depot().take();
+        if (!chain.head) {
+            chain = carve_slab();
+        }
+        Node* node = chain.head;
+        chain.head = node->next;
+        --chain.count;
+        depot().give(chain);
+        return node;
+    }
+
+    static Depot& depot() {
+        static Depot* instance = new Depot();  // 不析构：线程退出时仍可能归还块
+        return *instance;
+    }
+
+    static Chain carve_slab() {
+        char* slab = static_cast<char*>(
+            ::operator new(BlockSize * BATCH, std::align_val_t(ALIGNMENT)));
+        Chain chain;
+        for (size_t i = BATCH; i-- > 0;) {
+            Node* node = reinterpret_cast<Node*>(slab + i * BlockSize);
+            node->next = chain.head;
+            chain.head = node;
+        }
+        chain.count = BATCH;
+        depot().capacity.fetch_add(BATCH, std::memory_order_relaxed);
+        return chain;
+    }
+};
+
+/**
+ * @brief 对象大小 -> 池块大小（按 64 字节向上取整）
+ */
+constexpr size_t pool_block_size(size_t object_size) {
+    return (object_size + 63) / 64 * 64;
+}
+
+// 超过该大小的对象不走池（直接 operator new）
+constexpr size_t MAX_POOLED_OBJECT_SIZE = 4096;
+
+} // namespace trading
@@ -0,0 +1,214 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "idle_strategy.h"
+
+namespace trading {
+
+/**
+ * @brief 单写者顺序锁（seqlock）
+ *
+ * 写者每次修改前后各把序号加一（修改期间为奇数），读者读取前后比较序号，
+ * 不一致或为奇数时重读。读者不写共享内存，多个读者之间、读者与写者之间都不争用缓存行。
+ *
+ * 约束：
+ * - 同一时刻只允许一个写者（调用方保证，通常是行情线程）
+ * - 读者在临界区内读到的可能是写到一半的数据，只能做拷贝，
+ *   不能解引用其中的指针或按其中的长度分配内存（先做边界检查）
+ *
+ * 用法：
+ *   lock.write_begin(); ...修改...; lock.write_end();
+ *   auto value = lock.read([&] { return 拷贝; });
+ */
+class SeqLock {
+public:
+    void write_begin() {
+        seq_.store(seq_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    void write_end() {
+        seq_.store(seq_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    uint64_t read_begin() const {
+        uint64_t seq;
+        while ((seq = seq_.load(std::memory_order_acquire)) & 1) {
+            cpu_relax();
+        }
+        return seq;
+    }
+
+    /**
+     * @return true 读取期间发生了写入，需要重读
+     */
+    bool read_retry(uint64_t seq) const {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return seq_.load(std::memory_order_relaxed) != seq;
+    }
+
+    /**
+     * @brief 重试读取直到拿到一致的结果（fn 返回拷贝出的值）
+     */
+    template <typename Fn>
+    auto read(Fn&& fn) const -> decltype(fn()) {
+        while (true) {
+            uint64_t seq = read_begin();
+            auto result = fn();
+            if (!read_retry(seq)) {
+                return result;
+            }
+        }
+    }
+
+private:
+    std::atomic<uint64_t> seq_{0};
+};
+
+/**
+ * @brief 单写者覆盖式环形缓冲区（读者无锁）
+ *
+ * 元素按写入序号（从 0 递增）编号，序号 i 存放在 slots_[i % capacity]，写满后覆盖最旧的元素。
+ * 写者先发布 reserved_（即将被覆盖的范围），写完再发布 published_；读者拷贝
+ * [from, published) 后重新读取 reserved_，丢弃拷贝期间被覆盖的前缀（不重读、不阻塞写者）。
+ *
+ * 元素必须是平凡可拷贝类型（读者可能拷贝到写到一半的元素，之后会被丢弃）。
+ * 同一时刻只允许一个写者。
+ */
+template <typename T>
+class OverwriteRing {
+public:
+    static_assert(std::is_trivially_copyable<T>::value, "OverwriteRing 元素必须平凡可拷贝");
+
+    explicit OverwriteRing(size_t capacity)
+        : capacity_(std::max<size_t>(capacity, 1))
+        , slots_(capacity_) {}
+
+    OverwriteRing(const OverwriteRing&) = delete;
+    OverwriteRing& operator=(const OverwriteRing&) = delete;
+
+    size_t capacity() const { return capacity_; }
+
+    // ==================== 写者 ====================
+
+    void push(const T& item) {
+        push(&item, 1);
+    }
+
+    /**
+     * @brief 连续写入 count 个元素
+     *
+     * count 超过容量时只写入最后 capacity 个（最新的元素），与逐个 push 的结果一致
+     * @return 写入的第一个元素的序号
+     */
+    uint64_t push(const T* items, size_t count) {
+        if (count > capacity_) {
+            items += count - capacity_;
+            count = capacity_;
+        }
+        uint64_t first = published_.load(std::memory_order_relaxed);
+        reserved_.store(first + count, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < count; ++i) {
+            slots_[(first + i) % capacity_] = items[i];
+        }
+        published_.store(first + count, std::memory_order_release);
+        return first;
+    }
+
+    /**
+     * @brief 逻辑清空（之前写入的元素对读者不可见）
+     */
+    void clear() {
+        cleared_.store(published_.load(std::memory_order_relaxed), std::memory_order_release);
+    }
+
+    // ==================== 读者 ====================
+
+    /**
+     * @brief 已发布的元素总数（下一个元素的序号）
+     */
+    uint64_t published() const {
+        return published_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief 当前仍可读取的最旧序号（published 之前发布的部分）
+     */
+    uint64_t oldest(uint64_t published) const {
+        uint64_t begin = published > capacity_ ? published - capacity_ : 0;
+        return std::max(begin, cleared_.load(std::memory_order_acquire));
+    }
+
+    /**
+     * @brief 拷贝之后调用：序号小于返回值的元素可能已被覆盖
+     */
+    uint64_t valid_from() const {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t reserved = reserved_.load(std::memory_order_relaxed);
+        return reserved > capacity_ ? reserved - capacity_ : 0;
+    }
+
+    /**
+     * @brief 拷贝序号 index 的元素（未校验，需配合 valid_from()）
+     */
+    T at(uint64_t index) const {
+        return slots_[index % capacity_];
+    }
+
+    /**
+     * @brief 拷贝最近 n 个元素（按写入顺序），返回第一个元素的序号
+     */
+    uint64_t copy_recent(size_t n, std::vector<T>& out) const {
+        out.clear();
+        uint64_t end = published();
+        uint64_t begin = oldest(end);
+        if (end - begin > n) {
+            begin = end - n;
+        }
+        out.reserve(end - begin);
+        for (uint64_t i = begin; i < end; ++i) {
+            out.push_back(at(i));
+        }
+        uint64_t valid = valid_from();
+        if (valid > begin) {
+            size_t dropped = static_cast<size_t>(std::min<uint64_t>(valid - begin, out.size()));
+            out.erase(out.begin(), out.begin() + dropped);
+            begin += dropped;
+        }
+        return begin;
+    }
+
+    /**
+     * @brief 拷贝最新的元素
+     * @return false 为空（或唯一的元素在拷贝期间被覆盖）
+     */
+    bool copy_last(T& out) const {
+        while (true) {
+            uint64_t end = published();
+            if (end <= oldest(end)) return false;
+            out = at(end - 1);
+            if (valid_from() < end) return true;
+        }
+    }
+
+    size_t size() const {
+        uint64_t end = published();
+        return static_cast<size_t>(end - oldest(end));
+    }
+
+private:
+    size_t capacity_;
+    std::vector<T> slots_;
+    std::atomic<uint64_t> reserved_{0};   // 写者即将写到的序号（含正在写的元素）
+    std::atomic<uint64_t> published_{0};  // 已写完的元素总数
+    std::atomic<uint64_t> cleared_{0};    // clear() 时的 published_
+};
+
+} // namespace trading
@@ -0,0 +1,459 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "data.h"
+#include "event_engine.h"
+#include "idle_strategy.h"
+#include "latency_histogram.h"
+#include "mpsc_queue.h"
+
+namespace trading {
+
+/**
+ * @brief 队列满时的处理方式
+ */
+enum class BackpressureMode {
+    BLOCK,   // 生产者等待（自旋 + yield），不丢事件
+    DROP     // 立即返回 false 并计数
+};
+
+/**
+ * @brief 分片配置
+ */
+struct ShardedEngineConfig {
+    size_t shard_count = 4;                          // 分片（工作线程）数
+    size_t queue_capacity = 65536;                   // 每个分片的队列容量（向上取整为 2 的幂）
+    size_t max_batch = 256;                          // 工作线程每轮最多处理的事件数
+    IdleMode idle_mode = IdleMode::BACKOFF;          // 工作线程空闲策略（POLL 按 BACKOFF 处理）
+    BackpressureMode backpressure = BackpressureMode::BLOCK;  // 仅作用于外部线程的 put
+    size_t cross_shard_retries = 4096;               // 监听器跨分片投递遇到队列满时的最大重试次数
+    std::vector<int> cpu_affinity;                   // 第 i 个分片绑定的 CPU（为空或 <0 不绑定）
+};
+
+/**
+ * @brief 单个分片的统计快照
+ */
+struct ShardStats {
+    size_t shard = 0;
+    uint64_t enqueued = 0;          // 入队事件数（含监听器内同步派发到本分片的事件）
+    uint64_t processed = 0;         // 已派发事件数
+    uint64_t dropped = 0;           // 队列满被丢弃的事件数
+    uint64_t blocked = 0;           // 生产者因队列满而等待的次数
+    size_t queue_depth = 0;         // 当前排队深度（近似）
+    size_t max_queue_depth = 0;     // 排队深度峰值
+    std::string queue_latency;      // 入队 -> 开始派发（LatencyHistogram::summary）
+    std::string dispatch_latency;   // 单个事件的派发耗时
+};
+
+/**
+ * @brief 分片多线程事件引擎
+ *
+ * 按路由键（品种ID / 账户 / 任意字符串）把事件分发到 N 个分片，每个分片有：
+ * - 一个 BoundedMpscQueue（多生产者无锁入队）
+ * - 一个工作线程
+ * - 一个独立的 EventEngine（沿用原有的监听器顺序、ignore_self、监听器内 put 的语义）
+ *
+ * 顺序保证：
+ * - 相同路由键的事件总是进入同一分片，按入队顺序派发
+ * - 不同路由键之间不保证顺序，不同分片的事件在不同核心上并行处理
+ *
+ * 监听器：
+ * - 必须在 start() 之前注册，注册会复制到每个分片（同一个监听器可能被多个线程同时调用，
+ *   只访问本键状态的监听器无需加锁，跨键共享的状态需要自行同步）
+ * - 监听器内调用 put() 投递到本分片时直接同步派发（与 EventEngine 相同）；
+ *   投递到其他分片时沿用监听器ID作为产生者，ignore_self 跨分片仍然生效
+ *
+ * 背压：
+ * - BackpressureMode 只作用于外部线程（非工作线程）的 put
+ * - 监听器跨分片投递不受 BLOCK 约束：两个分片互相投递时无限等待会死锁，
+ *   因此队列满时最多重试 cross_shard_retries 次（让出 CPU 给目标分片消费），
+ *   仍然满则丢弃并计数，每个分片第一次丢弃时打印日志
+ *
+ * 停止：
+ * - stop() 开始后拒绝外部线程的新投递，工作线程继续处理队列中的事件和监听器的跨分片投递，
+ *   直到所有分片都没有排队或正在派发的事件，才通知工作线程退出（不会有事件入队后无人派发）
+ *
+ * 用法：
+ *   ShardedEventEngine engine(ShardedEngineConfig{8});
+ *   engine.register_listener<TickerData>([](const TickerData& t) { ... });
+ *   engine.start();
+ *   engine.put(make_event<TickerData>("BTC-USDT-SWAP", 97000.0));  // 按品种ID路由
+ *   engine.put(order, account_id);                                  // 按账户路由
+ *   engine.stop();
+ */
+class ShardedEventEngine {
+public:
+    using Listener = Event::ListenerFunc;
+
+    explicit ShardedEventEngine(ShardedEngineConfig config = ShardedEngineConfig())
+        : config_(std::move(config)) {
+        size_t count = std::max<size_t>(config_.shard_count, 1);
+        config_.shard_count = count;
+        config_.max_batch = std::max<size_t>(config_.max_batch, 1);
+        shards_.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            shards_.push_back(std::make_unique<Shard>(i, config_.queue_capacity));
+        }
+    }
+
+    ~ShardedEventEngine() {
+        stop();
+    }
+
+    ShardedEventEngine(const ShardedEventEngine&) = delete;
+    ShardedEventEngine& operator=(const ShardedEventEngine&) = delete;
+
+    // ==================== 注册（start 之前） ====================
+
+    void register_listener(const std::type_index& event_type, Listener listener, bool ignore_self = true) {
+        check_not_running();
+        for (auto& shard : shards_) {
+            shard->engine.register_listener(event_type, listener, ignore_self);
+        }
+    }
+
+    template <typename T, typename Fn>
+    void register_listener(const Fn& fn, bool ignore_self = true) {
+        check_not_running();
+        for (auto& shard : shards_) {
+            shard->engine.template register_listener<T>(fn, ignore_self);
+        }
+    }
+
+    void register_global_listener(Listener listener, bool ignore_self = false, bool is_senior = false) {
+        check_not_running();
+        for (auto& shard : shards_) {
+            shard->engine.register_global_listener(listener, ignore_self, is_senior);
+        }
+    }
+
+    // ==================== 生命周期 ====================
+
+    void start() {
+        if (running_.exchange(true)) return;
+        for (auto& shard : shards_) {
+            shard->stopping.store(false, std::memory_order_relaxed);
+            Shard* s = shard.get();
+            shard->worker = std::thread([this, s] { run_shard(*s); });
+        }
+    }
+
+    /**
+     * @brief 停止工作线程（先处理完已入队的事件，包括处理过程中产生的跨分片事件）
+     *
+     * 不能在监听器内调用
+     */
+    void stop() {
+        if (!running() || stopping_.exchange(true)) return;
+        wait_quiescent();
+        running_.store(false, std::memory_order_release);
+        for (auto& shard : shards_) {
+            shard->stopping.store(true, std::memory_order_release);
+        }
+        for (auto& shard : shards_) {
+            if (shard->worker.joinable()) {
+                shard->worker.join();
+            }
+        }
+        stopping_.store(false, std::memory_order_release);
+    }
+
+    bool running() const { return running_.load(std::memory_order_acquire); }
+
+    // ==================== 投递 ====================
+
+    /**
+     * @brief 按整数键投递（品种ID、账户ID 等）
+     * @return false 队列满被丢弃（DROP 模式，或监听器跨分片投递重试后仍满）
+     */
+    bool put(Event::Ptr event, uint64_t key) {
+        if (!event) {
+            throw std::invalid_argument("Event cannot be null");
+        }
+        return enqueue(*shards_[shard_of(key)], std::move(event));
+    }
+
+    /**
+     * @brief 按字符串键投递（账户名、策略ID 等）
+     */
+    bool put(Event::Ptr event, std::string_view key) {
+        return put(std::move(event), hash_key(key));
+    }
+
+    /**
+     * @brief 行情数据按品种路由（品种ID，未登记时按 exchange + symbol 哈希）
+     */
+    bool put(const Data::Ptr& data) {
+        if (!data) {
+            throw std::invalid_argument("Event cannot be null");
+        }
+        return put(data, route_key(*data));
+    }
+
+    static uint64_t route_key(const Data& data) {
+        InstrumentId id = data.instrument_id();
+        if (id != INVALID_INSTRUMENT) {
+            return static_cast<uint64_t>(id);
+        }
+        return hash_key(data.exchange()) ^ (hash_key(data.symbol()) * 31);
+    }
+
+    size_t shard_of(uint64_t key) const {
+        // 混合高位，避免连续的品种ID落在同一组分片
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdULL;
+        key ^= key >> 33;
+        return static_cast<size_t>(key % shards_.size());
+    }
+
+    static uint64_t hash_key(std::string_view key) {
+        uint64_t h = 1469598103934665603ULL;  // FNV-1a
+        for (char c : key) {
+            h ^= static_cast<unsigned char>(c);
+            h *= 1099511628211ULL;
+        }
+        return h;
+    }
+
+    // ==================== 统计 ====================
+
+    size_t shard_count() const { return shards_.size(); }
+
+    /**
+     * @brief 分片内的 EventEngine（start 之前用于 inject 等配置）
+     */
+    EventEngine& shard_engine(size_t index) { return shards_.at(index)->engine; }
+
+    ShardStats shard_stats(size_t index) const {
+        const Shard& shard = *shards_.at(index);
+        ShardStats stats;
+        stats.shard = index;
+        stats.dropped = shard.dropped.load(std::memory_order_relaxed);
+        stats.enqueued = shard.pushed.load(std::memory_order_relaxed) - stats.dropped;
+        stats.processed = shard.processed.load(std::memory_order_relaxed);
+        stats.blocked = shard.blocked.load(std::memory_order_relaxed);
+        stats.queue_depth = shard.queue.size_approx();
+        stats.max_queue_depth = shard.max_queue_depth.load(std::memory_order_relaxed);
+        stats.queue_latency = shard.queue_latency.summary();
+        stats.dispatch_latency = shard.dispatch_latency.summary();
+        return stats;
+    }
+
+    std::vector<ShardStats> stats() const {
+        std::vector<ShardStats> result;
+        result.reserve(shards_.size());
+        for (size_t i = 0; i < shards_.size(); ++i) {
+            result.push_back(shard_stats(i));
+        }
+        return result;
+    }
+
+    void print_stats() const {
+        for (const auto& s : stats()) {
+            fprintf(stderr,
+                    "[EventEngine] shard %zu: enqueued=%llu processed=%llu dropped=%llu blocked=%llu "
+                    "depth=%zu max_depth=%zu queue{%s} dispatch{%s}\n",
+                    s.shard,
+                    static_cast<unsigned long long>(s.enqueued),
+                    static_cast<unsigned long long>(s.processed),
+                    static_cast<unsigned long long>(s.dropped),
+                    static_cast<unsigned long long>(s.blocked),
+                    s.queue_depth, s.max_queue_depth,
+                    s.queue_latency.c_str(), s.dispatch_latency.c_str());
+        }
+    }
+
+private:
+    struct QueuedEvent {
+        Event::Ptr event;
+        int64_t enqueue_ns = 0;
+        size_t producer_id = 0;      // 来源分片中正在执行的监听器ID（外部线程为 0）
+    };
+
+    struct Shard {
+        Shard(size_t index_, size_t capacity)
+            : index(index_)
+            , queue(capacity) {}
+
+        size_t index;
+        BoundedMpscQueue<QueuedEvent> queue;
+        EventEngine engine;          // 仅工作线程访问（start 之后）
+        std::thread worker;
+        std::atomic<bool> stopping{false};
+
+        // pushed 在入队之前计数，processed 在派发完成之后计数：
+        // pushed == processed + dropped 表示本分片没有排队或正在派发的事件
+        alignas(64) std::atomic<uint64_t> pushed{0};
+        std::atomic<uint64_t> dropped{0};
+        std::atomic<uint64_t> blocked{0};
+        std::atomic<size_t> max_queue_depth{0};
+        std::atomic<bool> drop_logged{false};
+        alignas(64) std::atomic<uint64_t> processed{0};
+        LatencyHistogram queue_latency;
+        LatencyHistogram dispatch_latency;
+    };
+
+    static int64_t now_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // 当前线程所属的分片（非工作线程为 nullptr）
+    static const Shard*& current_shard() {
+        thread_local const Shard* shard = nullptr;
+        return shard;
+    }
+
+    void check_not_running() const {
+        if (running()) {
+            throw std::runtime_error("Cannot register while sharded engine is running");
+        }
+    }
+
+    bool enqueue(Shard& shard, Event::Ptr event) {
+        const Shard* self = current_shard();
+        shard.pushed.fetch_add(1);
+        if (self == &shard) {
+            // 监听器内投递到本分片：与 EventEngine 相同，同步派发
+            shard.engine.put(std::move(event));
+            shard.processed.fetch_add(1);
+            return true;
+        }
+        if (!self && stopping_.load()) {
+            // 正在停止：拒绝外部线程的新投递（监听器的跨分片投递仍然接收，由 stop() 等待处理完）
+            shard.dropped.fetch_add(1);
+            return false;
+        }
+
+        // 工作线程内投递：记录来源监听器，目标分片据此处理 ignore_self
+        size_t producer = self ? self->engine.current_listener_id() : 0;
+        QueuedEvent item{std::move(event), now_ns(), producer};
+        if (!shard.queue.try_push(std::move(item))) {
+            bool may_block = config_.backpressure == BackpressureMode::BLOCK || self != nullptr;
+            if (!may_block || !running()) {
+                record_drop(shard, self != nullptr);
+                return false;
+            }
+            // 外部线程无限等待；监听器跨分片投递只做有限次重试，避免分片间死锁
+            size_t limit = self ? config_.cross_shard_retries : SIZE_MAX;
+            shard.blocked.fetch_add(1, std::memory_order_relaxed);
+            size_t spins = 0;
+            while (!shard.queue.try_push(std::move(item))) {
+                if (!running() || spins >= limit) {
+                    record_drop(shard, self != nullptr);
+                    return false;
+                }
+                if (++spins < 64) {
+                    cpu_relax();
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        }
+        size_t depth = shard.queue.size_approx();
+        size_t peak = shard.max_queue_depth.load(std::memory_order_relaxed);
+        while (depth > peak &&
+               !shard.max_queue_depth.compare_exchange_weak(peak, depth, std::memory_order_relaxed)) {
+        }
+        return true;
+    }
+
+    void record_drop(Shard& shard, bool from_listener) {
+        shard.dropped.fetch_add(1);
+        if (!shard.drop_logged.exchange(true, std::memory_order_relaxed)) {
+            fprintf(stderr, "[EventEngine] shard %zu 队列已满，开始丢弃事件（%s，容量 %zu）\n",
+                    shard.index, from_listener ? "监听器跨分片投递" : "DROP 模式",
+                    shard.queue.capacity());
+        }
+    }
+
+    void run_shard(Shard& shard) {
+        current_shard() = &shard;
+        pin_current_thread(shard.index);
+
+        IdleStrategy idle(config_.idle_mode == IdleMode::SPIN ? IdleMode::SPIN : IdleMode::BACKOFF);
+        QueuedEvent item;
+        while (true) {
+            int work = 0;
+            while (static_cast<size_t>(work) < config_.max_batch && shard.queue.try_pop(item)) {
+                int64_t start = now_ns();
+                shard.queue_latency.record(start - item.enqueue_ns);
+                shard.engine.put_with_producer(std::move(item.event), item.producer_id);
+                shard.dispatch_latency.record(now_ns() - start);
+                shard.processed.fetch_add(1);
+                ++work;
+            }
+            if (work == 0 && shard.stopping.load(std::memory_order_acquire)) {
+                break;  // 已入队的事件全部处理完
+            }
+            idle.idle(work, [](int) {});
+        }
+
+        current_shard() = nullptr;
+    }
+
+    /**
+     * @brief 等待所有分片静止（没有排队或正在派发的事件）
+     *
+     * 跨分片事件只能由正在派发的事件产生，因此所有分片同时静止后不会再有新事件。
+     * 逐个检查分片不是原子的：检查期间若有新投递，pushed 总数会变化，需要重新检查
+     */
+    void wait_quiescent() const {
+        auto total_pushed = [this] {
+            uint64_t total = 0;
+            for (const auto& shard : shards_) total += shard->pushed.load();
+            return total;
+        };
+        while (true) {
+            const uint64_t before = total_pushed();
+            bool idle = true;
+            for (const auto& shard : shards_) {
+                const uint64_t settled = shard->processed.load() + shard->dropped.load();
+                if (settled != shard->pushed.load()) {
+                    idle = false;
+                    break;
+                }
+            }
+            if (idle && total_pushed() == before) return;
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+
+    void pin_current_thread(size_t index) {
+#ifdef __linux__
+        if (index >= config_.cpu_affinity.size() || config_.cpu_affinity[index] < 0) return;
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        CPU_SET(config_.cpu_affinity[index], &cpuset);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset) != 0) {
+            fprintf(stderr, "[EventEngine] shard %zu 绑定 CPU %d 失败\n",
+                    index, config_.cpu_affinity[index]);
+        }
+#else
+        (void)index;
+#endif
+    }
+
+    ShardedEngineConfig config_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> stopping_{false};   // stop() 进行中（拒绝外部线程投递）
+};
+
+} // namespace trading
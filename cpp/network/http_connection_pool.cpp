@@ -0,0 +1,268 @@
+/**
+ * @file http_connection_pool.cpp
+ * @brief CURL 连接池实现
+ *
+ * @author Sequence Team
+ * @date 2025-12
+ */
+
+#include "http_connection_pool.h"
+#include <iostream>
+#include <thread>
+
+namespace trading {
+namespace core {
+
+// ==================== 全局统计 ====================
+
+namespace {
+
+std::atomic<uint64_t> g_requests{0};
+std::atomic<uint64_t> g_handle_hits{0};
+std::atomic<uint64_t> g_handle_misses{0};
+std::atomic<uint64_t> g_conn_reused{0};
+std::atomic<uint64_t> g_conn_new{0};
+std::atomic<uint64_t> g_errors{0};
+std::atomic<uint64_t> g_total_time_us{0};
+
+// 预热请求丢弃响应体
+size_t discard_callback(void* contents, size_t size, size_t nmemb, void* userp) {
+    (void)contents; (void)userp;
+    return size * nmemb;
+}
+
+// 保证 curl_global_init 在创建任何 handle 之前调用（线程安全的静态初始化）
+void ensure_curl_global_init() {
+    static const bool initialized = []() {
+        curl_global_init(CURL_GLOBAL_DEFAULT);
+        return true;
+    }();
+    (void)initialized;
+}
+
+} // namespace
+
+// ==================== 构造 / 析构 ====================
+
+HttpConnectionPool::HttpConnectionPool(const std::string& name, HttpPoolOptions options)
+    : name_(name)
+    , options_(options) {
+    ensure_curl_global_init();
+
+    share_ = curl_share_init();
+    if (share_) {
+        curl_share_setopt(share_, CURLSHOPT_LOCKFUNC, &HttpConnectionPool::share_lock);
+        curl_share_setopt(share_, CURLSHOPT_UNLOCKFUNC, &HttpConnectionPool::share_unlock);
+        curl_share_setopt(share_, CURLSHOPT_USERDATA, this);
+        curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+        curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+        // 不共享连接缓存（CURL_LOCK_DATA_CONNECT）：libcurl 文档说明多个线程同时使用的
+        // easy handle 共享连接缓存并不安全。连接保存在各 handle 自己的缓存里，
+        // handle 归还池中后随 handle 一起复用；新连接仍可复用共享的 DNS 与 TLS 会话
+    } else {
+        std::cerr << "[HttpPool:" << name_ << "] curl_share_init 失败，仅复用 handle\n";
+    }
+}
+
+HttpConnectionPool::~HttpConnectionPool() {
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+        for (CURL* curl : idle_) {
+            curl_easy_cleanup(curl);
+        }
+        idle_.clear();
+    }
+    // 所有使用 share 的 handle 清理后才能释放 share
+    if (share_) {
+        curl_share_cleanup(share_);
+        share_ = nullptr;
+    }
+}
+
+// ==================== handle 管理 ====================
+
+HttpConnectionPool::Handle HttpConnectionPool::acquire() {
+    CURL* curl = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+        if (!idle_.empty()) {
+            curl = idle_.back();
+            idle_.pop_back();
+        }
+    }
+
+    if (curl) {
+        handle_hits_++;
+        g_handle_hits++;
+        // reset 清除请求选项，但保留连接缓存、DNS 缓存和 TLS 会话
+        curl_easy_reset(curl);
+    } else {
+        handle_misses_++;
+        g_handle_misses++;
+        curl = curl_easy_init();
+    }
+
+    if (curl && share_) {
+        curl_easy_setopt(curl, CURLOPT_SHARE, share_);
+    }
+    return Handle(this, curl);
+}
+
+void HttpConnectionPool::release(CURL* curl) {
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+        if (idle_.size() < options_.max_idle_handles) {
+            idle_.push_back(curl);
+            return;
+        }
+    }
+    curl_easy_cleanup(curl);
+}
+
+void HttpConnectionPool::apply_defaults(CURL* curl, bool force_http1) const {
+    // TCP keepalive：保持空闲连接存活，避免被中间设备回收
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPIDLE, options_.keepalive_idle_sec);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPINTVL, options_.keepalive_idle_sec / 2 > 0 ? options_.keepalive_idle_sec / 2 : 1L);
+    curl_easy_setopt(curl, CURLOPT_TCP_NODELAY, 1L);
+
+    // 池内 handle 会在多个线程上使用，禁用基于信号的超时
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+
+    // DNS 缓存
+    curl_easy_setopt(curl, CURLOPT_DNS_CACHE_TIMEOUT, options_.dns_cache_timeout_sec);
+
+#if LIBCURL_VERSION_NUM >= 0x074100  // 7.65.0
+    // 超过该时间的空闲连接不再复用（服务端可能已关闭）
+    curl_easy_setopt(curl, CURLOPT_MAXAGE_CONN, options_.max_conn_age_sec);
+#endif
+
+    // HTTP 版本：HTTP/2 通过 ALPN 协商，服务端不支持时回退 HTTP/1.1
+    if (options_.http2 && !force_http1) {
+        curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+        curl_easy_setopt(curl, CURLOPT_PIPEWAIT, 1L);  // 优先等待复用已有 HTTP/2 连接
+    } else {
+        curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_1_1);
+    }
+}
+
+void HttpConnectionPool::record_result(CURL* curl, CURLcode res) {
+    requests_++;
+    g_requests++;
+
+    if (res != CURLE_OK) {
+        errors_++;
+        g_errors++;
+        return;
+    }
+
+    // NUM_CONNECTS: 本次请求新建的连接数，0 表示复用了已有连接
+    long num_connects = 0;
+    curl_easy_getinfo(curl, CURLINFO_NUM_CONNECTS, &num_connects);
+    if (num_connects == 0) {
+        conn_reused_++;
+        g_conn_reused++;
+    } else {
+        conn_new_++;
+        g_conn_new++;
+    }
+
+    curl_off_t total_us = 0;
+    if (curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME_T, &total_us) == CURLE_OK && total_us > 0) {
+        total_time_us_ += static_cast<uint64_t>(total_us);
+        g_total_time_us += static_cast<uint64_t>(total_us);
+    }
+}
+
+// ==================== 预热 ====================
+
+int HttpConnectionPool::warm_up(const std::string& url, int count, const std::string& proxy_url,
+                                bool force_http1) {
+    if (count <= 0) return 0;
+
+    // 每个 handle 在各自的线程里 curl_easy_perform：连接进入该 handle 自己的连接缓存，
+    // 归还池后随 handle 复用（multi 接口建立的连接属于 multi 句柄，cleanup 时会被关闭）
+    std::vector<Handle> handles;
+    handles.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        Handle handle = acquire();
+        if (!handle) break;
+
+        CURL* curl = handle.get();
+        apply_defaults(curl, force_http1);
+        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, discard_callback);
+        curl_easy_setopt(curl, CURLOPT_TIMEOUT, 10L);
+        curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 5L);
+        curl_easy_setopt(curl, CURLOPT_IPRESOLVE, CURL_IPRESOLVE_V4);
+        if (!proxy_url.empty()) {
+            curl_easy_setopt(curl, CURLOPT_PROXY, proxy_url.c_str());
+            curl_easy_setopt(curl, CURLOPT_PROXYTYPE, CURLPROXY_HTTP);
+            curl_easy_setopt(curl, CURLOPT_HTTPPROXYTUNNEL, 1L);
+        }
+        handles.push_back(std::move(handle));
+    }
+
+    std::atomic<int> established{0};
+    std::vector<std::thread> workers;
+    workers.reserve(handles.size());
+    for (auto& handle : handles) {
+        CURL* curl = handle.get();
+        workers.emplace_back([curl, &established]() {
+            if (curl_easy_perform(curl) == CURLE_OK) {
+                established++;
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    handles.clear();  // 归还连接池，连接留在各 handle 的连接缓存中
+
+    std::cout << "[HttpPool:" << name_ << "] 预热连接 " << established.load() << "/" << count << "\n";
+    return established.load();
+}
+
+// ==================== 统计 ====================
+
+HttpPoolStats HttpConnectionPool::get_stats() const {
+    HttpPoolStats stats;
+    stats.requests = requests_.load();
+    stats.handle_hits = handle_hits_.load();
+    stats.handle_misses = handle_misses_.load();
+    stats.conn_reused = conn_reused_.load();
+    stats.conn_new = conn_new_.load();
+    stats.errors = errors_.load();
+    stats.total_time_us = total_time_us_.load();
+    return stats;
+}
+
+HttpPoolStats HttpConnectionPool::global_stats() {
+    HttpPoolStats stats;
+    stats.requests = g_requests.load();
+    stats.handle_hits = g_handle_hits.load();
+    stats.handle_misses = g_handle_misses.load();
+    stats.conn_reused = g_conn_reused.load();
+    stats.conn_new = g_conn_new.load();
+    stats.errors = g_errors.load();
+    stats.total_time_us = g_total_time_us.load();
+    return stats;
+}
+
+// ==================== 共享缓存锁 ====================
+
+void HttpConnectionPool::share_lock(CURL* handle, curl_lock_data data, curl_lock_access access,
+                                    void* userptr) {
+    (void)handle; (void)access;
+    auto* pool = static_cast<HttpConnectionPool*>(userptr);
+    pool->share_mutexes_[data].lock();
+}
+
+void HttpConnectionPool::share_unlock(CURL* handle, curl_lock_data data, void* userptr) {
+    (void)handle;
+    auto* pool = static_cast<HttpConnectionPool*>(userptr);
+    pool->share_mutexes_[data].unlock();
+}
+
+} // namespace core
+} // namespace trading
@@ -0,0 +1,190 @@
+#pragma once
+
+/**
+ * @file http_connection_pool.h
+ * @brief CURL 连接池（REST API 长连接复用）
+ *
+ * 功能：
+ * 1. 复用 CURL easy handle（curl_easy_reset 保留连接缓存、TLS 会话）
+ * 2. 池内 handle 通过 CURLSH 共享 DNS 缓存、TLS 会话
+ *    - 连接缓存不跨 handle 共享（并发使用时不安全），连接随 handle 一起复用
+ *    - 新连接可恢复 TLS 会话，避免完整握手（经代理时尤其明显）
+ * 3. 可选 HTTP/2（ALPN 协商，服务端不支持时自动回退 HTTP/1.1）
+ * 4. 预热：启动时提前建立连接，首单不付握手成本
+ * 5. 统计：handle 命中率、连接复用率，便于观察效果
+ *
+ * 使用方式：
+ *   HttpConnectionPool pool("okx");
+ *   {
+ *       auto handle = pool.acquire();     // RAII，析构时归还
+ *       pool.apply_defaults(handle.get());
+ *       curl_easy_setopt(handle.get(), CURLOPT_URL, url.c_str());
+ *       ...
+ *       CURLcode res = curl_easy_perform(handle.get());
+ *       pool.record_result(handle.get(), res);
+ *   }
+ *
+ * 线程安全：acquire/release 和共享缓存都有锁保护；
+ * 同一个 handle 同一时间只被一个线程使用
+ *
+ * @author Sequence Team
+ * @date 2025-12
+ */
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <curl/curl.h>
+
+namespace trading {
+namespace core {
+
+/**
+ * @brief 连接池配置
+ */
+struct HttpPoolOptions {
+    size_t max_idle_handles = 8;         // 最多缓存的空闲 handle 数
+    bool http2 = true;                   // 启用 HTTP/2（ALPN 协商）
+    long dns_cache_timeout_sec = 300;    // DNS 缓存时间
+    long keepalive_idle_sec = 30;        // TCP keepalive 空闲探测间隔
+    long max_conn_age_sec = 110;         // 空闲连接最长复用时间（交易所通常 2 分钟断开空闲连接）
+};
+
+/**
+ * @brief 连接池统计
+ */
+struct HttpPoolStats {
+    uint64_t requests = 0;           // 请求总数
+    uint64_t handle_hits = 0;        // 复用空闲 handle 次数
+    uint64_t handle_misses = 0;      // 新建 handle 次数
+    uint64_t conn_reused = 0;        // 复用已有连接的请求数（无新握手）
+    uint64_t conn_new = 0;           // 新建连接的请求数
+    uint64_t errors = 0;             // CURL 失败次数
+    uint64_t total_time_us = 0;      // 请求总耗时
+
+    double conn_reuse_rate() const {
+        uint64_t n = conn_reused + conn_new;
+        return n ? static_cast<double>(conn_reused) / n : 0.0;
+    }
+
+    double avg_time_us() const {
+        return requests ? static_cast<double>(total_time_us) / requests : 0.0;
+    }
+};
+
+class HttpConnectionPool {
+public:
+    /**
+     * @brief RAII handle，析构时归还连接池
+     */
+    class Handle {
+    public:
+        Handle(HttpConnectionPool* pool, CURL* curl) : pool_(pool), curl_(curl) {}
+        ~Handle() { reset(); }
+
+        Handle(Handle&& other) noexcept : pool_(other.pool_), curl_(other.curl_) {
+            other.curl_ = nullptr;
+        }
+        Handle& operator=(Handle&& other) noexcept {
+            if (this != &other) {
+                reset();
+                pool_ = other.pool_;
+                curl_ = other.curl_;
+                other.curl_ = nullptr;
+            }
+            return *this;
+        }
+        Handle(const Handle&) = delete;
+        Handle& operator=(const Handle&) = delete;
+
+        CURL* get() const { return curl_; }
+        explicit operator bool() const { return curl_ != nullptr; }
+
+    private:
+        void reset() {
+            if (curl_) {
+                pool_->release(curl_);
+                curl_ = nullptr;
+            }
+        }
+
+        HttpConnectionPool* pool_;
+        CURL* curl_;
+    };
+
+    explicit HttpConnectionPool(const std::string& name, HttpPoolOptions options = HttpPoolOptions());
+    ~HttpConnectionPool();
+
+    HttpConnectionPool(const HttpConnectionPool&) = delete;
+    HttpConnectionPool& operator=(const HttpConnectionPool&) = delete;
+
+    /**
+     * @brief 取一个 handle（优先复用空闲 handle）
+     *
+     * 返回的 handle 已 reset 并挂上共享缓存，失败时 get() == nullptr
+     */
+    Handle acquire();
+
+    /**
+     * @brief 设置连接复用相关选项（keepalive、HTTP 版本、DNS 缓存）
+     *
+     * 在 acquire() 之后、设置请求选项之前调用
+     *
+     * @param force_http1 强制 HTTP/1.1（某些代理不支持 HTTP/2）
+     */
+    void apply_defaults(CURL* curl, bool force_http1 = false) const;
+
+    /**
+     * @brief 记录请求结果（连接是否复用、耗时）
+     */
+    void record_result(CURL* curl, CURLcode res);
+
+    /**
+     * @brief 预热连接：并发发起 count 个 GET 请求，建立的连接随 handle 留在池中
+     *
+     * @param url 轻量公共接口（如服务器时间）
+     * @param count 预热连接数
+     * @param proxy_url 代理（空表示直连）
+     * @param force_http1 强制 HTTP/1.1
+     * @return 成功建立的连接数
+     */
+    int warm_up(const std::string& url, int count, const std::string& proxy_url = "",
+                bool force_http1 = false);
+
+    HttpPoolStats get_stats() const;
+
+    /**
+     * @brief 所有连接池的汇总统计
+     */
+    static HttpPoolStats global_stats();
+
+    const std::string& name() const { return name_; }
+
+private:
+    void release(CURL* curl);
+
+    static void share_lock(CURL* handle, curl_lock_data data, curl_lock_access access, void* userptr);
+    static void share_unlock(CURL* handle, curl_lock_data data, void* userptr);
+
+    std::string name_;
+    HttpPoolOptions options_;
+
+    CURLSH* share_ = nullptr;
+    std::mutex share_mutexes_[CURL_LOCK_DATA_LAST];
+
+    std::mutex idle_mutex_;
+    std::vector<CURL*> idle_;
+
+    std::atomic<uint64_t> requests_{0};
+    std::atomic<uint64_t> handle_hits_{0};
+    std::atomic<uint64_t> handle_misses_{0};
+    std::atomic<uint64_t> conn_reused_{0};
+    std::atomic<uint64_t> conn_new_{0};
+    std::atomic<uint64_t> errors_{0};
+    std::atomic<uint64_t> total_time_us_{0};
+};
+
+} // namespace core
+} // namespace trading
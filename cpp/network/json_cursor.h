@@ -0,0 +1,292 @@
+#pragma once
+
+/**
+ * @file json_cursor.h
+ * @brief 按需 JSON 扫描器 - 在原始报文上逐字段读取，不构建 DOM
+ *
+ * 用于已知结构的高频推送（行情等）：调用方按 schema 逐个读取 key，
+ * 需要的值以 string_view 形式返回（指向原始报文，不拷贝），其余值直接跳过。
+ *
+ * 约定：
+ * - 任何不符合预期的输入都使 ok() 变为 false，调用方应回退到 nlohmann::json
+ * - read_string() 不处理转义：字符串含反斜杠时视为失败（行情字段不会出现转义）
+ * - skip_value() 能正确跳过含转义的字符串和任意嵌套的对象/数组
+ *
+ * 用法：
+ *   JsonCursor cur(message);
+ *   std::string_view key;
+ *   if (cur.begin_object()) {
+ *       while (cur.next_key(key)) {
+ *           if (key == "px") cur.read_scalar(px);
+ *           else cur.skip_value();
+ *       }
+ *   }
+ *   if (!cur.ok()) { 回退 DOM 解析 }
+ */
+
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+
+namespace trading {
+namespace core {
+
+class JsonCursor {
+public:
+    explicit JsonCursor(std::string_view text)
+        : p_(text.data()), end_(text.data() + text.size()) {}
+
+    bool ok() const { return ok_; }
+
+    /**
+     * @brief 剩余内容是否只有空白
+     */
+    bool at_end() {
+        skip_ws();
+        return p_ == end_;
+    }
+
+    /**
+     * @brief 下一个值的首字符（跳过空白），已到末尾返回 0
+     */
+    char peek() {
+        skip_ws();
+        return p_ < end_ ? *p_ : '\0';
+    }
+
+    const char* position() const { return p_; }
+
+    // ==================== 对象 / 数组 ====================
+
+    bool begin_object() { return expect('{'); }
+    bool begin_array() { return expect('['); }
+
+    /**
+     * @brief 读取对象的下一个 key（并消费其后的 ':'）
+     * @return false 表示对象结束（已消费 '}'）或出错
+     */
+    bool next_key(std::string_view& key) {
+        skip_ws();
+        if (p_ < end_ && *p_ == '}') {
+            ++p_;
+            return false;
+        }
+        if (p_ < end_ && *p_ == ',') {
+            ++p_;
+        }
+        if (!read_string(key) || !expect(':')) {
+            return fail();
+        }
+        return true;
+    }
+
+    /**
+     * @brief 数组是否还有下一个元素（消费元素间的 ','）
+     * @return false 表示数组结束（已消费 ']'）或出错
+     */
+    bool next_element() {
+        skip_ws();
+        if (p_ >= end_) {
+            return fail();
+        }
+        if (*p_ == ']') {
+            ++p_;
+            return false;
+        }
+        if (*p_ == ',') {
+            ++p_;
+            skip_ws();
+        }
+        return p_ < end_ || fail();
+    }
+
+    // ==================== 标量 ====================
+
+    /**
+     * @brief 读取字符串内容（不含引号、不处理转义）
+     */
+    bool read_string(std::string_view& out) {
+        skip_ws();
+        if (p_ >= end_ || *p_ != '"') {
+            return fail();
+        }
+        const char* start = ++p_;
+        const void* quote = std::memchr(p_, '"', static_cast<size_t>(end_ - p_));
+        if (!quote) {
+            return fail();
+        }
+        const char* stop = static_cast<const char*>(quote);
+        if (std::memchr(start, '\\', static_cast<size_t>(stop - start))) {
+            return fail();  // 含转义：交给 DOM 解析
+        }
+        out = std::string_view(start, static_cast<size_t>(stop - start));
+        p_ = stop + 1;
+        return true;
+    }
+
+    /**
+     * @brief 读取标量：字符串返回其内容，数字/true/false/null 返回原始文本
+     *
+     * 交易所常把数字编码为字符串（"px":"42000.1"），两种形式统一按文本返回，
+     * 再用 to_double()/to_int64() 转换
+     */
+    bool read_scalar(std::string_view& out) {
+        skip_ws();
+        if (p_ >= end_) {
+            return fail();
+        }
+        if (*p_ == '"') {
+            return read_string(out);
+        }
+        if (*p_ == '{' || *p_ == '[') {
+            return fail();
+        }
+        const char* start = p_;
+        while (p_ < end_ && *p_ != ',' && *p_ != '}' && *p_ != ']' &&
+               *p_ != ' ' && *p_ != '\n' && *p_ != '\r' && *p_ != '\t') {
+            ++p_;
+        }
+        if (p_ == start) {
+            return fail();
+        }
+        out = std::string_view(start, static_cast<size_t>(p_ - start));
+        return true;
+    }
+
+    /**
+     * @brief 跳过任意一个值（对象/数组整体跳过）
+     */
+    bool skip_value() {
+        skip_ws();
+        if (p_ >= end_) {
+            return fail();
+        }
+        if (*p_ == '"') {
+            return skip_string();
+        }
+        if (*p_ != '{' && *p_ != '[') {
+            std::string_view ignored;
+            return read_scalar(ignored);
+        }
+
+        int depth = 0;
+        while (p_ < end_) {
+            char c = *p_;
+            if (c == '"') {
+                if (!skip_string()) {
+                    return false;
+                }
+                continue;
+            }
+            ++p_;
+            if (c == '{' || c == '[') {
+                ++depth;
+            } else if (c == '}' || c == ']') {
+                if (--depth == 0) {
+                    return true;
+                }
+            }
+        }
+        return fail();
+    }
+
+    /**
+     * @brief 跳过一个值并返回其原始文本（用于延后解析）
+     */
+    bool capture_value(std::string_view& out) {
+        skip_ws();
+        const char* start = p_;
+        if (!skip_value()) {
+            return false;
+        }
+        out = std::string_view(start, static_cast<size_t>(p_ - start));
+        return true;
+    }
+
+    // ==================== 数值转换 ====================
+
+    /**
+     * @brief 文本转 double（空串返回 false，与 json_to_double 的默认值语义一致）
+     */
+    static bool to_double(std::string_view text, double& out) {
+        if (text.empty()) {
+            return false;
+        }
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+        auto res = std::from_chars(text.data(), text.data() + text.size(), out);
+        return res.ec == std::errc();
+#else
+        char buf[64];
+        if (text.size() >= sizeof(buf)) {
+            return false;
+        }
+        std::memcpy(buf, text.data(), text.size());
+        buf[text.size()] = '\0';
+        char* parsed_end = nullptr;
+        out = std::strtod(buf, &parsed_end);
+        return parsed_end != buf;
+#endif
+    }
+
+    static bool to_int64(std::string_view text, int64_t& out) {
+        if (text.empty()) {
+            return false;
+        }
+        auto res = std::from_chars(text.data(), text.data() + text.size(), out);
+        return res.ec == std::errc();
+    }
+
+    static double to_double_or(std::string_view text, double default_val = 0.0) {
+        double v;
+        return to_double(text, v) ? v : default_val;
+    }
+
+    static int64_t to_int64_or(std::string_view text, int64_t default_val = 0) {
+        int64_t v;
+        return to_int64(text, v) ? v : default_val;
+    }
+
+private:
+    void skip_ws() {
+        while (p_ < end_ && (*p_ == ' ' || *p_ == '\n' || *p_ == '\r' || *p_ == '\t')) {
+            ++p_;
+        }
+    }
+
+    bool expect(char c) {
+        skip_ws();
+        if (p_ < end_ && *p_ == c) {
+            ++p_;
+            return true;
+        }
+        return fail();
+    }
+
+    bool skip_string() {
+        ++p_;  // 起始引号
+        while (p_ < end_) {
+            char c = *p_++;
+            if (c == '\\') {
+                ++p_;  // 跳过被转义的字符
+            } else if (c == '"') {
+                return true;
+            }
+        }
+        return fail();
+    }
+
+    bool fail() {
+        ok_ = false;
+        p_ = end_;
+        return false;
+    }
+
+    const char* p_;
+    const char* end_;
+    bool ok_ = true;
+};
+
+} // namespace core
+} // namespace trading
@@ -0,0 +1,501 @@
+/**
+ * @file market_push.cpp
+ * @brief 交易所行情推送快速解析实现
+ *
+ * @author Sequence Team
+ * @date 2025-12
+ */
+
+#include "market_push.h"
+#include "json_cursor.h"
+#include <atomic>
+
+namespace trading {
+namespace core {
+
+namespace {
+
+std::atomic<uint64_t> g_fast_parsed{0};
+std::atomic<uint64_t> g_fallback_parsed{0};
+
+double num(std::string_view text) {
+    return JsonCursor::to_double_or(text);
+}
+
+int64_t int_num(std::string_view text) {
+    return JsonCursor::to_int64_or(text);
+}
+
+bool starts_with(std::string_view s, std::string_view prefix) {
+    return s.size() >= prefix.size() && s.compare(0, prefix.size(), prefix) == 0;
+}
+
+// ==================== OKX ====================
+
+enum class OkxChannel {
+    NONE,
+    TICKERS,
+    TRADES,
+    BOOKS,
+    CANDLE,
+    FUNDING_RATE
+};
+
+// 与 OKXWebSocket::on_message 的频道分派保持一致
+OkxChannel classify_okx_channel(std::string_view channel) {
+    if (channel == "tickers") return OkxChannel::TICKERS;
+    if (channel == "trades" || channel == "trades-all") return OkxChannel::TRADES;
+    if (channel.find("books") != std::string_view::npos || channel == "bbo-tbt") return OkxChannel::BOOKS;
+    if (starts_with(channel, "candle")) return OkxChannel::CANDLE;
+    if (channel == "funding-rate") return OkxChannel::FUNDING_RATE;
+    return OkxChannel::NONE;
+}
+
+bool parse_okx_ticker(JsonCursor& cur, std::string_view inst_id, TickerPush& t) {
+    t.symbol = inst_id;
+    std::string_view key, v;
+    if (!cur.begin_object()) return false;
+    while (cur.next_key(key)) {
+        if (key == "instId") { cur.read_scalar(t.symbol); continue; }
+        if (key == "instType") { cur.read_scalar(t.inst_type); continue; }
+        if (!cur.read_scalar(v)) return false;
+        if (key == "last") t.last = num(v);
+        else if (key == "open24h") t.open_24h = num(v);
+        else if (key == "high24h") t.high_24h = num(v);
+        else if (key == "low24h") t.low_24h = num(v);
+        else if (key == "vol24h") t.volume_24h = num(v);
+        else if (key == "bidPx") t.bid_price = num(v);
+        else if (key == "bidSz") t.bid_size = num(v);
+        else if (key == "askPx") t.ask_price = num(v);
+        else if (key == "askSz") t.ask_size = num(v);
+        else if (key == "ts") t.timestamp = int_num(v);
+    }
+    return cur.ok();
+}
+
+bool parse_okx_trade(JsonCursor& cur, std::string_view inst_id, TradePush& t) {
+    t.symbol = inst_id;
+    std::string_view key, v;
+    if (!cur.begin_object()) return false;
+    while (cur.next_key(key)) {
+        if (!cur.read_scalar(v)) return false;
+        if (key == "px") t.price = num(v);
+        else if (key == "sz") t.quantity = num(v);
+        else if (key == "side") t.side = v;
+        else if (key == "tradeId") t.trade_id = v;
+        else if (key == "ts") t.timestamp = int_num(v);
+        else if (key == "instId" && inst_id.empty()) t.symbol = v;
+    }
+    return cur.ok();
+}
+
+bool parse_book_levels(JsonCursor& cur, std::vector<BookLevelPush>& levels) {
+    if (!cur.begin_array()) return false;
+    while (cur.next_element()) {
+        // ["价格", "数量", "0", "订单数"]
+        BookLevelPush level;
+        if (!cur.begin_array() || !cur.next_element() || !cur.read_scalar(level.price_text) ||
+            !cur.next_element() || !cur.read_scalar(level.size_text)) {
+            return false;
+        }
+        while (cur.next_element()) {
+            cur.skip_value();
+        }
+        if (!cur.ok()) return false;
+        level.price = num(level.price_text);
+        level.size = num(level.size_text);
+        levels.push_back(level);
+    }
+    return cur.ok();
+}
+
+bool parse_okx_book(JsonCursor& cur, BookPush& book) {
+    std::string_view key, v;
+    if (!cur.begin_object()) return false;
+    while (cur.next_key(key)) {
+        if (key == "bids") {
+            if (!parse_book_levels(cur, book.bids)) return false;
+        } else if (key == "asks") {
+            if (!parse_book_levels(cur, book.asks)) return false;
+        } else if (key == "ts" || key == "checksum" || key == "seqId" || key == "prevSeqId") {
+            if (!cur.read_scalar(v)) return false;
+            if (key == "ts") book.timestamp = int_num(v);
+            else if (key == "checksum") { book.checksum = int_num(v); book.has_checksum = true; }
+            else if (key == "seqId") book.seq_id = int_num(v);
+            else book.prev_seq_id = int_num(v);
+        } else {
+            cur.skip_value();
+        }
+    }
+    return cur.ok();
+}
+
+/**
+ * @return 1 已解析，0 元素不足已跳过，-1 出错
+ */
+int parse_okx_candle(JsonCursor& cur, KlinePush& k) {
+    // [ts, o, h, l, c, vol, volCcy, volCcyQuote, confirm]
+    std::string_view fields[9];
+    size_t n = 0;
+    if (!cur.begin_array()) return -1;
+    while (cur.next_element()) {
+        std::string_view v;
+        if (!cur.read_scalar(v)) return -1;
+        if (n < 9) fields[n] = v;
+        ++n;
+    }
+    if (!cur.ok()) return -1;
+    if (n < 6) return 0;
+
+    k.open_time = int_num(fields[0]);
+    k.open = num(fields[1]);
+    k.high = num(fields[2]);
+    k.low = num(fields[3]);
+    k.close = num(fields[4]);
+    k.volume = num(fields[5]);
+    if (n > 7) k.quote_volume = num(fields[7]);
+    if (n > 8) {
+        k.has_confirm = true;
+        k.confirmed = fields[8] == "1";
+    }
+    return 1;
+}
+
+bool parse_okx_funding_rate(JsonCursor& cur, FundingRatePush& f) {
+    std::string_view key, v;
+    if (!cur.begin_object()) return false;
+    while (cur.next_key(key)) {
+        if (!cur.read_scalar(v)) return false;
+        if (key == "instId") f.symbol = v;
+        else if (key == "instType") f.inst_type = v;
+        else if (key == "fundingRate") f.funding_rate = num(v);
+        else if (key == "nextFundingRate") f.next_funding_rate = num(v);
+        else if (key == "fundingTime") f.funding_time = int_num(v);
+        else if (key == "nextFundingTime") f.next_funding_time = int_num(v);
+        else if (key == "minFundingRate") f.min_funding_rate = num(v);
+        else if (key == "maxFundingRate") f.max_funding_rate = num(v);
+        else if (key == "interestRate") f.interest_rate = num(v);
+        else if (key == "impactValue") f.impact_value = num(v);
+        else if (key == "premium") f.premium = num(v);
+        else if (key == "settState") f.sett_state = v;
+        else if (key == "settFundingRate") f.sett_funding_rate = num(v);
+        else if (key == "method") f.method = v;
+        else if (key == "formulaType") f.formula_type = v;
+        else if (key == "ts") f.timestamp = int_num(v);
+    }
+    return cur.ok();
+}
+
+// ==================== Binance ====================
+
+/**
+ * @brief Binance 事件字段（单/双字母 key）
+ *
+ * 只记录原始文本，按事件类型再解释（同一个 key 在不同事件中含义不同，
+ * 例如 trade 的 p 是成交价，24hrTicker 的 p 是涨跌额）。
+ * 未出现的字段 data() 为 nullptr，可用于区分“缺失”和“空串”。
+ */
+struct BinanceFields {
+    std::string_view e, E, s, ps, t, p, q, m, T, c, o, h, l, v, i, r, x, b, B, a, A;
+    std::string_view k;  // 嵌套 K 线对象的原始文本
+};
+
+/**
+ * @brief 顶层报文的附加信息（组合流包装、控制消息标志）
+ */
+struct BinanceEnvelope {
+    std::string_view stream;
+    std::string_view data;
+    bool is_control = false;  // 交易 API / 订阅响应、ping、深度快照
+};
+
+bool parse_binance_fields(JsonCursor& cur, BinanceFields& f, BinanceEnvelope* env = nullptr) {
+    std::string_view key;
+    if (!cur.begin_object()) return false;
+    while (cur.next_key(key)) {
+        std::string_view* slot = nullptr;
+        if (key.size() == 1) {
+            switch (key[0]) {
+                case 'e': slot = &f.e; break;
+                case 'E': slot = &f.E; break;
+                case 's': slot = &f.s; break;
+                case 't': slot = &f.t; break;
+                case 'p': slot = &f.p; break;
+                case 'q': slot = &f.q; break;
+                case 'm': slot = &f.m; break;
+                case 'T': slot = &f.T; break;
+                case 'c': slot = &f.c; break;
+                case 'o': slot = &f.o; break;
+                case 'h': slot = &f.h; break;
+                case 'l': slot = &f.l; break;
+                case 'v': slot = &f.v; break;
+                case 'i': slot = &f.i; break;
+                case 'r': slot = &f.r; break;
+                case 'x': slot = &f.x; break;
+                case 'b': slot = &f.b; break;
+                case 'B': slot = &f.B; break;
+                case 'a': slot = &f.a; break;
+                case 'A': slot = &f.A; break;
+                case 'k':
+                    if (!cur.capture_value(f.k)) return false;
+                    continue;
+                default: break;
+            }
+        } else if (key == "ps") {
+            slot = &f.ps;
+        } else if (env) {
+            if (key == "stream") {
+                if (!cur.read_scalar(env->stream)) return false;
+                continue;
+            }
+            if (key == "data") {
+                if (!cur.capture_value(env->data)) return false;
+                continue;
+            }
+            if (key == "id" || key == "result" || key == "status" || key == "ping" || key == "lastUpdateId") {
+                env->is_control = true;
+            }
+        }
+
+        if (slot) {
+            char c = cur.peek();
+            if (c == '{' || c == '[') {
+                cur.skip_value();  // 同名但结构不同的字段（如 ACCOUNT_UPDATE 的 a），事件类型会判定为不支持
+            } else if (!cur.read_scalar(*slot)) {
+                return false;
+            }
+        } else if (!cur.skip_value()) {
+            return false;
+        }
+    }
+    return cur.ok();
+}
+
+PushParseStatus emit_binance_event(const BinanceFields& f, MarketPushBatch& batch) {
+    if (f.e == "trade") {
+        TradePush t;
+        t.symbol = f.s;
+        t.trade_id = f.t;
+        t.price = num(f.p);
+        t.quantity = num(f.q);
+        if (f.m.data()) {
+            t.side = f.m == "true" ? "sell" : "buy";  // m=true 表示买方是挂单方，即主动卖出
+        }
+        t.timestamp = int_num(f.T);
+        batch.trades.push_back(t);
+        return PushParseStatus::OK;
+    }
+
+    if (f.e == "kline" || f.e == "continuous_kline") {
+        KlinePush k;
+        k.symbol = f.ps.data() ? f.ps : f.s;
+        if (f.k.data()) {
+            JsonCursor kc(f.k);
+            BinanceFields kf;
+            if (!parse_binance_fields(kc, kf)) return PushParseStatus::MALFORMED;
+            k.interval = kf.i;
+            k.open_time = int_num(kf.t);
+            k.open = num(kf.o);
+            k.high = num(kf.h);
+            k.low = num(kf.l);
+            k.close = num(kf.c);
+            k.volume = num(kf.v);
+            k.quote_volume = num(kf.q);
+            k.has_confirm = kf.x.data() != nullptr;
+            k.confirmed = kf.x == "true";
+        }
+        batch.klines.push_back(k);
+        return PushParseStatus::OK;
+    }
+
+    if (f.e == "24hrTicker" || f.e == "24hrMiniTicker") {
+        TickerPush t;
+        t.symbol = f.s;
+        t.last = num(f.c);
+        t.open_24h = num(f.o);
+        t.high_24h = num(f.h);
+        t.low_24h = num(f.l);
+        t.volume_24h = num(f.v);
+        t.bid_price = num(f.b);
+        t.bid_size = num(f.B);
+        t.ask_price = num(f.a);
+        t.ask_size = num(f.A);
+        t.timestamp = int_num(f.E);
+        batch.tickers.push_back(t);
+        return PushParseStatus::OK;
+    }
+
+    if (f.e == "markPriceUpdate") {
+        MarkPricePush mp;
+        mp.symbol = f.s;
+        mp.mark_price = num(f.p);
+        mp.index_price = num(f.i);
+        mp.has_funding_rate = f.r.data() != nullptr;
+        mp.funding_rate = num(f.r);
+        mp.next_funding_time = int_num(f.T);
+        mp.timestamp = int_num(f.E);
+        batch.mark_prices.push_back(mp);
+        return PushParseStatus::OK;
+    }
+
+    return PushParseStatus::UNSUPPORTED;
+}
+
+PushParseStatus parse_binance_event_array(JsonCursor& cur, MarketPushBatch& batch) {
+    if (!cur.begin_array()) return PushParseStatus::MALFORMED;
+    while (cur.next_element()) {
+        BinanceFields f;
+        if (!parse_binance_fields(cur, f)) return PushParseStatus::MALFORMED;
+        PushParseStatus status = emit_binance_event(f, batch);
+        if (status != PushParseStatus::OK) return status;
+    }
+    return cur.ok() ? PushParseStatus::OK : PushParseStatus::MALFORMED;
+}
+
+} // namespace
+
+// ==================== 入口 ====================
+
+PushParseStatus parse_okx_push(std::string_view message, MarketPushBatch& batch) {
+    batch.clear();
+    JsonCursor cur(message);
+    if (cur.peek() != '{') {
+        return PushParseStatus::UNSUPPORTED;  // "pong" 等非 JSON 文本
+    }
+    cur.begin_object();
+
+    std::string_view key, channel, arg_inst_id, action, data;
+    while (cur.next_key(key)) {
+        if (key == "arg") {
+            std::string_view arg_key;
+            if (!cur.begin_object()) break;
+            while (cur.next_key(arg_key)) {
+                if (arg_key == "channel") cur.read_scalar(channel);
+                else if (arg_key == "instId") cur.read_scalar(arg_inst_id);
+                else cur.skip_value();
+            }
+        } else if (key == "data") {
+            cur.capture_value(data);  // data 可能先于 arg 出现，先记录位置
+        } else if (key == "action") {
+            cur.read_scalar(action);
+        } else if (key == "event" || key == "op" || key == "id") {
+            return PushParseStatus::UNSUPPORTED;  // 订阅/登录/下单响应
+        } else {
+            cur.skip_value();
+        }
+    }
+    if (!cur.ok()) return PushParseStatus::MALFORMED;
+    if (channel.empty() || data.empty()) return PushParseStatus::UNSUPPORTED;
+
+    OkxChannel kind = classify_okx_channel(channel);
+    if (kind == OkxChannel::NONE) return PushParseStatus::UNSUPPORTED;
+
+    JsonCursor d(data);
+    if (!d.begin_array()) return PushParseStatus::MALFORMED;
+
+    switch (kind) {
+        case OkxChannel::TICKERS:
+            while (d.next_element()) {
+                TickerPush t;
+                if (!parse_okx_ticker(d, arg_inst_id, t)) return PushParseStatus::MALFORMED;
+                batch.tickers.push_back(t);
+            }
+            break;
+        case OkxChannel::TRADES:
+            while (d.next_element()) {
+                TradePush t;
+                if (!parse_okx_trade(d, arg_inst_id, t)) return PushParseStatus::MALFORMED;
+                batch.trades.push_back(t);
+            }
+            break;
+        case OkxChannel::BOOKS:
+            // 只取第一个元素（与通用路径一致）
+            if (d.next_element()) {
+                BookPush& book = batch.book;
+                book.symbol = arg_inst_id;
+                book.channel = channel;
+                book.action = action.data() ? action : std::string_view("snapshot");
+                book.timestamp = 0;
+                book.checksum = 0;
+                book.seq_id = -1;
+                book.prev_seq_id = -1;
+                book.has_checksum = false;
+                if (!parse_okx_book(d, book)) return PushParseStatus::MALFORMED;
+                batch.has_book = true;
+            }
+            break;
+        case OkxChannel::CANDLE: {
+            std::string_view interval = channel.substr(6);  // "candle1m" -> "1m"
+            while (d.next_element()) {
+                KlinePush k;
+                k.symbol = arg_inst_id;
+                k.interval = interval;
+                int res = parse_okx_candle(d, k);
+                if (res < 0) return PushParseStatus::MALFORMED;
+                if (res > 0) batch.klines.push_back(k);
+            }
+            break;
+        }
+        case OkxChannel::FUNDING_RATE:
+            while (d.next_element()) {
+                FundingRatePush f;
+                if (!parse_okx_funding_rate(d, f)) return PushParseStatus::MALFORMED;
+                batch.funding_rates.push_back(f);
+            }
+            break;
+        case OkxChannel::NONE:
+            break;
+    }
+
+    return d.ok() ? PushParseStatus::OK : PushParseStatus::MALFORMED;
+}
+
+PushParseStatus parse_binance_push(std::string_view message, MarketPushBatch& batch) {
+    batch.clear();
+    JsonCursor cur(message);
+    char first = cur.peek();
+    if (first == '[') {
+        return parse_binance_event_array(cur, batch);
+    }
+    if (first != '{') {
+        return PushParseStatus::UNSUPPORTED;
+    }
+
+    // 一次扫描同时收集事件字段和组合流的 stream/data
+    BinanceFields f;
+    BinanceEnvelope env;
+    if (!parse_binance_fields(cur, f, &env)) return PushParseStatus::MALFORMED;
+
+    if (env.stream.data() && env.data.data()) {
+        // 组合流 {"stream": "...", "data": {...} 或 [...]}
+        JsonCursor inner(env.data);
+        if (inner.peek() == '[') {
+            return parse_binance_event_array(inner, batch);
+        }
+        f = BinanceFields();
+        BinanceEnvelope inner_env;
+        if (!parse_binance_fields(inner, f, &inner_env)) return PushParseStatus::MALFORMED;
+        env.is_control = inner_env.is_control;
+    }
+
+    if (env.is_control || !f.e.data()) {
+        return PushParseStatus::UNSUPPORTED;  // 交易 API 响应、订阅响应、深度快照等
+    }
+    return emit_binance_event(f, batch);
+}
+
+// ==================== 统计 ====================
+
+void count_push_parse(bool fast) {
+    (fast ? g_fast_parsed : g_fallback_parsed).fetch_add(1, std::memory_order_relaxed);
+}
+
+PushParseStats get_push_parse_stats() {
+    PushParseStats stats;
+    stats.fast = g_fast_parsed.load(std::memory_order_relaxed);
+    stats.fallback = g_fallback_parsed.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace core
+} // namespace trading
@@ -0,0 +1,189 @@
+#pragma once
+
+/**
+ * @file market_push.h
+ * @brief 交易所行情推送的类型化结构与快速解析
+ *
+ * 对已知的行情推送 schema 直接从原始报文提取字段到结构体，不构建 nlohmann::json DOM：
+ * - OKX: tickers / trades / books* / bbo-tbt / candle* / funding-rate
+ * - Binance: trade / kline / continuous_kline / 24hrTicker / 24hrMiniTicker / markPriceUpdate
+ *   （单条事件、组合流 {"stream","data"} 以及数组推送）
+ *
+ * 结构体中的 string_view 指向原始报文，只在回调期间有效；需要保存时请自行拷贝。
+ *
+ * 解析器对整条报文“全部成功或不产出”：返回非 OK 时 batch 内容无意义，
+ * 调用方应回退到 nlohmann::json 通用路径（订阅响应、私有频道、含转义的报文等）。
+ * 解析前会先清空 batch，可直接复用同一个对象。
+ *
+ * @author Sequence Team
+ * @date 2025-12
+ */
+
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+namespace trading {
+namespace core {
+
+// ==================== 类型化推送 ====================
+
+struct TickerPush {
+    std::string_view symbol;
+    std::string_view inst_type;  // OKX instType
+    double last = 0.0;
+    double open_24h = 0.0;
+    double high_24h = 0.0;
+    double low_24h = 0.0;
+    double volume_24h = 0.0;
+    double bid_price = 0.0;
+    double bid_size = 0.0;
+    double ask_price = 0.0;
+    double ask_size = 0.0;
+    int64_t timestamp = 0;       // 交易所时间戳（毫秒）
+};
+
+struct TradePush {
+    std::string_view symbol;
+    std::string_view trade_id;
+    std::string_view side;       // "buy" / "sell"
+    double price = 0.0;
+    double quantity = 0.0;
+    int64_t timestamp = 0;
+};
+
+struct BookLevelPush {
+    double price = 0.0;
+    double size = 0.0;
+    std::string_view price_text;  // 原始文本（OKX checksum 需要）
+    std::string_view size_text;
+};
+
+struct BookPush {
+    std::string_view symbol;
+    std::string_view channel;    // books5 / books / bbo-tbt / books-l2-tbt ...
+    std::string_view action;     // snapshot / update
+    std::vector<BookLevelPush> bids;
+    std::vector<BookLevelPush> asks;
+    int64_t timestamp = 0;
+    int64_t checksum = 0;
+    int64_t seq_id = -1;
+    int64_t prev_seq_id = -1;
+    bool has_checksum = false;
+};
+
+struct KlinePush {
+    std::string_view symbol;
+    std::string_view interval;
+    int64_t open_time = 0;       // K线开始时间（毫秒）
+    double open = 0.0;
+    double high = 0.0;
+    double low = 0.0;
+    double close = 0.0;
+    double volume = 0.0;
+    double quote_volume = 0.0;
+    bool has_confirm = false;    // 推送是否带完结标志
+    bool confirmed = false;      // OKX confirm=1 / Binance x=true
+};
+
+struct FundingRatePush {
+    std::string_view symbol;
+    std::string_view inst_type;
+    std::string_view sett_state;
+    std::string_view method;
+    std::string_view formula_type;
+    double funding_rate = 0.0;
+    double next_funding_rate = 0.0;
+    double min_funding_rate = 0.0;
+    double max_funding_rate = 0.0;
+    double interest_rate = 0.0;
+    double impact_value = 0.0;
+    double premium = 0.0;
+    double sett_funding_rate = 0.0;
+    int64_t funding_time = 0;
+    int64_t next_funding_time = 0;
+    int64_t timestamp = 0;
+};
+
+struct MarkPricePush {
+    std::string_view symbol;
+    double mark_price = 0.0;
+    double index_price = 0.0;
+    double funding_rate = 0.0;
+    int64_t next_funding_time = 0;
+    int64_t timestamp = 0;
+    bool has_funding_rate = false;
+};
+
+/**
+ * @brief 一条报文解析出的全部推送
+ *
+ * 建议按线程复用（thread_local），clear() 保留容量，稳定后不再分配内存
+ */
+struct MarketPushBatch {
+    std::vector<TickerPush> tickers;
+    std::vector<TradePush> trades;
+    std::vector<KlinePush> klines;
+    std::vector<FundingRatePush> funding_rates;
+    std::vector<MarkPricePush> mark_prices;
+    BookPush book;               // OKX 深度推送每条只有一个快照/增量
+    bool has_book = false;
+
+    void clear() {
+        tickers.clear();
+        trades.clear();
+        klines.clear();
+        funding_rates.clear();
+        mark_prices.clear();
+        book.bids.clear();
+        book.asks.clear();
+        has_book = false;
+    }
+
+    bool empty() const {
+        return tickers.empty() && trades.empty() && klines.empty() &&
+               funding_rates.empty() && mark_prices.empty() && !has_book;
+    }
+};
+
+// 类型化行情回调（交易所适配器的 set_*_push_callback 使用）
+using TickerPushCallback = std::function<void(const TickerPush&)>;
+using TradePushCallback = std::function<void(const TradePush&)>;
+using OrderBookPushCallback = std::function<void(const BookPush&)>;
+using KlinePushCallback = std::function<void(const KlinePush&)>;
+using FundingRatePushCallback = std::function<void(const FundingRatePush&)>;
+using MarkPricePushCallback = std::function<void(const MarkPricePush&)>;
+
+enum class PushParseStatus {
+    OK,           // 已解析，batch 可用
+    UNSUPPORTED,  // 合法报文但不是支持的推送（事件响应、私有频道等）
+    MALFORMED     // 报文不符合预期（含转义、结构不符），交给 DOM 解析
+};
+
+/**
+ * @brief 解析 OKX 推送 {"arg":{...},"action":...,"data":[...]}
+ */
+PushParseStatus parse_okx_push(std::string_view message, MarketPushBatch& batch);
+
+/**
+ * @brief 解析 Binance 推送（单条事件 / 组合流 / 数组）
+ */
+PushParseStatus parse_binance_push(std::string_view message, MarketPushBatch& batch);
+
+// ==================== 统计 ====================
+
+struct PushParseStats {
+    uint64_t fast = 0;      // 快速路径处理的报文数
+    uint64_t fallback = 0;  // 回退到 DOM 解析的行情报文数（已设置类型化回调的连接）
+};
+
+/**
+ * @brief 记录一次解析结果（各交易所连接共用，全局累计）
+ */
+void count_push_parse(bool fast);
+
+PushParseStats get_push_parse_stats();
+
+} // namespace core
+} // namespace trading
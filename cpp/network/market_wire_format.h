@@ -0,0 +1,486 @@
+/**
+ * @file market_wire_format.h
+ * @brief 行情二进制线格式（定长 POD 结构）
+ *
+ * 功能：
+ * 1. 为 trade/ticker/kline/orderbook/funding_rate 定义版本化的定长结构
+ * 2. 服务端：将回调中构建的行情 JSON 直接编码为二进制（替代 dump）
+ * 3. 策略端：识别二进制帧并按结构体读取（替代 json::parse）
+ *
+ * 帧格式（与 JSON 帧共用主题前缀，ZMQ 主题过滤不受影响）：
+ *   JSON:   {topic}|{json_data}
+ *   BINARY: {topic}|{WireHeader}{Body}[{WireLevel} * N]
+ *
+ * 策略端通过 '|' 之后的 magic 区分两种帧，因此同一通道可以混合发送，
+ * 服务端按频道逐个切换编码，旧策略无需同时升级。
+ *
+ * 注意：
+ * - 仅用于同机 IPC，字节序为本机字节序（x86_64 小端）
+ * - 结构体使用 1 字节对齐，读取时一律 memcpy，避免未对齐访问
+ * - 字段变更必须递增 WIRE_VERSION，解码端拒绝不匹配的版本
+ *
+ * @author Sequence Team
+ * @date 2025-12
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <nlohmann/json.hpp>
+
+#include "../core/instrument_registry.h"
+
+namespace trading {
+namespace server {
+namespace wire {
+
+// ============================================================
+// 常量定义
+// ============================================================
+
+// 帧 magic: "SQWF"（小端），JSON 帧以 '{' 开头，不会与之冲突
+constexpr uint32_t WIRE_MAGIC = 0x46575153;
+
+// 线格式版本（结构体布局变更时递增）
+constexpr uint16_t WIRE_VERSION = 2;
+
+// 定长字符串字段长度（含结尾 '\0'）
+constexpr size_t WIRE_SYMBOL_LEN = 32;
+constexpr size_t WIRE_EXCHANGE_LEN = 16;
+constexpr size_t WIRE_TRADE_ID_LEN = 32;
+constexpr size_t WIRE_SHORT_STR_LEN = 16;
+
+/**
+ * @brief 行情编码方式
+ */
+enum class WireEncoding : uint8_t {
+    JSON = 0,      // topic|json（默认，兼容所有客户端）
+    BINARY = 1,    // topic|header+body（定长结构）
+};
+
+/**
+ * @brief 二进制消息类型
+ *
+ * 数值同时作为 ZmqServer 中按频道启用二进制编码的位索引
+ */
+enum class WireMsgType : uint8_t {
+    UNKNOWN = 0,
+    TICKER = 1,
+    ORDERBOOK = 2,
+    TRADE = 3,
+    KLINE = 4,
+    FUNDING_RATE = 5,
+};
+
+// ============================================================
+// 线格式结构体（1 字节对齐）
+// ============================================================
+
+#pragma pack(push, 1)
+
+/**
+ * @brief 帧头（所有二进制消息共用）
+ */
+struct WireHeader {
+    uint32_t magic;                        // WIRE_MAGIC
+    uint16_t version;                      // WIRE_VERSION
+    uint8_t msg_type;                      // WireMsgType
+    uint8_t reserved;                      // 保留（对齐用）
+    uint32_t body_size;                    // 消息体字节数（不含帧头）
+    int32_t instrument_id;                 // 服务端品种ID（InstrumentRegistry，-1 未登记；仅服务端进程内有效）
+    int64_t timestamp_ns;                  // 服务端构建时间（纳秒，用于延迟测量）
+    char exchange[WIRE_EXCHANGE_LEN];      // 交易所
+    char symbol[WIRE_SYMBOL_LEN];          // 交易对
+};
+
+/**
+ * @brief Ticker 消息体
+ */
+struct WireTicker {
+    int64_t timestamp;                     // 交易所时间（毫秒）
+    double price;                          // 最新价
+    double high_24h;
+    double low_24h;
+    double open_24h;
+    double volume_24h;
+};
+
+/**
+ * @brief 逐笔成交消息体
+ */
+struct WireTrade {
+    int64_t timestamp;                     // 成交时间（毫秒）
+    double price;
+    double quantity;
+    char trade_id[WIRE_TRADE_ID_LEN];
+    char side[8];                          // "buy" / "sell"
+};
+
+/**
+ * @brief K线消息体
+ */
+struct WireKline {
+    int64_t timestamp;                     // K线开始时间（毫秒）
+    double open;
+    double high;
+    double low;
+    double close;
+    double volume;
+    char interval[8];                      // "1m" / "1H" ...
+};
+
+/**
+ * @brief 深度消息体（后接 bid_count + ask_count 个 WireLevel）
+ */
+struct WireOrderBook {
+    int64_t timestamp;
+    double best_bid_price;
+    double best_bid_size;
+    double best_ask_price;
+    double best_ask_size;
+    double mid_price;
+    double spread;
+    char channel[WIRE_SHORT_STR_LEN];      // "books5" / "bbo-tbt" ...
+    char action[WIRE_SHORT_STR_LEN];       // "snapshot" / "update"
+    uint16_t bid_count;
+    uint16_t ask_count;
+};
+
+/**
+ * @brief 深度档位
+ */
+struct WireLevel {
+    double price;
+    double size;
+};
+
+/**
+ * @brief 资金费率消息体
+ */
+struct WireFundingRate {
+    int64_t timestamp;
+    double funding_rate;
+    double next_funding_rate;
+    int64_t funding_time;
+    int64_t next_funding_time;
+    double min_funding_rate;
+    double max_funding_rate;
+    double interest_rate;
+    double impact_value;
+    double premium;
+    double sett_funding_rate;
+    char method[WIRE_SHORT_STR_LEN];
+    char formula_type[WIRE_SHORT_STR_LEN];
+    char sett_state[WIRE_SHORT_STR_LEN];
+    char inst_type[WIRE_SHORT_STR_LEN];
+};
+
+#pragma pack(pop)
+
+static_assert(sizeof(WireHeader) == 72, "WireHeader 布局变更需要递增 WIRE_VERSION");
+static_assert(sizeof(WireLevel) == 16, "WireLevel 布局变更需要递增 WIRE_VERSION");
+
+// ============================================================
+// 辅助函数
+// ============================================================
+
+/**
+ * @brief 行情类型字符串 -> WireMsgType
+ *
+ * 仅覆盖策略端需要的行情类型，其余类型（如 mark_price）返回 UNKNOWN，走 JSON
+ */
+inline WireMsgType wire_type_from_string(const std::string& type) {
+    if (type == "ticker") return WireMsgType::TICKER;
+    if (type == "orderbook") return WireMsgType::ORDERBOOK;
+    if (type == "trade" || type == "trades") return WireMsgType::TRADE;
+    if (type == "kline") return WireMsgType::KLINE;
+    if (type == "funding_rate") return WireMsgType::FUNDING_RATE;
+    return WireMsgType::UNKNOWN;
+}
+
+/**
+ * @brief 拷贝字符串到定长字段（截断并保证 '\0' 结尾）
+ */
+inline void copy_fixed(char* dst, size_t cap, const std::string& src) {
+    size_t n = src.size() < cap - 1 ? src.size() : cap - 1;
+    std::memcpy(dst, src.data(), n);
+    std::memset(dst + n, 0, cap - n);
+}
+
+/**
+ * @brief 从定长字段读取字符串
+ */
+inline std::string read_fixed(const char* src, size_t cap) {
+    return std::string(src, strnlen(src, cap));
+}
+
+/**
+ * @brief 从 JSON 读取 double（兼容字符串数值）
+ */
+inline double json_number(const nlohmann::json& data, const char* key, double default_val = 0.0) {
+    auto it = data.find(key);
+    if (it == data.end()) return default_val;
+    if (it->is_number()) return it->get<double>();
+    if (it->is_string()) {
+        try {
+            return std::stod(it->get_ref<const std::string&>());
+        } catch (...) {
+            return default_val;
+        }
+    }
+    return default_val;
+}
+
+/**
+ * @brief 从 JSON 读取 int64（兼容字符串数值）
+ */
+inline int64_t json_int64(const nlohmann::json& data, const char* key, int64_t default_val = 0) {
+    auto it = data.find(key);
+    if (it == data.end()) return default_val;
+    if (it->is_number()) return it->get<int64_t>();
+    if (it->is_string()) {
+        try {
+            return std::stoll(it->get_ref<const std::string&>());
+        } catch (...) {
+            return default_val;
+        }
+    }
+    return default_val;
+}
+
+/**
+ * @brief 从 JSON 读取字符串
+ */
+inline std::string json_str(const nlohmann::json& data, const char* key) {
+    auto it = data.find(key);
+    if (it == data.end() || !it->is_string()) return "";
+    return it->get<std::string>();
+}
+
+template <typename Body>
+inline void append_pod(std::string& out, const Body& body) {
+    out.append(reinterpret_cast<const char*>(&body), sizeof(Body));
+}
+
+// ============================================================
+// 编码（服务端）
+// ============================================================
+
+/**
+ * @brief 将行情 JSON 编码为二进制并追加到 out
+ *
+ * @param data 回调中构建的行情 JSON（字段名与 JSON 帧一致）
+ * @param out 输出缓冲区（通常已包含 "topic|" 前缀）
+ * @return true 编码成功
+ * @return false 类型不支持，调用方应回退到 JSON
+ */
+inline bool encode_market_json(const nlohmann::json& data, std::string& out) {
+    WireMsgType type = wire_type_from_string(json_str(data, "type"));
+    if (type == WireMsgType::UNKNOWN) {
+        return false;
+    }
+
+    WireHeader header;
+    header.magic = WIRE_MAGIC;
+    header.version = WIRE_VERSION;
+    header.msg_type = static_cast<uint8_t>(type);
+    header.reserved = 0;
+    header.body_size = 0;
+    header.timestamp_ns = json_int64(data, "timestamp_ns");
+    const std::string exchange = json_str(data, "exchange");
+    const std::string symbol = json_str(data, "symbol");
+    header.instrument_id = symbol.empty() ? INVALID_INSTRUMENT
+                                          : InstrumentRegistry::instance().intern(exchange, symbol);
+    copy_fixed(header.exchange, sizeof(header.exchange), exchange);
+    copy_fixed(header.symbol, sizeof(header.symbol), symbol);
+
+    size_t header_pos = out.size();
+
+    switch (type) {
+        case WireMsgType::TICKER: {
+            WireTicker body;
+            body.timestamp = json_int64(data, "timestamp");
+            body.price = json_number(data, "price");
+            body.high_24h = json_number(data, "high_24h");
+            body.low_24h = json_number(data, "low_24h");
+            body.open_24h = json_number(data, "open_24h");
+            body.volume_24h = json_number(data, "volume_24h");
+            header.body_size = sizeof(body);
+            append_pod(out, header);
+            append_pod(out, body);
+            break;
+        }
+        case WireMsgType::TRADE: {
+            WireTrade body;
+            body.timestamp = json_int64(data, "timestamp");
+            body.price = json_number(data, "price");
+            body.quantity = json_number(data, "quantity");
+            copy_fixed(body.trade_id, sizeof(body.trade_id), json_str(data, "trade_id"));
+            copy_fixed(body.side, sizeof(body.side), json_str(data, "side"));
+            header.body_size = sizeof(body);
+            append_pod(out, header);
+            append_pod(out, body);
+            break;
+        }
+        case WireMsgType::KLINE: {
+            WireKline body;
+            body.timestamp = json_int64(data, "timestamp");
+            body.open = json_number(data, "open");
+            body.high = json_number(data, "high");
+            body.low = json_number(data, "low");
+            body.close = json_number(data, "close");
+            body.volume = json_number(data, "volume");
+            copy_fixed(body.interval, sizeof(body.interval), json_str(data, "interval"));
+            header.body_size = sizeof(body);
+            append_pod(out, header);
+            append_pod(out, body);
+            break;
+        }
+        case WireMsgType::ORDERBOOK: {
+            WireOrderBook body;
+            body.timestamp = json_int64(data, "timestamp");
+            body.best_bid_price = json_number(data, "best_bid_price");
+            body.best_bid_size = json_number(data, "best_bid_size");
+            body.best_ask_price = json_number(data, "best_ask_price");
+            body.best_ask_size = json_number(data, "best_ask_size");
+            body.mid_price = json_number(data, "mid_price");
+            body.spread = json_number(data, "spread");
+            copy_fixed(body.channel, sizeof(body.channel), json_str(data, "channel"));
+            copy_fixed(body.action, sizeof(body.action), json_str(data, "action"));
+
+            auto bids_it = data.find("bids");
+            auto asks_it = data.find("asks");
+            bool has_bids = bids_it != data.end() && bids_it->is_array();
+            bool has_asks = asks_it != data.end() && asks_it->is_array();
+            size_t bid_count = has_bids ? std::min<size_t>(bids_it->size(), UINT16_MAX) : 0;
+            size_t ask_count = has_asks ? std::min<size_t>(asks_it->size(), UINT16_MAX) : 0;
+            body.bid_count = static_cast<uint16_t>(bid_count);
+            body.ask_count = static_cast<uint16_t>(ask_count);
+
+            header.body_size = static_cast<uint32_t>(
+                sizeof(body) + (bid_count + ask_count) * sizeof(WireLevel));
+            out.reserve(out.size() + sizeof(header) + header.body_size);
+            append_pod(out, header);
+            append_pod(out, body);
+
+            auto append_levels = [&out](const nlohmann::json& levels, size_t count) {
+                for (size_t i = 0; i < count; ++i) {
+                    const auto& level = levels[i];
+                    WireLevel wl{0.0, 0.0};
+                    if (level.is_array() && level.size() >= 2) {
+                        wl.price = level[0].is_number() ? level[0].get<double>()
+                                                        : std::stod(level[0].get<std::string>());
+                        wl.size = level[1].is_number() ? level[1].get<double>()
+                                                       : std::stod(level[1].get<std::string>());
+                    }
+                    append_pod(out, wl);
+                }
+            };
+            try {
+                if (has_bids) append_levels(*bids_it, bid_count);
+                if (has_asks) append_levels(*asks_it, ask_count);
+            } catch (...) {
+                // 档位格式异常，回退到 JSON
+                out.resize(header_pos);
+                return false;
+            }
+            break;
+        }
+        case WireMsgType::FUNDING_RATE: {
+            WireFundingRate body;
+            body.timestamp = json_int64(data, "timestamp");
+            body.funding_rate = json_number(data, "funding_rate");
+            body.next_funding_rate = json_number(data, "next_funding_rate");
+            body.funding_time = json_int64(data, "funding_time");
+            body.next_funding_time = json_int64(data, "next_funding_time");
+            body.min_funding_rate = json_number(data, "min_funding_rate");
+            body.max_funding_rate = json_number(data, "max_funding_rate");
+            body.interest_rate = json_number(data, "interest_rate");
+            body.impact_value = json_number(data, "impact_value");
+            body.premium = json_number(data, "premium");
+            body.sett_funding_rate = json_number(data, "sett_funding_rate");
+            copy_fixed(body.method, sizeof(body.method), json_str(data, "method"));
+            copy_fixed(body.formula_type, sizeof(body.formula_type), json_str(data, "formula_type"));
+            copy_fixed(body.sett_state, sizeof(body.sett_state), json_str(data, "sett_state"));
+            copy_fixed(body.inst_type, sizeof(body.inst_type), json_str(data, "inst_type"));
+            header.body_size = sizeof(body);
+            append_pod(out, header);
+            append_pod(out, body);
+            break;
+        }
+        default:
+            return false;
+    }
+
+    return true;
+}
+
+// ============================================================
+// 解码（策略端）
+// ============================================================
+
+/**
+ * @brief 判断负载是否为二进制帧
+ *
+ * @param payload '|' 之后的数据
+ * @param size 数据长度
+ */
+inline bool is_binary_frame(const char* payload, size_t size) {
+    if (size < sizeof(WireHeader)) return false;
+    uint32_t magic;
+    std::memcpy(&magic, payload, sizeof(magic));
+    return magic == WIRE_MAGIC;
+}
+
+/**
+ * @brief 读取并校验帧头
+ *
+ * @param payload '|' 之后的数据
+ * @param size 数据长度
+ * @param header 输出帧头
+ * @return true 帧头合法（magic/版本/长度均匹配）
+ */
+inline bool read_header(const char* payload, size_t size, WireHeader& header) {
+    if (size < sizeof(WireHeader)) return false;
+    std::memcpy(&header, payload, sizeof(WireHeader));
+    if (header.magic != WIRE_MAGIC || header.version != WIRE_VERSION) return false;
+    return size - sizeof(WireHeader) >= header.body_size;
+}
+
+/**
+ * @brief 读取定长消息体
+ *
+ * @param payload '|' 之后的数据（含帧头）
+ * @param header 已校验的帧头
+ * @param body 输出消息体
+ * @return true 消息体长度足够
+ */
+template <typename Body>
+inline bool read_body(const char* payload, const WireHeader& header, Body& body) {
+    if (header.body_size < sizeof(Body)) return false;
+    std::memcpy(&body, payload + sizeof(WireHeader), sizeof(Body));
+    return true;
+}
+
+/**
+ * @brief 读取深度档位
+ *
+ * 调用前需确认 body_size 覆盖 bid_count + ask_count 个档位
+ *
+ * @param payload '|' 之后的数据（含帧头）
+ * @param index 档位序号（bids 在前，asks 在后）
+ */
+inline WireLevel read_level(const char* payload, size_t index) {
+    WireLevel level;
+    std::memcpy(&level,
+                payload + sizeof(WireHeader) + sizeof(WireOrderBook) + index * sizeof(WireLevel),
+                sizeof(WireLevel));
+    return level;
+}
+
+} // namespace wire
+} // namespace server
+} // namespace trading
@@ -0,0 +1,387 @@
+#pragma once
+
+/**
+ * @file order_book.h
+ * @brief 本地 L2 订单簿（增量维护 + 校验）
+ *
+ * - OrderBook: 每侧按价格有序的档位数组（价格/数量/原始文本分列存放），
+ *   最优价位于数组末尾，盘口附近的增删只移动少量元素
+ * - OkxBookSync: OKX books / books-l2-tbt / books50-l2-tbt 增量，
+ *   校验 seqId/prevSeqId 连续性与 CRC32 checksum（前 25 档）
+ * - BinanceBookSync: Binance diff depth（<symbol>@depth@100ms），
+ *   按 U/u（合约为 pu）衔接 REST 快照与增量
+ *
+ * 校验失败或序号断档时返回 RESYNC，由调用方重新订阅（OKX）或拉取 REST 快照（Binance），
+ * 之后的增量返回 PENDING 直到收到新快照。
+ * 非线程安全，由调用方加锁。
+ *
+ * @author Sequence Team
+ * @date 2026-01
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "market_push.h"
+
+namespace trading {
+namespace core {
+
+// ==================== CRC32 ====================
+
+/**
+ * @brief CRC32（IEEE 802.3，与 zlib crc32 相同），可分段累加
+ */
+inline uint32_t crc32_update(uint32_t crc, const char* data, size_t len) {
+    static const auto table = [] {
+        std::vector<uint32_t> t(256);
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            t[i] = c;
+        }
+        return t;
+    }();
+    crc = ~crc;
+    for (size_t i = 0; i < len; ++i) {
+        crc = table[(crc ^ static_cast<uint8_t>(data[i])) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+// ==================== 订单簿 ====================
+
+enum class BookSide { BID = 0, ASK = 1 };
+
+class OrderBook {
+public:
+    static constexpr size_t npos = std::numeric_limits<size_t>::max();
+    static constexpr size_t MAX_TEXT_LEN = 31;
+
+    void clear() {
+        for (auto& ladder : ladders_) ladder.clear();
+    }
+
+    /**
+     * @brief 设置一个档位（size <= 0 表示删除）
+     * @param price_text / size_text 交易所原始文本（OKX checksum 需要，其他交易所可留空）
+     * @return 变动档位距最优价的序号（0 = 最优档），档位不存在且为删除时返回 npos
+     */
+    size_t update(BookSide side, double price, double size,
+                  std::string_view price_text = {}, std::string_view size_text = {}) {
+        Ladder& ladder = ladders_[static_cast<int>(side)];
+        const bool bid = side == BookSide::BID;
+        // 数组内自差到优排列：买盘价格升序，卖盘价格降序
+        auto it = bid
+            ? std::lower_bound(ladder.prices.begin(), ladder.prices.end(), price)
+            : std::lower_bound(ladder.prices.begin(), ladder.prices.end(), price, std::greater<double>());
+        const size_t idx = static_cast<size_t>(it - ladder.prices.begin());
+        const bool exists = it != ladder.prices.end() && *it == price;
+        const size_t n = ladder.prices.size();
+
+        if (size <= 0.0) {
+            if (!exists) return npos;
+            ladder.prices.erase(ladder.prices.begin() + idx);
+            ladder.sizes.erase(ladder.sizes.begin() + idx);
+            ladder.texts.erase(ladder.texts.begin() + idx);
+            return n - 1 - idx;
+        }
+
+        if (exists) {
+            ladder.sizes[idx] = size;
+            ladder.texts[idx].set(price_text, size_text);
+            return n - 1 - idx;
+        }
+        ladder.prices.insert(ladder.prices.begin() + idx, price);
+        ladder.sizes.insert(ladder.sizes.begin() + idx, size);
+        ladder.texts.insert(ladder.texts.begin() + idx, LevelText{});
+        ladder.texts[idx].set(price_text, size_text);
+        return n - idx;
+    }
+
+    size_t depth(BookSide side) const {
+        return ladders_[static_cast<int>(side)].prices.size();
+    }
+
+    // level: 0 = 最优档
+    double price(BookSide side, size_t level) const {
+        const Ladder& ladder = ladders_[static_cast<int>(side)];
+        return ladder.prices[ladder.prices.size() - 1 - level];
+    }
+
+    double size(BookSide side, size_t level) const {
+        const Ladder& ladder = ladders_[static_cast<int>(side)];
+        return ladder.sizes[ladder.sizes.size() - 1 - level];
+    }
+
+    std::string_view price_text(BookSide side, size_t level) const {
+        const Ladder& ladder = ladders_[static_cast<int>(side)];
+        return ladder.texts[ladder.texts.size() - 1 - level].price();
+    }
+
+    std::string_view size_text(BookSide side, size_t level) const {
+        const Ladder& ladder = ladders_[static_cast<int>(side)];
+        return ladder.texts[ladder.texts.size() - 1 - level].size();
+    }
+
+    bool crossed() const {
+        return depth(BookSide::BID) > 0 && depth(BookSide::ASK) > 0 &&
+               price(BookSide::BID, 0) >= price(BookSide::ASK, 0);
+    }
+
+    /**
+     * @brief OKX checksum：前 25 档按 bid:size:ask:size 交错拼接后取 CRC32（有符号）
+     *
+     * 任一文本超长（> MAX_TEXT_LEN）时返回值不可信，调用方会因不匹配而重新同步
+     */
+    int32_t okx_checksum() const {
+        uint32_t crc = 0;
+        bool first = true;
+        auto append = [&](std::string_view price, std::string_view size) {
+            if (!first) crc = crc32_update(crc, ":", 1);
+            first = false;
+            crc = crc32_update(crc, price.data(), price.size());
+            crc = crc32_update(crc, ":", 1);
+            crc = crc32_update(crc, size.data(), size.size());
+        };
+        const size_t bids = std::min<size_t>(25, depth(BookSide::BID));
+        const size_t asks = std::min<size_t>(25, depth(BookSide::ASK));
+        for (size_t i = 0; i < std::max(bids, asks); ++i) {
+            if (i < bids) append(price_text(BookSide::BID, i), size_text(BookSide::BID, i));
+            if (i < asks) append(price_text(BookSide::ASK, i), size_text(BookSide::ASK, i));
+        }
+        return static_cast<int32_t>(crc);
+    }
+
+private:
+    struct LevelText {
+        char price_buf[MAX_TEXT_LEN];
+        uint8_t price_len = 0;
+        char size_buf[MAX_TEXT_LEN];
+        uint8_t size_len = 0;
+
+        void set(std::string_view p, std::string_view s) {
+            price_len = static_cast<uint8_t>(std::min(p.size(), MAX_TEXT_LEN));
+            size_len = static_cast<uint8_t>(std::min(s.size(), MAX_TEXT_LEN));
+            std::memcpy(price_buf, p.data(), price_len);
+            std::memcpy(size_buf, s.data(), size_len);
+        }
+        std::string_view price() const { return {price_buf, price_len}; }
+        std::string_view size() const { return {size_buf, size_len}; }
+    };
+
+    struct Ladder {
+        std::vector<double> prices;     // 查找只访问这一列
+        std::vector<double> sizes;
+        std::vector<LevelText> texts;
+
+        void clear() {
+            prices.clear();
+            sizes.clear();
+            texts.clear();
+        }
+    };
+
+    Ladder ladders_[2];
+};
+
+enum class BookSyncStatus {
+    UPDATED,    // 已应用，且关注的前 N 档有变化
+    UNCHANGED,  // 已应用（或丢弃过期增量），前 N 档无变化
+    PENDING,    // 等待快照（Binance 期间的增量会被缓存，OKX 丢弃）
+    RESYNC      // 校验失败或断档，需要重新同步（每次失同步只返回一次）
+};
+
+/**
+ * @brief 应用一侧的档位列表，返回最小变动档位序号
+ */
+template <typename Levels, typename Fn>
+inline size_t apply_levels(OrderBook& book, BookSide side, const Levels& levels, Fn&& update) {
+    size_t touched = OrderBook::npos;
+    for (const auto& level : levels) {
+        touched = std::min(touched, update(book, side, level));
+    }
+    return touched;
+}
+
+inline bool within_watch(size_t touched, size_t watch_depth) {
+    return touched != OrderBook::npos && (watch_depth == 0 || touched < watch_depth);
+}
+
+// ==================== OKX ====================
+
+class OkxBookSync {
+public:
+    /**
+     * @brief 应用一条 OKX 深度推送（snapshot / update）
+     * @param watch_depth 关注的档位数（0 = 全部），用于判断是否需要发布
+     */
+    BookSyncStatus apply(const BookPush& push, size_t watch_depth) {
+        const bool snapshot = push.action != "update";
+        if (snapshot) {
+            book_.clear();
+            synced_ = true;
+        } else if (!synced_) {
+            return BookSyncStatus::PENDING;  // 已请求重新同步，等待快照
+        } else if (push.prev_seq_id >= 0 && seq_id_ >= 0 && push.prev_seq_id != seq_id_) {
+            sequence_gaps_++;
+            synced_ = false;
+            return BookSyncStatus::RESYNC;
+        }
+
+        auto update = [](OrderBook& book, BookSide side, const BookLevelPush& level) {
+            return book.update(side, level.price, level.size, level.price_text, level.size_text);
+        };
+        size_t touched = std::min(apply_levels(book_, BookSide::BID, push.bids, update),
+                                  apply_levels(book_, BookSide::ASK, push.asks, update));
+        seq_id_ = push.seq_id;
+
+        if (push.has_checksum && book_.okx_checksum() != static_cast<int32_t>(push.checksum)) {
+            checksum_failures_++;
+            synced_ = false;
+            return BookSyncStatus::RESYNC;
+        }
+        return (snapshot || within_watch(touched, watch_depth))
+            ? BookSyncStatus::UPDATED : BookSyncStatus::UNCHANGED;
+    }
+
+    const OrderBook& book() const { return book_; }
+    bool synced() const { return synced_; }
+    uint64_t checksum_failures() const { return checksum_failures_; }
+    uint64_t sequence_gaps() const { return sequence_gaps_; }
+
+private:
+    OrderBook book_;
+    int64_t seq_id_ = -1;
+    bool synced_ = false;
+    uint64_t checksum_failures_ = 0;
+    uint64_t sequence_gaps_ = 0;
+};
+
+// ==================== Binance ====================
+
+using PriceLevels = std::vector<std::pair<double, double>>;  // (price, size)
+
+/**
+ * @brief Binance depthUpdate 事件
+ */
+struct DepthDiff {
+    int64_t first_update_id = 0;    // U
+    int64_t final_update_id = 0;    // u
+    int64_t prev_final_id = -1;     // pu（仅合约，现货为 -1）
+    int64_t timestamp = 0;          // E
+    PriceLevels bids;
+    PriceLevels asks;
+};
+
+class BinanceBookSync {
+public:
+    static constexpr size_t MAX_BUFFERED = 4096;
+
+    /**
+     * @brief 应用增量；未同步时缓存并返回 PENDING
+     */
+    BookSyncStatus apply_diff(DepthDiff&& diff, size_t watch_depth) {
+        if (!synced_) {
+            if (buffered_.size() >= MAX_BUFFERED) buffered_.pop_front();
+            buffered_.push_back(std::move(diff));
+            return BookSyncStatus::PENDING;
+        }
+        BookSyncStatus status = apply_one(diff, watch_depth);
+        if (status == BookSyncStatus::RESYNC) {
+            buffered_.push_back(std::move(diff));
+        }
+        return status;
+    }
+
+    /**
+     * @brief 应用 REST 快照（GET depth 的 lastUpdateId/bids/asks），并回放缓存的增量
+     * @return RESYNC 表示快照与缓存的增量衔接不上（快照过旧或增量断档），需要重新拉取
+     */
+    BookSyncStatus apply_snapshot(int64_t last_update_id, const PriceLevels& bids,
+                                  const PriceLevels& asks) {
+        book_.clear();
+        for (const auto& level : bids) book_.update(BookSide::BID, level.first, level.second);
+        for (const auto& level : asks) book_.update(BookSide::ASK, level.first, level.second);
+        last_update_id_ = last_update_id;
+        bridging_ = true;
+        synced_ = true;
+
+        while (!buffered_.empty()) {
+            // 断档时保留该条及之后的增量，等待下一次快照
+            if (apply_one(buffered_.front(), 0) == BookSyncStatus::RESYNC) {
+                return BookSyncStatus::RESYNC;
+            }
+            buffered_.pop_front();
+        }
+        return BookSyncStatus::UPDATED;
+    }
+
+    /**
+     * @brief 是否需要发起快照请求（每次失同步只返回一次 true）
+     */
+    bool take_snapshot_request() {
+        if (synced_ || snapshot_requested_) return false;
+        snapshot_requested_ = true;
+        return true;
+    }
+
+    // 快照请求失败时调用，允许再次请求
+    void snapshot_failed() { snapshot_requested_ = false; }
+
+    const OrderBook& book() const { return book_; }
+    bool synced() const { return synced_; }
+    int64_t last_update_id() const { return last_update_id_; }
+    uint64_t sequence_gaps() const { return sequence_gaps_; }
+
+private:
+    BookSyncStatus apply_one(const DepthDiff& diff, size_t watch_depth) {
+        if (diff.final_update_id < last_update_id_) {
+            return BookSyncStatus::UNCHANGED;  // 快照已包含
+        }
+        if (bridging_) {
+            // 第一条增量必须覆盖快照：U <= lastUpdateId + 1 且 u >= lastUpdateId
+            if (diff.first_update_id > last_update_id_ + 1) return lose_sync();
+            bridging_ = false;
+        } else if (diff.prev_final_id >= 0 ? diff.prev_final_id != last_update_id_
+                                           : diff.first_update_id != last_update_id_ + 1) {
+            return lose_sync();
+        }
+
+        auto update = [](OrderBook& book, BookSide side, const std::pair<double, double>& level) {
+            return book.update(side, level.first, level.second);
+        };
+        size_t touched = std::min(apply_levels(book_, BookSide::BID, diff.bids, update),
+                                  apply_levels(book_, BookSide::ASK, diff.asks, update));
+        last_update_id_ = diff.final_update_id;
+        return within_watch(touched, watch_depth) ? BookSyncStatus::UPDATED : BookSyncStatus::UNCHANGED;
+    }
+
+    BookSyncStatus lose_sync() {
+        sequence_gaps_++;
+        synced_ = false;
+        snapshot_requested_ = false;
+        return BookSyncStatus::RESYNC;
+    }
+
+    OrderBook book_;
+    std::deque<DepthDiff> buffered_;
+    int64_t last_update_id_ = 0;
+    bool synced_ = false;
+    bool bridging_ = false;
+    bool snapshot_requested_ = false;
+    uint64_t sequence_gaps_ = 0;
+};
+
+} // namespace core
+} // namespace trading
@@ -0,0 +1,796 @@
+/**
+ * @file shm_ring.h
+ * @brief 共享内存环形缓冲区（同机 IPC 的低延迟替代通道）
+ *
+ * 功能：
+ * 1. ShmBroadcastRing: 单写者、多读者广播环（行情）
+ *    - 每个读者持有独立游标，互不影响
+ *    - 写者从不等待读者：慢读者被覆盖时通过 seqlock 检测并跳过（计入丢失）
+ * 2. ShmMpscQueue: 多写者、单读者有界队列（订单）
+ *    - 基于槽位序号的无锁队列，写满时返回 false，由调用方回退到 ZMQ
+ *
+ * 原理说明：
+ * - 数据直接写入 /dev/shm 映射的内存，读者轮询写序号，不经过内核
+ * - 同机延迟约 1-5μs（ipc:// 为 30-100μs）
+ * - 帧内容与 ZMQ 通道一致（topic|payload），上层解析逻辑无需区分
+ *
+ * 注意：
+ * - 只支持同机进程，跨机仍需使用 ZMQ
+ * - 订单队列的写者在占用槽位后、提交前崩溃会留下未提交的槽位：读者等待
+ *   shm_slot_timeout_ns() 后跳过该槽位，避免阻塞其他策略的订单
+ * - 服务端异常退出不会设置 closed：服务端定期写心跳（heartbeat_ns），
+ *   策略端通过 writer_alive() 检测心跳超时，超时后回退到 ZMQ
+ * - 读者需要轮询，不适合阻塞等待（策略主循环本身就是轮询）
+ *
+ * @author Sequence Team
+ * @date 2025-12
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace trading {
+namespace server {
+
+// ============================================================
+// 共享内存名称
+// ============================================================
+
+/**
+ * @brief 共享内存通道名称（/dev/shm 下）
+ */
+struct ShmAddresses {
+    // 行情广播环：服务端写，策略端读（对应 IpcAddresses::MARKET_DATA）
+    static constexpr const char* MARKET_DATA = "/seq_md_ring";
+
+    // 订单队列：策略端写，服务端读（对应 IpcAddresses::ORDER）
+    static constexpr const char* ORDER = "/seq_order_ring";
+};
+
+// 共享内存头部 magic / 版本
+constexpr uint32_t SHM_RING_MAGIC = 0x53514D52;  // "RMQS"
+constexpr uint32_t SHM_RING_VERSION = 2;
+
+// 服务端心跳间隔；策略端超过超时时间未见心跳即认为服务端已退出
+constexpr int64_t SHM_HEARTBEAT_INTERVAL_NS = 100'000'000;     // 100ms
+constexpr int64_t SHM_DEFAULT_STALE_TIMEOUT_NS = 3'000'000'000; // 3s
+
+/**
+ * @brief 心跳时钟（CLOCK_MONOTONIC，同机进程之间可比较）
+ */
+inline int64_t shm_clock_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 订单队列槽位占用后未提交的超时（写者在两步之间退出）
+constexpr int64_t SHM_DEFAULT_SLOT_TIMEOUT_NS = 1'000'000'000;  // 1s
+
+/**
+ * @brief 心跳超时（环境变量 SEQ_SHM_STALE_MS 覆盖，默认 3000ms）
+ */
+inline int64_t shm_stale_timeout_ns() {
+    static const int64_t timeout = [] {
+        const char* v = std::getenv("SEQ_SHM_STALE_MS");
+        long ms = v ? std::atol(v) : 0;
+        return ms > 0 ? static_cast<int64_t>(ms) * 1'000'000 : SHM_DEFAULT_STALE_TIMEOUT_NS;
+    }();
+    return timeout;
+}
+
+/**
+ * @brief 未提交槽位超时（环境变量 SEQ_SHM_SLOT_TIMEOUT_MS 覆盖，默认 1000ms）
+ */
+inline int64_t shm_slot_timeout_ns() {
+    static const int64_t timeout = [] {
+        const char* v = std::getenv("SEQ_SHM_SLOT_TIMEOUT_MS");
+        long ms = v ? std::atol(v) : 0;
+        return ms > 0 ? static_cast<int64_t>(ms) * 1'000'000 : SHM_DEFAULT_SLOT_TIMEOUT_NS;
+    }();
+    return timeout;
+}
+
+// ============================================================
+// 共享内存区域（RAII）
+// ============================================================
+
+/**
+ * @brief POSIX 共享内存映射
+ *
+ * 服务端 create()（先删除旧区域再创建），策略端 attach()
+ */
+class ShmRegion {
+public:
+    ShmRegion() = default;
+    ~ShmRegion() { close(); }
+
+    ShmRegion(const ShmRegion&) = delete;
+    ShmRegion& operator=(const ShmRegion&) = delete;
+
+    /**
+     * @brief 创建共享内存（已存在则先删除）
+     */
+    bool create(const std::string& name, size_t size) {
+        close();
+        shm_unlink(name.c_str());
+
+        int fd = shm_open(name.c_str(), O_CREAT | O_RDWR | O_EXCL, 0666);
+        if (fd < 0) {
+            std::cerr << "[ShmRing] 创建共享内存失败: " << name << " (" << std::strerror(errno) << ")\n";
+            return false;
+        }
+        if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            std::cerr << "[ShmRing] 设置共享内存大小失败: " << name << "\n";
+            ::close(fd);
+            shm_unlink(name.c_str());
+            return false;
+        }
+        if (!map(fd, size)) {
+            shm_unlink(name.c_str());
+            return false;
+        }
+        name_ = name;
+        owner_ = true;
+        return true;
+    }
+
+    /**
+     * @brief 连接已存在的共享内存
+     */
+    bool attach(const std::string& name) {
+        close();
+
+        int fd = shm_open(name.c_str(), O_RDWR, 0666);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+            ::close(fd);
+            return false;
+        }
+        if (!map(fd, static_cast<size_t>(st.st_size))) {
+            return false;
+        }
+        name_ = name;
+        owner_ = false;
+        return true;
+    }
+
+    /**
+     * @brief 解除映射（创建者同时删除共享内存）
+     */
+    void close() {
+        if (addr_) {
+            munmap(addr_, size_);
+            addr_ = nullptr;
+            size_ = 0;
+        }
+        if (owner_ && !name_.empty()) {
+            shm_unlink(name_.c_str());
+        }
+        owner_ = false;
+        name_.clear();
+    }
+
+    void* data() const { return addr_; }
+    size_t size() const { return size_; }
+    bool valid() const { return addr_ != nullptr; }
+
+private:
+    bool map(int fd, size_t size) {
+        void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);  // 映射建立后 fd 不再需要
+        if (addr == MAP_FAILED) {
+            std::cerr << "[ShmRing] mmap 失败: " << std::strerror(errno) << "\n";
+            return false;
+        }
+        addr_ = addr;
+        size_ = size;
+        return true;
+    }
+
+    void* addr_ = nullptr;
+    size_t size_ = 0;
+    std::string name_;
+    bool owner_ = false;
+};
+
+// ============================================================
+// 广播环（单写者、多读者）
+// ============================================================
+
+/**
+ * @brief 单写者多读者广播环
+ *
+ * 内存布局: [RingHeader][Slot * capacity]
+ *
+ * 一条记录占用 1..N 个连续槽位（超过单槽容量的帧跨槽存放），
+ * 续槽的 span 写为 0，读者被覆盖后重新定位时据此跳到下一条记录的首槽。
+ * 每个槽位有独立的 seqlock 序号：
+ *   - 写入中: seq = 2 * pos + 1
+ *   - 写入完成: seq = 2 * pos + 2
+ * 读者拷贝前后各读一次 seq，不一致或不等于期望值说明被覆盖。
+ */
+class ShmBroadcastRing {
+public:
+    static constexpr size_t SLOT_SIZE = 1024;  // 单槽大小（含槽头）
+
+    struct alignas(64) RingHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t capacity;                  // 槽位数量（2 的幂）
+        uint64_t slot_size;
+        std::atomic<uint32_t> closed;       // 服务端停止时置 1
+        uint32_t reserved;
+        std::atomic<int64_t> heartbeat_ns;  // 服务端心跳（shm_clock_ns）
+        char pad0[64 - 40];
+        alignas(64) std::atomic<uint64_t> write_pos;  // 下一个写入位置（槽位序号，单调递增）
+    };
+
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> seq;          // seqlock 序号
+        uint32_t size;                      // 记录总字节数（仅首槽有效）
+        uint32_t span;                      // 记录占用槽位数（首槽 >= 1，续槽为 0）
+        char data[SLOT_SIZE - 16];
+    };
+
+    static constexpr size_t SLOT_PAYLOAD = sizeof(Slot::data);
+
+    static_assert(sizeof(Slot) == SLOT_SIZE, "Slot 大小必须等于 SLOT_SIZE");
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "跨进程需要无锁原子");
+
+    /**
+     * @brief 计算共享内存大小
+     */
+    static size_t region_size(size_t capacity) {
+        return sizeof(RingHeader) + capacity * sizeof(Slot);
+    }
+
+    /**
+     * @brief 服务端创建广播环
+     * @param name 共享内存名称
+     * @param capacity 槽位数量（向上取整为 2 的幂）
+     */
+    bool create(const std::string& name, size_t capacity) {
+        capacity = round_up_pow2(capacity);
+        if (!region_.create(name, region_size(capacity))) {
+            return false;
+        }
+        header_ = static_cast<RingHeader*>(region_.data());
+        slots_ = reinterpret_cast<Slot*>(static_cast<char*>(region_.data()) + sizeof(RingHeader));
+
+        // 新建的共享内存已被内核清零，只需填写头部
+        header_->capacity = capacity;
+        header_->slot_size = SLOT_SIZE;
+        header_->closed.store(0, std::memory_order_relaxed);
+        header_->heartbeat_ns.store(shm_clock_ns(), std::memory_order_relaxed);
+        header_->write_pos.store(0, std::memory_order_relaxed);
+        header_->version = SHM_RING_VERSION;
+        std::atomic_thread_fence(std::memory_order_release);
+        header_->magic = SHM_RING_MAGIC;
+
+        mask_ = capacity - 1;
+        return true;
+    }
+
+    /**
+     * @brief 策略端连接广播环
+     */
+    bool attach(const std::string& name) {
+        if (!region_.attach(name)) {
+            return false;
+        }
+        header_ = static_cast<RingHeader*>(region_.data());
+        if (region_.size() < sizeof(RingHeader) ||
+            header_->magic != SHM_RING_MAGIC || header_->version != SHM_RING_VERSION ||
+            header_->slot_size != SLOT_SIZE ||
+            region_.size() < region_size(header_->capacity)) {
+            std::cerr << "[ShmRing] 共享内存格式不匹配: " << name << "\n";
+            region_.close();
+            header_ = nullptr;
+            return false;
+        }
+        slots_ = reinterpret_cast<Slot*>(static_cast<char*>(region_.data()) + sizeof(RingHeader));
+        mask_ = header_->capacity - 1;
+        return true;
+    }
+
+    /**
+     * @brief 标记关闭并释放（服务端停止时调用）
+     */
+    void close() {
+        if (header_ && header_->magic == SHM_RING_MAGIC) {
+            header_->closed.store(1, std::memory_order_release);
+        }
+        header_ = nullptr;
+        slots_ = nullptr;
+        region_.close();
+    }
+
+    bool valid() const { return header_ != nullptr; }
+    bool closed() const { return !header_ || header_->closed.load(std::memory_order_acquire) != 0; }
+    uint64_t capacity() const { return header_ ? header_->capacity : 0; }
+
+    /**
+     * @brief 服务端心跳（定期调用，间隔远小于 shm_stale_timeout_ns()）
+     */
+    void heartbeat(int64_t now_ns = shm_clock_ns()) {
+        if (header_) header_->heartbeat_ns.store(now_ns, std::memory_order_release);
+    }
+
+    /**
+     * @brief 服务端仍在运行（未关闭且心跳未超时）
+     *
+     * 服务端崩溃或被 kill 时不会设置 closed，只能通过心跳超时发现；
+     * 服务端重启会重建共享内存，旧映射的心跳同样停止更新。
+     */
+    bool writer_alive(int64_t timeout_ns = shm_stale_timeout_ns()) const {
+        if (closed()) return false;
+        return shm_clock_ns() - header_->heartbeat_ns.load(std::memory_order_acquire) < timeout_ns;
+    }
+
+    uint64_t write_pos() const {
+        return header_->write_pos.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief 写入一条记录（仅限单写者，多线程写需外部加锁）
+     *
+     * @return false 记录超过环容量的一半（不写入）
+     */
+    bool write(const char* data, size_t size) {
+        if (!header_) return false;
+
+        uint64_t span = size == 0 ? 1 : (size + SLOT_PAYLOAD - 1) / SLOT_PAYLOAD;
+        if (span > header_->capacity / 2) {
+            return false;
+        }
+
+        uint64_t pos = header_->write_pos.load(std::memory_order_relaxed);
+        size_t offset = 0;
+        for (uint64_t i = 0; i < span; ++i) {
+            Slot& slot = slots_[(pos + i) & mask_];
+            slot.seq.store(2 * (pos + i) + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            // 续槽清除旧的首槽信息，避免读者重新定位后把它当作一条记录
+            slot.size = i == 0 ? static_cast<uint32_t>(size) : 0;
+            slot.span = i == 0 ? static_cast<uint32_t>(span) : 0;
+            size_t n = std::min(SLOT_PAYLOAD, size - offset);
+            std::memcpy(slot.data, data + offset, n);
+            offset += n;
+
+            slot.seq.store(2 * (pos + i) + 2, std::memory_order_release);
+        }
+
+        header_->write_pos.store(pos + span, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief 读取结果
+     */
+    enum class ReadResult {
+        OK,          // 读取成功
+        EMPTY,       // 没有新数据
+        OVERRUN,     // 读者落后被覆盖（游标已前移，调用方可继续读）
+    };
+
+    /**
+     * @brief 从指定游标读取一条记录
+     *
+     * @param cursor 读者游标（成功或覆盖时前移）
+     * @param out 输出数据
+     * @param lost 被覆盖跳过的槽位数（累加）
+     */
+    ReadResult read(uint64_t& cursor, std::string& out, uint64_t& lost) const {
+        uint64_t wpos = header_->write_pos.load(std::memory_order_acquire);
+        if (cursor >= wpos) {
+            return ReadResult::EMPTY;
+        }
+
+        // 落后超过整个环：直接跳到最老的可用位置
+        if (wpos - cursor > header_->capacity) {
+            uint64_t next = wpos - header_->capacity;
+            lost += next - cursor;
+            cursor = next;
+            return ReadResult::OVERRUN;
+        }
+
+        const Slot& first = slots_[cursor & mask_];
+        uint64_t expected = 2 * cursor + 2;
+        uint64_t seq_before = first.seq.load(std::memory_order_acquire);
+        if (seq_before != expected) {
+            // 写入中（写者正在覆盖）或已被覆盖
+            if (seq_before > expected) {
+                lost += 1;
+                cursor += 1;
+                return ReadResult::OVERRUN;
+            }
+            return ReadResult::EMPTY;
+        }
+
+        uint32_t size = first.size;
+        uint32_t span = first.span;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (first.seq.load(std::memory_order_relaxed) != expected) {
+            lost += 1;
+            cursor += 1;
+            return ReadResult::OVERRUN;
+        }
+        if (span == 0) {
+            // 游标落在跨槽记录的续槽上（覆盖跳过后重新定位），跳到下一条记录的首槽
+            lost += 1;
+            cursor += 1;
+            return ReadResult::OVERRUN;
+        }
+        if (span > header_->capacity / 2 || size > static_cast<uint64_t>(span) * SLOT_PAYLOAD) {
+            lost += 1;
+            cursor += 1;
+            return ReadResult::OVERRUN;
+        }
+
+        out.resize(size);
+        size_t offset = 0;
+        for (uint32_t i = 0; i < span; ++i) {
+            const Slot& slot = slots_[(cursor + i) & mask_];
+            uint64_t slot_expected = 2 * (cursor + i) + 2;
+            if (slot.seq.load(std::memory_order_acquire) != slot_expected) {
+                lost += span;
+                cursor += span;
+                return ReadResult::OVERRUN;
+            }
+            size_t n = std::min<size_t>(SLOT_PAYLOAD, size - offset);
+            std::memcpy(&out[offset], slot.data, n);
+            offset += n;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.seq.load(std::memory_order_relaxed) != slot_expected) {
+                lost += span;
+                cursor += span;
+                return ReadResult::OVERRUN;
+            }
+        }
+
+        cursor += span;
+        return ReadResult::OK;
+    }
+
+private:
+    static size_t round_up_pow2(size_t v) {
+        size_t p = 2;
+        while (p < v) p <<= 1;
+        return p;
+    }
+
+    ShmRegion region_;
+    RingHeader* header_ = nullptr;
+    Slot* slots_ = nullptr;
+    uint64_t mask_ = 0;
+};
+
+/**
+ * @brief 广播环读者（每个读者独立游标）
+ */
+class ShmBroadcastReader {
+public:
+    /**
+     * @brief 连接广播环，游标从当前写位置开始（不回放历史）
+     */
+    bool attach(const std::string& name) {
+        if (!ring_.attach(name)) {
+            return false;
+        }
+        cursor_ = ring_.write_pos();
+        lost_ = 0;
+        return true;
+    }
+
+    void detach() { ring_.close(); }
+
+    bool valid() const { return ring_.valid(); }
+
+    /**
+     * @brief 写者已关闭（服务端停止或重启）
+     */
+    bool closed() const { return ring_.closed(); }
+
+    /**
+     * @brief 写者仍在运行（见 ShmBroadcastRing::writer_alive）
+     */
+    bool writer_alive() const { return ring_.writer_alive(); }
+
+    /**
+     * @brief 非阻塞读取一条记录
+     * @return true 读到数据
+     */
+    bool read(std::string& out) {
+        if (!ring_.valid()) return false;
+        while (true) {
+            auto result = ring_.read(cursor_, out, lost_);
+            if (result == ShmBroadcastRing::ReadResult::OK) return true;
+            if (result == ShmBroadcastRing::ReadResult::EMPTY) return false;
+            // OVERRUN: 游标已前移，继续读
+        }
+    }
+
+    /**
+     * @brief 因读取过慢被覆盖丢失的槽位数
+     */
+    uint64_t lost_count() const { return lost_; }
+
+private:
+    ShmBroadcastRing ring_;
+    uint64_t cursor_ = 0;
+    uint64_t lost_ = 0;
+};
+
+// ============================================================
+// 多写者单读者队列（订单）
+// ============================================================
+
+/**
+ * @brief 多写者单读者有界队列
+ *
+ * 内存布局: [QueueHeader][Cell * capacity]
+ *
+ * 槽位序号协议（Vyukov 有界队列）：
+ *   - cell.seq == pos       : 空闲，可被位置 pos 的写者占用
+ *   - cell.seq == pos + 1   : 已写入，可被读者读取
+ *   - 读取后 cell.seq = pos + capacity，留给下一轮写者
+ * 写满时 try_push 返回 false，不覆盖（订单不能丢）
+ *
+ * 写者占用槽位（CAS tail）与提交（seq = pos + 1）是两步：写者在两步之间退出时，
+ * 读者在 shm_slot_timeout_ns() 后把该槽位 CAS 为 pos + capacity 跳过；
+ * 写者提交同样使用 CAS，槽位已被跳过时 try_push 返回 false，消息不会既丢又报成功。
+ *
+ * 同一策略的订单只能走一条通道：try_push 失败后调用方应改为一直使用 ZMQ，
+ * 服务端在共享内存队列排空之前不处理 ZMQ 订单（见 ZmqServer::recv_order）。
+ */
+class ShmMpscQueue {
+public:
+    static constexpr size_t CELL_SIZE = 4096;  // 单个订单消息上限（含槽头）
+
+    struct alignas(64) QueueHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t capacity;
+        uint64_t cell_size;
+        std::atomic<uint32_t> closed;
+        uint32_t reserved;
+        std::atomic<int64_t> heartbeat_ns;  // 服务端（读者）心跳
+        char pad0[64 - 40];
+        alignas(64) std::atomic<uint64_t> tail;   // 写者位置
+        alignas(64) std::atomic<uint64_t> head;   // 读者位置
+    };
+
+    struct alignas(64) Cell {
+        std::atomic<uint64_t> seq;
+        uint32_t size;
+        uint32_t reserved;
+        char data[CELL_SIZE - 16];
+    };
+
+    static constexpr size_t CELL_PAYLOAD = sizeof(Cell::data);
+
+    static_assert(sizeof(Cell) == CELL_SIZE, "Cell 大小必须等于 CELL_SIZE");
+
+    static size_t region_size(size_t capacity) {
+        return sizeof(QueueHeader) + capacity * sizeof(Cell);
+    }
+
+    /**
+     * @brief 服务端创建队列
+     */
+    bool create(const std::string& name, size_t capacity) {
+        size_t cap = 2;
+        while (cap < capacity) cap <<= 1;
+        if (!region_.create(name, region_size(cap))) {
+            return false;
+        }
+        header_ = static_cast<QueueHeader*>(region_.data());
+        cells_ = reinterpret_cast<Cell*>(static_cast<char*>(region_.data()) + sizeof(QueueHeader));
+
+        header_->capacity = cap;
+        header_->cell_size = CELL_SIZE;
+        header_->closed.store(0, std::memory_order_relaxed);
+        header_->heartbeat_ns.store(shm_clock_ns(), std::memory_order_relaxed);
+        header_->tail.store(0, std::memory_order_relaxed);
+        header_->head.store(0, std::memory_order_relaxed);
+        for (size_t i = 0; i < cap; ++i) {
+            cells_[i].seq.store(i, std::memory_order_relaxed);
+        }
+        header_->version = SHM_RING_VERSION;
+        std::atomic_thread_fence(std::memory_order_release);
+        header_->magic = SHM_RING_MAGIC;
+
+        mask_ = cap - 1;
+        return true;
+    }
+
+    /**
+     * @brief 策略端连接队列
+     */
+    bool attach(const std::string& name) {
+        if (!region_.attach(name)) {
+            return false;
+        }
+        header_ = static_cast<QueueHeader*>(region_.data());
+        if (region_.size() < sizeof(QueueHeader) ||
+            header_->magic != SHM_RING_MAGIC || header_->version != SHM_RING_VERSION ||
+            header_->cell_size != CELL_SIZE ||
+            region_.size() < region_size(header_->capacity)) {
+            std::cerr << "[ShmRing] 订单队列格式不匹配: " << name << "\n";
+            region_.close();
+            header_ = nullptr;
+            return false;
+        }
+        cells_ = reinterpret_cast<Cell*>(static_cast<char*>(region_.data()) + sizeof(QueueHeader));
+        mask_ = header_->capacity - 1;
+        return true;
+    }
+
+    void close() {
+        if (header_ && header_->magic == SHM_RING_MAGIC) {
+            header_->closed.store(1, std::memory_order_release);
+        }
+        header_ = nullptr;
+        cells_ = nullptr;
+        region_.close();
+    }
+
+    bool valid() const { return header_ != nullptr; }
+    bool closed() const { return !header_ || header_->closed.load(std::memory_order_acquire) != 0; }
+
+    /**
+     * @brief 服务端心跳（定期调用，间隔远小于 shm_stale_timeout_ns()）
+     */
+    void heartbeat(int64_t now_ns = shm_clock_ns()) {
+        if (header_) header_->heartbeat_ns.store(now_ns, std::memory_order_release);
+    }
+
+    /**
+     * @brief 服务端（读者）仍在运行（未关闭且心跳未超时）
+     *
+     * 服务端崩溃或被 kill 时不会设置 closed，只能通过心跳超时发现；
+     * 服务端重启会重建共享内存，旧映射的心跳同样停止更新。
+     */
+    bool consumer_alive(int64_t timeout_ns = shm_stale_timeout_ns()) const {
+        if (closed()) return false;
+        return shm_clock_ns() - header_->heartbeat_ns.load(std::memory_order_acquire) < timeout_ns;
+    }
+
+    /**
+     * @brief 写入一条消息（多写者安全）
+     *
+     * 失败一次后本进程不再写入（disable_push），同一进程内所有调用方一起回退
+     *
+     * @return false 队列已满、消息过大、槽位被跳过或队列已关闭，调用方应回退到 ZMQ
+     */
+    bool try_push(const char* data, size_t size) {
+        if (!push_one(data, size)) {
+            disable_push();
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief 本进程停止写入（之后 try_push 一律返回 false）
+     */
+    void disable_push() { push_disabled_.store(true, std::memory_order_relaxed); }
+    bool push_disabled() const { return push_disabled_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 读取一条消息（仅限单读者）
+     * @return true 读到数据
+     */
+    bool try_pop(std::string& out) {
+        if (!header_) return false;
+
+        while (true) {
+            uint64_t pos = header_->head.load(std::memory_order_relaxed);
+            Cell& cell = cells_[pos & mask_];
+            uint64_t seq = cell.seq.load(std::memory_order_acquire);
+            if (seq == pos + 1) {
+                out.assign(cell.data, std::min<size_t>(cell.size, CELL_PAYLOAD));
+                cell.seq.store(pos + header_->capacity, std::memory_order_release);
+                header_->head.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+            if (seq != pos || header_->tail.load(std::memory_order_acquire) <= pos) {
+                return false;  // 空
+            }
+
+            // 槽位已被占用但未提交：写者正在写入，或已在两步之间退出
+            int64_t now = shm_clock_ns();
+            if (stalled_pos_ != pos) {
+                stalled_pos_ = pos;
+                stalled_since_ns_ = now;
+                return false;
+            }
+            if (now - stalled_since_ns_ < shm_slot_timeout_ns()) {
+                return false;
+            }
+            uint64_t expected = pos;
+            if (!cell.seq.compare_exchange_strong(expected, pos + header_->capacity,
+                                                  std::memory_order_acq_rel)) {
+                continue;  // 写者恰好提交
+            }
+            header_->head.store(pos + 1, std::memory_order_release);
+            skipped_++;
+            std::cerr << "[ShmRing] 订单队列槽位 " << pos << " 占用后 "
+                      << (now - stalled_since_ns_) / 1'000'000 << "ms 未提交（写者可能已退出），跳过\n";
+        }
+    }
+
+    /**
+     * @brief 队列中是否还有已占用的槽位（含未提交的），仅限读者调用
+     */
+    bool has_pending() const {
+        return header_ && header_->tail.load(std::memory_order_acquire) !=
+                              header_->head.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 因写者超时未提交而跳过的槽位数
+     */
+    uint64_t skipped_count() const { return skipped_; }
+
+private:
+    bool push_one(const char* data, size_t size) {
+        if (!header_ || size > CELL_PAYLOAD || closed() || push_disabled()) {
+            return false;
+        }
+
+        uint64_t pos = header_->tail.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells_[pos & mask_];
+            uint64_t seq = cell->seq.load(std::memory_order_acquire);
+            int64_t diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos);
+            if (diff == 0) {
+                if (header_->tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;  // 队列已满
+            } else {
+                pos = header_->tail.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->size = static_cast<uint32_t>(size);
+        std::memcpy(cell->data, data, size);
+        uint64_t expected = pos;
+        // 失败说明读者已判定超时并跳过该槽位
+        return cell->seq.compare_exchange_strong(expected, pos + 1, std::memory_order_release,
+                                                 std::memory_order_relaxed);
+    }
+
+    ShmRegion region_;
+    QueueHeader* header_ = nullptr;
+    Cell* cells_ = nullptr;
+    uint64_t mask_ = 0;
+    std::atomic<bool> push_disabled_{false};  // 写者侧（本进程）
+
+    // 读者侧：未提交槽位的等待起点
+    uint64_t stalled_pos_ = UINT64_MAX;
+    int64_t stalled_since_ns_ = 0;
+    uint64_t skipped_ = 0;
+};
+
+} // namespace server
+} // namespace trading
@@ -118,7 +118,7 @@ void WebSocketServer::send_response(int client_id, bool success, const std::stri
 
     {
         std::lock_guard<std::mutex> lock(message_queue_mutex_);
-        message_queue_.push({client_id, response});
+        message_queue_.push({client_id, response, {}});
     }
     message_queue_cv_.notify_one();
 }
@@ -135,7 +135,30 @@ void WebSocketServer::send_event(const std::string& event_type, const nlohmann::
 
     {
         std::lock_guard<std::mutex> lock(message_queue_mutex_);
-        message_queue_.push({-1, event});
+        message_queue_.push({-1, event, {}});
+    }
+    message_queue_cv_.notify_one();
+}
+
+void WebSocketServer::send_event_raw(const std::string& event_type, std::string_view data_json) {
+    int64_t timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()
+    ).count();
+
+    // 与 send_event 生成的结构一致: {"type":"event","event_type":...,"timestamp":...,"data":...}
+    PendingMessage pending{-1, nullptr, {}};
+    pending.raw.reserve(data_json.size() + event_type.size() + 80);
+    pending.raw += "{\"type\":\"event\",\"event_type\":";
+    pending.raw += nlohmann::json(event_type).dump();
+    pending.raw += ",\"timestamp\":";
+    pending.raw += std::to_string(timestamp);
+    pending.raw += ",\"data\":";
+    pending.raw.append(data_json.data(), data_json.size());
+    pending.raw += '}';
+
+    {
+        std::lock_guard<std::mutex> lock(message_queue_mutex_);
+        message_queue_.push(std::move(pending));
     }
     message_queue_cv_.notify_one();
 }
@@ -169,7 +192,7 @@ void WebSocketServer::send_log(const std::string& level, const std::string& sour
 
     {
         std::lock_guard<std::mutex> lock(message_queue_mutex_);
-        message_queue_.push({-1, log_msg});
+        message_queue_.push({-1, log_msg, {}});
     }
     message_queue_cv_.notify_one();
 }
@@ -270,7 +293,7 @@ void WebSocketServer::snapshot_thread_func() {
 
                 {
                     std::lock_guard<std::mutex> lock(message_queue_mutex_);
-                    message_queue_.push({-1, message});
+                    message_queue_.push({-1, message, {}});
                 }
                 message_queue_cv_.notify_one();
 
@@ -293,12 +316,14 @@ void WebSocketServer::process_message_queue() {
     });
 
     while (!message_queue_.empty()) {
-        PendingMessage msg = message_queue_.front();
+        PendingMessage msg = std::move(message_queue_.front());
         message_queue_.pop();
 
         lock.unlock();
 
-        if (msg.client_id == -1) {
+        if (!msg.raw.empty()) {
+            broadcast_raw_internal(msg.raw);
+        } else if (msg.client_id == -1) {
             broadcast_internal(msg.message);
         } else {
             send_to_client_internal(msg.client_id, msg.message);
@@ -361,6 +386,26 @@ void WebSocketServer::broadcast_internal(const nlohmann::json& message) {
 #endif
 }
 
+void WebSocketServer::broadcast_raw_internal(const std::string& msg_str) {
+    std::lock_guard<std::mutex> lock(clients_mutex_);
+
+#ifdef USE_WEBSOCKETPP
+    for (auto& [id, hdl] : clients_) {
+        try {
+            server_impl_->send(hdl, msg_str, websocketpp::frame::opcode::text);
+        } catch (const std::exception& e) {
+            std::cerr << "[WebSocketServer] 广播失败: " << e.what() << std::endl;
+        }
+    }
+#else
+    if (msg_str.length() > 100) {
+        std::cout << "[WebSocketServer] 广播消息: " << msg_str.substr(0, 100) << "..." << std::endl;
+    } else {
+        std::cout << "[WebSocketServer] 广播消息: " << msg_str << std::endl;
+    }
+#endif
+}
+
 void WebSocketServer::send_to_client_internal(int client_id, const nlohmann::json& message) {
     std::lock_guard<std::mutex> lock(clients_mutex_);
 
@@ -2,6 +2,7 @@
 
 #include <functional>
 #include <string>
+#include <string_view>
 #include <map>
 #include <mutex>
 #include <thread>
@@ -44,18 +45,22 @@ public:
 
     void send_response(int client_id, bool success, const std::string& message, const nlohmann::json& data = {});
     void send_event(const std::string& event_type, const nlohmann::json& data);
+    // data_json 为已序列化的 JSON，直接拼接进事件外壳，避免 JSON 树拷贝和重复 dump
+    void send_event_raw(const std::string& event_type, std::string_view data_json);
     void send_log(const std::string& level, const std::string& source, const std::string& message);
 
 private:
     struct PendingMessage {
         int client_id;
         nlohmann::json message;
+        std::string raw;        // 非空时直接发送（已序列化）
     };
 
     void server_thread_func();
     void snapshot_thread_func();
     void handle_client_message(int client_id, const std::string& message);
     void broadcast_internal(const nlohmann::json& message);
+    void broadcast_raw_internal(const std::string& msg_str);
     void send_to_client_internal(int client_id, const nlohmann::json& message);
     void process_message_queue();
 
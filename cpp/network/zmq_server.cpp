@@ -209,6 +209,22 @@ void ZmqServer::stop() {
         subscribe_pull_->close();
         subscribe_pull_.reset();
     }
+
+    // 关闭共享内存通道（读者会看到 closed 标志）
+    {
+        std::lock_guard<std::mutex> lock(market_mutex_);
+        if (shm_market_) {
+            shm_market_->close();
+            shm_market_.reset();
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(order_mutex_);
+        if (shm_order_) {
+            shm_order_->close();
+            shm_order_.reset();
+        }
+    }
     
     // 清理 IPC 文件
     std::string md_path = std::string(market_data_addr_).substr(6);
@@ -235,6 +251,33 @@ void ZmqServer::stop() {
               << ", 订阅: " << subscribe_count_ << "\n";
 }
 
+bool ZmqServer::enable_shm_transport(size_t market_slots, size_t order_slots) {
+    auto market_ring = std::make_unique<ShmBroadcastRing>();
+    if (!market_ring->create(ShmAddresses::MARKET_DATA, market_slots)) {
+        return false;
+    }
+
+    auto order_queue = std::make_unique<ShmMpscQueue>();
+    if (!order_queue->create(ShmAddresses::ORDER, order_slots)) {
+        market_ring->close();
+        return false;
+    }
+
+    std::cout << "[ZmqServer] 共享内存行情环: /dev/shm" << ShmAddresses::MARKET_DATA
+              << " (" << market_ring->capacity() << " 槽)\n";
+    std::cout << "[ZmqServer] 共享内存订单队列: /dev/shm" << ShmAddresses::ORDER << "\n";
+
+    {
+        std::lock_guard<std::mutex> lock(market_mutex_);
+        shm_market_ = std::move(market_ring);
+    }
+    {
+        std::lock_guard<std::mutex> lock(order_mutex_);
+        shm_order_ = std::move(order_queue);
+    }
+    return true;
+}
+
 // ============================================================
 // 行情发布
 // ============================================================
@@ -252,52 +295,113 @@ bool ZmqServer::publish_market(const nlohmann::json& data, MessageType msg_type)
         return false;
     }
 
+    // 构建主题: {exchange}.{type}.{symbol}[.{interval}]
+    std::string topic = build_market_topic(data, msg_type, data.value("exchange", "unknown"));
+
+    // 消息格式: topic|json_data 或 topic|binary
+    std::string msg;
+    build_market_frame(topic, data, msg);
+
     // 线程安全保护
     std::lock_guard<std::mutex> lock(market_mutex_);
+    write_shm_market(msg);
 
-    // 构建主题: {exchange}.{type}.{symbol}[.{interval}]
-    std::string exchange = data.value("exchange", "unknown");
-    std::string symbol = data.value("symbol", "");
-    std::string type_str;
+    if (send_message(*market_pub_, msg)) {
+        market_msg_count_++;
+        return true;
+    }
+    return false;
+}
 
-    switch (msg_type) {
-        case MessageType::TICKER: type_str = "ticker"; break;
-        case MessageType::DEPTH:  type_str = "depth"; break;
-        case MessageType::TRADE:  type_str = "trade"; break;
-        case MessageType::KLINE:  type_str = "kline"; break;
-        default: type_str = "unknown"; break;
+bool ZmqServer::publish_market_fanout(const nlohmann::json& data, MessageType msg_type,
+                                      uint32_t sinks) {
+    if (!running_.load()) {
+        return false;
     }
 
-    // 从 JSON 中获取 type 字段（更准确）
-    std::string json_type = data.value("type", "");
-    if (!json_type.empty()) {
-        type_str = json_type;
+    std::string exchange = data.value("exchange", "unknown");
+    zmq::socket_t* exchange_socket = nullptr;
+    if (sinks & SINK_EXCHANGE) {
+        if (exchange == "okx") {
+            exchange_socket = market_pub_okx_.get();
+        } else if (exchange == "binance") {
+            exchange_socket = market_pub_binance_.get();
+        }
     }
+    zmq::socket_t* unified_socket = (sinks & SINK_UNIFIED) ? market_pub_.get() : nullptr;
+
+    bool sent = false;
+    bool frontend_done = false;
+
+    if (unified_socket || exchange_socket) {
+        // 序列化一次：统一通道与交易所通道的主题相同（{exchange}.{type}.{symbol}[.{interval}]）
+        auto* frame = new SharedFrame();
+        build_market_frame(build_market_topic(data, msg_type, exchange), data, frame->bytes);
+        frame->payload_offset = frame->bytes.find('|') + 1;
+        frame->binary = wire::is_binary_frame(frame->bytes.data() + frame->payload_offset,
+                                              frame->bytes.size() - frame->payload_offset);
+
+        {
+            // 线程安全保护（两个 socket 在同一次加锁内发送）
+            std::lock_guard<std::mutex> lock(market_mutex_);
+            if (unified_socket) {
+                write_shm_market(frame->bytes);
+            }
+            if (unified_socket && send_shared(*unified_socket, frame)) {
+                market_msg_count_++;
+                sent = true;
+            }
+            if (exchange_socket && send_shared(*exchange_socket, frame)) {
+                market_msg_count_++;
+                sent = true;
+            }
+        }
 
-    std::string topic = exchange + "." + type_str + "." + symbol;
+        // 前端复用已序列化的 JSON
+        if ((sinks & SINK_FRONTEND) && frontend_sink_ && !frame->binary) {
+            std::string_view json(frame->bytes.data() + frame->payload_offset,
+                                  frame->bytes.size() - frame->payload_offset);
+            frontend_sink_(data.value("type", ""), json);
+            frontend_done = true;
+        }
 
-    // K线数据添加周期
-    if (msg_type == MessageType::KLINE || json_type == "kline") {
-        std::string interval = data.value("interval", "");
-        if (!interval.empty()) {
-            topic += "." + interval;
+        // 释放创建者持有的引用（ZMQ 仍持有的引用在发送完成后释放）
+        if (frame->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete frame;
         }
+        fanout_count_++;
     }
 
-    // 消息格式: topic|json_data
-    std::string msg = topic + "|" + data.dump();
-
-    if (send_message(*market_pub_, msg)) {
-        market_msg_count_++;
-        return true;
+    // 仅发往前端，或该类型使用二进制编码：前端需要单独的 JSON
+    if ((sinks & SINK_FRONTEND) && frontend_sink_ && !frontend_done) {
+        std::string json = data.dump();
+        frontend_sink_(data.value("type", ""), json);
+        if (!unified_socket && !exchange_socket) {
+            sent = true;
+        }
     }
-    return false;
+
+    return sent;
 }
 
 // ============================================================
 // 订单接收
 // ============================================================
 
+void ZmqServer::heartbeat_shm() {
+    int64_t now = shm_clock_ns();
+    if (now - last_shm_heartbeat_ns_ < SHM_HEARTBEAT_INTERVAL_NS) {
+        return;
+    }
+    last_shm_heartbeat_ns_ = now;
+    shm_order_->heartbeat(now);
+
+    std::lock_guard<std::mutex> lock(market_mutex_);
+    if (shm_market_) {
+        shm_market_->heartbeat(now);
+    }
+}
+
 bool ZmqServer::recv_order(std::string& order_msg) {
     if (!running_.load() || !order_pull_) {
         return false;
@@ -305,7 +409,40 @@ bool ZmqServer::recv_order(std::string& order_msg) {
 
     // 线程安全保护
     std::lock_guard<std::mutex> lock(order_mutex_);
-    return recv_message(*order_pull_, order_msg);
+
+    if (!shm_order_) {
+        return recv_message(*order_pull_, order_msg);
+    }
+
+    // 共享内存队列优先。策略 try_push 失败后改走 ZMQ，它之前写入共享内存的订单
+    // 一定已占用槽位，因此共享内存排空（含超时跳过未提交槽位）之前不交付 ZMQ 订单
+    heartbeat_shm();
+    if (shm_order_->try_pop(order_msg)) {
+        shm_order_count_++;
+        return true;
+    }
+    if (shm_order_->has_pending()) {
+        return false;  // 槽位已占用但未提交，等待写者提交或超时跳过
+    }
+    if (has_deferred_order_) {
+        has_deferred_order_ = false;
+        order_msg.swap(deferred_order_);
+        return true;
+    }
+    if (!recv_message(*order_pull_, order_msg)) {
+        return false;
+    }
+    if (shm_order_->has_pending()) {
+        // 检查之后又有共享内存订单写入：先交付它们，ZMQ 订单暂存
+        deferred_order_.swap(order_msg);
+        has_deferred_order_ = true;
+        if (shm_order_->try_pop(order_msg)) {
+            shm_order_count_++;
+            return true;
+        }
+        return false;
+    }
+    return true;
 }
 
 bool ZmqServer::recv_order_json(nlohmann::json& order) {
@@ -451,6 +588,38 @@ int ZmqServer::poll_subscriptions() {
     return count;
 }
 
+// ============================================================
+// 阻塞等待
+// ============================================================
+
+bool ZmqServer::wait_orders(int timeout_ms) {
+    if (shm_order_) {
+        bool pending;
+        {
+            std::lock_guard<std::mutex> lock(order_mutex_);
+            pending = shm_order_->has_pending() || has_deferred_order_;
+        }
+        if (pending) {
+            std::this_thread::sleep_for(std::chrono::microseconds(20));
+            return true;
+        }
+        if (wait_readable(order_pull_.get(), 0)) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(20));
+        return false;
+    }
+    return wait_readable(order_pull_.get(), timeout_ms);
+}
+
+bool ZmqServer::wait_queries(int timeout_ms) {
+    return wait_readable(query_rep_.get(), timeout_ms);
+}
+
+bool ZmqServer::wait_subscriptions(int timeout_ms) {
+    return wait_readable(subscribe_pull_.get(), timeout_ms);
+}
+
 // ============================================================
 // K线发布
 // ============================================================
@@ -464,8 +633,14 @@ bool ZmqServer::publish_with_topic(const std::string& topic, const nlohmann::jso
         return false;
     }
 
-    // 消息格式: topic|json_data
-    std::string msg = topic + "|" + data.dump();
+    // 消息格式: topic|json_data 或 topic|binary
+    std::string msg;
+    build_market_frame(topic, data, msg);
+
+    {
+        std::lock_guard<std::mutex> lock(market_mutex_);
+        write_shm_market(msg);
+    }
 
     if (send_message(*market_pub_, msg)) {
         market_msg_count_++;
@@ -483,57 +658,107 @@ bool ZmqServer::publish_okx_market(const nlohmann::json& data, MessageType msg_t
         return false;
     }
 
+    // 构建主题: okx.{type}.{symbol}[.{interval}]
+    std::string topic = build_market_topic(data, msg_type, "okx");
+
+    // 消息格式: topic|json_data 或 topic|binary
+    std::string msg;
+    build_market_frame(topic, data, msg);
+
     // 线程安全保护
     std::lock_guard<std::mutex> lock(market_mutex_);
 
-    // 构建主题: okx.{type}.{symbol}[.{interval}]
-    std::string symbol = data.value("symbol", "");
-    std::string type_str;
-
-    switch (msg_type) {
-        case MessageType::TICKER: type_str = "ticker"; break;
-        case MessageType::DEPTH:  type_str = "depth"; break;
-        case MessageType::TRADE:  type_str = "trade"; break;
-        case MessageType::KLINE:  type_str = "kline"; break;
-        default: type_str = "unknown"; break;
+    if (send_message(*market_pub_okx_, msg)) {
+        market_msg_count_++;
+        return true;
     }
+    return false;
+}
 
-    // 从 JSON 中获取 type 字段（更准确）
-    std::string json_type = data.value("type", "");
-    if (!json_type.empty()) {
-        type_str = json_type;
+bool ZmqServer::publish_binance_market(const nlohmann::json& data, MessageType msg_type) {
+    if (!running_.load() || !market_pub_binance_) {
+        return false;
     }
 
-    std::string topic = "okx." + type_str + "." + symbol;
+    // 构建主题: binance.{type}.{symbol}[.{interval}]
+    std::string topic = build_market_topic(data, msg_type, "binance");
 
-    // K线数据添加周期
-    if (msg_type == MessageType::KLINE || json_type == "kline") {
-        std::string interval = data.value("interval", "");
-        if (!interval.empty()) {
-            topic += "." + interval;
-        }
-    }
+    // 消息格式: topic|json_data 或 topic|binary
+    std::string msg;
+    build_market_frame(topic, data, msg);
 
-    // 消息格式: topic|json_data
-    std::string msg = topic + "|" + data.dump();
+    // 线程安全保护
+    std::lock_guard<std::mutex> lock(market_mutex_);
 
-    if (send_message(*market_pub_okx_, msg)) {
+    if (send_message(*market_pub_binance_, msg)) {
         market_msg_count_++;
         return true;
     }
     return false;
 }
 
-bool ZmqServer::publish_binance_market(const nlohmann::json& data, MessageType msg_type) {
-    if (!running_.load() || !market_pub_binance_) {
+// ============================================================
+// 行情编码
+// ============================================================
+
+bool ZmqServer::set_market_encoding(const std::string& msg_type, wire::WireEncoding encoding) {
+    wire::WireMsgType type = wire::wire_type_from_string(msg_type);
+    if (type == wire::WireMsgType::UNKNOWN) {
+        std::cerr << "[ZmqServer] 不支持二进制编码的行情类型: " << msg_type << "\n";
         return false;
     }
 
-    // 线程安全保护
-    std::lock_guard<std::mutex> lock(market_mutex_);
+    uint32_t bit = 1u << static_cast<uint32_t>(type);
+    if (encoding == wire::WireEncoding::BINARY) {
+        binary_channel_mask_.fetch_or(bit);
+    } else {
+        binary_channel_mask_.fetch_and(~bit);
+    }
 
-    // 构建主题: binance.{type}.{symbol}[.{interval}]
-    std::string symbol = data.value("symbol", "");
+    std::cout << "[ZmqServer] 行情编码: " << msg_type << " -> "
+              << (encoding == wire::WireEncoding::BINARY ? "BINARY" : "JSON") << "\n";
+    return true;
+}
+
+wire::WireEncoding ZmqServer::get_market_encoding(const std::string& msg_type) const {
+    wire::WireMsgType type = wire::wire_type_from_string(msg_type);
+    if (type == wire::WireMsgType::UNKNOWN) {
+        return wire::WireEncoding::JSON;
+    }
+    uint32_t bit = 1u << static_cast<uint32_t>(type);
+    return (binary_channel_mask_.load(std::memory_order_relaxed) & bit)
+        ? wire::WireEncoding::BINARY : wire::WireEncoding::JSON;
+}
+
+void ZmqServer::build_market_frame(const std::string& topic, const nlohmann::json& data,
+                                   std::string& frame) {
+    frame.reserve(topic.size() + 256);
+    frame.assign(topic);
+    frame.push_back('|');
+
+    uint32_t mask = binary_channel_mask_.load(std::memory_order_relaxed);
+    if (mask != 0) {
+        auto type_it = data.find("type");
+        if (type_it != data.end() && type_it->is_string()) {
+            uint32_t bit = 1u << static_cast<uint32_t>(
+                wire::wire_type_from_string(type_it->get_ref<const std::string&>()));
+            if ((mask & bit) && wire::encode_market_json(data, frame)) {
+                binary_msg_count_++;
+                return;
+            }
+        }
+    }
+
+    // 默认（或二进制编码失败时）使用 JSON
+    frame += data.dump();
+}
+
+// ============================================================
+// 私有辅助函数
+// ============================================================
+
+std::string ZmqServer::build_market_topic(const nlohmann::json& data, MessageType msg_type,
+                                          const std::string& exchange) {
     std::string type_str;
 
     switch (msg_type) {
@@ -550,29 +775,59 @@ bool ZmqServer::publish_binance_market(const nlohmann::json& data, MessageType m
         type_str = json_type;
     }
 
-    std::string topic = "binance." + type_str + "." + symbol;
+    std::string topic;
+    topic.reserve(64);
+    topic += exchange;
+    topic += '.';
+    topic += type_str;
+    topic += '.';
+    topic += data.value("symbol", "");
 
     // K线数据添加周期
     if (msg_type == MessageType::KLINE || json_type == "kline") {
         std::string interval = data.value("interval", "");
         if (!interval.empty()) {
-            topic += "." + interval;
+            topic += '.';
+            topic += interval;
         }
     }
 
-    // 消息格式: topic|json_data
-    std::string msg = topic + "|" + data.dump();
+    return topic;
+}
 
-    if (send_message(*market_pub_binance_, msg)) {
-        market_msg_count_++;
-        return true;
+/**
+ * @brief 共享帧释放函数（由 ZMQ 在消息销毁时调用，可能位于 I/O 线程）
+ */
+static void release_shared_frame(void* /*data*/, void* hint) {
+    auto* frame = static_cast<SharedFrame*>(hint);
+    if (frame->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        delete frame;
     }
-    return false;
 }
 
-// ============================================================
-// 私有辅助函数
-// ============================================================
+bool ZmqServer::send_shared(zmq::socket_t& socket, SharedFrame* frame) {
+    // 为本次发送增加一个引用，由 release_shared_frame 释放
+    frame->refs.fetch_add(1, std::memory_order_relaxed);
+
+    zmq::message_t message;
+    try {
+        message.rebuild(frame->bytes.data(), frame->bytes.size(), &release_shared_frame, frame);
+    } catch (const zmq::error_t& e) {
+        // 消息未创建，free 函数不会被调用，手动归还引用
+        frame->refs.fetch_sub(1, std::memory_order_acq_rel);
+        std::cerr << "[ZmqServer] 创建共享消息失败: " << e.what() << "\n";
+        return false;
+    }
+
+    try {
+        // 发送失败时 message 析构会调用 free 函数归还引用
+        auto result = socket.send(message, zmq::send_flags::none);
+        return result.has_value();
+    } catch (const zmq::error_t& e) {
+        std::cerr << "[ZmqServer] 发送失败: " << e.what() << "\n";
+        return false;
+    }
+}
 
 bool ZmqServer::send_message(zmq::socket_t& socket, const std::string& data) {
     try {
@@ -591,6 +846,22 @@ bool ZmqServer::send_message(zmq::socket_t& socket, const std::string& data) {
     }
 }
 
+bool ZmqServer::wait_readable(zmq::socket_t* socket, int timeout_ms) {
+    if (!running_.load() || !socket) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(timeout_ms));
+        return false;
+    }
+
+    try {
+        zmq::pollitem_t item = {socket->handle(), 0, ZMQ_POLLIN, 0};
+        int rc = zmq::poll(&item, 1, std::chrono::milliseconds(timeout_ms));
+        return rc > 0 && (item.revents & ZMQ_POLLIN);
+    } catch (const zmq::error_t&) {
+        // EINTR（信号）或 socket 已关闭
+        return false;
+    }
+}
+
 bool ZmqServer::recv_message(zmq::socket_t& socket, std::string& data) {
     try {
         zmq::message_t message;
@@ -20,6 +20,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <functional>
 #include <memory>
 #include <atomic>
@@ -28,6 +29,9 @@
 #include <zmq.hpp>
 #include <nlohmann/json.hpp>
 
+#include "market_wire_format.h"
+#include "shm_ring.h"
+
 namespace trading {
 namespace server {
 
@@ -88,6 +92,34 @@ enum class MessageType {
     ERROR = 100,         // 错误消息
 };
 
+/**
+ * @brief 行情发布目标（可按位组合）
+ *
+ * 用于 publish_market_fanout()：同一条行情只序列化一次，
+ * 然后按位分发到各个通道
+ */
+enum MarketSink : uint32_t {
+    SINK_UNIFIED = 1u << 0,    // 统一行情通道 (MARKET_DATA)
+    SINK_EXCHANGE = 1u << 1,   // 交易所专用通道（按 exchange 字段选择 OKX/Binance）
+    SINK_FRONTEND = 1u << 2,   // 前端 WebSocket（通过 set_frontend_sink 注册）
+    SINK_ZMQ = SINK_UNIFIED | SINK_EXCHANGE,
+    SINK_ALL = SINK_ZMQ | SINK_FRONTEND,
+};
+
+/**
+ * @brief 共享行情帧
+ *
+ * 序列化一次后在多个 PUB socket 间共享同一块内存：
+ * 每个 zmq::message_t 持有一个引用（零拷贝构造 + free 函数），
+ * ZMQ 发送完成后在 I/O 线程中释放引用，最后一个引用释放时回收内存
+ */
+struct SharedFrame {
+    std::string bytes;              // 完整帧: topic|payload
+    size_t payload_offset = 0;      // payload 起始位置（'|' 之后）
+    bool binary = false;            // payload 是否为二进制编码
+    std::atomic<int> refs{1};       // 引用计数（创建者持有 1）
+};
+
 // ============================================================
 // ZeroMQ 服务端类
 // ============================================================
@@ -126,6 +158,8 @@ public:
     using OrderCallback = std::function<void(const nlohmann::json& order)>;
     using QueryCallback = std::function<nlohmann::json(const nlohmann::json& request)>;
     using SubscribeCallback = std::function<void(const nlohmann::json& request)>;
+    // 前端行情回调: (事件类型, 已序列化的 JSON)
+    using FrontendSink = std::function<void(const std::string& event_type, std::string_view json)>;
     
     /**
      * @brief 构造函数
@@ -176,6 +210,25 @@ public:
      * @brief 检查是否运行中
      */
     bool is_running() const { return running_.load(); }
+
+    /**
+     * @brief 启用共享内存通道（同机低延迟替代 ipc://）
+     *
+     * 创建行情广播环与订单队列，ipc 通道保持不变：
+     * - 统一行情通道的每一帧同时写入广播环（内容相同：topic|payload）
+     * - recv_order() 优先从订单队列读取，队列排空后再读 ipc（同一策略的订单不跨通道乱序）
+     * 策略端通过 SEQ_SHM_TRANSPORT=1 选择从共享内存读写
+     *
+     * @param market_slots 行情环槽位数（每槽 1KB）
+     * @param order_slots 订单队列槽位数（每槽 4KB）
+     * @return true 创建成功
+     */
+    bool enable_shm_transport(size_t market_slots = 65536, size_t order_slots = 4096);
+
+    /**
+     * @brief 共享内存通道是否已启用
+     */
+    bool shm_enabled() const { return shm_market_ != nullptr; }
     
     // ========================================
     // 行情发布（服务端 -> 策略端）
@@ -324,6 +377,30 @@ public:
      * @return 处理的请求数量
      */
     int poll_subscriptions();
+
+    // ========================================
+    // 阻塞等待（配合 IdleStrategy::POLL）
+    // ========================================
+
+    /**
+     * @brief 阻塞等待订单通道可读
+     *
+     * 共享内存订单队列无法被 poll 唤醒，启用时只做非阻塞检查并短暂让出 CPU
+     *
+     * @param timeout_ms 超时（毫秒）
+     * @return true 有消息可读
+     */
+    bool wait_orders(int timeout_ms);
+
+    /**
+     * @brief 阻塞等待查询通道可读
+     */
+    bool wait_queries(int timeout_ms);
+
+    /**
+     * @brief 阻塞等待订阅通道可读
+     */
+    bool wait_subscriptions(int timeout_ms);
     
     /**
      * @brief 发布K线数据
@@ -352,6 +429,50 @@ public:
      * @brief 发布 Binance 行情数据到专用通道
      */
     bool publish_binance_market(const nlohmann::json& data, MessageType msg_type);
+
+    /**
+     * @brief 发布行情到多个目标（只序列化一次）
+     *
+     * 替代 publish_okx_market() + publish_ticker() + send_event() 的组合：
+     * - 主题只构建一次（统一通道与交易所通道主题相同）
+     * - 帧只编码一次，放入引用计数缓冲区，以零拷贝方式发送到各 socket
+     * - 前端直接复用已序列化的 JSON（二进制编码时才单独 dump 一次）
+     * - 两个 PUB socket 在同一次加锁内发送
+     *
+     * @param data 行情 JSON（需包含 type/exchange/symbol）
+     * @param msg_type 消息类型
+     * @param sinks 发布目标（MarketSink 按位组合）
+     * @return true 至少一个 ZMQ 通道发送成功（或仅发往前端）
+     */
+    bool publish_market_fanout(const nlohmann::json& data, MessageType msg_type,
+                               uint32_t sinks = SINK_ZMQ);
+
+    /**
+     * @brief 注册前端行情目标
+     *
+     * publish_market_fanout() 带 SINK_FRONTEND 时调用
+     */
+    void set_frontend_sink(FrontendSink sink) {
+        frontend_sink_ = std::move(sink);
+    }
+
+    /**
+     * @brief 设置某类行情的编码方式
+     *
+     * 默认全部为 JSON。切换为 BINARY 后，该类型的行情以定长结构发送
+     * （见 market_wire_format.h），策略端自动识别，无需额外配置。
+     * 可在运行中调用（原子位图，发布路径无锁读取）。
+     *
+     * @param msg_type 行情类型: "ticker"/"trade"/"kline"/"orderbook"/"funding_rate"
+     * @param encoding 编码方式
+     * @return false 类型不支持二进制编码
+     */
+    bool set_market_encoding(const std::string& msg_type, wire::WireEncoding encoding);
+
+    /**
+     * @brief 获取某类行情的编码方式
+     */
+    wire::WireEncoding get_market_encoding(const std::string& msg_type) const;
     
     // ========================================
     // 回报发布（服务端 -> 策略端）
@@ -395,6 +516,21 @@ public:
      */
     uint64_t get_report_msg_count() const { return report_msg_count_.load(); }
 
+    /**
+     * @brief 获取以二进制编码发布的行情消息数量
+     */
+    uint64_t get_binary_msg_count() const { return binary_msg_count_.load(); }
+
+    /**
+     * @brief 获取 fan-out 发布次数（每次只序列化一次）
+     */
+    uint64_t get_fanout_count() const { return fanout_count_.load(); }
+
+    /**
+     * @brief 获取经共享内存接收的订单数量
+     */
+    uint64_t get_shm_order_count() const { return shm_order_count_.load(); }
+
 private:
     /**
      * @brief 发送消息到指定 socket
@@ -414,6 +550,57 @@ private:
      */
     bool recv_message(zmq::socket_t& socket, std::string& data);
 
+    /**
+     * @brief zmq::poll 等待 socket 可读
+     *
+     * @param socket ZeroMQ socket（只能由其所属线程调用）
+     * @param timeout_ms 超时（毫秒）
+     * @return true 可读
+     */
+    bool wait_readable(zmq::socket_t* socket, int timeout_ms);
+
+    /**
+     * @brief 构建行情帧
+     *
+     * 按该类型当前的编码方式生成 topic|json 或 topic|binary
+     *
+     * @param topic 主题
+     * @param data 行情 JSON
+     * @param frame 输出帧
+     */
+    void build_market_frame(const std::string& topic, const nlohmann::json& data, std::string& frame);
+
+    /**
+     * @brief 构建行情主题: {exchange}.{type}.{symbol}[.{interval}]
+     *
+     * @param data 行情 JSON
+     * @param msg_type 消息类型（JSON 中无 type 字段时使用）
+     * @param exchange 交易所前缀
+     */
+    static std::string build_market_topic(const nlohmann::json& data, MessageType msg_type,
+                                          const std::string& exchange);
+
+    /**
+     * @brief 以零拷贝方式发送共享帧（增加一个引用，由 ZMQ 释放）
+     */
+    bool send_shared(zmq::socket_t& socket, SharedFrame* frame);
+
+    /**
+     * @brief 统一通道帧写入共享内存广播环（调用方持有 market_mutex_）
+     */
+    void write_shm_market(const std::string& frame) {
+        if (shm_market_) {
+            shm_market_->write(frame.data(), frame.size());
+        }
+    }
+
+    /**
+     * @brief 共享内存心跳（订单线程每轮调用，调用方持有 order_mutex_）
+     *
+     * 策略端据此区分服务端正常运行与崩溃/重启（崩溃时 closed 标志不会被设置）
+     */
+    void heartbeat_shm();
+
 private:
     // ZeroMQ 上下文（线程安全，可共享）
     zmq::context_t context_;
@@ -435,6 +622,13 @@ private:
     std::unique_ptr<zmq::socket_t> report_pub_;          // 回报发布 (PUB)
     std::unique_ptr<zmq::socket_t> query_rep_;           // 查询响应 (REP)
     std::unique_ptr<zmq::socket_t> subscribe_pull_;      // 订阅管理 (PULL)
+
+    // 共享内存通道（可选）
+    std::unique_ptr<ShmBroadcastRing> shm_market_;       // 行情广播环（单写者，market_mutex_ 保护）
+    std::unique_ptr<ShmMpscQueue> shm_order_;            // 订单队列（单读者，order_mutex_ 保护）
+    int64_t last_shm_heartbeat_ns_ = 0;                  // 上次心跳时间（order_mutex_ 保护）
+    std::string deferred_order_;                         // 等共享内存排空后再交付的 ZMQ 订单（order_mutex_ 保护）
+    bool has_deferred_order_ = false;
     
     // 运行状态
     std::atomic<bool> running_{false};
@@ -443,6 +637,7 @@ private:
     OrderCallback order_callback_;
     QueryCallback query_callback_;
     SubscribeCallback subscribe_callback_;
+    FrontendSink frontend_sink_;
 
     // 统计计数器
     std::atomic<uint64_t> market_msg_count_{0};
@@ -450,6 +645,12 @@ private:
     std::atomic<uint64_t> report_msg_count_{0};
     std::atomic<uint64_t> query_count_{0};
     std::atomic<uint64_t> subscribe_count_{0};
+    std::atomic<uint64_t> binary_msg_count_{0};
+    std::atomic<uint64_t> fanout_count_{0};
+    std::atomic<uint64_t> shm_order_count_{0};
+
+    // 二进制编码频道位图（位索引 = wire::WireMsgType）
+    std::atomic<uint32_t> binary_channel_mask_{0};
 
     // 线程安全保护（ZMQ socket 非线程安全）
     mutable std::mutex market_mutex_;      // 保护行情发布
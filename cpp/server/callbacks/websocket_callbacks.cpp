@@ -6,24 +6,34 @@
 #include "websocket_callbacks.h"
 #include "../config/server_config.h"
 #include "../managers/redis_recorder.h"
+#include "../managers/order_book_manager.h"
 #include "../../adapters/okx/okx_websocket.h"
 #include "../../adapters/binance/binance_websocket.h"
+#include "../../adapters/binance/binance_rest_api.h"
 #include "../../network/websocket_server.h"
+#include "../../core/instrument_registry.h"
+#include <condition_variable>
+#include <deque>
 #include <functional>
+#include <set>
+#include <thread>
 
 using namespace trading::okx;
 
 namespace trading {
 namespace server {
 
-// 辅助函数：去掉 -SWAP 后缀用于前端显示
-static std::string strip_swap_suffix(const std::string& symbol) {
-    const std::string suffix = "-SWAP";
-    if (symbol.size() > suffix.size() &&
-        symbol.compare(symbol.size() - suffix.size(), suffix.size(), suffix) == 0) {
-        return symbol.substr(0, symbol.size() - suffix.size());
+OrderBookManager g_order_book_manager;
+
+// 辅助函数：OKX 品种的前端显示代码（去掉 -SWAP 后缀）
+// 由品种注册表在首次出现时计算并缓存，之后每个 tick 只做一次无锁查找
+static const std::string& okx_display_symbol(std::string_view symbol) {
+    if (const Instrument* instrument = InstrumentRegistry::instance().resolve("okx", symbol)) {
+        return instrument->display_symbol;
     }
-    return symbol;
+    thread_local std::string fallback;
+    fallback = InstrumentRegistry::make_display_symbol(symbol);
+    return fallback;
 }
 
 // 辅助函数：从 JSON 值中安全获取 double（支持字符串和数字类型）
@@ -73,9 +83,386 @@ static std::string json_to_string(const nlohmann::json& val, const std::string&
     return default_val;
 }
 
+// ==================== 发布（类型化快速路径与 JSON 通用路径共用） ====================
+
+static void publish_okx_trade(ZmqServer& zmq_server, const nlohmann::json& msg, const std::string& symbol) {
+    // 序列化一次，发布到 OKX 专用通道 + 统一通道
+    // 转发给前端 WebSocket（每10条发送一次，避免过多数据）
+    static int trade_counter = 0;
+    uint32_t sinks = SINK_ZMQ;
+    if (++trade_counter % 10 == 0) {
+        sinks |= SINK_FRONTEND;
+    }
+    zmq_server.publish_market_fanout(msg, MessageType::TRADE, sinks);
+
+    // Redis 录制 Trade 数据
+    if (g_redis_recorder && g_redis_recorder->is_running()) {
+        g_redis_recorder->record_trade(symbol, "okx", msg);
+    }
+}
+
+static void publish_orderbook(ZmqServer& zmq_server, nlohmann::json& msg, const std::string& symbol,
+                              const std::string& exchange) {
+    const auto& bids = msg["bids"];
+    const auto& asks = msg["asks"];
+
+    // 计算最优价格
+    if (!bids.empty()) {
+        msg["best_bid_price"] = bids[0][0];
+        msg["best_bid_size"] = bids[0][1];
+    }
+    if (!asks.empty()) {
+        msg["best_ask_price"] = asks[0][0];
+        msg["best_ask_size"] = asks[0][1];
+    }
+    if (!bids.empty() && !asks.empty()) {
+        double best_bid = bids[0][0].get<double>();
+        double best_ask = asks[0][0].get<double>();
+        msg["mid_price"] = (best_bid + best_ask) / 2.0;
+        msg["spread"] = best_ask - best_bid;
+    }
+
+    // 序列化一次，发布到 OKX 专用通道 + 统一通道
+    zmq_server.publish_market_fanout(msg, MessageType::DEPTH);
+
+    // Redis 录制 Orderbook 数据
+    if (g_redis_recorder && g_redis_recorder->is_running()) {
+        g_redis_recorder->record_orderbook(symbol, exchange, msg);
+    }
+}
+
+// ==================== 本地订单簿（增量频道） ====================
+
+/**
+ * @brief 本地订单簿的前 N 档 -> orderbook 快照消息（格式与交易所快照推送一致）
+ */
+static nlohmann::json make_book_snapshot_msg(const std::string& exchange, const std::string& symbol,
+                                             std::string_view channel, const BookTop& top,
+                                             int64_t timestamp) {
+    auto levels = [](const core::PriceLevels& side) {
+        nlohmann::json arr = nlohmann::json::array();
+        for (const auto& level : side) {
+            arr.push_back({level.first, level.second});
+        }
+        return arr;
+    };
+    return {
+        {"type", "orderbook"},
+        {"exchange", exchange},
+        {"symbol", symbol},
+        {"channel", channel},
+        {"action", "snapshot"},
+        {"bids", levels(top.bids)},
+        {"asks", levels(top.asks)},
+        {"timestamp_ns", current_timestamp_ns()},
+        {"timestamp", timestamp}
+    };
+}
+
+static OrderBookManager::PublishFn book_publisher(ZmqServer& zmq_server, const std::string& exchange) {
+    return [&zmq_server, exchange](std::string_view symbol_view, std::string_view channel,
+                                   const BookTop& top, int64_t timestamp) {
+        std::string symbol(symbol_view);
+        nlohmann::json msg = make_book_snapshot_msg(exchange, symbol, channel, top, timestamp);
+        publish_orderbook(zmq_server, msg, symbol, exchange);
+    };
+}
+
+// 在 setup_*_callbacks 中设置
+static OrderBookManager::PublishFn g_okx_book_publish;
+static OrderBookManager::PublishFn g_binance_book_publish;
+
+static bool okx_book_subscribed(const std::string& symbol, const std::string& channel) {
+    std::lock_guard<std::mutex> lock(g_sub_mutex);
+    auto it = g_subscribed_orderbooks.find(symbol);
+    return it != g_subscribed_orderbooks.end() && it->second.count(channel) > 0;
+}
+
+/**
+ * @brief OKX 增量订单簿失同步：重新订阅，OKX 会先推送完整快照
+ *
+ * 在独立线程中发送，避免在 WebSocket 回调线程里调用同一连接的发送。
+ * 重新订阅后等待快照，超时未到则退避重试；订阅已被取消时停止
+ */
+static void resubscribe_okx_book(const std::string& symbol, const std::string& channel) {
+    std::cerr << "[OrderBook] OKX " << symbol << " " << channel << " 校验失败，重新订阅\n";
+    std::thread([symbol, channel]() {
+        auto wait = std::chrono::seconds(5);
+        for (int attempt = 1;; ++attempt) {
+            // 只在检查订阅集合时持有 g_sub_mutex，网络发送在锁外进行，不阻塞 handle_subscription
+            if (!g_ws_public || !okx_book_subscribed(symbol, channel)) {
+                return;  // 已取消订阅
+            }
+            g_ws_public->unsubscribe_orderbook(symbol, channel);
+            g_ws_public->subscribe_orderbook(symbol, channel);
+            if (!okx_book_subscribed(symbol, channel)) {
+                // 发送期间被取消订阅：撤销刚才的重新订阅
+                g_ws_public->unsubscribe_orderbook(symbol, channel);
+                return;
+            }
+
+            auto deadline = std::chrono::steady_clock::now() + wait;
+            while (std::chrono::steady_clock::now() < deadline) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                if (g_order_book_manager.okx_synced(symbol, channel)) return;
+            }
+            std::cerr << "[OrderBook] OKX " << symbol << " " << channel << " 重新订阅后 "
+                      << std::chrono::duration_cast<std::chrono::seconds>(wait).count()
+                      << " 秒未收到快照，重试（第 " << attempt + 1 << " 次）\n";
+            wait = std::min(wait * 2, std::chrono::seconds(60));
+        }
+    }).detach();
+}
+
+static void apply_okx_book(const core::BookPush& book) {
+    if (!g_order_book_manager.on_okx_book(book, g_okx_book_publish)) {
+        resubscribe_okx_book(std::string(book.symbol), std::string(book.channel));
+    }
+}
+
+static core::PriceLevels parse_binance_levels(const nlohmann::json& levels) {
+    core::PriceLevels result;
+    if (!levels.is_array()) return result;
+    result.reserve(levels.size());
+    for (const auto& level : levels) {
+        if (level.is_array() && level.size() >= 2) {
+            result.emplace_back(json_to_double(level[0]), json_to_double(level[1]));
+        }
+    }
+    return result;
+}
+
+// 快照早于缓存的增量时的最多拉取次数，超过后等下一条增量重新触发
+constexpr int BINANCE_SNAPSHOT_ATTEMPTS = 5;
+
+/**
+ * @brief 拉取 Binance REST 深度快照并与缓存的增量衔接
+ */
+static void fetch_binance_snapshot(binance::BinanceRestAPI& api, const std::string& symbol) {
+    for (int attempt = 1; attempt <= BINANCE_SNAPSHOT_ATTEMPTS; ++attempt) {
+        bool again = false;
+        try {
+            nlohmann::json snapshot = api.get_depth(symbol, 1000);
+            if (!snapshot.contains("lastUpdateId")) {
+                throw std::runtime_error(snapshot.dump());
+            }
+            again = g_order_book_manager.on_binance_snapshot(
+                symbol, json_to_int64(snapshot["lastUpdateId"]),
+                parse_binance_levels(snapshot.value("bids", nlohmann::json::array())),
+                parse_binance_levels(snapshot.value("asks", nlohmann::json::array())),
+                snapshot.contains("E") ? json_to_int64(snapshot["E"]) : current_timestamp_ms(),
+                g_binance_book_publish);
+        } catch (const std::exception& e) {
+            std::cerr << "[OrderBook] Binance " << symbol << " 深度快照获取失败: " << e.what() << "\n";
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+            g_order_book_manager.on_binance_snapshot_failed(symbol);
+            return;
+        }
+        if (!again) return;
+        // 快照早于缓存的增量（或增量断档），稍后重新拉取
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    }
+    std::cerr << "[OrderBook] Binance " << symbol << " 连续 " << BINANCE_SNAPSHOT_ATTEMPTS
+              << " 次快照未能衔接增量，等待下一条增量重新触发\n";
+    g_order_book_manager.on_binance_snapshot_failed(symbol);
+}
+
+// 快照请求队列（同一 symbol 排队中不重复入队）
+static std::mutex g_binance_snapshot_mutex;
+static std::condition_variable g_binance_snapshot_cv;
+static std::deque<std::string> g_binance_snapshot_queue;
+static std::set<std::string> g_binance_snapshot_queued;
+
+/**
+ * @brief 快照线程：按请求顺序逐个拉取，复用同一个 REST 客户端（市场类型与行情连接一致）
+ */
+static void binance_snapshot_worker() {
+    std::unique_ptr<binance::BinanceRestAPI> api;
+    binance::MarketType api_market = binance::MarketType::FUTURES;
+    bool api_testnet = false;
+
+    while (true) {
+        std::string symbol;
+        {
+            std::unique_lock<std::mutex> lock(g_binance_snapshot_mutex);
+            g_binance_snapshot_cv.wait(lock, [] { return !g_binance_snapshot_queue.empty(); });
+            symbol = std::move(g_binance_snapshot_queue.front());
+            g_binance_snapshot_queue.pop_front();
+            g_binance_snapshot_queued.erase(symbol);
+        }
+
+        binance::MarketType market = g_binance_ws_market ? g_binance_ws_market->get_market_type()
+                                                         : binance::MarketType::FUTURES;
+        bool testnet = g_binance_ws_market ? g_binance_ws_market->is_testnet() : Config::binance_is_testnet;
+        if (!api || api_market != market || api_testnet != testnet) {
+            api = std::make_unique<binance::BinanceRestAPI>("", "", market, testnet);
+            api_market = market;
+            api_testnet = testnet;
+        }
+        fetch_binance_snapshot(*api, symbol);
+    }
+}
+
+/**
+ * @brief 异步请求 Binance 深度快照（失败 1 秒后允许下一条增量再次触发）
+ */
+static void request_binance_snapshot(const std::string& symbol) {
+    static std::once_flag started;
+    std::call_once(started, [] { std::thread(binance_snapshot_worker).detach(); });
+    {
+        std::lock_guard<std::mutex> lock(g_binance_snapshot_mutex);
+        if (!g_binance_snapshot_queued.insert(symbol).second) return;
+        g_binance_snapshot_queue.push_back(symbol);
+    }
+    g_binance_snapshot_cv.notify_one();
+}
+
+static void publish_okx_funding_rate(ZmqServer& zmq_server, const nlohmann::json& msg, const std::string& inst_id) {
+    // 序列化一次，发布到 OKX 专用通道 + 统一通道
+    zmq_server.publish_market_fanout(msg, MessageType::TICKER);
+
+    // Redis 录制 Funding Rate 数据
+    if (g_redis_recorder && g_redis_recorder->is_running()) {
+        g_redis_recorder->record_funding_rate(inst_id, "okx", msg);
+    }
+}
+
+static void publish_okx_kline(ZmqServer& zmq_server, const nlohmann::json& msg,
+                              const std::string& symbol, const std::string& interval) {
+    g_kline_count++;
+    g_okx_kline_count++;
+
+    // 序列化一次，发布到 OKX 专用通道 + 统一通道
+    zmq_server.publish_market_fanout(msg, MessageType::KLINE);
+
+    // Redis 录制 K线 数据
+    if (g_redis_recorder && g_redis_recorder->is_running()) {
+        g_redis_recorder->record_kline(symbol, interval, "okx", msg);
+    }
+}
+
+static void publish_binance_trade(ZmqServer& zmq_server, const nlohmann::json& msg, const std::string& symbol) {
+    // 序列化一次，发布到 Binance 专用通道 + 统一通道（每10条转发一次前端）
+    static int binance_trade_counter = 0;
+    uint32_t sinks = SINK_ZMQ;
+    if (++binance_trade_counter % 10 == 0) {
+        sinks |= SINK_FRONTEND;
+    }
+    zmq_server.publish_market_fanout(msg, MessageType::TRADE, sinks);
+
+    // Redis 录制 Trade 数据
+    if (g_redis_recorder && g_redis_recorder->is_running()) {
+        g_redis_recorder->record_trade(symbol, "binance", msg);
+    }
+}
+
+static void publish_binance_mark_price(ZmqServer& zmq_server, const nlohmann::json& msg, const std::string& symbol) {
+    g_binance_markprice_count++;
+    g_funding_rate_count++;
+
+    // 序列化一次，发布到 Binance 专用通道 + 统一通道
+    zmq_server.publish_market_fanout(msg, MessageType::TICKER);
+
+    // Redis 录制 Funding Rate 数据（Mark Price 包含资金费率）
+    if (g_redis_recorder && g_redis_recorder->is_running() && msg.contains("funding_rate")) {
+        g_redis_recorder->record_funding_rate(symbol, "binance", msg);
+    }
+}
+
+// Binance K线消息（continuous_kline 的交易对在 ps，普通 kline 在 s）
+static nlohmann::json make_binance_kline_msg(const core::KlinePush& k, std::string& symbol) {
+    symbol.assign(k.symbol.data(), k.symbol.size());
+    std::transform(symbol.begin(), symbol.end(), symbol.begin(), ::toupper);
+    return {
+        {"type", "kline"},
+        {"exchange", "binance"},
+        {"symbol", symbol},
+        {"timestamp_ns", current_timestamp_ns()},
+        {"interval", std::string(k.interval)},
+        {"open", k.open},
+        {"high", k.high},
+        {"low", k.low},
+        {"close", k.close},
+        {"volume", k.volume},
+        {"timestamp", k.open_time}
+    };
+}
+
+static nlohmann::json make_binance_mark_price_msg(const core::MarkPricePush& mp, std::string& symbol) {
+    symbol.assign(mp.symbol.data(), mp.symbol.size());
+    nlohmann::json msg = {
+        {"type", "mark_price"},
+        {"exchange", "binance"},
+        {"symbol", symbol},
+        {"timestamp_ns", current_timestamp_ns()},
+        {"mark_price", mp.mark_price},
+        {"index_price", mp.index_price},
+        {"next_funding_time", mp.next_funding_time},
+        {"timestamp", mp.timestamp}
+    };
+    if (mp.has_funding_rate) {
+        msg["funding_rate"] = mp.funding_rate;
+    }
+    return msg;
+}
+
+static void set_binance_mark_price_callbacks(binance::BinanceWebSocket* ws, ZmqServer& zmq_server) {
+    // 类型化快速路径
+    ws->set_mark_price_push_callback([&zmq_server](const core::MarkPricePush& mp) {
+        std::string symbol;
+        nlohmann::json msg = make_binance_mark_price_msg(mp, symbol);
+        publish_binance_mark_price(zmq_server, msg, symbol);
+    });
+
+    // 通用路径（快速路径不支持的报文）
+    ws->set_mark_price_callback([&zmq_server](const nlohmann::json& raw) {
+        // Binance markPrice 字段: s(symbol), p(markPrice), i(indexPrice), r(fundingRate), T(nextFundingTime), E(eventTime)
+        std::string symbol = "";
+        if (raw.contains("s")) {
+            symbol = json_to_string(raw["s"]);
+        }
+
+        nlohmann::json msg = {
+            {"type", "mark_price"},
+            {"exchange", "binance"},
+            {"symbol", symbol},
+            {"timestamp_ns", current_timestamp_ns()}
+        };
+
+        if (raw.contains("p")) msg["mark_price"] = json_to_double(raw["p"]);
+        if (raw.contains("i")) msg["index_price"] = json_to_double(raw["i"]);
+        if (raw.contains("r")) msg["funding_rate"] = json_to_double(raw["r"]);
+        if (raw.contains("T")) msg["next_funding_time"] = json_to_int64(raw["T"]);
+        if (raw.contains("E")) msg["timestamp"] = json_to_int64(raw["E"]);
+
+        publish_binance_mark_price(zmq_server, msg, symbol);
+    });
+}
+
 void setup_websocket_callbacks(ZmqServer& zmq_server) {
+    g_okx_book_publish = book_publisher(zmq_server, "okx");
+
     // Trades 回调（公共频道）
     if (g_ws_public) {
+        // OKX Ticker 回调（类型化快速路径）
+        g_ws_public->set_ticker_push_callback([&zmq_server](const core::TickerPush& t) {
+            g_okx_ticker_count++;
+
+            nlohmann::json msg = {
+                {"type", "ticker"},
+                {"exchange", "okx"},
+                {"symbol", okx_display_symbol(t.symbol)},
+                {"timestamp_ns", current_timestamp_ns()},
+                {"price", t.last},
+                {"timestamp", t.timestamp},
+                {"high_24h", t.high_24h},
+                {"low_24h", t.low_24h},
+                {"open_24h", t.open_24h},
+                {"volume_24h", t.volume_24h}
+            };
+            zmq_server.publish_market_fanout(msg, MessageType::TICKER, SINK_ALL);
+        });
+
         // OKX Ticker 回调（原始JSON格式）
         g_ws_public->set_ticker_callback([&zmq_server](const nlohmann::json& raw) {
             g_okx_ticker_count++;
@@ -84,7 +471,7 @@ void setup_websocket_callbacks(ZmqServer& zmq_server) {
             if (raw.contains("instId")) {
                 symbol = json_to_string(raw["instId"]);
             }
-            std::string display_symbol = strip_swap_suffix(symbol);
+            const std::string& display_symbol = okx_display_symbol(symbol);
 
             nlohmann::json msg = {
                 {"type", "ticker"},
@@ -101,14 +488,28 @@ void setup_websocket_callbacks(ZmqServer& zmq_server) {
             if (raw.contains("open24h")) msg["open_24h"] = json_to_double(raw["open24h"]);
             if (raw.contains("vol24h")) msg["volume_24h"] = json_to_double(raw["vol24h"]);
 
-            // 发布到 OKX 专用通道
-            zmq_server.publish_okx_market(msg, MessageType::TICKER);
-            // 同时发布到统一通道（兼容旧客户端）
-            zmq_server.publish_ticker(msg);
+            // 序列化一次，发布到 OKX 专用通道 + 统一通道（兼容旧客户端）+ 前端
+            zmq_server.publish_market_fanout(msg, MessageType::TICKER, SINK_ALL);
+        });
 
-            if (g_frontend_server) {
-                g_frontend_server->send_event("ticker", msg);
-            }
+        // OKX Trade 回调（类型化快速路径）
+        g_ws_public->set_trade_push_callback([&zmq_server](const core::TradePush& t) {
+            g_trade_count++;
+            g_okx_trade_count++;
+
+            std::string symbol(t.symbol);
+            nlohmann::json msg = {
+                {"type", "trade"},
+                {"exchange", "okx"},
+                {"symbol", symbol},
+                {"timestamp_ns", current_timestamp_ns()},
+                {"trade_id", std::string(t.trade_id)},
+                {"price", t.price},
+                {"quantity", t.quantity},
+                {"side", std::string(t.side)},
+                {"timestamp", t.timestamp}
+            };
+            publish_okx_trade(zmq_server, msg, symbol);
         });
 
         // OKX Trade 回调（原始JSON格式）
@@ -136,24 +537,44 @@ void setup_websocket_callbacks(ZmqServer& zmq_server) {
             if (raw.contains("side")) msg["side"] = json_to_string(raw["side"]);
             if (raw.contains("ts")) msg["timestamp"] = json_to_int64(raw["ts"]);
 
-            // 发布到 OKX 专用通道
-            zmq_server.publish_okx_market(msg, MessageType::TRADE);
-            // 同时发布到统一通道
-            zmq_server.publish_ticker(msg);
+            publish_okx_trade(zmq_server, msg, symbol);
+        });
+
+        // OKX 深度数据回调（类型化快速路径）
+        g_ws_public->set_orderbook_push_callback([&zmq_server](const core::BookPush& book) {
+            g_orderbook_count++;
 
-            // Redis 录制 Trade 数据
-            if (g_redis_recorder && g_redis_recorder->is_running()) {
-                g_redis_recorder->record_trade(symbol, "okx", msg);
+            // 增量频道：维护本地订单簿，前 N 档变化时发布快照
+            if (OrderBookManager::is_okx_incremental(std::string(book.channel))) {
+                apply_okx_book(book);
+                return;
             }
 
-            // 转发给前端 WebSocket（每10条发送一次，避免过多数据）
-            static int trade_counter = 0;
-            if (++trade_counter % 10 == 0 && g_frontend_server) {
-                g_frontend_server->send_event("trade", msg);
+            nlohmann::json bids = nlohmann::json::array();
+            nlohmann::json asks = nlohmann::json::array();
+            for (const auto& level : book.bids) {
+                bids.push_back({level.price, level.size});
+            }
+            for (const auto& level : book.asks) {
+                asks.push_back({level.price, level.size});
             }
+
+            std::string symbol(book.symbol);
+            nlohmann::json msg = {
+                {"type", "orderbook"},
+                {"exchange", "okx"},
+                {"symbol", symbol},
+                {"channel", std::string(book.channel)},
+                {"action", std::string(book.action)},
+                {"bids", std::move(bids)},
+                {"asks", std::move(asks)},
+                {"timestamp_ns", current_timestamp_ns()},
+                {"timestamp", book.timestamp}
+            };
+            publish_orderbook(zmq_server, msg, symbol, "okx");
         });
 
-        // OKX 深度数据回调（原始JSON格式）- 注意：目前OKX没有订阅深度
+        // OKX 深度数据回调（原始JSON格式，快速路径无法解析的报文）
         g_ws_public->set_orderbook_callback([&zmq_server](const nlohmann::json& raw) {
             g_orderbook_count++;
 
@@ -174,6 +595,38 @@ void setup_websocket_callbacks(ZmqServer& zmq_server) {
                 action = "snapshot";
             }
 
+            if (OrderBookManager::is_okx_incremental(channel)) {
+                // 转成 BookPush（文本字段指向 raw 中的字符串，checksum 需要原始文本）
+                core::BookPush book;
+                book.symbol = symbol;
+                book.channel = channel;
+                book.action = action;
+                auto levels = [](const nlohmann::json& arr, std::vector<core::BookLevelPush>& out) {
+                    if (!arr.is_array()) return;
+                    for (const auto& level : arr) {
+                        if (!level.is_array() || level.size() < 2 ||
+                            !level[0].is_string() || !level[1].is_string()) continue;
+                        core::BookLevelPush l;
+                        l.price_text = level[0].get_ref<const std::string&>();
+                        l.size_text = level[1].get_ref<const std::string&>();
+                        l.price = json_to_double(level[0]);
+                        l.size = json_to_double(level[1]);
+                        out.push_back(l);
+                    }
+                };
+                if (raw.contains("bids")) levels(raw["bids"], book.bids);
+                if (raw.contains("asks")) levels(raw["asks"], book.asks);
+                if (raw.contains("ts")) book.timestamp = json_to_int64(raw["ts"]);
+                if (raw.contains("seqId")) book.seq_id = json_to_int64(raw["seqId"]);
+                if (raw.contains("prevSeqId")) book.prev_seq_id = json_to_int64(raw["prevSeqId"]);
+                if (raw.contains("checksum")) {
+                    book.checksum = json_to_int64(raw["checksum"]);
+                    book.has_checksum = true;
+                }
+                apply_okx_book(book);
+                return;
+            }
+
             nlohmann::json bids = nlohmann::json::array();
             nlohmann::json asks = nlohmann::json::array();
 
@@ -210,31 +663,36 @@ void setup_websocket_callbacks(ZmqServer& zmq_server) {
 
             if (raw.contains("ts")) msg["timestamp"] = json_to_int64(raw["ts"]);
 
-            // 计算最优价格
-            if (!bids.empty()) {
-                msg["best_bid_price"] = bids[0][0];
-                msg["best_bid_size"] = bids[0][1];
-            }
-            if (!asks.empty()) {
-                msg["best_ask_price"] = asks[0][0];
-                msg["best_ask_size"] = asks[0][1];
-            }
-            if (!bids.empty() && !asks.empty()) {
-                double best_bid = bids[0][0].get<double>();
-                double best_ask = asks[0][0].get<double>();
-                msg["mid_price"] = (best_bid + best_ask) / 2.0;
-                msg["spread"] = best_ask - best_bid;
-            }
+            publish_orderbook(zmq_server, msg, symbol, "okx");
+        });
 
-            // 发布到 OKX 专用通道
-            zmq_server.publish_okx_market(msg, MessageType::DEPTH);
-            // 同时发布到统一通道
-            zmq_server.publish_depth(msg);
+        // OKX 资金费率回调（类型化快速路径）
+        g_ws_public->set_funding_rate_push_callback([&zmq_server](const core::FundingRatePush& f) {
+            g_funding_rate_count++;
 
-            // Redis 录制 Orderbook 数据
-            if (g_redis_recorder && g_redis_recorder->is_running()) {
-                g_redis_recorder->record_orderbook(symbol, "okx", msg);
-            }
+            std::string inst_id(f.symbol);
+            nlohmann::json msg = {
+                {"type", "funding_rate"},
+                {"exchange", "okx"},
+                {"symbol", inst_id},
+                {"inst_type", std::string(f.inst_type)},
+                {"timestamp_ns", current_timestamp_ns()},
+                {"funding_rate", f.funding_rate},
+                {"next_funding_rate", f.next_funding_rate},
+                {"funding_time", f.funding_time},
+                {"next_funding_time", f.next_funding_time},
+                {"min_funding_rate", f.min_funding_rate},
+                {"max_funding_rate", f.max_funding_rate},
+                {"interest_rate", f.interest_rate},
+                {"impact_value", f.impact_value},
+                {"premium", f.premium},
+                {"sett_state", std::string(f.sett_state)},
+                {"sett_funding_rate", f.sett_funding_rate},
+                {"method", std::string(f.method)},
+                {"formula_type", std::string(f.formula_type)},
+                {"timestamp", f.timestamp}
+            };
+            publish_okx_funding_rate(zmq_server, msg, inst_id);
         });
 
         // OKX 资金费率回调（原始JSON格式）
@@ -274,20 +732,38 @@ void setup_websocket_callbacks(ZmqServer& zmq_server) {
             if (raw.contains("formulaType")) msg["formula_type"] = json_to_string(raw["formulaType"]);
             if (raw.contains("ts")) msg["timestamp"] = json_to_int64(raw["ts"]);
 
-            // 发布到 OKX 专用通道
-            zmq_server.publish_okx_market(msg, MessageType::TICKER);
-            // 同时发布到统一通道
-            zmq_server.publish_ticker(msg);
-
-            // Redis 录制 Funding Rate 数据
-            if (g_redis_recorder && g_redis_recorder->is_running()) {
-                g_redis_recorder->record_funding_rate(inst_id, "okx", msg);
-            }
+            publish_okx_funding_rate(zmq_server, msg, inst_id);
         });
     }
 
     // OKX K线回调（原始JSON格式）
     if (g_ws_business) {
+        // 类型化快速路径
+        g_ws_business->set_kline_push_callback([&zmq_server](const core::KlinePush& k) {
+            // 只发布已完结的K线（confirm=1）
+            if (k.has_confirm && !k.confirmed) {
+                return;
+            }
+
+            std::string symbol(k.symbol);
+            std::string interval(k.interval);
+            nlohmann::json msg = {
+                {"type", "kline"},
+                {"exchange", "okx"},
+                {"symbol", symbol},
+                {"interval", interval},
+                {"timestamp_ns", current_timestamp_ns()},
+                {"open", k.open},
+                {"high", k.high},
+                {"low", k.low},
+                {"close", k.close},
+                {"volume", k.volume},
+                {"timestamp", k.open_time}
+            };
+            publish_okx_kline(zmq_server, msg, symbol, interval);
+        });
+
+        // 通用路径
         g_ws_business->set_kline_callback([&zmq_server](const nlohmann::json& raw) {
             // 检查是否为已确认的K线（confirm字段）- 支持字符串和数字类型
             // OKX K线: confirm=0 表示未完结（实时更新），confirm=1 表示已完结
@@ -305,9 +781,6 @@ void setup_websocket_callbacks(ZmqServer& zmq_server) {
                 }
             }
 
-            g_kline_count++;
-            g_okx_kline_count++;
-
             std::string symbol = "";
             if (raw.contains("symbol")) {
                 symbol = json_to_string(raw["symbol"]);
@@ -333,15 +806,7 @@ void setup_websocket_callbacks(ZmqServer& zmq_server) {
             if (raw.contains("vol")) msg["volume"] = json_to_double(raw["vol"]);
             if (raw.contains("ts")) msg["timestamp"] = json_to_int64(raw["ts"]);
 
-            // 发布到 OKX 专用通道
-            zmq_server.publish_okx_market(msg, MessageType::KLINE);
-            // 同时发布到统一通道
-            zmq_server.publish_kline(msg);
-
-            // Redis 录制 K线 数据
-            if (g_redis_recorder && g_redis_recorder->is_running()) {
-                g_redis_recorder->record_kline(symbol, interval, "okx", msg);
-            }
+            publish_okx_kline(zmq_server, msg, symbol, interval);
         });
     }
 
@@ -408,8 +873,76 @@ void setup_websocket_callbacks(ZmqServer& zmq_server) {
 }
 
 void setup_binance_websocket_callbacks(ZmqServer& zmq_server) {
+    g_binance_book_publish = book_publisher(zmq_server, "binance");
+
     // Binance 回调（原始JSON格式）
     if (g_binance_ws_market) {
+        // Binance 深度回调：已注册本地订单簿的 symbol 按 diff depth 维护，其余按 depth<levels> 快照转发
+        g_binance_ws_market->set_orderbook_callback([&zmq_server](const nlohmann::json& raw) {
+            g_orderbook_count++;
+
+            std::string symbol = raw.contains("s") ? json_to_string(raw["s"]) : raw.value("symbol", "");
+            std::transform(symbol.begin(), symbol.end(), symbol.begin(), ::toupper);
+            if (symbol.empty()) return;
+
+            if (raw.contains("U") && raw.contains("u") && g_order_book_manager.has_binance(symbol)) {
+                core::DepthDiff diff;
+                diff.first_update_id = json_to_int64(raw["U"]);
+                diff.final_update_id = json_to_int64(raw["u"]);
+                if (raw.contains("pu")) diff.prev_final_id = json_to_int64(raw["pu"]);
+                if (raw.contains("E")) diff.timestamp = json_to_int64(raw["E"]);
+                if (raw.contains("b")) diff.bids = parse_binance_levels(raw["b"]);
+                if (raw.contains("a")) diff.asks = parse_binance_levels(raw["a"]);
+                if (g_order_book_manager.on_binance_diff(symbol, std::move(diff), g_binance_book_publish)) {
+                    request_binance_snapshot(symbol);
+                }
+                return;
+            }
+
+            // depth<levels>：合约为 depthUpdate（b/a），现货为 {lastUpdateId, bids, asks}
+            const char* bids_key = raw.contains("b") ? "b" : "bids";
+            const char* asks_key = raw.contains("a") ? "a" : "asks";
+            nlohmann::json bids = nlohmann::json::array();
+            nlohmann::json asks = nlohmann::json::array();
+            if (raw.contains(bids_key)) {
+                for (const auto& level : parse_binance_levels(raw[bids_key])) bids.push_back({level.first, level.second});
+            }
+            if (raw.contains(asks_key)) {
+                for (const auto& level : parse_binance_levels(raw[asks_key])) asks.push_back({level.first, level.second});
+            }
+            nlohmann::json msg = {
+                {"type", "orderbook"},
+                {"exchange", "binance"},
+                {"symbol", symbol},
+                {"channel", "depth"},
+                {"action", "snapshot"},
+                {"bids", std::move(bids)},
+                {"asks", std::move(asks)},
+                {"timestamp_ns", current_timestamp_ns()},
+                {"timestamp", raw.contains("E") ? json_to_int64(raw["E"]) : current_timestamp_ms()}
+            };
+            publish_orderbook(zmq_server, msg, symbol, "binance");
+        });
+
+        // Binance Ticker 回调（类型化快速路径）- !ticker@arr 每条报文包含全部合约
+        g_binance_ws_market->set_ticker_push_callback([&zmq_server](const core::TickerPush& t) {
+            g_binance_ticker_count++;
+
+            nlohmann::json msg = {
+                {"type", "ticker"},
+                {"exchange", "binance"},
+                {"symbol", std::string(t.symbol)},
+                {"timestamp_ns", current_timestamp_ns()},
+                {"price", t.last},
+                {"timestamp", t.timestamp},
+                {"high_24h", t.high_24h},
+                {"low_24h", t.low_24h},
+                {"open_24h", t.open_24h},
+                {"volume_24h", t.volume_24h}
+            };
+            zmq_server.publish_market_fanout(msg, MessageType::TICKER, SINK_ALL);
+        });
+
         // Binance Ticker 回调（原始JSON格式）- !ticker@arr
         g_binance_ws_market->set_ticker_callback([&zmq_server](const nlohmann::json& raw) {
             g_binance_ticker_count++;
@@ -434,14 +967,29 @@ void setup_binance_websocket_callbacks(ZmqServer& zmq_server) {
             if (raw.contains("o")) msg["open_24h"] = json_to_double(raw["o"]);
             if (raw.contains("v")) msg["volume_24h"] = json_to_double(raw["v"]);
 
-            // 发布到 Binance 专用通道
-            zmq_server.publish_binance_market(msg, MessageType::TICKER);
-            // 同时发布到统一通道
-            zmq_server.publish_ticker(msg);
+            // 序列化一次，发布到 Binance 专用通道 + 统一通道 + 前端
+            zmq_server.publish_market_fanout(msg, MessageType::TICKER, SINK_ALL);
+        });
 
-            if (g_frontend_server) {
-                g_frontend_server->send_event("ticker", msg);
+        // Binance Trade 回调（类型化快速路径）
+        g_binance_ws_market->set_trade_push_callback([&zmq_server](const core::TradePush& t) {
+            g_trade_count++;
+
+            std::string symbol(t.symbol);
+            nlohmann::json msg = {
+                {"type", "trade"},
+                {"exchange", "binance"},
+                {"symbol", symbol},
+                {"timestamp_ns", current_timestamp_ns()},
+                {"trade_id", std::string(t.trade_id)},
+                {"price", t.price},
+                {"quantity", t.quantity},
+                {"timestamp", t.timestamp}
+            };
+            if (!t.side.empty()) {
+                msg["side"] = std::string(t.side);
             }
+            publish_binance_trade(zmq_server, msg, symbol);
         });
 
         // Binance Trade 回调（原始JSON格式）- 注意：目前Binance没有订阅trade
@@ -473,19 +1021,21 @@ void setup_binance_websocket_callbacks(ZmqServer& zmq_server) {
             }
             if (raw.contains("T")) msg["timestamp"] = json_to_int64(raw["T"]);
 
-            // 发布到 Binance 专用通道
-            zmq_server.publish_binance_market(msg, MessageType::TRADE);
-            // 同时发布到统一通道
-            zmq_server.publish_ticker(msg);
+            publish_binance_trade(zmq_server, msg, symbol);
+        });
 
-            // Redis 录制 Trade 数据
-            if (g_redis_recorder && g_redis_recorder->is_running()) {
-                g_redis_recorder->record_trade(symbol, "binance", msg);
-            }
+        // Binance K线回调（类型化快速路径）
+        g_binance_ws_market->set_kline_push_callback([&zmq_server](const core::KlinePush& k) {
+            g_kline_count++;
+            g_binance_kline_count++;
 
-            static int binance_trade_counter = 0;
-            if (++binance_trade_counter % 10 == 0 && g_frontend_server) {
-                g_frontend_server->send_event("trade", msg);
+            std::string symbol;
+            nlohmann::json msg = make_binance_kline_msg(k, symbol);
+            zmq_server.publish_market_fanout(msg, MessageType::KLINE);
+
+            // Redis 录制 K线 数据（仅当 K 线完结时保存）
+            if (k.confirmed && g_redis_recorder && g_redis_recorder->is_running()) {
+                g_redis_recorder->record_kline(symbol, std::string(k.interval), "binance", msg);
             }
         });
 
@@ -525,10 +1075,8 @@ void setup_binance_websocket_callbacks(ZmqServer& zmq_server) {
                 if (k.contains("t")) msg["timestamp"] = json_to_int64(k["t"]);
             }
 
-            // 发布到 Binance 专用通道
-            zmq_server.publish_binance_market(msg, MessageType::KLINE);
-            // 同时发布到统一通道
-            zmq_server.publish_kline(msg);
+            // 序列化一次，发布到 Binance 专用通道 + 统一通道
+            zmq_server.publish_market_fanout(msg, MessageType::KLINE);
 
             // Redis 录制 K线 数据（仅当 K 线完结时保存，x=true 表示已完结）
             if (g_redis_recorder && g_redis_recorder->is_running()) {
@@ -543,40 +1091,8 @@ void setup_binance_websocket_callbacks(ZmqServer& zmq_server) {
             }
         });
 
-        // Binance 标记价格回调（原始JSON格式）- 注意：目前设在 g_binance_ws_market，但实际 markPrice 在 g_binance_ws_depth
-        g_binance_ws_market->set_mark_price_callback([&zmq_server](const nlohmann::json& raw) {
-            g_binance_markprice_count++;
-            g_funding_rate_count++;
-
-            // Binance markPrice 字段: s(symbol), p(markPrice), i(indexPrice), r(fundingRate), T(nextFundingTime), E(eventTime)
-            std::string symbol = "";
-            if (raw.contains("s")) {
-                symbol = json_to_string(raw["s"]);
-            }
-
-            nlohmann::json msg = {
-                {"type", "mark_price"},
-                {"exchange", "binance"},
-                {"symbol", symbol},
-                {"timestamp_ns", current_timestamp_ns()}
-            };
-
-            if (raw.contains("p")) msg["mark_price"] = json_to_double(raw["p"]);
-            if (raw.contains("i")) msg["index_price"] = json_to_double(raw["i"]);
-            if (raw.contains("r")) msg["funding_rate"] = json_to_double(raw["r"]);
-            if (raw.contains("T")) msg["next_funding_time"] = json_to_int64(raw["T"]);
-            if (raw.contains("E")) msg["timestamp"] = json_to_int64(raw["E"]);
-
-            // 发布到 Binance 专用通道
-            zmq_server.publish_binance_market(msg, MessageType::TICKER);
-            // 同时发布到统一通道
-            zmq_server.publish_ticker(msg);
-
-            // Redis 录制 Funding Rate 数据（Mark Price 包含资金费率）
-            if (g_redis_recorder && g_redis_recorder->is_running() && msg.contains("funding_rate")) {
-                g_redis_recorder->record_funding_rate(symbol, "binance", msg);
-            }
-        });
+        // Binance 标记价格回调 - 注意：目前设在 g_binance_ws_market，但实际 markPrice 在 g_binance_ws_depth
+        set_binance_mark_price_callbacks(g_binance_ws_market.get(), zmq_server);
     }
 
     // Binance 用户数据流回调
@@ -652,39 +1168,7 @@ void setup_binance_websocket_callbacks(ZmqServer& zmq_server) {
 
     // Binance markPrice 专用连接（g_binance_ws_depth 实际用于 !markPrice@arr）
     if (g_binance_ws_depth) {
-        g_binance_ws_depth->set_mark_price_callback([&zmq_server](const nlohmann::json& raw) {
-            g_binance_markprice_count++;
-            g_funding_rate_count++;
-
-            // Binance markPrice 字段: s(symbol), p(markPrice), i(indexPrice), r(fundingRate), T(nextFundingTime), E(eventTime)
-            std::string symbol = "";
-            if (raw.contains("s")) {
-                symbol = json_to_string(raw["s"]);
-            }
-
-            nlohmann::json msg = {
-                {"type", "mark_price"},
-                {"exchange", "binance"},
-                {"symbol", symbol},
-                {"timestamp_ns", current_timestamp_ns()}
-            };
-
-            if (raw.contains("p")) msg["mark_price"] = json_to_double(raw["p"]);
-            if (raw.contains("i")) msg["index_price"] = json_to_double(raw["i"]);
-            if (raw.contains("r")) msg["funding_rate"] = json_to_double(raw["r"]);
-            if (raw.contains("T")) msg["next_funding_time"] = json_to_int64(raw["T"]);
-            if (raw.contains("E")) msg["timestamp"] = json_to_int64(raw["E"]);
-
-            // 发布到 Binance 专用通道
-            zmq_server.publish_binance_market(msg, MessageType::TICKER);
-            // 同时发布到统一通道
-            zmq_server.publish_ticker(msg);
-
-            // Redis 录制 Funding Rate 数据（Mark Price 包含资金费率）
-            if (g_redis_recorder && g_redis_recorder->is_running() && msg.contains("funding_rate")) {
-                g_redis_recorder->record_funding_rate(symbol, "binance", msg);
-            }
-        });
+        set_binance_mark_price_callbacks(g_binance_ws_depth.get(), zmq_server);
     }
 }
 
@@ -695,6 +1179,29 @@ void setup_binance_kline_callback(
 ) {
     if (!ws) return;
 
+    // 类型化快速路径
+    ws->set_kline_push_callback([&zmq_server, on_closed_kline](const core::KlinePush& k) {
+        // 仅当 K线 完结时才发布到 ZMQ 和 Redis（与 OKX 行为一致）
+        if (!k.confirmed) {
+            return;
+        }
+        g_kline_count++;
+        g_binance_kline_count++;
+
+        std::string symbol;
+        nlohmann::json msg = make_binance_kline_msg(k, symbol);
+        zmq_server.publish_market_fanout(msg, MessageType::KLINE);
+
+        if (on_closed_kline) {
+            on_closed_kline(symbol, k.open_time);
+        }
+
+        if (g_redis_recorder && g_redis_recorder->is_running()) {
+            g_redis_recorder->record_kline(symbol, std::string(k.interval), "binance", msg);
+        }
+    });
+
+    // 通用路径
     ws->set_kline_callback([&zmq_server, on_closed_kline](const nlohmann::json& raw) {
         // continuous_kline 格式: ps(交易对), ct(合约类型), k(K线数据)
         // 普通 kline 格式: s(交易对), k(K线数据)
@@ -737,10 +1244,8 @@ void setup_binance_kline_callback(
             g_kline_count++;
             g_binance_kline_count++;
 
-            // 发布到 Binance 专用通道
-            zmq_server.publish_binance_market(msg, MessageType::KLINE);
-            // 同时发布到统一通道
-            zmq_server.publish_kline(msg);
+            // 序列化一次，发布到 Binance 专用通道 + 统一通道
+            zmq_server.publish_market_fanout(msg, MessageType::KLINE);
 
             if (on_closed_kline) {
                 on_closed_kline(symbol, msg.value("timestamp", 0LL));
@@ -56,6 +56,12 @@ std::atomic<uint64_t> g_order_success{0};
 std::atomic<uint64_t> g_order_failed{0};
 std::atomic<uint64_t> g_query_count{0};
 
+// 订单延迟：策略发送 -> 订单线程分发
+LatencyHistogram g_order_dispatch_latency;
+
+int g_http_warmup_connections = 2;
+std::string g_default_order_route = "rest";
+
 // 分交易所统计
 // OKX: Ticker + Trades + K线
 std::atomic<uint64_t> g_okx_ticker_count{0};
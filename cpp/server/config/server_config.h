@@ -19,6 +19,7 @@
 #include <sys/types.h>
 #include <nlohmann/json.hpp>
 #include "../../core/config_center.h"
+#include "../../core/latency_histogram.h"
 
 // 前向声明
 namespace trading {
@@ -79,6 +80,15 @@ extern std::atomic<uint64_t> g_order_success;
 extern std::atomic<uint64_t> g_order_failed;
 extern std::atomic<uint64_t> g_query_count;
 
+// 订单延迟：策略发送（send_ts_ns）-> 订单线程分发
+extern LatencyHistogram g_order_dispatch_latency;
+
+// 账户注册后预热的 REST 连接数（0 表示不预热）
+extern int g_http_warmup_connections;
+
+// 账户默认订单通道："rest" 或 "ws"（注册请求中的 order_route 优先）
+extern std::string g_default_order_route;
+
 // 分交易所统计
 // OKX: Ticker + Trades + K线 (无深度)
 extern std::atomic<uint64_t> g_okx_ticker_count;
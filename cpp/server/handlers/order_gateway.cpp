@@ -0,0 +1,145 @@
+/**
+ * @file order_gateway.cpp
+ * @brief 异步订单网关实现
+ */
+
+#include "order_gateway.h"
+#include "../../core/logger.h"
+#include <iostream>
+
+using namespace trading::core;
+
+namespace trading {
+namespace server {
+
+OrderGateway g_order_gateway;
+
+void OrderGateway::start(size_t worker_count) {
+    if (running_.load()) {
+        return;
+    }
+
+    workers_.clear();
+    for (size_t i = 0; i < worker_count; ++i) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+    running_.store(worker_count > 0);
+
+    for (auto& worker : workers_) {
+        Worker* w = worker.get();
+        worker->thread = std::thread([this, w]() { worker_loop(*w); });
+    }
+
+    if (worker_count > 0) {
+        std::cout << "[订单网关] 已启动 " << worker_count << " 个工作线程（按账户分派）\n";
+    } else {
+        std::cout << "[订单网关] 工作线程数为 0，订单同步执行\n";
+    }
+}
+
+void OrderGateway::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    for (auto& worker : workers_) {
+        {
+            std::lock_guard<std::mutex> lock(worker->mutex);
+        }
+        worker->cv.notify_all();
+    }
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+
+    std::cout << "[订单网关] 已停止 (提交: " << submitted_.load()
+              << ", 完成: " << completed_.load() << ")\n";
+}
+
+void OrderGateway::submit(const std::string& key, Task task) {
+    submitted_++;
+
+    if (!running_.load() || workers_.empty()) {
+        run_task(task);
+        return;
+    }
+
+    Worker& worker = *workers_[route(key)];
+    {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.queue.push_back(std::move(task));
+        if (worker.queue.size() > worker.max_depth) {
+            worker.max_depth = worker.queue.size();
+        }
+    }
+    worker.cv.notify_one();
+}
+
+OrderGateway::Stats OrderGateway::get_stats() const {
+    Stats stats;
+    stats.submitted = submitted_.load();
+    stats.completed = completed_.load();
+    for (const auto& worker : workers_) {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        stats.pending += worker->queue.size();
+        if (worker->max_depth > stats.max_queue_depth) {
+            stats.max_queue_depth = worker->max_depth;
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(route_mutex_);
+        stats.accounts = routes_.size();
+    }
+    return stats;
+}
+
+size_t OrderGateway::route(const std::string& key) {
+    std::lock_guard<std::mutex> lock(route_mutex_);
+
+    auto it = routes_.find(key);
+    if (it != routes_.end()) {
+        return it->second;
+    }
+
+    size_t best = 0;
+    for (size_t i = 1; i < workers_.size(); ++i) {
+        if (workers_[i]->assigned < workers_[best]->assigned) {
+            best = i;
+        }
+    }
+    workers_[best]->assigned++;
+    routes_[key] = best;
+    return best;
+}
+
+void OrderGateway::worker_loop(Worker& worker) {
+    while (true) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(worker.mutex);
+            worker.cv.wait(lock, [&]() { return !worker.queue.empty() || !running_.load(); });
+            if (worker.queue.empty()) {
+                break;  // 已停止且队列已清空
+            }
+            task = std::move(worker.queue.front());
+            worker.queue.pop_front();
+        }
+        run_task(task);
+    }
+}
+
+void OrderGateway::run_task(Task& task) {
+    try {
+        task();
+    } catch (const std::exception& e) {
+        Logger::instance().error("system", std::string("[订单网关] 任务异常: ") + e.what());
+    } catch (...) {
+        Logger::instance().error("system", "[订单网关] 任务未知异常");
+    }
+    completed_++;
+}
+
+} // namespace server
+} // namespace trading
@@ -0,0 +1,104 @@
+/**
+ * @file order_gateway.h
+ * @brief 异步订单网关 - 按账户分派到工作线程池
+ *
+ * 订单线程只做解析和风控检查，交易所 REST 调用交给网关执行：
+ * - 同一账户的请求始终落在同一个工作线程，保证下单/撤单/改单顺序
+ * - 不同账户分配到不同工作线程并行执行，一个慢请求不再阻塞其他账户
+ * - 回报在请求完成时由工作线程直接发布（ZmqServer::publish_report 线程安全）
+ *
+ * 工作线程数为 0 时退化为同步执行（与原来的行为一致）
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <condition_variable>
+#include <unordered_map>
+
+namespace trading {
+namespace server {
+
+class OrderGateway {
+public:
+    using Task = std::function<void()>;
+
+    /**
+     * @brief 网关统计
+     */
+    struct Stats {
+        uint64_t submitted = 0;      // 提交的任务数
+        uint64_t completed = 0;      // 完成的任务数
+        size_t pending = 0;          // 当前排队中的任务数
+        size_t max_queue_depth = 0;  // 单个工作线程历史最大排队深度
+        size_t accounts = 0;         // 已分配的账户数
+    };
+
+    OrderGateway() = default;
+    ~OrderGateway() { stop(); }
+
+    OrderGateway(const OrderGateway&) = delete;
+    OrderGateway& operator=(const OrderGateway&) = delete;
+
+    /**
+     * @brief 启动工作线程
+     * @param worker_count 工作线程数（0 表示同步执行）
+     */
+    void start(size_t worker_count);
+
+    /**
+     * @brief 停止工作线程（执行完已排队的任务后退出）
+     */
+    void stop();
+
+    bool is_running() const { return running_.load(); }
+
+    /**
+     * @brief 提交任务
+     *
+     * @param key 路由键（账户ID，缺省为策略ID），相同 key 按提交顺序执行
+     * @param task 任务（需按值捕获请求数据）
+     */
+    void submit(const std::string& key, Task task);
+
+    Stats get_stats() const;
+
+    size_t worker_count() const { return workers_.size(); }
+
+private:
+    struct Worker {
+        std::thread thread;
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::deque<Task> queue;
+        size_t assigned = 0;         // 分配到该线程的账户数
+        size_t max_depth = 0;
+    };
+
+    void worker_loop(Worker& worker);
+    size_t route(const std::string& key);
+    void run_task(Task& task);
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<bool> running_{false};
+
+    // 账户 -> 工作线程（首次出现时分配给账户最少的线程，之后固定）
+    mutable std::mutex route_mutex_;
+    std::unordered_map<std::string, size_t> routes_;
+
+    std::atomic<uint64_t> submitted_{0};
+    std::atomic<uint64_t> completed_{0};
+};
+
+// 全局订单网关（在 order_gateway.cpp 中定义）
+extern OrderGateway g_order_gateway;
+
+} // namespace server
+} // namespace trading
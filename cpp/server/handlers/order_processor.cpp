@@ -4,6 +4,8 @@
  */
 
 #include "order_processor.h"
+#include "order_gateway.h"
+#include "ws_order_router.h"
 #include "../config/server_config.h"
 #include "../managers/account_manager.h"
 #include "../managers/account_monitor.h"  // 账户监控模块
@@ -83,9 +85,16 @@ static std::string get_log_source(const std::string& strategy_id) {
     return strategy_id;
 }
 
-void process_place_order(ZmqServer& server, const nlohmann::json& order) {
-    g_order_count++;
+// 订单网关路由键：按账户分派，未登记账户的策略按策略ID分派
+static std::string get_route_key(const std::string& strategy_id) {
+    std::string account_id = get_account_id(strategy_id);
+    return account_id.empty() ? strategy_id : account_id;
+}
 
+/**
+ * @brief 执行下单（交易所 REST 调用 + 发布回报），在订单网关工作线程中运行
+ */
+static void execute_place_order(ZmqServer& server, const nlohmann::json& order) {
     std::string strategy_id = order.value("strategy_id", "unknown");
     std::string client_order_id = order.value("client_order_id", "");
     std::string symbol = order.value("symbol", "BTC-USDT");
@@ -97,96 +106,6 @@ void process_place_order(ZmqServer& server, const nlohmann::json& order) {
     std::string pos_side = order.value("pos_side", "");
     std::string tgt_ccy = order.value("tgt_ccy", "");
 
-    LOG_ORDER_SRC(get_log_source(strategy_id), client_order_id, "RECEIVED", "symbol=" + symbol + " side=" + side + " qty=" + std::to_string(quantity));
-    LOG_AUDIT_SRC(get_log_source(strategy_id), "ORDER_SUBMIT", "order_id=" + client_order_id + " symbol=" + symbol);
-
-    Logger::instance().info(get_log_source(strategy_id), "[下单] " + symbol + " | " + side + " " + order_type + " | 数量: " + std::to_string(quantity));
-
-    // 🆕 验证策略是否已注册
-    // TODO: 实现 is_strategy_registered 函数
-    /*
-    if (!is_strategy_registered(strategy_id)) {
-        std::string error_msg = "策略 " + strategy_id + " 未注册账户";
-        std::cout << "[下单] ✗ " << error_msg << "\n";
-        LOG_ORDER_SRC(get_log_source(strategy_id), client_order_id, "REJECTED", "reason=" + error_msg);
-        g_order_failed++;
-
-        nlohmann::json report = make_order_report(
-            strategy_id, client_order_id, "", symbol,
-            "rejected", price, quantity, 0.0, error_msg
-        );
-        server.publish_report(report);
-        return;
-    }
-    */
-
-    // ========== 风控检查 ==========
-    // 在实盘交易前进行风控检查
-    OrderSide order_side = (side == "buy" || side == "BUY") ? OrderSide::BUY : OrderSide::SELL;
-
-    // 获取订单金额用于风控检查
-    double order_value = 0.0;
-    double check_price = price;
-
-    // 优先使用策略端传来的 order_value（避免OKX张数/Binance币数计算问题）
-    if (order.contains("order_value")) {
-        order_value = order.value("order_value", 0.0);
-        Logger::instance().info(get_log_source(strategy_id), "[风控] 使用策略端订单金额: " + std::to_string(order_value) + " USDT");
-    } else {
-        // 如果没有 order_value，则使用 estimated_price * quantity 计算
-        if ((price == 0.0 || order_type == "market") && order.contains("estimated_price")) {
-            check_price = order.value("estimated_price", 0.0);
-            Logger::instance().info(get_log_source(strategy_id), "[风控] 市价单使用估算价格: " + std::to_string(check_price) + " USDT");
-        }
-        order_value = check_price * quantity;
-        Logger::instance().info(get_log_source(strategy_id), "[风控] 计算订单金额: " + std::to_string(check_price) + " × " + std::to_string(quantity) + " = " + std::to_string(order_value) + " USDT");
-    }
-
-    // 调试：打印订单信息和当前风控限制
-    auto current_limits = g_risk_manager.get_limits();
-    Logger::instance().info(get_log_source(strategy_id), "[风控] 检查订单: " + symbol + " " + side + " 订单金额=" + std::to_string(order_value) + " USDT");
-    Logger::instance().info(get_log_source(strategy_id), "[风控] 当前限制: max_order_value=" + std::to_string(current_limits.max_order_value) + " USDT");
-
-    // 使用 check_order_with_value 传入准确的订单金额
-    RiskCheckResult risk_result = g_risk_manager.check_order_with_value(symbol, order_side, check_price, quantity, order_value, strategy_id);
-
-    if (!risk_result.passed) {
-        // 风控检查失败，拒绝订单
-        std::string error_msg = "[风控拒绝] " + risk_result.reason;
-        Logger::instance().error(get_log_source(strategy_id), "[下单] ✗ " + error_msg);
-        LOG_ORDER_SRC(get_log_source(strategy_id), client_order_id, "RISK_REJECTED", "reason=" + risk_result.reason);
-        g_order_failed++;
-
-        nlohmann::json report = make_order_report(
-            strategy_id, client_order_id, "", symbol,
-            "rejected", price, quantity, 0.0, error_msg
-        );
-        report["risk_check"] = false;
-        report["risk_reason"] = risk_result.reason;
-        server.publish_report(report);
-
-        // 发送到前端 WebSocket
-        if (g_frontend_server) {
-            g_frontend_server->send_event("order_report", report);
-        }
-
-        // 发送风控告警
-        std::string acct = get_account_id(strategy_id);
-        std::string acct_info = acct.empty() ? "" : (" 账户: " + acct);
-        g_risk_manager.send_alert(
-            "订单被风控拒绝: " + strategy_id + acct_info + " " + symbol + " " + side + " " + std::to_string(quantity) +
-            "\n原因: " + risk_result.reason,
-            AlertLevel::WARNING,
-            "风控拒绝订单"
-        );
-        return;
-    }
-
-    // 风控检查通过，记录订单执行
-    g_risk_manager.record_order_execution();
-    Logger::instance().info(get_log_source(strategy_id), "[风控] ✓ 订单通过风控检查");
-    // ========== 风控检查结束 ==========
-
     // 获取交易所类型
     std::string exchange = order.value("exchange", "okx");
     std::transform(exchange.begin(), exchange.end(), exchange.begin(), ::tolower);
@@ -374,6 +293,252 @@ void process_place_order(ZmqServer& server, const nlohmann::json& order) {
     server.publish_report(report);
 }
 
+// ==================== WebSocket 订单通道回报 ====================
+
+/**
+ * @brief 解析 WebSocket 交易响应
+ * @return 交易所是否接受请求
+ */
+static bool parse_ws_response(const WsPendingRequest& pending, const nlohmann::json& response,
+                              std::string& exchange_order_id, std::string& error_msg) {
+    if (pending.exchange == ExchangeType::OKX) {
+        // {"id", "op", "code", "msg", "data": [{"ordId", "clOrdId", "sCode", "sMsg"}]}
+        const nlohmann::json* item = nullptr;
+        if (response.contains("data") && response["data"].is_array() && !response["data"].empty()) {
+            item = &response["data"][0];
+            exchange_order_id = item->value("ordId", "");
+        }
+        if (response.value("code", "") == "0" && item && item->value("sCode", "") == "0") {
+            return true;
+        }
+        std::string s_msg = item ? item->value("sMsg", "") : "";
+        error_msg = s_msg.empty() ? response.value("msg", "API error") : s_msg;
+        return false;
+    }
+
+    // Binance: {"id", "status": 200, "result": {"orderId", ...}} / {"status": 4xx, "error": {"code", "msg"}}
+    if (response.value("status", 0) == 200 && response.contains("result")) {
+        const auto& result = response["result"];
+        if (result.contains("orderId") && result["orderId"].is_number()) {
+            exchange_order_id = std::to_string(result["orderId"].get<int64_t>());
+        }
+        return true;
+    }
+    error_msg = (response.contains("error") && response["error"].is_object())
+        ? response["error"].value("msg", "未知错误") : "未知错误";
+    return false;
+}
+
+/**
+ * @brief WebSocket 响应 -> 订单/撤单/改单回报（格式与 REST 路径一致，额外带 route = "ws"）
+ */
+static void handle_ws_order_response(ZmqServer& server, const WsPendingRequest& pending,
+                                     const nlohmann::json& response, bool timed_out) {
+    const auto& request = pending.request;
+    std::string strategy_id = request.value("strategy_id", "unknown");
+    std::string client_order_id = request.value("client_order_id", "");
+    std::string order_id = request.value("order_id", "");
+    std::string symbol = request.value("symbol", "");
+    std::string exchange = (pending.exchange == ExchangeType::BINANCE) ? "binance" : "okx";
+
+    bool success = false;
+    std::string exchange_order_id;
+    std::string error_msg;
+    if (timed_out) {
+        error_msg = "WebSocket 响应超时，订单状态未知，请查询确认";
+    } else {
+        success = parse_ws_response(pending, response, exchange_order_id, error_msg);
+    }
+
+    auto rtt_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count() - pending.sent_ns;
+    std::string rtt_str = LatencyHistogram::format_ns(static_cast<uint64_t>(rtt_ns));
+
+    if (pending.kind == WsRequestKind::PLACE) {
+        std::string side = request.value("side", "buy");
+        double price = request.value("price", 0.0);
+        double quantity = request.value("quantity", 0.0);
+
+        if (success) {
+            g_order_success++;
+            LOG_ORDER_SRC(get_log_source(strategy_id), client_order_id, "ACCEPTED", "exchange_id=" + exchange_order_id + " route=ws");
+            Logger::instance().info(get_log_source(strategy_id), "[WS响应] 订单ID: " + client_order_id + " | 往返: " + rtt_str + " | ✓");
+        } else if (timed_out) {
+            LOG_ORDER_SRC(get_log_source(strategy_id), client_order_id, "TIMEOUT", "route=ws");
+            Logger::instance().error(get_log_source(strategy_id), "[WS响应] 订单ID: " + client_order_id + " | ✗ " + error_msg);
+        } else {
+            g_order_failed++;
+            LOG_ORDER_SRC(get_log_source(strategy_id), client_order_id, "REJECTED", "error=" + error_msg + " route=ws");
+            Logger::instance().error(get_log_source(strategy_id), "[WS响应] 订单ID: " + client_order_id + " | 往返: " + rtt_str + " | ✗ " + error_msg);
+        }
+
+        // 下单失败时发送邮件通知
+        if (!success) {
+            std::string acct = get_account_id(strategy_id);
+            std::string acct_line = acct.empty() ? "" : ("账户: " + acct + "\n");
+            std::string email_body = acct_line + "策略: " + strategy_id + "\n交易对: " + symbol + "\n方向: " + side +
+                "\n数量: " + std::to_string(quantity) + "\n失败原因: " + error_msg;
+            g_risk_manager.send_risk_alert_to_strategy(strategy_id, email_body,
+                exchange == "binance" ? "Binance下单失败" : "OKX下单失败");
+        }
+
+        std::string status = success ? (exchange == "binance" ? "submitted" : "accepted")
+                                     : (timed_out ? "timeout" : "rejected");
+        nlohmann::json report = make_order_report(
+            strategy_id, client_order_id, exchange_order_id, symbol,
+            status, price, quantity, 0.0, error_msg, exchange
+        );
+        report["route"] = "ws";
+        if (exchange == "binance") {
+            report["side"] = side;
+        }
+        server.publish_report(report);
+
+        if (exchange == "binance" && g_frontend_server) {
+            g_frontend_server->send_event("order_report", report);
+        }
+        return;
+    }
+
+    std::string cancel_id = order_id.empty() ? client_order_id : order_id;
+    bool is_cancel = (pending.kind == WsRequestKind::CANCEL);
+    if (success) {
+        if (is_cancel) LOG_ORDER_SRC(get_log_source(strategy_id), cancel_id, "CANCELLED", "success route=ws");
+        Logger::instance().info(get_log_source(strategy_id), std::string(is_cancel ? "[撤单]" : "[修改订单]") + " ✓ 成功 (WS, 往返: " + rtt_str + ")");
+    } else {
+        if (is_cancel) LOG_ORDER_SRC(get_log_source(strategy_id), cancel_id, timed_out ? "CANCEL_TIMEOUT" : "CANCEL_FAILED", "error=" + error_msg + " route=ws");
+        Logger::instance().error(get_log_source(strategy_id), std::string(is_cancel ? "[撤单]" : "[修改订单]") + " ✗ " + error_msg);
+    }
+
+    std::string ok_status = is_cancel ? "cancelled" : "amended";
+    nlohmann::json report = {
+        {"type", is_cancel ? "cancel_report" : "amend_report"}, {"strategy_id", strategy_id},
+        {"order_id", order_id}, {"client_order_id", client_order_id},
+        {"status", success ? ok_status : (timed_out ? "timeout" : "rejected")},
+        {"error_msg", error_msg}, {"timestamp", current_timestamp_ms()},
+        {"route", "ws"}
+    };
+    server.publish_report(report);
+}
+
+void init_ws_order_routing(ZmqServer& server) {
+    g_ws_order_router.set_response_handler(
+        [&server](const WsPendingRequest& pending, const nlohmann::json& response, bool timed_out) {
+            handle_ws_order_response(server, pending, response, timed_out);
+        });
+}
+
+void process_place_order(ZmqServer& server, const nlohmann::json& order) {
+    g_order_count++;
+
+    std::string strategy_id = order.value("strategy_id", "unknown");
+    std::string client_order_id = order.value("client_order_id", "");
+    std::string symbol = order.value("symbol", "BTC-USDT");
+    std::string side = order.value("side", "buy");
+    std::string order_type = order.value("order_type", "limit");
+    double price = order.value("price", 0.0);
+    double quantity = order.value("quantity", 0.0);
+
+    LOG_ORDER_SRC(get_log_source(strategy_id), client_order_id, "RECEIVED", "symbol=" + symbol + " side=" + side + " qty=" + std::to_string(quantity));
+    LOG_AUDIT_SRC(get_log_source(strategy_id), "ORDER_SUBMIT", "order_id=" + client_order_id + " symbol=" + symbol);
+
+    Logger::instance().info(get_log_source(strategy_id), "[下单] " + symbol + " | " + side + " " + order_type + " | 数量: " + std::to_string(quantity));
+
+    // 🆕 验证策略是否已注册
+    // TODO: 实现 is_strategy_registered 函数
+    /*
+    if (!is_strategy_registered(strategy_id)) {
+        std::string error_msg = "策略 " + strategy_id + " 未注册账户";
+        std::cout << "[下单] ✗ " << error_msg << "\n";
+        LOG_ORDER_SRC(get_log_source(strategy_id), client_order_id, "REJECTED", "reason=" + error_msg);
+        g_order_failed++;
+
+        nlohmann::json report = make_order_report(
+            strategy_id, client_order_id, "", symbol,
+            "rejected", price, quantity, 0.0, error_msg
+        );
+        server.publish_report(report);
+        return;
+    }
+    */
+
+    // ========== 风控检查 ==========
+    // 在实盘交易前进行风控检查
+    OrderSide order_side = (side == "buy" || side == "BUY") ? OrderSide::BUY : OrderSide::SELL;
+
+    // 获取订单金额用于风控检查
+    double order_value = 0.0;
+    double check_price = price;
+
+    // 优先使用策略端传来的 order_value（避免OKX张数/Binance币数计算问题）
+    if (order.contains("order_value")) {
+        order_value = order.value("order_value", 0.0);
+        Logger::instance().info(get_log_source(strategy_id), "[风控] 使用策略端订单金额: " + std::to_string(order_value) + " USDT");
+    } else {
+        // 如果没有 order_value，则使用 estimated_price * quantity 计算
+        if ((price == 0.0 || order_type == "market") && order.contains("estimated_price")) {
+            check_price = order.value("estimated_price", 0.0);
+            Logger::instance().info(get_log_source(strategy_id), "[风控] 市价单使用估算价格: " + std::to_string(check_price) + " USDT");
+        }
+        order_value = check_price * quantity;
+        Logger::instance().info(get_log_source(strategy_id), "[风控] 计算订单金额: " + std::to_string(check_price) + " × " + std::to_string(quantity) + " = " + std::to_string(order_value) + " USDT");
+    }
+
+    // 调试：打印订单信息和当前风控限制
+    const RiskLimits& current_limits = g_risk_manager.limits();  // 快照引用，无锁无拷贝
+    Logger::instance().info(get_log_source(strategy_id), "[风控] 检查订单: " + symbol + " " + side + " 订单金额=" + std::to_string(order_value) + " USDT");
+    Logger::instance().info(get_log_source(strategy_id), "[风控] 当前限制: max_order_value=" + std::to_string(current_limits.max_order_value) + " USDT");
+
+    // 使用 check_order_with_value 传入准确的订单金额
+    RiskCheckResult risk_result = g_risk_manager.check_order_with_value(symbol, order_side, check_price, quantity, order_value, strategy_id);
+
+    if (!risk_result.passed) {
+        // 风控检查失败，拒绝订单
+        std::string error_msg = "[风控拒绝] " + risk_result.reason;
+        Logger::instance().error(get_log_source(strategy_id), "[下单] ✗ " + error_msg);
+        LOG_ORDER_SRC(get_log_source(strategy_id), client_order_id, "RISK_REJECTED", "reason=" + risk_result.reason);
+        g_order_failed++;
+
+        nlohmann::json report = make_order_report(
+            strategy_id, client_order_id, "", symbol,
+            "rejected", price, quantity, 0.0, error_msg
+        );
+        report["risk_check"] = false;
+        report["risk_reason"] = risk_result.reason;
+        server.publish_report(report);
+
+        // 发送到前端 WebSocket
+        if (g_frontend_server) {
+            g_frontend_server->send_event("order_report", report);
+        }
+
+        // 发送风控告警
+        std::string acct = get_account_id(strategy_id);
+        std::string acct_info = acct.empty() ? "" : (" 账户: " + acct);
+        g_risk_manager.send_alert(
+            "订单被风控拒绝: " + strategy_id + acct_info + " " + symbol + " " + side + " " + std::to_string(quantity) +
+            "\n原因: " + risk_result.reason,
+            AlertLevel::WARNING,
+            "风控拒绝订单"
+        );
+        return;
+    }
+
+    // 风控检查通过（频率配额已在检查时扣除），记录下单数
+    g_risk_manager.record_order_execution();
+    Logger::instance().info(get_log_source(strategy_id), "[风控] ✓ 订单通过风控检查");
+    // ========== 风控检查结束 ==========
+
+    // 交易所调用交给订单网关（同账户串行，不同账户并行）
+    // 开启 WebSocket 订单通道的账户优先走 WS，通道不可用时回退 REST
+    std::string route_key = get_route_key(strategy_id);
+    g_order_gateway.submit(route_key, [&server, order, route_key]() {
+        if (!g_ws_order_router.submit(route_key, WsRequestKind::PLACE, order)) {
+            execute_place_order(server, order);
+        }
+    });
+}
+
 void process_batch_orders(ZmqServer& server, const nlohmann::json& request) {
     std::string strategy_id = request.value("strategy_id", "unknown");
     std::string batch_id = request.value("batch_id", "");
@@ -749,6 +914,11 @@ void process_cancel_order(ZmqServer& server, const nlohmann::json& request) {
 
     Logger::instance().info(get_log_source(strategy_id), "[撤单] " + symbol + " | " + cancel_id);
 
+    // 开启 WebSocket 订单通道的账户优先走 WS，结果由 WS 响应回报
+    if (g_ws_order_router.submit(get_route_key(strategy_id), WsRequestKind::CANCEL, request)) {
+        return;
+    }
+
     okx::OKXRestAPI* api = get_api_for_strategy(strategy_id);
     if (!api) {
         nlohmann::json report = {
@@ -870,6 +1040,11 @@ void process_amend_order(ZmqServer& server, const nlohmann::json& request) {
 
     Logger::instance().info(get_log_source(strategy_id), "[修改订单] " + symbol);
 
+    // 开启 WebSocket 订单通道的账户优先走 WS，结果由 WS 响应回报
+    if (g_ws_order_router.submit(get_route_key(strategy_id), WsRequestKind::AMEND, request)) {
+        return;
+    }
+
     okx::OKXRestAPI* api = get_api_for_strategy(strategy_id);
     if (!api) {
         nlohmann::json report = {
@@ -1044,6 +1219,37 @@ void process_register_account(ZmqServer& server, const nlohmann::json& request)
                 }
             }
 
+            // 以下任务在该账户的网关线程中执行：不阻塞注册，且排在该账户首单之前
+            std::string route_key = get_route_key(strategy_id);
+
+            // 预热 REST 连接
+            if (g_http_warmup_connections > 0 && !strategy_id.empty()) {
+                g_order_gateway.submit(route_key, [strategy_id, ex_type]() {
+                    int count = g_http_warmup_connections;
+                    if (ex_type == ExchangeType::OKX) {
+                        if (auto* api = g_account_registry.get_okx_api(strategy_id)) {
+                            api->warm_up_connections(count);
+                        }
+                    } else if (ex_type == ExchangeType::BINANCE) {
+                        if (auto* api = g_account_registry.get_binance_api(strategy_id)) {
+                            api->warm_up_connections(count);
+                        }
+                    }
+                });
+            }
+
+            // 订单通道：order_route = "ws" 时建立 WebSocket 订单通道（REST 兜底）
+            std::string order_route = request.value("order_route", g_default_order_route);
+            if (order_route == "ws" && !strategy_id.empty()) {
+                g_order_gateway.submit(route_key, [route_key, ex_type, api_key, secret_key, passphrase, is_testnet]() {
+                    if (ex_type == ExchangeType::OKX) {
+                        g_ws_order_router.enable_okx(route_key, api_key, secret_key, passphrase, is_testnet);
+                    } else if (ex_type == ExchangeType::BINANCE) {
+                        g_ws_order_router.enable_binance(route_key, api_key, secret_key, is_testnet);
+                    }
+                });
+            }
+
             // 动态添加到账户监控器（如果该 account_id 已在监控中，跳过避免重复）
             bool already_monitored = false;
             if (g_account_monitor && !account_id.empty()) {
@@ -1114,8 +1320,14 @@ void process_unregister_account(ZmqServer& server, const nlohmann::json& request
         report["error_msg"] = "缺少 strategy_id";
     } else {
         ExchangeType ex_type = string_to_exchange_type(exchange);
+        std::string route_key = get_route_key(strategy_id);
         bool success = g_account_registry.unregister_account(strategy_id, ex_type);
 
+        // 关闭该账户的 WebSocket 订单通道（当前已在该账户的网关线程中，已排队请求均已执行）
+        if (success && g_ws_order_router.is_enabled(route_key)) {
+            g_ws_order_router.disable(route_key);
+        }
+
         // 同步从账户监控中移除
         if (success && g_account_monitor) {
             if (ex_type == ExchangeType::OKX) {
@@ -1474,26 +1686,34 @@ void process_change_leverage(ZmqServer& server, const nlohmann::json& request) {
 void process_order_request(ZmqServer& server, const nlohmann::json& request) {
     std::string type = request.value("type", "order_request");
 
+    // 涉及交易所 REST 的请求交给订单网关异步执行（按值捕获请求）
+    // 账户注册/注销也走该账户的网关线程：注销排在已排队的撤单之后执行，
+    // 且不会在工作线程仍持有 API 指针时释放账户
+    auto submit = [&server, &request](void (*handler)(ZmqServer&, const nlohmann::json&)) {
+        g_order_gateway.submit(get_route_key(request.value("strategy_id", "unknown")),
+                               [&server, request, handler]() { handler(server, request); });
+    };
+
     if (type == "order_request") {
-        process_place_order(server, request);
+        process_place_order(server, request);  // 风控检查在订单线程，REST 调用在网关
     } else if (type == "batch_order_request") {
-        process_batch_orders(server, request);
+        submit(process_batch_orders);
     } else if (type == "cancel_request") {
-        process_cancel_order(server, request);
+        submit(process_cancel_order);
     } else if (type == "batch_cancel_request") {
-        process_batch_cancel(server, request);
+        submit(process_batch_cancel);
     } else if (type == "amend_request") {
-        process_amend_order(server, request);
+        submit(process_amend_order);
     } else if (type == "register_account") {
-        process_register_account(server, request);
+        submit(process_register_account);
     } else if (type == "unregister_account") {
-        process_unregister_account(server, request);
+        submit(process_unregister_account);
     } else if (type == "query_account") {
-        process_query_account(server, request);
+        submit(process_query_account);
     } else if (type == "query_positions") {
-        process_query_positions(server, request);
+        submit(process_query_positions);
     } else if (type == "change_leverage") {
-        process_change_leverage(server, request);
+        submit(process_change_leverage);
     } else if (type == "heartbeat") {
         // 策略心跳 - 轻量处理，不打日志避免刷屏
         std::string sid = request.value("strategy_id", "");
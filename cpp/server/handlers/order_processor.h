@@ -29,6 +29,13 @@ extern AccountMonitor* g_account_monitor;
 // 全局策略进程管理器（在 trading_server_main.cpp 中定义）
 extern StrategyProcessManager g_strategy_manager;
 
+/**
+ * @brief 初始化 WebSocket 订单通道（注册响应回报处理）
+ *
+ * 在订单线程启动前调用
+ */
+void init_ws_order_routing(ZmqServer& server);
+
 /**
  * @brief 处理下单请求
  */
@@ -5,6 +5,7 @@
 
 #include "subscription_manager.h"
 #include "../config/server_config.h"
+#include "../managers/order_book_manager.h"
 #include "../../adapters/okx/okx_websocket.h"
 #include "../../adapters/binance/binance_websocket.h"
 #include <iostream>
@@ -16,6 +17,13 @@ namespace server {
 // OKX K线订阅引用计数：key = "symbol:interval", value = 引用计数
 static std::map<std::string, int> g_okx_kline_ref_count;
 
+// Binance depth<levels> 订阅：key = 大写 symbol，value = 已订阅的档位
+// depth<levels> 与 books（diff depth）推送格式相同，同一 symbol 只允许其中一种
+static std::map<std::string, std::set<int>> g_binance_depth_levels;
+
+// Binance 订单簿（books）订阅引用计数：key = 大写 symbol，最后一个订阅者退订时才拆除本地订单簿
+static std::map<std::string, int> g_binance_book_ref_count;
+
 void handle_subscription(const nlohmann::json& request) {
     std::string action = request.value("action", "subscribe");
     std::string channel = request.value("channel", "");
@@ -60,14 +68,58 @@ void handle_subscription(const nlohmann::json& request) {
         }
         else if (channel == "orderbook" || channel == "depth") {
             int levels = request.value("levels", 20);
+            std::string upper_symbol = symbol;
+            std::transform(upper_symbol.begin(), upper_symbol.end(), upper_symbol.begin(), ::toupper);
             if (action == "subscribe" && g_binance_ws_market) {
+                if (g_order_book_manager.has_binance(upper_symbol)) {
+                    // 增量会被当作 diff 打断 pu 连续性，导致反复拉取 REST 快照
+                    std::cerr << "[订阅] Binance 深度: " << symbol
+                              << " 已订阅 books（diff depth），拒绝 depth" << levels << "，请使用 books 频道\n";
+                    return;
+                }
                 g_binance_ws_market->subscribe_depth(lower_symbol, levels);
+                g_binance_depth_levels[upper_symbol].insert(levels);
                 std::cout << "[订阅] Binance 深度: " << symbol << " ✓\n";
             } else if (action == "unsubscribe" && g_binance_ws_market) {
                 g_binance_ws_market->unsubscribe(lower_symbol + "@depth" + std::to_string(levels));
+                auto it = g_binance_depth_levels.find(upper_symbol);
+                if (it != g_binance_depth_levels.end()) {
+                    it->second.erase(levels);
+                    if (it->second.empty()) g_binance_depth_levels.erase(it);
+                }
                 std::cout << "[取消订阅] Binance 深度: " << symbol << " ✓\n";
             }
         }
+        else if (channel == "books") {
+            // 完整订单簿：diff depth + REST 快照，在服务端维护后按前 N 档发布
+            std::string upper_symbol = symbol;
+            std::transform(upper_symbol.begin(), upper_symbol.end(), upper_symbol.begin(), ::toupper);
+            if (action == "subscribe" && g_binance_ws_market) {
+                if (g_binance_depth_levels.count(upper_symbol)) {
+                    std::cerr << "[订阅] Binance 订单簿: " << symbol
+                              << " 已订阅 depth<levels>，两者推送格式相同无法区分，拒绝 books\n";
+                    return;
+                }
+                int ref_count = ++g_binance_book_ref_count[upper_symbol];
+                if (ref_count == 1) {
+                    g_order_book_manager.add_binance(upper_symbol);
+                    g_binance_ws_market->subscribe_diff_depth(lower_symbol);
+                }
+                std::cout << "[订阅] Binance 订单簿: " << symbol << " ✓ (引用计数: " << ref_count << ")\n";
+            } else if (action == "unsubscribe" && g_binance_ws_market) {
+                auto it = g_binance_book_ref_count.find(upper_symbol);
+                if (it == g_binance_book_ref_count.end()) {
+                    std::cout << "[取消订阅] Binance 订单簿: " << symbol << " 未订阅，忽略\n";
+                } else if (--it->second > 0) {
+                    std::cout << "[取消订阅] Binance 订单簿: " << symbol << " ✓ (引用计数: " << it->second << ")\n";
+                } else {
+                    g_binance_book_ref_count.erase(it);
+                    g_binance_ws_market->unsubscribe(lower_symbol + "@depth@100ms");
+                    g_order_book_manager.remove_binance(upper_symbol);
+                    std::cout << "[取消订阅] Binance 订单簿: " << symbol << " ✓ (已无订阅者)\n";
+                }
+            }
+        }
         else if (channel == "mark_price" || channel == "markPrice") {
             if (action == "subscribe" && g_binance_ws_market) {
                 g_binance_ws_market->subscribe_mark_price(lower_symbol);
@@ -157,6 +209,7 @@ void handle_subscription(const nlohmann::json& request) {
         } else if (action == "unsubscribe" && g_ws_public) {
             g_ws_public->unsubscribe_orderbook(symbol, depth_channel);
             g_subscribed_orderbooks[symbol].erase(depth_channel);
+            g_order_book_manager.remove_okx(symbol, depth_channel);
             std::cout << "[取消订阅] OKX 深度: " << symbol << " " << depth_channel << " ✓\n";
         }
     }
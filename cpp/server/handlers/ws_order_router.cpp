@@ -0,0 +1,365 @@
+/**
+ * @file ws_order_router.cpp
+ * @brief WebSocket 订单通道实现
+ */
+
+#include "ws_order_router.h"
+#include "../../adapters/okx/okx_websocket.h"
+#include "../../adapters/binance/binance_websocket.h"
+#include "../../core/logger.h"
+#include <chrono>
+#include <vector>
+#include <iostream>
+
+using namespace trading::core;
+
+namespace trading {
+namespace server {
+
+WsOrderRouter g_ws_order_router;
+
+namespace {
+
+int64_t steady_now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+// ==================== 会话管理 ====================
+
+bool WsOrderRouter::Session::ready() const {
+    if (exchange == ExchangeType::OKX) {
+        return okx && okx->is_connected() && okx->is_logged_in();
+    }
+    return binance && binance->is_connected();
+}
+
+WsOrderRouter::~WsOrderRouter() {
+    stop();
+}
+
+void WsOrderRouter::set_response_handler(ResponseHandler handler) {
+    handler_ = std::move(handler);
+}
+
+bool WsOrderRouter::enable_okx(const std::string& route_key, const std::string& api_key,
+                               const std::string& secret_key, const std::string& passphrase,
+                               bool is_testnet) {
+    if (is_enabled(route_key)) {
+        return true;
+    }
+
+    auto session = std::make_shared<Session>();
+    session->exchange = ExchangeType::OKX;
+    session->okx = okx::create_private_ws(api_key, secret_key, passphrase, is_testnet);
+    session->okx->set_auto_reconnect(true);  // 重连后自动重新登录
+    session->okx->set_place_order_callback([this](const nlohmann::json& data) { on_response(data); });
+
+    if (!session->okx->connect()) {
+        Logger::instance().error("system", "[WS订单] ✗ OKX 私有频道连接失败: " + route_key);
+        return false;
+    }
+    session->okx->login();
+    if (!session->okx->wait_for_login(5000)) {
+        Logger::instance().error("system", "[WS订单] ✗ OKX 私有频道登录失败: " + route_key);
+        session->okx->disconnect();
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(sessions_mutex_);
+        sessions_[route_key] = session;
+    }
+    Logger::instance().info("system", "[WS订单] ✓ OKX WebSocket 订单通道已开启: " + route_key);
+    return true;
+}
+
+bool WsOrderRouter::enable_binance(const std::string& route_key, const std::string& api_key,
+                                   const std::string& secret_key, bool is_testnet) {
+    if (is_enabled(route_key)) {
+        return true;
+    }
+
+    auto session = std::make_shared<Session>();
+    session->exchange = ExchangeType::BINANCE;
+    session->binance = binance::create_trading_ws(api_key, secret_key, binance::MarketType::FUTURES, is_testnet);
+    session->binance->set_auto_reconnect(true);
+    session->binance->set_order_response_callback([this](const nlohmann::json& data) { on_response(data); });
+
+    if (!session->binance->connect()) {
+        Logger::instance().error("system", "[WS订单] ✗ Binance 交易 API 连接失败: " + route_key);
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(sessions_mutex_);
+        sessions_[route_key] = session;
+    }
+    Logger::instance().info("system", "[WS订单] ✓ Binance WebSocket 订单通道已开启: " + route_key);
+    return true;
+}
+
+void WsOrderRouter::disable(const std::string& route_key) {
+    std::shared_ptr<Session> session;
+    {
+        std::lock_guard<std::mutex> lock(sessions_mutex_);
+        auto it = sessions_.find(route_key);
+        if (it == sessions_.end()) {
+            return;
+        }
+        session = std::move(it->second);
+        sessions_.erase(it);
+    }
+    // 会话在锁外析构（断开连接、等待接收线程退出）
+    Logger::instance().info("system", "[WS订单] 已关闭 WebSocket 订单通道: " + route_key);
+}
+
+bool WsOrderRouter::is_enabled(const std::string& route_key) const {
+    std::lock_guard<std::mutex> lock(sessions_mutex_);
+    return sessions_.count(route_key) > 0;
+}
+
+std::shared_ptr<WsOrderRouter::Session> WsOrderRouter::find_session(const std::string& route_key) const {
+    std::lock_guard<std::mutex> lock(sessions_mutex_);
+    auto it = sessions_.find(route_key);
+    return it == sessions_.end() ? nullptr : it->second;
+}
+
+void WsOrderRouter::stop() {
+    std::unordered_map<std::string, std::shared_ptr<Session>> sessions;
+    {
+        std::lock_guard<std::mutex> lock(sessions_mutex_);
+        sessions.swap(sessions_);
+    }
+    sessions.clear();
+}
+
+// ==================== 发送 ====================
+
+std::string WsOrderRouter::next_request_id() {
+    // OKX 要求请求ID为字母数字且不超过32位
+    return "ws" + std::to_string(request_counter_.fetch_add(1) + 1);
+}
+
+bool WsOrderRouter::submit(const std::string& route_key, WsRequestKind kind, const nlohmann::json& request) {
+    auto session = find_session(route_key);
+    if (!session) {
+        return false;  // 该账户未开启 WS 通道
+    }
+    if (!session->ready()) {
+        fallbacks_++;
+        return false;
+    }
+    // 通道按账户选择，请求指定的交易所与通道不一致时走 REST，避免按错误的交易所格式发单
+    if (string_to_exchange_type(request.value("exchange", "okx")) != session->exchange) {
+        fallbacks_++;
+        return false;
+    }
+
+    std::string request_id = next_request_id();
+
+    // 先登记再发送：响应可能在 send 返回前到达
+    {
+        WsPendingRequest pending;
+        pending.kind = kind;
+        pending.exchange = session->exchange;
+        pending.route_key = route_key;
+        pending.request_id = request_id;
+        pending.request = request;
+        pending.sent_ns = steady_now_ns();
+
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        pending_[request_id] = std::move(pending);
+    }
+
+    if (!send(*session, kind, request, request_id)) {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        pending_.erase(request_id);
+        fallbacks_++;
+        return false;
+    }
+
+    sent_++;
+    return true;
+}
+
+bool WsOrderRouter::send(Session& session, WsRequestKind kind, const nlohmann::json& request,
+                         const std::string& request_id) {
+    std::string symbol = request.value("symbol", "");
+    std::string order_id = request.value("order_id", "");
+    std::string client_order_id = request.value("client_order_id", "");
+
+    if (session.exchange == ExchangeType::OKX) {
+        switch (kind) {
+            case WsRequestKind::PLACE: {
+                // 附带止盈止损的订单走 REST（place_order_ws 不支持 attachAlgoOrds）
+                if (request.contains("attach_algo_ords") && request["attach_algo_ords"].is_array() &&
+                    !request["attach_algo_ords"].empty()) {
+                    return false;
+                }
+                double price = request.value("price", 0.0);
+                std::string tag;
+                if (request.contains("tag") && request["tag"].is_string()) {
+                    tag = request["tag"].get<std::string>();
+                }
+                return !session.okx->place_order_ws(
+                    symbol,
+                    request.value("td_mode", "cash"),
+                    request.value("side", "buy"),
+                    request.value("order_type", "limit"),
+                    std::to_string(request.value("quantity", 0.0)),
+                    price > 0 ? std::to_string(price) : "",
+                    "",
+                    client_order_id,
+                    tag,
+                    request.value("pos_side", ""),
+                    false,
+                    request.value("tgt_ccy", ""),
+                    false,
+                    request_id
+                ).empty();
+            }
+            case WsRequestKind::CANCEL:
+                return !session.okx->cancel_order_ws(symbol, order_id, client_order_id, request_id).empty();
+            case WsRequestKind::AMEND:
+                return !session.okx->amend_order_ws(
+                    symbol, order_id, client_order_id,
+                    request.value("new_quantity", ""), request.value("new_price", ""),
+                    request_id
+                ).empty();
+        }
+        return false;
+    }
+
+    // Binance
+    int64_t exchange_order_id = 0;
+    if (!order_id.empty()) {
+        try {
+            exchange_order_id = std::stoll(order_id);
+        } catch (...) {
+            return false;
+        }
+    }
+
+    std::string pos_side = request.value("pos_side", "");
+    binance::PositionSide position_side = binance::PositionSide::BOTH;
+    if (pos_side == "LONG") position_side = binance::PositionSide::LONG;
+    else if (pos_side == "SHORT") position_side = binance::PositionSide::SHORT;
+
+    switch (kind) {
+        case WsRequestKind::PLACE: {
+            std::string order_type = request.value("order_type", "limit");
+            double price = request.value("price", 0.0);
+            return !session.binance->place_order_ws(
+                symbol,
+                request.value("side", "buy") == "buy" ? binance::OrderSide::BUY : binance::OrderSide::SELL,
+                order_type == "market" ? binance::OrderType::MARKET : binance::OrderType::LIMIT,
+                std::to_string(request.value("quantity", 0.0)),
+                (price > 0 && order_type != "market") ? std::to_string(price) : "",
+                binance::TimeInForce::GTC,
+                position_side,
+                client_order_id,
+                request_id
+            ).empty();
+        }
+        case WsRequestKind::CANCEL:
+            return !session.binance->cancel_order_ws(symbol, exchange_order_id, client_order_id, request_id).empty();
+        case WsRequestKind::AMEND: {
+            // Binance 改单需要方向、数量和价格
+            std::string side = request.value("side", "");
+            std::string new_qty = request.value("new_quantity", "");
+            std::string new_px = request.value("new_price", "");
+            if (side.empty() || new_qty.empty() || new_px.empty()) {
+                return false;
+            }
+            return !session.binance->modify_order_ws(
+                symbol,
+                side == "buy" ? binance::OrderSide::BUY : binance::OrderSide::SELL,
+                new_qty, new_px, exchange_order_id, client_order_id, position_side,
+                request_id
+            ).empty();
+        }
+    }
+    return false;
+}
+
+// ==================== 响应关联 ====================
+
+void WsOrderRouter::on_response(const nlohmann::json& data) {
+    if (!data.contains("id")) {
+        return;
+    }
+    std::string request_id = data["id"].is_string() ? data["id"].get<std::string>() : data["id"].dump();
+
+    WsPendingRequest pending;
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        auto it = pending_.find(request_id);
+        if (it == pending_.end()) {
+            return;  // 不是路由器发出的请求，或已超时
+        }
+        pending = std::move(it->second);
+        pending_.erase(it);
+    }
+
+    responses_++;
+    round_trip_.record(steady_now_ns() - pending.sent_ns);
+
+    if (handler_) {
+        handler_(pending, data, false);
+    }
+}
+
+size_t WsOrderRouter::expire_pending(int timeout_ms) {
+    int64_t deadline = steady_now_ns() - static_cast<int64_t>(timeout_ms) * 1000000;
+
+    std::vector<WsPendingRequest> expired;
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        for (auto it = pending_.begin(); it != pending_.end();) {
+            if (it->second.sent_ns < deadline) {
+                expired.push_back(std::move(it->second));
+                it = pending_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    for (const auto& pending : expired) {
+        timeouts_++;
+        Logger::instance().warn("system", "[WS订单] 请求超时未响应: " + pending.request_id +
+                                " client_order_id=" + pending.request.value("client_order_id", ""));
+        if (handler_) {
+            handler_(pending, nlohmann::json(), true);
+        }
+    }
+    return expired.size();
+}
+
+WsOrderRouter::Stats WsOrderRouter::get_stats() const {
+    Stats stats;
+    stats.sent = sent_.load();
+    stats.responses = responses_.load();
+    stats.fallbacks = fallbacks_.load();
+    stats.timeouts = timeouts_.load();
+    {
+        std::lock_guard<std::mutex> lock(sessions_mutex_);
+        stats.sessions = sessions_.size();
+        for (const auto& kv : sessions_) {
+            if (kv.second->ready()) {
+                stats.active_sessions++;
+            }
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        stats.pending = pending_.size();
+    }
+    return stats;
+}
+
+} // namespace server
+} // namespace trading
@@ -0,0 +1,173 @@
+/**
+ * @file ws_order_router.h
+ * @brief WebSocket 订单通道 - 通过交易所私有 WebSocket 下单/撤单/改单
+ *
+ * 按账户开启（注册时 order_route = "ws"）：
+ * - OKX：私有频道登录后使用 op=order / cancel-order / amend-order
+ * - Binance：WebSocket 交易 API（order.place / order.cancel / order.modify）
+ *
+ * 请求 ID 由路由器生成并登记待响应表，响应到达时按请求 ID 找回原始请求
+ * （strategy_id / client_order_id），交给响应处理函数生成回报。
+ *
+ * submit() 返回 false（未开启、连接断开或未登录、交易所不一致、参数不支持）时，
+ * 调用方继续走 REST，因此 REST 始终是兜底通道。
+ */
+
+#pragma once
+
+#include <string>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <unordered_map>
+#include <nlohmann/json.hpp>
+#include "../../core/latency_histogram.h"
+#include "../../trading/account_registry.h"
+
+namespace trading {
+namespace okx { class OKXWebSocket; }
+namespace binance { class BinanceWebSocket; }
+
+namespace server {
+
+/**
+ * @brief WebSocket 请求类型
+ */
+enum class WsRequestKind {
+    PLACE,
+    CANCEL,
+    AMEND
+};
+
+/**
+ * @brief 待响应的请求
+ */
+struct WsPendingRequest {
+    WsRequestKind kind = WsRequestKind::PLACE;
+    ExchangeType exchange = ExchangeType::OKX;
+    std::string route_key;
+    std::string request_id;
+    nlohmann::json request;       // 策略端原始请求
+    int64_t sent_ns = 0;          // steady_clock 发送时间
+};
+
+class WsOrderRouter {
+public:
+    /**
+     * @brief 响应处理函数
+     *
+     * 在 WebSocket 接收线程（或超时检查线程）中调用
+     *
+     * @param pending 原始请求
+     * @param response 交易所响应（超时时为 null）
+     * @param timed_out 是否超时
+     */
+    using ResponseHandler = std::function<void(const WsPendingRequest& pending,
+                                               const nlohmann::json& response,
+                                               bool timed_out)>;
+
+    struct Stats {
+        uint64_t sent = 0;           // 通过 WebSocket 发出的请求数
+        uint64_t responses = 0;      // 收到的响应数
+        uint64_t fallbacks = 0;      // 已开启 WS 但回退 REST 的请求数
+        uint64_t timeouts = 0;       // 超时未响应的请求数
+        size_t sessions = 0;         // WS 会话数
+        size_t active_sessions = 0;  // 可用（已连接/已登录）的会话数
+        size_t pending = 0;          // 待响应请求数
+    };
+
+    WsOrderRouter() = default;
+    ~WsOrderRouter();
+
+    WsOrderRouter(const WsOrderRouter&) = delete;
+    WsOrderRouter& operator=(const WsOrderRouter&) = delete;
+
+    void set_response_handler(ResponseHandler handler);
+
+    /**
+     * @brief 为账户开启 WebSocket 订单通道（阻塞：连接 + 登录）
+     *
+     * 账户已有会话时直接返回 true
+     *
+     * @param route_key 路由键（与订单网关一致：账户ID，缺省为策略ID）
+     * @return 连接（OKX 还需登录）成功
+     */
+    bool enable_okx(const std::string& route_key, const std::string& api_key,
+                    const std::string& secret_key, const std::string& passphrase,
+                    bool is_testnet);
+
+    bool enable_binance(const std::string& route_key, const std::string& api_key,
+                        const std::string& secret_key, bool is_testnet);
+
+    /**
+     * @brief 关闭账户的 WebSocket 订单通道
+     */
+    void disable(const std::string& route_key);
+
+    /**
+     * @brief 账户是否已开启 WebSocket 订单通道（不论当前是否可用）
+     */
+    bool is_enabled(const std::string& route_key) const;
+
+    /**
+     * @brief 通过 WebSocket 发送请求
+     *
+     * @return true 已发送，结果由响应处理函数回报；false 调用方应走 REST
+     */
+    bool submit(const std::string& route_key, WsRequestKind kind, const nlohmann::json& request);
+
+    /**
+     * @brief 清理超时请求（对每个超时请求调用响应处理函数，timed_out = true）
+     * @return 超时请求数
+     */
+    size_t expire_pending(int timeout_ms);
+
+    /**
+     * @brief 关闭所有会话
+     */
+    void stop();
+
+    Stats get_stats() const;
+
+    /**
+     * @brief WebSocket 往返延迟（发送 -> 响应）
+     */
+    const LatencyHistogram& round_trip() const { return round_trip_; }
+
+private:
+    struct Session {
+        ExchangeType exchange = ExchangeType::OKX;
+        std::unique_ptr<okx::OKXWebSocket> okx;
+        std::unique_ptr<binance::BinanceWebSocket> binance;
+
+        bool ready() const;
+    };
+
+    std::shared_ptr<Session> find_session(const std::string& route_key) const;
+    std::string next_request_id();
+    bool send(Session& session, WsRequestKind kind, const nlohmann::json& request,
+              const std::string& request_id);
+    void on_response(const nlohmann::json& data);
+
+    mutable std::mutex sessions_mutex_;
+    std::unordered_map<std::string, std::shared_ptr<Session>> sessions_;
+
+    mutable std::mutex pending_mutex_;
+    std::unordered_map<std::string, WsPendingRequest> pending_;
+
+    ResponseHandler handler_;
+    std::atomic<uint64_t> request_counter_{0};
+
+    std::atomic<uint64_t> sent_{0};
+    std::atomic<uint64_t> responses_{0};
+    std::atomic<uint64_t> fallbacks_{0};
+    std::atomic<uint64_t> timeouts_{0};
+    LatencyHistogram round_trip_;
+};
+
+// 全局 WebSocket 订单通道（在 ws_order_router.cpp 中定义）
+extern WsOrderRouter g_ws_order_router;
+
+} // namespace server
+} // namespace trading
@@ -0,0 +1,402 @@
+#pragma once
+
+/**
+ * @file kline_codec.h
+ * @brief K线列式压缩编码（替代 ZSET 中逐根存放的 JSON 成员）
+ *
+ * Redis 数据结构：
+ * - klinec:{exchange}:{symbol}:{interval} -> Hash
+ *     field = 分块序号（timestamp / chunk_span_ms），value = 分块编码
+ * - 1m 及以下周期每块 1 天；更大周期按比例放大，使每块约 1440 根
+ * - kline:{exchange}:{symbol}:{interval} 的 JSON ZSET 仍作为实时写入的热数据，
+ *   kline_compactor 把已过沉淀期的 K 线合并进分块并从 ZSET 删除
+ *
+ * 分块格式（小端）：
+ *   [0..1] "KC"  [2] 版本  [3] 标志（bit0=全部已完结）  [4..7] 根数
+ *   之后为比特流，按列依次存放：
+ *   - timestamp: 首个原值，之后 delta-of-delta 变长编码（等间隔 K 线每根 1 bit）
+ *   - open/high/low/close/volume/turnover: Gorilla XOR 编码
+ *   - is_closed: 仅当存在未完结 K 线时逐根 1 bit
+ *
+ * 编解码为模板，Bar 需要 timestamp/open/high/low/close/volume/turnover/is_closed 字段
+ * （KlineBar 可直接使用）。
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace trading {
+namespace kline_codec {
+
+constexpr uint8_t CHUNK_VERSION = 1;
+constexpr size_t CHUNK_HEADER_SIZE = 8;
+constexpr int64_t DAY_MS = 24 * 60 * 60 * 1000LL;
+
+// ==================== Key / 分块划分 ====================
+
+inline std::string chunk_key(const std::string& exchange, const std::string& symbol,
+                             const std::string& interval) {
+    return "klinec:" + exchange + ":" + symbol + ":" + interval;
+}
+
+/**
+ * @brief 单个分块覆盖的时间跨度（毫秒）
+ */
+inline int64_t chunk_span_ms(int64_t interval_ms) {
+    const int64_t minute = 60 * 1000LL;
+    return interval_ms <= minute ? DAY_MS : DAY_MS * (interval_ms / minute);
+}
+
+inline int64_t chunk_index(int64_t timestamp, int64_t span_ms) {
+    return timestamp / span_ms;
+}
+
+/**
+ * @brief 分块头中的根数（不解码比特流），格式不符返回 -1
+ */
+inline int64_t chunk_count(std::string_view data) {
+    if (data.size() < CHUNK_HEADER_SIZE || data[0] != 'K' || data[1] != 'C' ||
+        static_cast<uint8_t>(data[2]) != CHUNK_VERSION) {
+        return -1;
+    }
+    uint32_t count;
+    std::memcpy(&count, data.data() + 4, sizeof(count));
+    return count;
+}
+
+// ==================== 比特流 ====================
+
+class BitWriter {
+public:
+    explicit BitWriter(std::string& out) : out_(out) {}
+
+    /**
+     * @brief 写入 v 的低 n 位（高位在前），n <= 64
+     */
+    void write(uint64_t v, int n) {
+        if (n > 32) {
+            write(v >> 32, n - 32);
+            write(v & 0xFFFFFFFFULL, 32);
+            return;
+        }
+        if (n <= 0) return;
+        acc_ = (acc_ << n) | (v & ((1ULL << n) - 1));
+        bits_ += n;
+        while (bits_ >= 8) {
+            bits_ -= 8;
+            out_.push_back(static_cast<char>((acc_ >> bits_) & 0xFF));
+        }
+    }
+
+    void finish() {
+        if (bits_ > 0) {
+            out_.push_back(static_cast<char>((acc_ << (8 - bits_)) & 0xFF));
+            bits_ = 0;
+        }
+    }
+
+private:
+    std::string& out_;
+    uint64_t acc_ = 0;
+    int bits_ = 0;
+};
+
+class BitReader {
+public:
+    BitReader(const char* data, size_t size)
+        : p_(reinterpret_cast<const uint8_t*>(data)), end_(p_ + size) {}
+
+    uint64_t read(int n) {
+        if (n > 32) {
+            uint64_t hi = read(n - 32);
+            return (hi << 32) | read(32);
+        }
+        if (n <= 0) return 0;
+        while (bits_ < n) {
+            if (p_ >= end_) {
+                ok_ = false;
+                return 0;
+            }
+            acc_ = (acc_ << 8) | *p_++;
+            bits_ += 8;
+        }
+        bits_ -= n;
+        return (acc_ >> bits_) & ((1ULL << n) - 1);
+    }
+
+    bool bit() { return read(1) != 0; }
+    bool ok() const { return ok_; }
+
+private:
+    const uint8_t* p_;
+    const uint8_t* end_;
+    uint64_t acc_ = 0;
+    int bits_ = 0;
+    bool ok_ = true;
+};
+
+// ==================== 列编码 ====================
+
+namespace detail {
+
+inline uint64_t double_bits(double v) {
+    uint64_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    return bits;
+}
+
+inline double bits_double(uint64_t bits) {
+    double v;
+    std::memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+inline int64_t sign_extend(uint64_t v, int n) {
+    uint64_t sign = 1ULL << (n - 1);
+    return static_cast<int64_t>((v ^ sign) - sign);
+}
+
+/**
+ * @brief delta-of-delta 分段：0 / 14 / 20 / 32 / 64 位
+ */
+inline void write_dod(BitWriter& w, int64_t dod) {
+    if (dod == 0) {
+        w.write(0, 1);
+    } else if (dod >= -(1 << 13) && dod < (1 << 13)) {
+        w.write(0b10, 2);
+        w.write(static_cast<uint64_t>(dod), 14);
+    } else if (dod >= -(1 << 19) && dod < (1 << 19)) {
+        w.write(0b110, 3);
+        w.write(static_cast<uint64_t>(dod), 20);
+    } else if (dod >= INT32_MIN && dod <= INT32_MAX) {
+        w.write(0b1110, 4);
+        w.write(static_cast<uint64_t>(dod), 32);
+    } else {
+        w.write(0b1111, 4);
+        w.write(static_cast<uint64_t>(dod), 64);
+    }
+}
+
+inline int64_t read_dod(BitReader& r) {
+    if (!r.bit()) return 0;
+    if (!r.bit()) return sign_extend(r.read(14), 14);
+    if (!r.bit()) return sign_extend(r.read(20), 20);
+    if (!r.bit()) return sign_extend(r.read(32), 32);
+    return static_cast<int64_t>(r.read(64));
+}
+
+/**
+ * @brief Gorilla XOR 编码器（每列一个实例）
+ */
+class XorEncoder {
+public:
+    void put(BitWriter& w, double value) {
+        uint64_t bits = double_bits(value);
+        if (first_) {
+            w.write(bits, 64);
+            prev_ = bits;
+            first_ = false;
+            return;
+        }
+        uint64_t x = bits ^ prev_;
+        prev_ = bits;
+        if (x == 0) {
+            w.write(0, 1);
+            return;
+        }
+        w.write(1, 1);
+        int lead = __builtin_clzll(x);
+        int trail = __builtin_ctzll(x);
+        if (lead > 31) lead = 31;  // 前导零用 5 位表示
+        if (prev_lead_ >= 0 && lead >= prev_lead_ && trail >= prev_trail_) {
+            // 落在上一个有效位窗口内，复用窗口
+            w.write(0, 1);
+            w.write(x >> prev_trail_, 64 - prev_lead_ - prev_trail_);
+        } else {
+            int sig = 64 - lead - trail;
+            w.write(1, 1);
+            w.write(static_cast<uint64_t>(lead), 5);
+            w.write(static_cast<uint64_t>(sig == 64 ? 0 : sig), 6);
+            w.write(x >> trail, sig);
+            prev_lead_ = lead;
+            prev_trail_ = trail;
+        }
+    }
+
+private:
+    uint64_t prev_ = 0;
+    int prev_lead_ = -1;
+    int prev_trail_ = 0;
+    bool first_ = true;
+};
+
+class XorDecoder {
+public:
+    double get(BitReader& r) {
+        if (first_) {
+            prev_ = r.read(64);
+            first_ = false;
+            return bits_double(prev_);
+        }
+        if (r.bit()) {
+            if (r.bit()) {
+                prev_lead_ = static_cast<int>(r.read(5));
+                int sig = static_cast<int>(r.read(6));
+                if (sig == 0) sig = 64;
+                prev_trail_ = 64 - prev_lead_ - sig;
+            }
+            int sig = 64 - prev_lead_ - prev_trail_;
+            prev_ ^= r.read(sig) << prev_trail_;
+        }
+        return bits_double(prev_);
+    }
+
+private:
+    uint64_t prev_ = 0;
+    int prev_lead_ = 0;
+    int prev_trail_ = 0;
+    bool first_ = true;
+};
+
+} // namespace detail
+
+// ==================== 分块编解码 ====================
+
+/**
+ * @brief 编码一个分块
+ * @param bars 按 timestamp 严格递增
+ */
+template <typename Bar>
+std::string encode_chunk(const std::vector<Bar>& bars) {
+    std::string out;
+    out.reserve(CHUNK_HEADER_SIZE + bars.size() * 16);
+
+    bool all_closed = true;
+    for (const auto& bar : bars) {
+        all_closed = all_closed && bar.is_closed;
+    }
+    uint32_t count = static_cast<uint32_t>(bars.size());
+    out.push_back('K');
+    out.push_back('C');
+    out.push_back(static_cast<char>(CHUNK_VERSION));
+    out.push_back(static_cast<char>(all_closed ? 1 : 0));
+    out.append(reinterpret_cast<const char*>(&count), sizeof(count));
+    if (bars.empty()) {
+        return out;
+    }
+
+    BitWriter w(out);
+
+    // timestamp 列
+    w.write(static_cast<uint64_t>(bars[0].timestamp), 64);
+    int64_t prev_delta = 0;
+    for (size_t i = 1; i < bars.size(); ++i) {
+        int64_t delta = bars[i].timestamp - bars[i - 1].timestamp;
+        detail::write_dod(w, delta - prev_delta);
+        prev_delta = delta;
+    }
+
+    // 数值列
+    auto put_column = [&](auto field) {
+        detail::XorEncoder enc;
+        for (const auto& bar : bars) {
+            enc.put(w, bar.*field);
+        }
+    };
+    put_column(&Bar::open);
+    put_column(&Bar::high);
+    put_column(&Bar::low);
+    put_column(&Bar::close);
+    put_column(&Bar::volume);
+    put_column(&Bar::turnover);
+
+    if (!all_closed) {
+        for (const auto& bar : bars) {
+            w.write(bar.is_closed ? 1 : 0, 1);
+        }
+    }
+    w.finish();
+    return out;
+}
+
+/**
+ * @brief 解码分块中 [start_time, end_time] 范围内的 K 线，追加到 out
+ *
+ * 只填充数值字段；symbol/exchange/interval 等由调用方补齐
+ * @return false 分块格式错误（out 不变）
+ */
+template <typename Bar>
+bool decode_chunk(std::string_view data, std::vector<Bar>& out,
+                  int64_t start_time = INT64_MIN, int64_t end_time = INT64_MAX) {
+    int64_t count = chunk_count(data);
+    if (count < 0) {
+        return false;
+    }
+    if (count == 0) {
+        return true;
+    }
+    bool all_closed = (static_cast<uint8_t>(data[3]) & 1) != 0;
+    BitReader r(data.data() + CHUNK_HEADER_SIZE, data.size() - CHUNK_HEADER_SIZE);
+
+    // 先解 timestamp 列，确定落在范围内的下标区间
+    std::vector<int64_t> ts(static_cast<size_t>(count));
+    ts[0] = static_cast<int64_t>(r.read(64));
+    int64_t delta = 0;
+    for (int64_t i = 1; i < count; ++i) {
+        delta += detail::read_dod(r);
+        ts[i] = ts[i - 1] + delta;
+    }
+    if (!r.ok()) {
+        return false;
+    }
+
+    size_t lo = 0;
+    while (lo < ts.size() && ts[lo] < start_time) ++lo;
+    size_t hi = lo;
+    while (hi < ts.size() && ts[hi] <= end_time) ++hi;
+
+    size_t base = out.size();
+    out.resize(base + (hi - lo));
+    for (size_t i = lo; i < hi; ++i) {
+        out[base + i - lo].timestamp = ts[i];
+        out[base + i - lo].is_closed = true;
+    }
+
+    // 数值列需顺序解码，只保留范围内的值
+    auto get_column = [&](auto field) {
+        detail::XorDecoder dec;
+        for (size_t i = 0; i < ts.size(); ++i) {
+            double v = dec.get(r);
+            if (i >= lo && i < hi) {
+                out[base + i - lo].*field = v;
+            }
+        }
+    };
+    get_column(&Bar::open);
+    get_column(&Bar::high);
+    get_column(&Bar::low);
+    get_column(&Bar::close);
+    get_column(&Bar::volume);
+    get_column(&Bar::turnover);
+
+    if (!all_closed) {
+        for (size_t i = 0; i < ts.size(); ++i) {
+            bool closed = r.bit();
+            if (i >= lo && i < hi) {
+                out[base + i - lo].is_closed = closed;
+            }
+        }
+    }
+
+    if (!r.ok()) {
+        out.resize(base);
+        return false;
+    }
+    return true;
+}
+
+} // namespace kline_codec
+} // namespace trading
@@ -0,0 +1,416 @@
+/**
+ * @file kline_compactor.cpp
+ * @brief K线压缩迁移工具：把 ZSET 中的 JSON K线合并为列式压缩分块
+ *
+ * 对每个 kline:{exchange}:{symbol}:{interval}：
+ * 1. 取已过沉淀期（默认 2 天前及更早）的每个分块时间段的 JSON 成员
+ * 2. 与 klinec:{...} 中已有的同一分块合并（同一时间戳以 ZSET 为准）
+ * 3. 编码后立即解码校验，逐根比对一致才写入
+ * 4. MULTI/EXEC 中 HSET 分块 + ZREM 已迁移的成员（无法解析的成员保留在 ZSET）
+ *
+ * 实时写入仍走 JSON ZSET，本工具可定时运行（如每天一次）。
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <nlohmann/json.hpp>
+#include "kline_utils.h"
+#include "kline_codec.h"
+#include "../managers/redis_data_provider.h"
+#include "../managers/redis_recorder.h"
+#include <hiredis/hiredis.h>
+
+using trading::server::KlineBar;
+namespace kline_codec = trading::kline_codec;
+
+// ==================== 数据结构 ====================
+
+struct Options {
+    std::string redis_host = "127.0.0.1";
+    int redis_port = 6379;
+    std::vector<std::string> symbols;
+    std::string exchange_filter;
+    std::string interval_filter;
+    int min_age_days = 2;
+    bool dry_run = false;
+    bool verbose = false;
+};
+
+struct CompactStats {
+    int64_t chunks_written = 0;
+    int64_t bars_migrated = 0;
+    int64_t bars_skipped = 0;      // 无法解析、保留在 ZSET 中的成员
+    int64_t chunks_expired = 0;
+    int64_t json_bytes = 0;
+    int64_t chunk_bytes = 0;
+    int64_t verify_failures = 0;
+};
+
+// ==================== Redis SCAN ====================
+
+std::vector<std::string> scan_keys(redisContext* ctx, const std::string& pattern) {
+    std::vector<std::string> keys;
+    unsigned long long cursor = 0;
+
+    do {
+        redisReply* reply = (redisReply*)redisCommand(ctx,
+            "SCAN %llu MATCH %s COUNT 1000", cursor, pattern.c_str());
+
+        if (!reply || reply->type != REDIS_REPLY_ARRAY || reply->elements != 2) {
+            if (reply) freeReplyObject(reply);
+            break;
+        }
+
+        cursor = strtoull(reply->element[0]->str, nullptr, 10);
+
+        if (reply->element[1]->type == REDIS_REPLY_ARRAY) {
+            for (size_t i = 0; i < reply->element[1]->elements; i++) {
+                keys.push_back(reply->element[1]->element[i]->str);
+            }
+        }
+
+        freeReplyObject(reply);
+    } while (cursor != 0);
+
+    return keys;
+}
+
+// ==================== 分块处理 ====================
+
+bool same_bars(const std::vector<KlineBar>& a, const std::vector<KlineBar>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        // 编码无损，逐位比较（NaN 也视为一致）
+        if (a[i].timestamp != b[i].timestamp || a[i].is_closed != b[i].is_closed) return false;
+        const double lhs[] = {a[i].open, a[i].high, a[i].low, a[i].close, a[i].volume, a[i].turnover};
+        const double rhs[] = {b[i].open, b[i].high, b[i].low, b[i].close, b[i].volume, b[i].turnover};
+        if (std::memcmp(lhs, rhs, sizeof(lhs)) != 0) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 迁移一个分块时间段 [chunk_start, chunk_end]
+ */
+void compact_chunk(
+    redisContext* ctx,
+    const std::string& key,
+    const std::string& chunk_key,
+    int64_t index,
+    int64_t chunk_start,
+    int64_t chunk_end,
+    int expire_seconds,
+    const Options& opts,
+    CompactStats& stats
+) {
+    redisReply* reply = (redisReply*)redisCommand(ctx,
+        "ZRANGEBYSCORE %s %lld %lld WITHSCORES",
+        key.c_str(), (long long)chunk_start, (long long)chunk_end);
+    if (!reply || reply->type != REDIS_REPLY_ARRAY || reply->elements == 0) {
+        if (reply) freeReplyObject(reply);
+        return;
+    }
+
+    // 解析 JSON 成员（WITHSCORES: member, score, ...）
+    std::map<int64_t, KlineBar> merged;
+    std::vector<std::string> members;
+    int64_t json_bytes = 0;
+    for (size_t i = 0; i + 1 < reply->elements; i += 2) {
+        std::string member(reply->element[i]->str, reply->element[i]->len);
+        try {
+            KlineBar bar = KlineBar::from_json(nlohmann::json::parse(member));
+            bar.timestamp = std::stoll(reply->element[i + 1]->str);  // 以 score 为准
+            merged[bar.timestamp] = bar;
+            json_bytes += static_cast<int64_t>(member.size());
+            members.push_back(std::move(member));
+        } catch (const std::exception&) {
+            stats.bars_skipped++;
+        }
+    }
+    freeReplyObject(reply);
+
+    if (members.empty()) return;
+
+    // 合并已有分块（ZSET 优先）
+    reply = (redisReply*)redisCommand(ctx, "HGET %s %lld", chunk_key.c_str(), (long long)index);
+    if (reply && reply->type == REDIS_REPLY_STRING) {
+        std::vector<KlineBar> existing;
+        if (kline_codec::decode_chunk(std::string_view(reply->str, reply->len), existing)) {
+            for (auto& bar : existing) {
+                merged.emplace(bar.timestamp, std::move(bar));
+            }
+        } else {
+            std::cerr << "[警告] 已有分块格式错误，将被覆盖: " << chunk_key << " #" << index << "\n";
+        }
+    }
+    if (reply) freeReplyObject(reply);
+
+    std::vector<KlineBar> bars;
+    bars.reserve(merged.size());
+    for (auto& [ts, bar] : merged) bars.push_back(std::move(bar));
+
+    std::string chunk = kline_codec::encode_chunk(bars);
+
+    // 解码校验
+    std::vector<KlineBar> decoded;
+    if (!kline_codec::decode_chunk(chunk, decoded) || !same_bars(bars, decoded)) {
+        stats.verify_failures++;
+        std::cerr << "[错误] 分块校验失败，跳过: " << chunk_key << " #" << index << "\n";
+        return;
+    }
+
+    stats.json_bytes += json_bytes;
+    stats.chunk_bytes += static_cast<int64_t>(chunk.size());
+    stats.bars_migrated += static_cast<int64_t>(members.size());
+    stats.chunks_written++;
+
+    if (opts.verbose) {
+        std::cout << "    #" << index << " " << trading::kline_utils::format_timestamp(chunk_start)
+                  << " 迁移 " << members.size() << " 根（分块共 " << bars.size() << " 根） "
+                  << json_bytes << "B -> " << chunk.size() << "B\n";
+    }
+
+    if (opts.dry_run) return;
+
+    // 原子写入：HSET 分块 + ZREM 已迁移成员 + 刷新过期时间
+    std::string field = std::to_string(index);
+    std::vector<const char*> argv = {"ZREM", key.c_str()};
+    std::vector<size_t> argvlen = {4, key.size()};
+    for (const auto& m : members) {
+        argv.push_back(m.data());
+        argvlen.push_back(m.size());
+    }
+
+    redisAppendCommand(ctx, "MULTI");
+    redisAppendCommand(ctx, "HSET %s %s %b", chunk_key.c_str(), field.c_str(), chunk.data(), chunk.size());
+    redisAppendCommandArgv(ctx, (int)argv.size(), argv.data(), argvlen.data());
+    redisAppendCommand(ctx, "EXPIRE %s %d", chunk_key.c_str(), expire_seconds);
+    redisAppendCommand(ctx, "EXEC");
+
+    bool ok = true;
+    for (int i = 0; i < 5; i++) {
+        redisReply* r = nullptr;
+        if (redisGetReply(ctx, (void**)&r) != REDIS_OK || !r) {
+            ok = false;
+            break;
+        }
+        if (r->type == REDIS_REPLY_ERROR || (i == 4 && r->type != REDIS_REPLY_ARRAY)) ok = false;
+        freeReplyObject(r);
+    }
+    if (!ok) {
+        std::cerr << "[错误] 写入分块失败: " << chunk_key << " #" << index << "\n";
+    }
+}
+
+/**
+ * @brief 删除超过保留期的分块（Hash 字段不会单独过期）
+ */
+void expire_old_chunks(
+    redisContext* ctx,
+    const std::string& chunk_key,
+    int64_t oldest_index,
+    const Options& opts,
+    CompactStats& stats
+) {
+    redisReply* reply = (redisReply*)redisCommand(ctx, "HKEYS %s", chunk_key.c_str());
+    if (!reply || reply->type != REDIS_REPLY_ARRAY) {
+        if (reply) freeReplyObject(reply);
+        return;
+    }
+
+    std::vector<std::string> expired;
+    for (size_t i = 0; i < reply->elements; i++) {
+        if (std::atoll(reply->element[i]->str) < oldest_index) {
+            expired.emplace_back(reply->element[i]->str, reply->element[i]->len);
+        }
+    }
+    freeReplyObject(reply);
+
+    if (expired.empty()) return;
+    stats.chunks_expired += static_cast<int64_t>(expired.size());
+    if (opts.dry_run) return;
+
+    std::vector<const char*> argv = {"HDEL", chunk_key.c_str()};
+    std::vector<size_t> argvlen = {4, chunk_key.size()};
+    for (const auto& f : expired) {
+        argv.push_back(f.c_str());
+        argvlen.push_back(f.size());
+    }
+    reply = (redisReply*)redisCommandArgv(ctx, (int)argv.size(), argv.data(), argvlen.data());
+    if (reply) freeReplyObject(reply);
+}
+
+// ==================== 命令行解析 ====================
+
+Options parse_args(int argc, char* argv[]) {
+    Options opts;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--symbol" && i + 1 < argc) {
+            opts.symbols.push_back(argv[++i]);
+        } else if (arg == "--exchange" && i + 1 < argc) {
+            opts.exchange_filter = argv[++i];
+        } else if (arg == "--interval" && i + 1 < argc) {
+            opts.interval_filter = argv[++i];
+        } else if (arg == "--min-age-days" && i + 1 < argc) {
+            opts.min_age_days = std::max(1, std::stoi(argv[++i]));
+        } else if (arg == "--redis-host" && i + 1 < argc) {
+            opts.redis_host = argv[++i];
+        } else if (arg == "--redis-port" && i + 1 < argc) {
+            opts.redis_port = std::stoi(argv[++i]);
+        } else if (arg == "--dry-run") {
+            opts.dry_run = true;
+        } else if (arg == "--verbose") {
+            opts.verbose = true;
+        } else if (arg == "--help" || arg == "-h") {
+            std::cout << "用法: kline_compactor [选项]\n"
+                      << "  --symbol BTCUSDT     只处理指定币种（可多次指定）\n"
+                      << "  --exchange binance   只处理指定交易所\n"
+                      << "  --interval 1m        只处理指定周期\n"
+                      << "  --min-age-days N     只迁移 N 天前及更早的分块 (默认: 2)\n"
+                      << "  --redis-host HOST    Redis地址 (默认: 127.0.0.1)\n"
+                      << "  --redis-port PORT    Redis端口 (默认: 6379)\n"
+                      << "  --dry-run            只统计压缩效果，不写入\n"
+                      << "  --verbose            显示详细输出\n"
+                      << "  --help               显示帮助\n";
+            exit(0);
+        }
+    }
+
+    return opts;
+}
+
+// ==================== 主程序 ====================
+
+int main(int argc, char* argv[]) {
+    auto t_start = std::chrono::steady_clock::now();
+
+    std::cout << "╔════════════════════════════════════════════════════════════╗\n"
+              << "║          K线列式压缩迁移工具 (kline_compactor)             ║\n"
+              << "╚════════════════════════════════════════════════════════════╝\n\n";
+
+    Options opts = parse_args(argc, argv);
+
+    std::cout << "[配置]\n"
+              << "  Redis: " << opts.redis_host << ":" << opts.redis_port << "\n"
+              << "  交易所过滤: " << (opts.exchange_filter.empty() ? "全部" : opts.exchange_filter) << "\n"
+              << "  周期过滤: " << (opts.interval_filter.empty() ? "全部" : opts.interval_filter) << "\n"
+              << "  币种过滤: " << (opts.symbols.empty() ? "全部" : std::to_string(opts.symbols.size()) + " 个") << "\n"
+              << "  沉淀期: " << opts.min_age_days << " 天\n"
+              << "  模式: " << (opts.dry_run ? "仅统计 (dry-run)" : "迁移") << "\n\n";
+
+    redisContext* ctx = redisConnect(opts.redis_host.c_str(), opts.redis_port);
+    if (!ctx || ctx->err) {
+        std::cerr << "[错误] Redis连接失败";
+        if (ctx) {
+            std::cerr << ": " << ctx->errstr;
+            redisFree(ctx);
+        }
+        std::cerr << std::endl;
+        return 1;
+    }
+    std::cout << "[Redis] 已连接 " << opts.redis_host << ":" << opts.redis_port << "\n\n";
+
+    auto kline_keys = scan_keys(ctx, "kline:*");
+    std::sort(kline_keys.begin(), kline_keys.end());
+    std::set<std::string> symbol_filter_set(opts.symbols.begin(), opts.symbols.end());
+
+    const trading::server::RedisConfig defaults;
+    const int64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    // 截止到今天 0 点往前 min_age_days 天，之前的分块不会再有实时写入
+    const int64_t cutoff_ms = (now_ms / kline_codec::DAY_MS - opts.min_age_days + 1) * kline_codec::DAY_MS;
+
+    CompactStats stats;
+    int processed_keys = 0;
+
+    for (const auto& key : kline_keys) {
+        // key格式: kline:exchange:symbol:interval
+        size_t p1 = key.find(':');
+        size_t p2 = key.find(':', p1 + 1);
+        if (p2 == std::string::npos) continue;
+        size_t p3 = key.find(':', p2 + 1);
+        if (p3 == std::string::npos || key.find(':', p3 + 1) != std::string::npos) continue;
+
+        std::string exchange = key.substr(p1 + 1, p2 - p1 - 1);
+        std::string symbol = key.substr(p2 + 1, p3 - p2 - 1);
+        std::string interval = key.substr(p3 + 1);
+
+        if (!opts.exchange_filter.empty() && exchange != opts.exchange_filter) continue;
+        if (!opts.interval_filter.empty() && interval != opts.interval_filter) continue;
+        if (!symbol_filter_set.empty() && symbol_filter_set.find(symbol) == symbol_filter_set.end()) continue;
+
+        auto retention_it = defaults.kline_retention.find(interval);
+        if (retention_it == defaults.kline_retention.end()) continue;  // 非K线周期（如 1s）
+        const int expire_days = retention_it->second.expire_days;
+
+        const int64_t interval_ms = trading::kline_utils::get_interval_milliseconds(interval);
+        const int64_t span = kline_codec::chunk_span_ms(interval_ms);
+        const std::string chunk_key = kline_codec::chunk_key(exchange, symbol, interval);
+
+        // ZSET 最早的时间戳
+        redisReply* reply = (redisReply*)redisCommand(ctx,
+            "ZRANGEBYSCORE %s -inf +inf WITHSCORES LIMIT 0 1", key.c_str());
+        int64_t first_ts = -1;
+        if (reply && reply->type == REDIS_REPLY_ARRAY && reply->elements >= 2) {
+            first_ts = std::stoll(reply->element[1]->str);
+        }
+        if (reply) freeReplyObject(reply);
+
+        processed_keys++;
+        int64_t written_before = stats.chunks_written;
+
+        if (first_ts >= 0) {
+            if (opts.verbose) {
+                std::cout << "[" << exchange << ":" << symbol << ":" << interval << "]\n";
+            }
+            // 分块必须整体早于截止时间
+            for (int64_t index = kline_codec::chunk_index(first_ts, span);
+                 (index + 1) * span <= cutoff_ms; index++) {
+                compact_chunk(ctx, key, chunk_key, index, index * span, (index + 1) * span - 1,
+                              expire_days * 24 * 3600, opts, stats);
+            }
+        }
+
+        const int64_t oldest_index = kline_codec::chunk_index(
+            now_ms - static_cast<int64_t>(expire_days) * kline_codec::DAY_MS, span);
+        expire_old_chunks(ctx, chunk_key, oldest_index, opts, stats);
+
+        if (!opts.verbose && stats.chunks_written > written_before) {
+            std::cout << "[" << exchange << ":" << symbol << ":" << interval << "] 写入 "
+                      << (stats.chunks_written - written_before) << " 个分块\n";
+        }
+    }
+
+    redisFree(ctx);
+
+    auto t_end = std::chrono::steady_clock::now();
+    double elapsed = std::chrono::duration<double>(t_end - t_start).count();
+    double ratio = stats.chunk_bytes > 0
+        ? static_cast<double>(stats.json_bytes) / static_cast<double>(stats.chunk_bytes) : 0.0;
+
+    std::cout << "\n╔════════════════════════════════════════════════════════════╗\n"
+              << "║  汇总报告                                                  ║\n"
+              << "╠════════════════════════════════════════════════════════════╣\n"
+              << "║  扫描 key: " << processed_keys << "\n"
+              << "║  写入分块: " << stats.chunks_written << "\n"
+              << "║  迁移K线: " << stats.bars_migrated << "\n"
+              << "║  无法解析（保留）: " << stats.bars_skipped << "\n"
+              << "║  过期分块: " << stats.chunks_expired << "\n"
+              << "║  校验失败: " << stats.verify_failures << "\n"
+              << "║  JSON: " << stats.json_bytes << " B -> 分块: " << stats.chunk_bytes << " B"
+              << std::fixed << std::setprecision(1) << " (压缩比 " << ratio << "x)\n"
+              << "║  耗时: " << std::setprecision(2) << elapsed << " 秒\n"
+              << "╚════════════════════════════════════════════════════════════╝\n";
+
+    return stats.verify_failures > 0 ? 2 : 0;
+}
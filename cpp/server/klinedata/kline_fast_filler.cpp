@@ -12,6 +12,7 @@
 #include "historical_data_fetcher.h"
 #include "kline_utils.h"
 #include "gap_detector.h"
+#include "kline_codec.h"
 #include <hiredis/hiredis.h>
 
 using json = nlohmann::json;
@@ -37,6 +38,46 @@ struct Options {
     bool verbose = false;
 };
 
+// ==================== 压缩分块 ====================
+
+// 已迁移到 klinec:* 分块中的 K 线时间戳（升序），扫描时视为已存在
+std::vector<int64_t> load_chunk_timestamps(
+    redisContext* ctx,
+    const std::string& exchange,
+    const std::string& symbol,
+    const std::string& interval
+) {
+    struct Bar {
+        int64_t timestamp = 0;
+        double open = 0, high = 0, low = 0, close = 0, volume = 0, turnover = 0;
+        bool is_closed = true;
+    };
+
+    std::string chunk_key = trading::kline_codec::chunk_key(exchange, symbol, interval);
+    redisReply* reply = (redisReply*)redisCommand(ctx, "HVALS %s", chunk_key.c_str());
+
+    std::vector<Bar> bars;
+    if (reply && reply->type == REDIS_REPLY_ARRAY) {
+        for (size_t i = 0; i < reply->elements; i++) {
+            trading::kline_codec::decode_chunk(
+                std::string_view(reply->element[i]->str, reply->element[i]->len), bars);
+        }
+    }
+    if (reply) freeReplyObject(reply);
+
+    std::vector<int64_t> timestamps;
+    timestamps.reserve(bars.size());
+    for (const auto& bar : bars) timestamps.push_back(bar.timestamp);
+    std::sort(timestamps.begin(), timestamps.end());
+    return timestamps;
+}
+
+int count_in_range(const std::vector<int64_t>& sorted_ts, int64_t start, int64_t end) {
+    auto lo = std::lower_bound(sorted_ts.begin(), sorted_ts.end(), start);
+    auto hi = std::upper_bound(sorted_ts.begin(), sorted_ts.end(), end);
+    return static_cast<int>(hi - lo);
+}
+
 // ==================== 阶段1：粗扫描 (Pipelined ZCOUNT) ====================
 
 std::vector<ChunkInfo> pipeline_zcount_scan(
@@ -44,7 +85,8 @@ std::vector<ChunkInfo> pipeline_zcount_scan(
     const std::string& key,
     int64_t first_ts,
     int64_t last_ts,
-    int64_t interval_ms
+    int64_t interval_ms,
+    const std::vector<int64_t>& chunk_ts
 ) {
     // 按1小时分块（对1m来说每块60条）
     const int64_t chunk_ms = 3600 * 1000LL; // 1小时
@@ -81,6 +123,8 @@ std::vector<ChunkInfo> pipeline_zcount_scan(
         redisReply* reply = nullptr;
         if (redisGetReply(ctx, (void**)&reply) == REDIS_OK && reply) {
             int actual = (reply->type == REDIS_REPLY_INTEGER) ? (int)reply->integer : 0;
+            // 已压缩的 K 线已从 ZSET 移除；未压缩前两边不会重叠
+            actual += count_in_range(chunk_ts, p.start, p.end);
             if (actual < p.expected) {
                 missing_chunks.push_back({p.start, p.end, p.expected, actual});
             }
@@ -97,7 +141,8 @@ std::vector<int64_t> fine_scan_gaps(
     redisContext* ctx,
     const std::string& key,
     const ChunkInfo& chunk,
-    int64_t interval_ms
+    int64_t interval_ms,
+    const std::vector<int64_t>& chunk_ts
 ) {
     // ZRANGEBYSCORE key chunk_start chunk_end WITHSCORES
     redisReply* reply = (redisReply*)redisCommand(ctx,
@@ -116,6 +161,10 @@ std::vector<int64_t> fine_scan_gaps(
         if (reply) freeReplyObject(reply);
     }
 
+    auto lo = std::lower_bound(chunk_ts.begin(), chunk_ts.end(), chunk.start_ts);
+    auto hi = std::upper_bound(chunk_ts.begin(), chunk_ts.end(), chunk.end_ts);
+    existing_ts.insert(lo, hi);
+
     // 逐个比对找出缺失
     std::vector<int64_t> missing;
     for (int64_t ts = chunk.start_ts; ts <= chunk.end_ts; ts += interval_ms) {
@@ -238,28 +287,35 @@ std::vector<std::string> scan_keys(redisContext* ctx, const std::string& pattern
 
 // ==================== 获取时间范围 ====================
 
-bool get_ts_range(redisContext* ctx, const std::string& key, int64_t& first_ts, int64_t& last_ts) {
+bool get_ts_range(redisContext* ctx, const std::string& key, const std::vector<int64_t>& chunk_ts,
+                  int64_t& first_ts, int64_t& last_ts) {
+    bool found = false;
+
     // 获取第一个元素的score
     redisReply* r1 = (redisReply*)redisCommand(ctx,
         "ZRANGEBYSCORE %s -inf +inf WITHSCORES LIMIT 0 1", key.c_str());
-    if (!r1 || r1->type != REDIS_REPLY_ARRAY || r1->elements < 2) {
-        if (r1) freeReplyObject(r1);
-        return false;
+    if (r1 && r1->type == REDIS_REPLY_ARRAY && r1->elements >= 2) {
+        first_ts = std::stoll(r1->element[1]->str);
+        found = true;
     }
-    first_ts = std::stoll(r1->element[1]->str);
-    freeReplyObject(r1);
+    if (r1) freeReplyObject(r1);
 
     // 获取最后一个元素的score
     redisReply* r2 = (redisReply*)redisCommand(ctx,
         "ZREVRANGEBYSCORE %s +inf -inf WITHSCORES LIMIT 0 1", key.c_str());
-    if (!r2 || r2->type != REDIS_REPLY_ARRAY || r2->elements < 2) {
-        if (r2) freeReplyObject(r2);
-        return false;
+    if (r2 && r2->type == REDIS_REPLY_ARRAY && r2->elements >= 2) {
+        last_ts = std::stoll(r2->element[1]->str);
+    }
+    if (r2) freeReplyObject(r2);
+
+    // 合并压缩分块的范围
+    if (!chunk_ts.empty()) {
+        first_ts = found ? std::min(first_ts, chunk_ts.front()) : chunk_ts.front();
+        last_ts = found ? std::max(last_ts, chunk_ts.back()) : chunk_ts.back();
+        found = true;
     }
-    last_ts = std::stoll(r2->element[1]->str);
-    freeReplyObject(r2);
 
-    return true;
+    return found;
 }
 
 // ==================== 命令行解析 ====================
@@ -402,8 +458,9 @@ int main(int argc, char* argv[]) {
         std::string key = "kline:" + info.exchange + ":" + info.symbol + ":" + interval;
 
         // 获取时间范围
+        auto chunk_ts = load_chunk_timestamps(ctx, info.exchange, info.symbol, interval);
         int64_t first_ts = 0, last_ts = 0;
-        if (!get_ts_range(ctx, key, first_ts, last_ts)) {
+        if (!get_ts_range(ctx, key, chunk_ts, first_ts, last_ts)) {
             if (opts.verbose) {
                 std::cout << "[" << (idx + 1) << "/" << total_symbols << "] "
                           << info.exchange << ":" << info.symbol << " - 无数据，跳过\n";
@@ -412,7 +469,7 @@ int main(int argc, char* argv[]) {
         }
 
         // 阶段1：粗扫描
-        auto missing_chunks = pipeline_zcount_scan(ctx, key, first_ts, last_ts, interval_ms);
+        auto missing_chunks = pipeline_zcount_scan(ctx, key, first_ts, last_ts, interval_ms, chunk_ts);
 
         if (missing_chunks.empty()) {
             if (opts.verbose) {
@@ -425,7 +482,7 @@ int main(int argc, char* argv[]) {
         // 阶段2：精扫描
         std::vector<int64_t> all_missing;
         for (const auto& chunk : missing_chunks) {
-            auto chunk_missing = fine_scan_gaps(ctx, key, chunk, interval_ms);
+            auto chunk_missing = fine_scan_gaps(ctx, key, chunk, interval_ms, chunk_ts);
             all_missing.insert(all_missing.end(), chunk_missing.begin(), chunk_missing.end());
         }
 
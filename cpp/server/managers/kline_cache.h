@@ -0,0 +1,271 @@
+/**
+ * @file kline_cache.h
+ * @brief 进程内 K 线缓存（LRU + 尾部增量刷新）
+ *
+ * 按 (exchange, symbol, interval) 缓存已解码的 KlineBar：
+ * - 每个条目记录已从 Redis 完整取回的区间 [covered_start, high_water]
+ * - 区间内的查询直接从内存切片返回
+ * - 查询终点超过 high_water 时只补取尾部（从最后一根 K 线开始，覆盖其未完结状态）
+ * - 查询起点早于 covered_start 时只补取头部
+ * - 按估算内存占用做 LRU 淘汰，超过上限的单个条目不缓存
+ * - 补取失败（Redis 断开等）时不扩展已覆盖区间，下次查询会重试
+ *
+ * 注意：已缓存区间内事后补录的数据（如 gap filler 写入）在 clear() 之前不可见
+ *
+ * 模板参数 Bar 需要 timestamp 以及 symbol/exchange/interval 字段（KlineBar 可直接使用）
+ *
+ * @author Sequence Team
+ * @date 2026-01
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace trading {
+namespace server {
+
+/**
+ * @brief 缓存统计
+ */
+struct KlineCacheStats {
+    uint64_t hits = 0;            // 完全命中
+    uint64_t partial_hits = 0;    // 命中但补取了头部/尾部
+    uint64_t misses = 0;          // 未命中（整段查询 Redis）
+    uint64_t evictions = 0;       // LRU 淘汰的条目数
+    size_t entries = 0;
+    size_t bytes = 0;             // 估算内存占用
+    size_t max_bytes = 0;
+
+    double hit_rate() const {
+        uint64_t total = hits + partial_hits + misses;
+        return total > 0 ? static_cast<double>(hits + partial_hits) / total : 0.0;
+    }
+};
+
+template <typename Bar>
+class KlineCache {
+public:
+    // 从 Redis 取回 [start_time, end_time] 的 K 线（升序）到 out，查询失败返回 false
+    using FetchFn = std::function<bool(int64_t start_time, int64_t end_time, std::vector<Bar>& out)>;
+
+    explicit KlineCache(size_t max_bytes = 0) : max_bytes_(max_bytes) {}
+
+    bool enabled() const { return max_bytes_ > 0; }
+
+    void set_max_bytes(size_t max_bytes) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        max_bytes_ = max_bytes;
+        evict_locked(nullptr);
+    }
+
+    /**
+     * @brief 查询 [start_time, end_time]，缺失部分通过 fetch 补取
+     * @param key 缓存键（exchange:symbol:interval）
+     *
+     * fetch（Redis 往返）在锁外执行：加锁确定缺失区间并拷出已缓存部分，解锁补取，
+     * 再加锁合并。其间条目若被其他查询更新或淘汰（version 变化），本次结果照常返回，
+     * 但不合并进缓存，由下次查询重新补取
+     */
+    std::vector<Bar> get(const std::string& key, int64_t start_time, int64_t end_time,
+                         const FetchFn& fetch) {
+        const int64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+
+        // 1. 加锁：完全命中直接返回，否则记下需要补取的头部/尾部
+        bool cached = false;
+        uint64_t version = 0;
+        int64_t head_end = 0;              // 头部补取 [start_time, head_end]
+        int64_t tail_from = 0;             // 尾部补取 [tail_from, end_time]
+        bool need_head = false;
+        bool need_tail = false;
+        std::vector<Bar> cached_bars;      // 已缓存的部分
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = entries_.find(key);
+            if (it == entries_.end()) {
+                stats_.misses++;
+            } else {
+                Entry& entry = it->second;
+                lru_.splice(lru_.begin(), lru_, entry.lru_it);
+                cached = true;
+                version = entry.version;
+                need_head = start_time < entry.covered_start;
+                head_end = entry.covered_start - 1;
+                need_tail = end_time > entry.high_water;
+                tail_from = entry.high_water + 1;
+                if (need_tail && !entry.bars.empty()) {
+                    // 从最后一根 K 线（可能未完结）开始重新取
+                    tail_from = std::max(entry.covered_start,
+                                         std::min(tail_from, entry.bars.back().timestamp));
+                }
+                if (!need_head && !need_tail) {
+                    stats_.hits++;
+                    return slice(entry.bars, start_time, end_time);
+                }
+                stats_.partial_hits++;
+                cached_bars = slice(entry.bars, start_time, end_time);
+            }
+        }
+
+        // 2. 锁外补取
+        if (!cached) {
+            std::vector<Bar> bars;
+            if (!fetch(start_time, end_time, bars)) {
+                return bars;
+            }
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (entries_.count(key) == 0) {
+                Entry entry;
+                entry.bars = bars;
+                entry.covered_start = start_time;
+                entry.high_water = std::min(end_time, now_ms);
+                entry.version = ++next_version_;
+                lru_.push_front(key);
+                entry.lru_it = lru_.begin();
+                store_locked(entries_.emplace(key, std::move(entry)).first);
+            }
+            return bars;
+        }
+
+        std::vector<Bar> head;
+        std::vector<Bar> tail;
+        const bool head_ok = need_head && fetch(start_time, head_end, head);
+        const bool tail_ok = need_tail && fetch(tail_from, end_time, tail);
+
+        if (tail_ok) {
+            // 尾部以补取结果为准（覆盖未完结的最后一根）
+            auto cut = std::lower_bound(cached_bars.begin(), cached_bars.end(), tail_from,
+                [](const Bar& bar, int64_t ts) { return bar.timestamp < ts; });
+            cached_bars.erase(cut, cached_bars.end());
+        }
+        std::vector<Bar> result;
+        result.reserve(head.size() + cached_bars.size() + tail.size());
+        result.insert(result.end(), head.begin(), head.end());
+        result.insert(result.end(), std::make_move_iterator(cached_bars.begin()),
+                      std::make_move_iterator(cached_bars.end()));
+        result.insert(result.end(), tail.begin(), tail.end());
+
+        // 3. 加锁合并（补取失败时不扩展已覆盖区间，下次查询会重试）
+        if (head_ok || tail_ok) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = entries_.find(key);
+            if (it != entries_.end() && it->second.version == version) {
+                Entry& entry = it->second;
+                if (head_ok) {
+                    entry.bars.insert(entry.bars.begin(), std::make_move_iterator(head.begin()),
+                                      std::make_move_iterator(head.end()));
+                    entry.covered_start = start_time;
+                }
+                if (tail_ok) {
+                    auto cut = std::lower_bound(entry.bars.begin(), entry.bars.end(), tail_from,
+                        [](const Bar& bar, int64_t ts) { return bar.timestamp < ts; });
+                    entry.bars.erase(cut, entry.bars.end());
+                    entry.bars.insert(entry.bars.end(), std::make_move_iterator(tail.begin()),
+                                      std::make_move_iterator(tail.end()));
+                    entry.high_water = std::max(entry.high_water, std::min(end_time, now_ms));
+                }
+                entry.version = ++next_version_;
+                store_locked(it);
+            }
+        }
+        return result;
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.clear();
+        lru_.clear();
+        bytes_ = 0;
+    }
+
+    KlineCacheStats stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        KlineCacheStats s = stats_;
+        s.entries = entries_.size();
+        s.bytes = bytes_;
+        s.max_bytes = max_bytes_;
+        return s;
+    }
+
+private:
+    struct Entry {
+        std::vector<Bar> bars;          // 按 timestamp 升序
+        int64_t covered_start = 0;
+        int64_t high_water = 0;
+        size_t bytes = 0;
+        uint64_t version = 0;           // 创建/合并时从 next_version_ 分配（锁外补取期间检测并发修改）
+        std::list<std::string>::iterator lru_it;
+    };
+
+    static size_t estimate_bytes(const std::string& key, const Entry& entry) {
+        size_t bytes = sizeof(Entry) + key.size() * 2 + entry.bars.capacity() * sizeof(Bar);
+        if (!entry.bars.empty()) {
+            // symbol/exchange/interval 超出 SSO 时的堆内存
+            const Bar& bar = entry.bars.front();
+            size_t heap = 0;
+            for (const std::string* s : {&bar.symbol, &bar.exchange, &bar.interval}) {
+                if (s->capacity() > 15) heap += s->capacity() + 1;
+            }
+            bytes += heap * entry.bars.size();
+        }
+        return bytes;
+    }
+
+    // [start_time, end_time] 内的 K 线
+    static std::vector<Bar> slice(const std::vector<Bar>& bars, int64_t start_time, int64_t end_time) {
+        auto first = std::lower_bound(bars.begin(), bars.end(), start_time,
+            [](const Bar& bar, int64_t ts) { return bar.timestamp < ts; });
+        auto last = std::upper_bound(first, bars.end(), end_time,
+            [](int64_t ts, const Bar& bar) { return ts < bar.timestamp; });
+        return std::vector<Bar>(first, last);
+    }
+
+    // 条目内容变化后更新内存占用并淘汰；单个条目超过上限时不保留
+    void store_locked(typename std::unordered_map<std::string, Entry>::iterator it) {
+        Entry& entry = it->second;
+        bytes_ -= entry.bytes;
+        entry.bytes = estimate_bytes(it->first, entry);
+        bytes_ += entry.bytes;
+        if (entry.bytes > max_bytes_) {
+            bytes_ -= entry.bytes;
+            lru_.erase(entry.lru_it);
+            entries_.erase(it);
+            stats_.evictions++;
+        } else {
+            evict_locked(&it->first);
+        }
+    }
+
+    // 从 LRU 尾部淘汰，直到不超过上限（keep 指向的条目不淘汰）
+    void evict_locked(const std::string* keep) {
+        while (bytes_ > max_bytes_ && !lru_.empty()) {
+            const std::string& victim = lru_.back();
+            if (keep && victim == *keep) break;
+            auto it = entries_.find(victim);
+            bytes_ -= it->second.bytes;
+            entries_.erase(it);
+            lru_.pop_back();
+            stats_.evictions++;
+        }
+    }
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Entry> entries_;
+    std::list<std::string> lru_;             // 头部为最近使用
+    size_t max_bytes_;
+    size_t bytes_ = 0;
+    uint64_t next_version_ = 0;              // 全局递增，clear() 后重建的条目也不会重复
+    KlineCacheStats stats_;
+};
+
+} // namespace server
+} // namespace trading
@@ -0,0 +1,243 @@
+/**
+ * @file order_book_manager.h
+ * @brief 服务端本地订单簿管理（OKX 增量频道 / Binance diff depth）
+ *
+ * 按 (symbol, channel) 维护 core::OkxBookSync，按 symbol 维护 core::BinanceBookSync：
+ * - 前 publish_depth 档有变化时通过 PublishFn 发布（0 = 任意档位变化都发布完整订单簿）
+ * - 锁内只应用推送并拷出待发布的前 N 档（线程缓存的 BookTop，不分配），锁外发布；
+ *   发布锁在释放订单簿锁之前获取，发布顺序与应用顺序一致
+ * - OKX 校验失败/断档时 on_okx_book 返回 false，由调用方重新订阅（OKX 会重新推送快照）
+ * - Binance 需要快照时 on_binance_diff 返回 true，由调用方异步拉取 REST 快照后调用
+ *   on_binance_snapshot；快照衔接失败会再次要求拉取
+ *
+ * 注意：Binance 合约的 <symbol>@depth<levels> 与 <symbol>@depth 推送格式相同，
+ * 单路 /ws 连接上无法按 stream 区分，同一 symbol 注册了 diff 订单簿后，所有 depthUpdate
+ * 都按增量处理。因此订阅管理拒绝同一 symbol 同时订阅 depth<levels> 与 books
+ *
+ * @author Sequence Team
+ * @date 2026-01
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include "../../network/order_book.h"
+
+namespace trading {
+namespace server {
+
+/**
+ * @brief 待发布的前 N 档（0 = 最优档）
+ */
+struct BookTop {
+    core::PriceLevels bids;   // (price, size)
+    core::PriceLevels asks;
+
+    void assign(const core::OrderBook& book, size_t depth) {
+        auto copy = [&](core::BookSide side, core::PriceLevels& out) {
+            const size_t n = depth == 0 ? book.depth(side) : std::min(depth, book.depth(side));
+            out.clear();
+            for (size_t i = 0; i < n; ++i) {
+                out.emplace_back(book.price(side, i), book.size(side, i));
+            }
+        };
+        copy(core::BookSide::BID, bids);
+        copy(core::BookSide::ASK, asks);
+    }
+};
+
+struct OrderBookStats {
+    uint64_t published = 0;       // 发布次数
+    uint64_t okx_resyncs = 0;     // OKX 重新订阅次数（checksum 失败或 seqId 断档）
+    uint64_t binance_resyncs = 0; // Binance 快照请求次数
+};
+
+class OrderBookManager {
+public:
+    using PublishFn = std::function<void(std::string_view symbol, std::string_view channel,
+                                         const BookTop& top, int64_t timestamp)>;
+
+    explicit OrderBookManager(size_t publish_depth = 20) : publish_depth_(publish_depth) {}
+
+    size_t publish_depth() const { return publish_depth_.load(); }
+
+    // 启动时设置（SEQ_BOOK_PUBLISH_DEPTH）
+    void set_publish_depth(size_t depth) { publish_depth_ = depth; }
+
+    /**
+     * @brief OKX 深度频道是否为增量推送（需要本地维护订单簿）
+     */
+    static bool is_okx_incremental(const std::string& channel) {
+        return channel == "books" || channel == "books-l2-tbt" ||
+               channel == "books50-l2-tbt" || channel == "books-elp";
+    }
+
+    /**
+     * @brief 应用 OKX 增量频道推送
+     * @return false 订单簿失同步，需要重新订阅
+     */
+    bool on_okx_book(const core::BookPush& push, const PublishFn& publish) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        core::OkxBookSync& sync = okx_book(push.symbol, push.channel);
+        const size_t depth = publish_depth_.load();
+        core::BookSyncStatus status = sync.apply(push, depth);
+        if (status == core::BookSyncStatus::RESYNC) {
+            stats_.okx_resyncs++;
+            return false;
+        }
+        if (status == core::BookSyncStatus::UPDATED) {
+            stats_.published++;
+            publish_unlocked(lock, sync.book(), depth, push.symbol, push.channel, push.timestamp, publish);
+        }
+        return true;
+    }
+
+    /**
+     * @brief OKX 订单簿是否已收到快照（重新订阅后用于判断是否需要重试）
+     */
+    bool okx_synced(const std::string& symbol, const std::string& channel) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = okx_books_.find(symbol);
+        if (it == okx_books_.end()) return false;
+        auto book = it->second.find(channel);
+        return book != it->second.end() && book->second.synced();
+    }
+
+    void remove_okx(const std::string& symbol, const std::string& channel) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = okx_books_.find(symbol);
+        if (it == okx_books_.end()) return;
+        it->second.erase(channel);
+        if (it->second.empty()) okx_books_.erase(it);
+    }
+
+    // ==================== Binance ====================
+
+    void add_binance(const std::string& symbol) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        binance_books_[symbol];
+    }
+
+    void remove_binance(const std::string& symbol) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        binance_books_.erase(symbol);
+    }
+
+    bool has_binance(const std::string& symbol) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return binance_books_.count(symbol) > 0;
+    }
+
+    /**
+     * @brief 应用 Binance depthUpdate
+     * @return true 需要拉取 REST 快照
+     */
+    bool on_binance_diff(const std::string& symbol, core::DepthDiff&& diff, const PublishFn& publish) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto it = binance_books_.find(symbol);
+        if (it == binance_books_.end()) return false;
+        const int64_t timestamp = diff.timestamp;
+        const size_t depth = publish_depth_.load();
+        core::BookSyncStatus status = it->second.apply_diff(std::move(diff), depth);
+        bool need_snapshot = take_snapshot_request(it->second);
+        if (status == core::BookSyncStatus::UPDATED) {
+            stats_.published++;
+            publish_unlocked(lock, it->second.book(), depth, symbol, BINANCE_CHANNEL, timestamp, publish);
+        }
+        return need_snapshot;
+    }
+
+    /**
+     * @brief 应用 REST 快照
+     * @return true 快照与增量衔接失败，需要重新拉取
+     */
+    bool on_binance_snapshot(const std::string& symbol, int64_t last_update_id,
+                             const core::PriceLevels& bids, const core::PriceLevels& asks,
+                             int64_t timestamp, const PublishFn& publish) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto it = binance_books_.find(symbol);
+        if (it == binance_books_.end()) return false;
+        core::BookSyncStatus status = it->second.apply_snapshot(last_update_id, bids, asks);
+        bool need_snapshot = take_snapshot_request(it->second);
+        if (status == core::BookSyncStatus::UPDATED) {
+            stats_.published++;
+            publish_unlocked(lock, it->second.book(), publish_depth_.load(), symbol, BINANCE_CHANNEL,
+                             timestamp, publish);
+        }
+        return need_snapshot;
+    }
+
+    /**
+     * @brief REST 快照拉取失败，允许下一条增量再次触发拉取
+     */
+    void on_binance_snapshot_failed(const std::string& symbol) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = binance_books_.find(symbol);
+        if (it != binance_books_.end()) it->second.snapshot_failed();
+    }
+
+    OrderBookStats stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+    static constexpr const char* BINANCE_CHANNEL = "books";
+
+private:
+    using OkxChannelBooks = std::map<std::string, core::OkxBookSync, std::less<>>;
+
+    // 按 (symbol, channel) 查找，已存在时不构造 key 字符串（调用方持有 mutex_）
+    core::OkxBookSync& okx_book(std::string_view symbol, std::string_view channel) {
+        auto it = okx_books_.find(symbol);
+        if (it == okx_books_.end()) {
+            it = okx_books_.emplace(std::string(symbol), OkxChannelBooks{}).first;
+        }
+        auto book = it->second.find(channel);
+        if (book == it->second.end()) {
+            book = it->second.emplace(std::string(channel), core::OkxBookSync{}).first;
+        }
+        return book->second;
+    }
+
+    /**
+     * @brief 拷出前 N 档后释放 mutex_ 再发布
+     *
+     * 先获取 publish_mutex_ 再释放 mutex_：同一订单簿的发布顺序与应用顺序一致，
+     * 而发布期间其他线程可以继续应用推送
+     */
+    void publish_unlocked(std::unique_lock<std::mutex>& lock, const core::OrderBook& book, size_t depth,
+                          std::string_view symbol, std::string_view channel, int64_t timestamp,
+                          const PublishFn& publish) {
+        thread_local BookTop top;  // 复用容量，稳态下不分配
+        top.assign(book, depth);
+        std::lock_guard<std::mutex> publish_lock(publish_mutex_);
+        lock.unlock();
+        publish(symbol, channel, top, timestamp);
+    }
+
+    bool take_snapshot_request(core::BinanceBookSync& sync) {
+        if (!sync.take_snapshot_request()) return false;
+        stats_.binance_resyncs++;
+        return true;
+    }
+
+    std::atomic<size_t> publish_depth_;
+    mutable std::mutex mutex_;
+    std::mutex publish_mutex_;                                    // 发布顺序（见 publish_unlocked）
+    std::map<std::string, OkxChannelBooks, std::less<>> okx_books_;  // symbol -> channel -> 订单簿
+    std::map<std::string, core::BinanceBookSync> binance_books_;  // key = symbol（大写）
+    OrderBookStats stats_;
+};
+
+// 全局实例（定义在 websocket_callbacks.cpp）
+extern OrderBookManager g_order_book_manager;
+
+} // namespace server
+} // namespace trading
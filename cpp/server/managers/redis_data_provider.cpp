@@ -7,10 +7,13 @@
  */
 
 #include "redis_data_provider.h"
+#include "../klinedata/kline_codec.h"
 #include <iostream>
 #include <algorithm>
 #include <cmath>
+#include <limits>
 #include <set>
+#include <thread>
 
 namespace trading {
 namespace server {
@@ -18,7 +21,7 @@ namespace server {
 // 全局 Redis 数据提供者实例
 std::unique_ptr<RedisDataProvider> g_redis_data_provider;
 
-RedisDataProvider::RedisDataProvider() = default;
+RedisDataProvider::RedisDataProvider() : cache_(config_.cache_max_bytes) {}
 
 RedisDataProvider::~RedisDataProvider() {
     disconnect();
@@ -26,6 +29,7 @@ RedisDataProvider::~RedisDataProvider() {
 
 void RedisDataProvider::set_config(const RedisProviderConfig& config) {
     config_ = config;
+    cache_.set_max_bytes(config_.cache_max_bytes);
 }
 
 bool RedisDataProvider::connect() {
@@ -128,24 +132,76 @@ int64_t RedisDataProvider::align_timestamp(int64_t timestamp, const std::string&
     return (timestamp / interval_ms) * interval_ms;
 }
 
-std::vector<KlineBar> RedisDataProvider::query_raw_klines(
-    const std::string& key,
+void RedisDataProvider::parse_json_members(redisReply* reply, std::vector<KlineBar>& out) {
+    out.reserve(out.size() + reply->elements);
+    for (size_t i = 0; i < reply->elements; i++) {
+        try {
+            std::string json_str(reply->element[i]->str, reply->element[i]->len);
+            nlohmann::json j = nlohmann::json::parse(json_str);
+            out.push_back(KlineBar::from_json(j));
+        } catch (const std::exception& e) {
+            // 解析失败，跳过
+            log_error("[RedisDataProvider] JSON 解析失败: " + std::string(e.what()));
+        }
+    }
+}
+
+void RedisDataProvider::decode_chunk_into(
+    const char* data, size_t len,
+    const std::string& symbol, const std::string& exchange, const std::string& interval,
+    int64_t start_time, int64_t end_time, std::vector<KlineBar>& out
+) {
+    size_t base = out.size();
+    if (!kline_codec::decode_chunk(std::string_view(data, len), out, start_time, end_time)) {
+        error_count_++;
+        log_error("[RedisDataProvider] K线分块解码失败: " + symbol + " " + interval);
+        return;
+    }
+    for (size_t i = base; i < out.size(); i++) {
+        out[i].symbol = symbol;
+        out[i].exchange = exchange;
+        out[i].interval = interval;
+    }
+}
+
+RedisDataProvider::PendingKlineQuery RedisDataProvider::append_kline_query(
+    const std::string& symbol,
+    const std::string& exchange,
+    const std::string& interval,
     int64_t start_time,
     int64_t end_time
 ) {
-    std::vector<KlineBar> result;
+    PendingKlineQuery query;
+    query.symbol = symbol;
+    query.start_time = start_time;
+    query.end_time = end_time;
 
-    std::lock_guard<std::mutex> lock(redis_mutex_);
-
-    if (!is_connected()) {
-        if (!reconnect()) {
-            error_count_++;
-            return result;
+    std::string key = "kline:" + exchange + ":" + symbol + ":" + interval;
+    std::string chunk_key = kline_codec::chunk_key(exchange, symbol, interval);
+
+    // 需要的分块序号；范围过大（如 start_time=0）时改为取全部分块再过滤
+    const int64_t span = kline_codec::chunk_span_ms(interval_to_ms(interval));
+    query.first_chunk = kline_codec::chunk_index(std::max<int64_t>(start_time, 0), span);
+    query.last_chunk = kline_codec::chunk_index(std::max<int64_t>(end_time, 0), span);
+    query.fetch_all_chunks = query.last_chunk - query.first_chunk + 1 > 1024;
+
+    if (query.fetch_all_chunks) {
+        redisAppendCommand(context_, "HGETALL %s", chunk_key.c_str());
+    } else {
+        std::vector<std::string> fields;
+        fields.reserve(static_cast<size_t>(query.last_chunk - query.first_chunk + 1));
+        for (int64_t c = query.first_chunk; c <= query.last_chunk; c++) {
+            fields.push_back(std::to_string(c));
+        }
+        std::vector<const char*> argv = {"HMGET", chunk_key.c_str()};
+        std::vector<size_t> argvlen = {5, chunk_key.size()};
+        for (const auto& f : fields) {
+            argv.push_back(f.c_str());
+            argvlen.push_back(f.size());
         }
+        redisAppendCommandArgv(context_, (int)argv.size(), argv.data(), argvlen.data());
     }
-
-    // 使用 ZRANGEBYSCORE 查询时间范围内的数据
-    redisReply* reply = (redisReply*)redisCommand(
+    redisAppendCommand(
         context_,
         "ZRANGEBYSCORE %s %lld %lld",
         key.c_str(),
@@ -153,45 +209,158 @@ std::vector<KlineBar> RedisDataProvider::query_raw_klines(
         (long long)end_time
     );
 
-    if (reply == nullptr || reply->type == REDIS_REPLY_ERROR) {
+    return query;
+}
+
+std::vector<KlineBar> RedisDataProvider::assemble_klines(
+    const PendingKlineQuery& query,
+    const std::string& exchange,
+    const std::string& interval
+) {
+    const std::string& symbol = query.symbol;
+    redisReply* chunk_reply = query.chunk_reply;
+    redisReply* json_reply = query.json_reply;
+
+    // 1. 压缩分块（按分块序号升序解码，结果自然有序）
+    std::vector<KlineBar> chunk_bars;
+    if (chunk_reply && chunk_reply->type == REDIS_REPLY_ARRAY) {
+        if (query.fetch_all_chunks) {
+            std::vector<std::pair<int64_t, redisReply*>> chunks;
+            for (size_t i = 0; i + 1 < chunk_reply->elements; i += 2) {
+                int64_t index = std::atoll(chunk_reply->element[i]->str);
+                if (index >= query.first_chunk && index <= query.last_chunk) {
+                    chunks.emplace_back(index, chunk_reply->element[i + 1]);
+                }
+            }
+            std::sort(chunks.begin(), chunks.end(),
+                [](const auto& a, const auto& b) { return a.first < b.first; });
+            for (const auto& [index, value] : chunks) {
+                decode_chunk_into(value->str, value->len, symbol, exchange, interval,
+                                  query.start_time, query.end_time, chunk_bars);
+            }
+        } else {
+            for (size_t i = 0; i < chunk_reply->elements; i++) {
+                redisReply* value = chunk_reply->element[i];
+                if (value->type != REDIS_REPLY_STRING) continue;  // 该分块不存在
+                decode_chunk_into(value->str, value->len, symbol, exchange, interval,
+                                  query.start_time, query.end_time, chunk_bars);
+            }
+        }
+    }
+
+    // 2. JSON ZSET（实时写入、尚未压缩的部分）
+    std::vector<KlineBar> json_bars;
+    if (json_reply && json_reply->type == REDIS_REPLY_ARRAY) {
+        parse_json_members(json_reply, json_bars);
+    } else {
         error_count_++;
-        if (reply) freeReplyObject(reply);
-        return result;
     }
 
-    query_count_++;
+    // 3. 合并（两边各自有序；同一时间戳以 ZSET 为准）
+    if (chunk_bars.empty()) return json_bars;
+    if (json_bars.empty()) return chunk_bars;
 
-    if (reply->type == REDIS_REPLY_ARRAY) {
-        result.reserve(reply->elements);
-        for (size_t i = 0; i < reply->elements; i++) {
-            try {
-                std::string json_str(reply->element[i]->str, reply->element[i]->len);
-                nlohmann::json j = nlohmann::json::parse(json_str);
-                result.push_back(KlineBar::from_json(j));
-            } catch (const std::exception& e) {
-                // 解析失败，跳过
-                log_error("[RedisDataProvider] JSON 解析失败: " + std::string(e.what()));
+    std::vector<KlineBar> result;
+    result.reserve(chunk_bars.size() + json_bars.size());
+    size_t i = 0, j = 0;
+    while (i < chunk_bars.size() || j < json_bars.size()) {
+        if (j == json_bars.size() ||
+            (i < chunk_bars.size() && chunk_bars[i].timestamp < json_bars[j].timestamp)) {
+            result.push_back(std::move(chunk_bars[i++]));
+        } else {
+            if (i < chunk_bars.size() && chunk_bars[i].timestamp == json_bars[j].timestamp) {
+                i++;
             }
+            result.push_back(std::move(json_bars[j++]));
         }
     }
+    return result;
+}
 
-    freeReplyObject(reply);
+bool RedisDataProvider::read_kline_query(PendingKlineQuery& query) {
+    if (redisGetReply(context_, (void**)&query.chunk_reply) != REDIS_OK) {
+        query.chunk_reply = nullptr;
+        return false;
+    }
+    if (redisGetReply(context_, (void**)&query.json_reply) != REDIS_OK) {
+        query.json_reply = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void RedisDataProvider::PendingKlineQuery::release() {
+    if (chunk_reply) freeReplyObject(chunk_reply);
+    if (json_reply) freeReplyObject(json_reply);
+    chunk_reply = nullptr;
+    json_reply = nullptr;
+}
+
+std::vector<KlineBar> RedisDataProvider::query_raw_klines(
+    const std::string& symbol,
+    const std::string& exchange,
+    const std::string& interval,
+    int64_t start_time,
+    int64_t end_time
+) {
+    if (end_time < start_time) return {};
+
+    PendingKlineQuery query;
+    {
+        std::lock_guard<std::mutex> lock(redis_mutex_);
+
+        if (!is_connected()) {
+            if (!reconnect()) {
+                error_count_++;
+                return {};
+            }
+        }
+
+        // Pipeline: 分块 HMGET/HGETALL + ZRANGEBYSCORE，一次往返
+        query = append_kline_query(symbol, exchange, interval, start_time, end_time);
+        if (!read_kline_query(query)) {
+            error_count_++;
+            query.release();
+            return {};
+        }
+        query_count_++;
+    }
+
+    // 回复已完整读出，解析不需要持有连接锁
+    auto result = assemble_klines(query, exchange, interval);
+    query.release();
     return result;
 }
 
-std::vector<KlineBar> RedisDataProvider::get_klines(
+std::vector<KlineBar> RedisDataProvider::cached_query_klines(
     const std::string& symbol,
     const std::string& exchange,
     const std::string& interval,
     int64_t start_time,
     int64_t end_time
 ) {
-    // 构建 Redis key
-    // 格式: kline:{exchange}:{symbol}:{interval}
-    std::string key = "kline:" + exchange + ":" + symbol + ":" + interval;
+    if (!cache_.enabled() || end_time < start_time) {
+        return query_raw_klines(symbol, exchange, interval, start_time, end_time);
+    }
+
+    return cache_.get(exchange + ":" + symbol + ":" + interval, start_time, end_time,
+        [&](int64_t from, int64_t to, std::vector<KlineBar>& out) {
+            // 查询期间出错（断线、回复异常）时不记入已覆盖区间
+            uint64_t errors_before = error_count_;
+            out = query_raw_klines(symbol, exchange, interval, from, to);
+            return error_count_ == errors_before;
+        });
+}
 
+std::vector<KlineBar> RedisDataProvider::get_klines(
+    const std::string& symbol,
+    const std::string& exchange,
+    const std::string& interval,
+    int64_t start_time,
+    int64_t end_time
+) {
     // 先尝试直接查询该周期的数据
-    auto result = query_raw_klines(key, start_time, end_time);
+    auto result = cached_query_klines(symbol, exchange, interval, start_time, end_time);
 
     // 如果没有数据且请求的不是 1m，尝试从 1m 聚合
     if (result.empty() && interval != "1m") {
@@ -260,16 +429,7 @@ std::vector<KlineBar> RedisDataProvider::get_latest_klines(
     query_count_++;
 
     if (reply->type == REDIS_REPLY_ARRAY) {
-        result.reserve(reply->elements);
-        for (size_t i = 0; i < reply->elements; i++) {
-            try {
-                std::string json_str(reply->element[i]->str, reply->element[i]->len);
-                nlohmann::json j = nlohmann::json::parse(json_str);
-                result.push_back(KlineBar::from_json(j));
-            } catch (const std::exception& e) {
-                log_error("[RedisDataProvider] JSON 解析失败: " + std::string(e.what()));
-            }
-        }
+        parse_json_members(reply, result);
     }
 
     freeReplyObject(reply);
@@ -277,6 +437,41 @@ std::vector<KlineBar> RedisDataProvider::get_latest_klines(
     // 反转结果，使其按时间升序
     std::reverse(result.begin(), result.end());
 
+    // ZSET 不足时从压缩分块（由新到旧）补足更早的 K 线
+    if ((int)result.size() < count) {
+        std::string chunk_key = kline_codec::chunk_key(exchange, symbol, interval);
+        std::vector<int64_t> indexes;
+        reply = (redisReply*)redisCommand(context_, "HKEYS %s", chunk_key.c_str());
+        if (reply && reply->type == REDIS_REPLY_ARRAY) {
+            for (size_t i = 0; i < reply->elements; i++) {
+                indexes.push_back(std::atoll(reply->element[i]->str));
+            }
+        }
+        if (reply) freeReplyObject(reply);
+        std::sort(indexes.rbegin(), indexes.rend());
+
+        int64_t before = result.empty() ? INT64_MAX : result.front().timestamp - 1;
+        for (int64_t index : indexes) {
+            if ((int)result.size() >= count) break;
+            reply = (redisReply*)redisCommand(context_, "HGET %s %lld",
+                                              chunk_key.c_str(), (long long)index);
+            std::vector<KlineBar> older;
+            if (reply && reply->type == REDIS_REPLY_STRING) {
+                decode_chunk_into(reply->str, reply->len, symbol, exchange, interval,
+                                  INT64_MIN, before, older);
+            }
+            if (reply) freeReplyObject(reply);
+            query_count_++;
+
+            if (older.empty()) continue;
+            size_t need = static_cast<size_t>(count) - result.size();
+            size_t skip = older.size() > need ? older.size() - need : 0;
+            result.insert(result.begin(), std::make_move_iterator(older.begin() + skip),
+                          std::make_move_iterator(older.end()));
+            before = result.front().timestamp - 1;
+        }
+    }
+
     return result;
 }
 
@@ -287,13 +482,11 @@ std::vector<KlineBar> RedisDataProvider::aggregate_klines(
     int64_t start_time,
     int64_t end_time
 ) {
-    // 从 1m K 线聚合（基础周期为 1m）
-    std::string source_key = "kline:" + exchange + ":" + symbol + ":1m";
-
     // 对齐开始时间到目标周期边界
     start_time = align_timestamp(start_time, target_interval);
 
-    auto source_bars = query_raw_klines(source_key, start_time, end_time);
+    // 从 1m K 线聚合（基础周期为 1m）
+    auto source_bars = cached_query_klines(symbol, exchange, "1m", start_time, end_time);
 
     if (source_bars.empty()) {
         return {};
@@ -474,6 +667,39 @@ std::pair<int64_t, int64_t> RedisDataProvider::get_data_time_range(
 
     query_count_ += 2;
 
+    // 压缩分块：最早/最新分块的首尾时间戳
+    std::string chunk_key = kline_codec::chunk_key(exchange, symbol, interval);
+    std::vector<int64_t> indexes;
+    reply = (redisReply*)redisCommand(context_, "HKEYS %s", chunk_key.c_str());
+    if (reply && reply->type == REDIS_REPLY_ARRAY) {
+        for (size_t i = 0; i < reply->elements; i++) {
+            indexes.push_back(std::atoll(reply->element[i]->str));
+        }
+    }
+    if (reply) freeReplyObject(reply);
+
+    if (!indexes.empty()) {
+        auto [min_it, max_it] = std::minmax_element(indexes.begin(), indexes.end());
+        for (int64_t index : {*min_it, *max_it}) {
+            reply = (redisReply*)redisCommand(context_, "HGET %s %lld",
+                                              chunk_key.c_str(), (long long)index);
+            std::vector<KlineBar> bars;
+            if (reply && reply->type == REDIS_REPLY_STRING) {
+                decode_chunk_into(reply->str, reply->len, symbol, exchange, interval,
+                                  INT64_MIN, INT64_MAX, bars);
+            }
+            if (reply) freeReplyObject(reply);
+            if (bars.empty()) continue;
+            if (result.first == 0 || bars.front().timestamp < result.first) {
+                result.first = bars.front().timestamp;
+            }
+            if (bars.back().timestamp > result.second) {
+                result.second = bars.back().timestamp;
+            }
+        }
+        query_count_ += 3;
+    }
+
     return result;
 }
 
@@ -505,7 +731,19 @@ int64_t RedisDataProvider::get_kline_count(
     }
     if (reply) freeReplyObject(reply);
 
-    query_count_++;
+    // 压缩分块只读头部根数（HVALS 会传回全部分块，属于冷路径）
+    std::string chunk_key = kline_codec::chunk_key(exchange, symbol, interval);
+    reply = (redisReply*)redisCommand(context_, "HVALS %s", chunk_key.c_str());
+    if (reply && reply->type == REDIS_REPLY_ARRAY) {
+        for (size_t i = 0; i < reply->elements; i++) {
+            int64_t n = kline_codec::chunk_count(
+                std::string_view(reply->element[i]->str, reply->element[i]->len));
+            if (n > 0) count += n;
+        }
+    }
+    if (reply) freeReplyObject(reply);
+
+    query_count_ += 2;
 
     return count;
 }
@@ -743,5 +981,154 @@ std::map<std::string, int64_t> RedisDataProvider::lua_batch_get_latest_timestamp
     return result;
 }
 
+std::vector<std::vector<KlineBar>> RedisDataProvider::batch_query_raw_klines(
+    const std::vector<std::string>& symbols,
+    const std::string& exchange,
+    const std::string& interval,
+    int64_t start_time,
+    int64_t end_time
+) {
+    std::vector<std::vector<KlineBar>> result(symbols.size());
+    if (symbols.empty() || end_time < start_time) return result;
+
+    std::vector<PendingKlineQuery> queries;
+    queries.reserve(symbols.size());
+    {
+        std::lock_guard<std::mutex> lock(redis_mutex_);
+
+        if (!is_connected()) {
+            if (!reconnect()) {
+                error_count_++;
+                return result;
+            }
+        }
+
+        // Pipeline: 所有币种的命令一次发出
+        for (const auto& symbol : symbols) {
+            queries.push_back(append_kline_query(symbol, exchange, interval, start_time, end_time));
+        }
+
+        // 批量读取回复（必须全部读完，否则连接上会残留回复）
+        bool ok = true;
+        for (auto& query : queries) {
+            if (!ok || !read_kline_query(query)) {
+                ok = false;
+            }
+        }
+        if (!ok) {
+            // 连接已处于错误状态，丢弃并在下次查询时重连
+            error_count_++;
+            for (auto& query : queries) query.release();
+            redisFree(context_);
+            context_ = nullptr;
+            return result;
+        }
+        query_count_ += symbols.size();
+    }
+
+    // 并行解析（每个线程处理一部分币种，各自写入 result 的不同元素）
+    size_t workers = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), 8);
+    workers = std::min(workers, (queries.size() + 7) / 8);
+
+    std::atomic<size_t> next{0};
+    auto work = [&]() {
+        size_t i;
+        while ((i = next.fetch_add(1)) < queries.size()) {
+            result[i] = assemble_klines(queries[i], exchange, interval);
+            queries[i].release();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < workers; t++) {
+        threads.emplace_back(work);
+    }
+    work();
+    for (auto& t : threads) t.join();
+
+    return result;
+}
+
+std::vector<std::vector<KlineBar>> RedisDataProvider::get_klines_batch(
+    const std::vector<std::string>& symbols,
+    const std::string& exchange,
+    const std::string& interval,
+    int64_t start_time,
+    int64_t end_time
+) {
+    auto result = batch_query_raw_klines(symbols, exchange, interval, start_time, end_time);
+
+    if (interval == "1m") return result;
+
+    // 与 get_klines 一致：没有该周期数据的币种从 1m 聚合
+    std::vector<std::string> missing;
+    std::vector<size_t> missing_index;
+    for (size_t i = 0; i < symbols.size(); i++) {
+        if (result[i].empty()) {
+            missing.push_back(symbols[i]);
+            missing_index.push_back(i);
+        }
+    }
+    if (missing.empty()) return result;
+
+    int64_t aligned_start = align_timestamp(start_time, interval);
+    auto source = batch_query_raw_klines(missing, exchange, "1m", aligned_start, end_time);
+    for (size_t k = 0; k < missing.size(); k++) {
+        if (!source[k].empty()) {
+            result[missing_index[k]] = do_aggregate(source[k], interval, missing[k], exchange);
+        }
+    }
+
+    return result;
+}
+
+KlinePanel RedisDataProvider::get_kline_panel(
+    const std::vector<std::string>& symbols,
+    const std::string& exchange,
+    const std::string& interval,
+    int64_t start_time,
+    int64_t end_time
+) {
+    auto series = get_klines_batch(symbols, exchange, interval, start_time, end_time);
+
+    KlinePanel panel;
+    panel.symbols = symbols;
+
+    // 行索引：所有币种时间戳的并集
+    size_t total = 0;
+    for (const auto& bars : series) total += bars.size();
+    panel.timestamps.reserve(total);
+    for (const auto& bars : series) {
+        for (const auto& bar : bars) panel.timestamps.push_back(bar.timestamp);
+    }
+    std::sort(panel.timestamps.begin(), panel.timestamps.end());
+    panel.timestamps.erase(std::unique(panel.timestamps.begin(), panel.timestamps.end()),
+                           panel.timestamps.end());
+
+    const size_t cells = panel.rows() * panel.cols();
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    for (auto* field : {&panel.open, &panel.high, &panel.low, &panel.close,
+                        &panel.volume, &panel.turnover}) {
+        field->assign(cells, nan);
+    }
+
+    // 各币种 K 线有序，与行索引做一次归并
+    for (size_t col = 0; col < series.size(); col++) {
+        size_t row = 0;
+        for (const auto& bar : series[col]) {
+            while (panel.timestamps[row] < bar.timestamp) row++;
+            size_t idx = panel.index(row, col);
+            panel.open[idx] = bar.open;
+            panel.high[idx] = bar.high;
+            panel.low[idx] = bar.low;
+            panel.close[idx] = bar.close;
+            panel.volume[idx] = bar.volume;
+            panel.turnover[idx] = bar.turnover;
+        }
+    }
+
+    return panel;
+}
+
 } // namespace server
 } // namespace trading
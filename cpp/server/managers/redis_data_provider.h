@@ -7,11 +7,14 @@
  * 2. 查询最近 N 天的 K 线数据
  * 3. 支持不同时间周期的 K 线聚合（1m -> 5m/15m/1h/4h/1d）
  * 4. 支持 OKX 和 Binance 两个交易所
+ * 5. 进程内 LRU 缓存已解码的 K 线，重复查询只补取新增尾部（见 kline_cache.h）
  *
  * 注意：本模块只负责从 Redis 读取数据，数据补齐由其他模块负责
  *
  * Redis 数据结构：
- * - kline:{exchange}:{symbol}:{interval} -> Sorted Set (score=timestamp_ms)
+ * - kline:{exchange}:{symbol}:{interval} -> Sorted Set (score=timestamp_ms)，实时写入的 JSON
+ * - klinec:{exchange}:{symbol}:{interval} -> Hash，已压缩的列式分块（见 kline_codec.h）
+ *   查询时两者合并，同一时间戳以 ZSET 为准（补录数据尚未压缩时）
  *
  * @author Sequence Team
  * @date 2026-01
@@ -25,10 +28,13 @@
 #include <mutex>
 #include <chrono>
 #include <map>
+#include <atomic>
 
 #include <hiredis/hiredis.h>
 #include <nlohmann/json.hpp>
 
+#include "kline_cache.h"
+
 namespace trading {
 namespace server {
 
@@ -65,22 +71,51 @@ struct KlineBar {
     }
 
     static KlineBar from_json(const nlohmann::json& j) {
+        // 聚合生成的 K 线把价格存为字符串，两种形式都接受
+        auto num = [&j](const char* key) -> double {
+            auto it = j.find(key);
+            if (it == j.end()) return 0.0;
+            if (it->is_number()) return it->get<double>();
+            if (it->is_string()) return std::stod(it->get<std::string>());
+            return 0.0;
+        };
         KlineBar bar;
         bar.symbol = j.value("symbol", "");
         bar.exchange = j.value("exchange", "");
         bar.interval = j.value("interval", "1s");
         bar.timestamp = j.value("timestamp", 0LL);  // 使用 0LL 避免整数溢出
-        bar.open = j.value("open", 0.0);
-        bar.high = j.value("high", 0.0);
-        bar.low = j.value("low", 0.0);
-        bar.close = j.value("close", 0.0);
-        bar.volume = j.value("volume", 0.0);
-        bar.turnover = j.value("turnover", 0.0);
+        bar.open = num("open");
+        bar.high = num("high");
+        bar.low = num("low");
+        bar.close = num("close");
+        bar.volume = j.contains("volume") ? num("volume") : num("vol");
+        bar.turnover = j.contains("turnover") ? num("turnover") : num("volCcy");
         bar.is_closed = j.value("is_closed", true);
         return bar;
     }
 };
 
+/**
+ * @brief 多币种对齐的 K 线面板（截面策略一次加载整个币池）
+ *
+ * 行 = 所有币种时间戳的并集（升序），列 = symbols；
+ * 各字段按行主序存放 [rows() x cols()]，某币种在该时间没有 K 线时为 NaN
+ */
+struct KlinePanel {
+    std::vector<std::string> symbols;
+    std::vector<int64_t> timestamps;
+    std::vector<double> open;
+    std::vector<double> high;
+    std::vector<double> low;
+    std::vector<double> close;
+    std::vector<double> volume;
+    std::vector<double> turnover;
+
+    size_t rows() const { return timestamps.size(); }
+    size_t cols() const { return symbols.size(); }
+    size_t index(size_t row, size_t col) const { return row * symbols.size() + col; }
+};
+
 /**
  * @brief Redis 数据查询配置
  */
@@ -91,6 +126,7 @@ struct RedisProviderConfig {
     int db = 0;
     int connection_timeout_ms = 5000;   // 连接超时
     int query_timeout_ms = 10000;       // 查询超时
+    size_t cache_max_bytes = 256ULL << 20;  // K 线缓存上限（0=禁用缓存）
 };
 
 /**
@@ -225,6 +261,41 @@ public:
 
     // ==================== 批量查询接口 ====================
 
+    /**
+     * @brief 批量查询多个币种指定时间范围的 K 线（Pipeline，单次往返）
+     *
+     * 所有币种的查询一次发出，回复读完后释放连接锁并行解析。
+     * 没有该周期数据的币种与 get_klines 一致，从 1m 聚合（再一次批量往返）。
+     * 有意不经过 K 线缓存：批量查询是全市场截面加载（通常只在策略启动时调用一次），
+     * 逐个币种走缓存会把单次 Pipeline 拆成多次往返，且大量一次性条目会挤掉
+     * get_klines 反复查询的热点条目。
+     *
+     * @param symbols 交易对列表
+     * @param exchange 交易所
+     * @param interval 时间周期
+     * @param start_time 开始时间戳（毫秒）
+     * @param end_time 结束时间戳（毫秒）
+     * @return 与 symbols 一一对应的 K 线列表（各自按时间升序）
+     */
+    std::vector<std::vector<KlineBar>> get_klines_batch(
+        const std::vector<std::string>& symbols,
+        const std::string& exchange,
+        const std::string& interval,
+        int64_t start_time,
+        int64_t end_time
+    );
+
+    /**
+     * @brief 批量查询并按时间戳对齐成面板（参数同 get_klines_batch）
+     */
+    KlinePanel get_kline_panel(
+        const std::vector<std::string>& symbols,
+        const std::string& exchange,
+        const std::string& interval,
+        int64_t start_time,
+        int64_t end_time
+    );
+
     /**
      * @brief 批量获取多个币种最新K线的时间戳（使用Redis Pipeline，单次往返）
      * @param symbols 交易对列表
@@ -269,6 +340,16 @@ public:
     uint64_t get_query_count() const { return query_count_; }
     uint64_t get_error_count() const { return error_count_; }
 
+    /**
+     * @brief K 线缓存统计（命中/部分命中/未命中/淘汰/内存占用）
+     */
+    KlineCacheStats get_cache_stats() const { return cache_.stats(); }
+
+    /**
+     * @brief 清空 K 线缓存（如补录历史数据后需要重新加载）
+     */
+    void clear_cache() { cache_.clear(); }
+
 private:
     /**
      * @brief 重连逻辑
@@ -286,14 +367,91 @@ private:
     int64_t align_timestamp(int64_t timestamp, const std::string& interval) const;
 
     /**
-     * @brief 从 Redis 查询原始 K 线数据
+     * @brief 从 Redis 查询原始 K 线数据（压缩分块 + JSON ZSET，一次 pipeline 往返）
      */
     std::vector<KlineBar> query_raw_klines(
-        const std::string& key,
+        const std::string& symbol,
+        const std::string& exchange,
+        const std::string& interval,
         int64_t start_time,
         int64_t end_time
     );
 
+    /**
+     * @brief 已发出、等待解析的一个 K 线查询（分块 + JSON 两条回复）
+     */
+    struct PendingKlineQuery {
+        std::string symbol;
+        int64_t start_time = 0;
+        int64_t end_time = 0;
+        int64_t first_chunk = 0;
+        int64_t last_chunk = 0;
+        bool fetch_all_chunks = false;
+        redisReply* chunk_reply = nullptr;
+        redisReply* json_reply = nullptr;
+
+        void release();
+    };
+
+    /**
+     * @brief 向 pipeline 追加一个币种的查询命令（需持有 redis_mutex_）
+     */
+    PendingKlineQuery append_kline_query(
+        const std::string& symbol,
+        const std::string& exchange,
+        const std::string& interval,
+        int64_t start_time,
+        int64_t end_time
+    );
+
+    /**
+     * @brief 读取 append_kline_query 对应的两条回复（需持有 redis_mutex_）
+     */
+    bool read_kline_query(PendingKlineQuery& query);
+
+    /**
+     * @brief 解码分块、解析 JSON 并合并（不访问连接，可并行调用）
+     */
+    std::vector<KlineBar> assemble_klines(
+        const PendingKlineQuery& query,
+        const std::string& exchange,
+        const std::string& interval
+    );
+
+    /**
+     * @brief 多币种原始 K 线：单次 pipeline 往返 + 并行解析
+     */
+    std::vector<std::vector<KlineBar>> batch_query_raw_klines(
+        const std::vector<std::string>& symbols,
+        const std::string& exchange,
+        const std::string& interval,
+        int64_t start_time,
+        int64_t end_time
+    );
+
+    /**
+     * @brief 经缓存查询原始 K 线（缓存禁用时直接查询 Redis）
+     */
+    std::vector<KlineBar> cached_query_klines(
+        const std::string& symbol,
+        const std::string& exchange,
+        const std::string& interval,
+        int64_t start_time,
+        int64_t end_time
+    );
+
+    /**
+     * @brief 解析 ZSET 中的 JSON 成员
+     */
+    void parse_json_members(redisReply* reply, std::vector<KlineBar>& out);
+
+    /**
+     * @brief 解码压缩分块并补齐 symbol/exchange/interval
+     */
+    void decode_chunk_into(const char* data, size_t len, const std::string& symbol,
+                           const std::string& exchange, const std::string& interval,
+                           int64_t start_time, int64_t end_time, std::vector<KlineBar>& out);
+
     /**
      * @brief 聚合 K 线数据
      */
@@ -318,9 +476,13 @@ private:
     // Lua脚本SHA缓存
     std::string lua_batch_ts_sha_;
 
+    // 已解码 K 线缓存
+    KlineCache<KlineBar> cache_;
+
     // 统计
-    mutable uint64_t query_count_ = 0;
-    mutable uint64_t error_count_ = 0;
+    // 统计（批量查询并行解析时也会更新）
+    mutable std::atomic<uint64_t> query_count_{0};
+    mutable std::atomic<uint64_t> error_count_{0};
 };
 
 // 全局 Redis 数据提供者实例（策略端使用）
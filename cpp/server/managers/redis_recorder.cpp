@@ -8,8 +8,11 @@
 
 #include "redis_recorder.h"
 #include <iostream>
-#include <cstdarg>
+#include <algorithm>
 #include <chrono>
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
 
 namespace trading {
 namespace server {
@@ -42,8 +45,16 @@ bool RedisRecorder::start() {
         return false;
     }
 
+    // 队列只创建一次且不随 stop() 释放：回调线程可能在 stop() 前一刻仍在入队
+    if (!queue_) {
+        queue_ = std::make_unique<BoundedMpscQueue<RedisWriteTask>>(config_.queue_capacity);
+    }
+    writer_running_.store(true);
+    writer_thread_ = std::thread(&RedisRecorder::writer_loop, this);
+
     running_.store(true);
-    log_info("[RedisRecorder] 启动成功，开始录制行情数据");
+    log_info("[RedisRecorder] 启动成功，开始录制行情数据（异步写入，队列容量 " +
+             std::to_string(queue_->capacity()) + "）");
     return true;
 }
 
@@ -52,7 +63,12 @@ void RedisRecorder::stop() {
         return;
     }
 
+    // 先停止入队，再让写线程排空队列
     running_.store(false);
+    writer_running_.store(false);
+    if (writer_thread_.joinable()) {
+        writer_thread_.join();
+    }
     disconnect();
 
     log_info("[RedisRecorder] 已停止");
@@ -60,7 +76,10 @@ void RedisRecorder::stop() {
              " K线=" + std::to_string(kline_count_.load()) +
              " 深度=" + std::to_string(orderbook_count_.load()) +
              " 资金费率=" + std::to_string(funding_rate_count_.load()) +
-             " 错误=" + std::to_string(error_count_.load()));
+             " 错误=" + std::to_string(error_count_.load()) +
+             " 丢弃=" + std::to_string(dropped_count_.load()) +
+             " 刷写=" + std::to_string(flush_count_.load()) +
+             (flush_latency_.count() > 0 ? " " + flush_latency_.summary() : ""));
 }
 
 bool RedisRecorder::is_connected() const {
@@ -137,66 +156,29 @@ bool RedisRecorder::reconnect() {
     return connect();
 }
 
+// ==================== 数据录制接口（回调线程：序列化 + 入队） ====================
+
 void RedisRecorder::record_trade(const std::string& symbol, const std::string& exchange,
                                   const nlohmann::json& data) {
     if (!running_.load() || !config_.enabled) return;
 
-    // 锁外准备数据（PERF-C6: 减少锁持有时间）
     nlohmann::json trade_data = data;
     trade_data["exchange"] = exchange;
     trade_data["symbol"] = symbol;
 
-    std::string key = "trades:" + symbol;
-    std::string value = trade_data.dump();
-
-    std::lock_guard<std::mutex> lock(redis_mutex_);
-
-    if (!is_connected()) {
-        if (!reconnect()) {
-            error_count_++;
-            return;
-        }
-    }
-
-    // Pipeline: 3条命令一次往返（PERF-C1）
-    redisAppendCommand(context_, "LPUSH %s %s", key.c_str(), value.c_str());
-    redisAppendCommand(context_, "LTRIM %s 0 %d", key.c_str(), config_.max_trades_per_symbol - 1);
-    redisAppendCommand(context_, "EXPIRE %s %d", key.c_str(), config_.expire_seconds);
-
-    for (int i = 0; i < 3; i++) {
-        redisReply* reply = nullptr;
-        if (redisGetReply(context_, (void**)&reply) != REDIS_OK || reply == nullptr) {
-            error_count_++;
-            if (reply) freeReplyObject(reply);
-            // pipeline 中断时需要 drain 剩余 reply
-            for (int j = i + 1; j < 3; j++) {
-                redisReply* r = nullptr;
-                redisGetReply(context_, (void**)&r);
-                if (r) freeReplyObject(r);
-            }
-            return;
-        }
-        if (reply->type == REDIS_REPLY_ERROR && i == 0) {
-            error_count_++;
-            freeReplyObject(reply);
-            for (int j = i + 1; j < 3; j++) {
-                redisReply* r = nullptr;
-                redisGetReply(context_, (void**)&r);
-                if (r) freeReplyObject(r);
-            }
-            return;
-        }
-        freeReplyObject(reply);
-    }
-
-    trade_count_++;
+    RedisWriteTask task;
+    task.kind = RedisWriteTask::Kind::TRADE;
+    task.key = "trades:" + symbol;
+    task.value = trade_data.dump();
+    task.max_count = config_.max_trades_per_symbol;
+    task.expire_seconds = config_.expire_seconds;
+    enqueue(std::move(task), false);
 }
 
 void RedisRecorder::record_kline(const std::string& symbol, const std::string& interval,
                                   const std::string& exchange, const nlohmann::json& data) {
     if (!running_.load() || !config_.enabled) return;
 
-    // 锁外准备数据（PERF-C6: 减少锁持有时间）
     int64_t timestamp = data.value("timestamp", 0LL);
     if (timestamp == 0) {
         timestamp = data.value("ts", 0LL);
@@ -215,9 +197,6 @@ void RedisRecorder::record_kline(const std::string& symbol, const std::string& i
         kline_data["timestamp"] = timestamp;
     }
 
-    std::string key = "kline:" + exchange + ":" + symbol + ":" + interval;
-    std::string value = kline_data.dump();
-
     int max_count = 43200;
     int expire_days = 30;
     auto it = config_.kline_retention.find(interval);
@@ -225,50 +204,15 @@ void RedisRecorder::record_kline(const std::string& symbol, const std::string& i
         max_count = it->second.max_count;
         expire_days = it->second.expire_days;
     }
-    int expire_seconds = expire_days * 24 * 60 * 60;
-
-    std::lock_guard<std::mutex> lock(redis_mutex_);
-
-    if (!is_connected()) {
-        if (!reconnect()) {
-            error_count_++;
-            return;
-        }
-    }
 
-    // Pipeline: 3条命令一次往返（PERF-C1）
-    redisAppendCommand(context_, "ZADD %s %lld %s",
-        key.c_str(), (long long)timestamp, value.c_str());
-    redisAppendCommand(context_, "ZREMRANGEBYRANK %s 0 -%d",
-        key.c_str(), max_count + 1);
-    redisAppendCommand(context_, "EXPIRE %s %d", key.c_str(), expire_seconds);
-
-    for (int i = 0; i < 3; i++) {
-        redisReply* reply = nullptr;
-        if (redisGetReply(context_, (void**)&reply) != REDIS_OK || reply == nullptr) {
-            error_count_++;
-            if (reply) freeReplyObject(reply);
-            for (int j = i + 1; j < 3; j++) {
-                redisReply* r = nullptr;
-                redisGetReply(context_, (void**)&r);
-                if (r) freeReplyObject(r);
-            }
-            return;
-        }
-        if (reply->type == REDIS_REPLY_ERROR && i == 0) {
-            error_count_++;
-            freeReplyObject(reply);
-            for (int j = i + 1; j < 3; j++) {
-                redisReply* r = nullptr;
-                redisGetReply(context_, (void**)&r);
-                if (r) freeReplyObject(r);
-            }
-            return;
-        }
-        freeReplyObject(reply);
-    }
-
-    kline_count_++;
+    RedisWriteTask task;
+    task.kind = RedisWriteTask::Kind::KLINE;
+    task.key = "kline:" + exchange + ":" + symbol + ":" + interval;
+    task.value = kline_data.dump();
+    task.score = timestamp;
+    task.max_count = max_count;
+    task.expire_seconds = expire_days * 24 * 60 * 60;
+    enqueue(std::move(task), true);
 
     // 如果是 1m K 线且启用了聚合，则聚合到其他周期
     if (interval == "1m" && config_.aggregate_on_receive) {
@@ -280,52 +224,23 @@ void RedisRecorder::record_orderbook(const std::string& symbol, const std::strin
                                       const nlohmann::json& data) {
     if (!running_.load() || !config_.enabled) return;
 
-    std::lock_guard<std::mutex> lock(redis_mutex_);
-
-    if (!is_connected()) {
-        if (!reconnect()) {
-            error_count_++;
-            return;
-        }
-    }
-
-    // 构建完整数据
     nlohmann::json orderbook_data = data;
     orderbook_data["exchange"] = exchange;
     orderbook_data["symbol"] = symbol;
 
-    std::string key = "orderbook:" + symbol;
-    std::string value = orderbook_data.dump();
-
-    // SET 只保留最新快照
-    redisReply* reply = (redisReply*)redisCommand(
-        context_, "SET %s %s EX %d",
-        key.c_str(), value.c_str(), config_.expire_seconds
-    );
-
-    if (reply == nullptr || reply->type == REDIS_REPLY_ERROR) {
-        error_count_++;
-        if (reply) freeReplyObject(reply);
-        return;
-    }
-    freeReplyObject(reply);
-
-    orderbook_count_++;
+    // SET 只保留最新快照（写线程对同批次同 key 只写最后一条）
+    RedisWriteTask task;
+    task.kind = RedisWriteTask::Kind::ORDERBOOK;
+    task.key = "orderbook:" + symbol;
+    task.value = orderbook_data.dump();
+    task.expire_seconds = config_.expire_seconds;
+    enqueue(std::move(task), false);
 }
 
 void RedisRecorder::record_funding_rate(const std::string& symbol, const std::string& exchange,
                                          const nlohmann::json& data) {
     if (!running_.load() || !config_.enabled) return;
 
-    std::lock_guard<std::mutex> lock(redis_mutex_);
-
-    if (!is_connected()) {
-        if (!reconnect()) {
-            error_count_++;
-            return;
-        }
-    }
-
     // 获取时间戳（0LL 确保 int64_t 推导，避免 32 位截断）
     int64_t timestamp = data.value("timestamp", 0LL);
     if (timestamp == 0) {
@@ -337,7 +252,6 @@ void RedisRecorder::record_funding_rate(const std::string& symbol, const std::st
         }
     }
 
-    // 构建完整数据
     nlohmann::json fr_data = data;
     fr_data["exchange"] = exchange;
     fr_data["symbol"] = symbol;
@@ -345,35 +259,263 @@ void RedisRecorder::record_funding_rate(const std::string& symbol, const std::st
         fr_data["timestamp"] = timestamp;
     }
 
-    std::string key = "funding_rate:" + symbol;
-    std::string value = fr_data.dump();
+    // 保持最近 100 条
+    RedisWriteTask task;
+    task.kind = RedisWriteTask::Kind::FUNDING_RATE;
+    task.key = "funding_rate:" + symbol;
+    task.value = fr_data.dump();
+    task.score = timestamp;
+    task.max_count = 100;
+    task.expire_seconds = config_.expire_seconds;
+    enqueue(std::move(task), true);
+}
 
-    // ZADD 添加到有序集合
-    redisReply* reply = (redisReply*)redisCommand(
-        context_, "ZADD %s %lld %s",
-        key.c_str(), (long long)timestamp, value.c_str()
-    );
+// ==================== 异步写入 ====================
 
-    if (reply == nullptr || reply->type == REDIS_REPLY_ERROR) {
-        error_count_++;
-        if (reply) freeReplyObject(reply);
+bool RedisRecorder::enqueue(RedisWriteTask&& task, bool may_wait) {
+    bool pushed = queue_->try_push(std::move(task));
+
+    // K线/资金费率频率低但不可补录，队列满时短暂等待写线程腾出空间
+    if (!pushed && may_wait && config_.kline_enqueue_timeout_us > 0) {
+        auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::microseconds(config_.kline_enqueue_timeout_us);
+        while (!pushed && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::yield();
+            pushed = queue_->try_push(std::move(task));
+        }
+    }
+
+    if (!pushed) {
+        uint64_t dropped = ++dropped_count_;
+        if (dropped == 1 || dropped % 10000 == 0) {
+            log_error("[RedisRecorder] 写入队列已满，累计丢弃 " + std::to_string(dropped) + " 条");
+        }
+        return false;
+    }
+
+    enqueued_count_.fetch_add(1, std::memory_order_relaxed);
+    size_t depth = queue_->size_approx();
+    size_t prev_max = max_queue_depth_.load(std::memory_order_relaxed);
+    while (depth > prev_max &&
+           !max_queue_depth_.compare_exchange_weak(prev_max, depth, std::memory_order_relaxed)) {
+    }
+    return true;
+}
+
+RedisWriterStats RedisRecorder::get_writer_stats() const {
+    RedisWriterStats stats;
+    if (queue_) {
+        stats.queue_depth = queue_->size_approx();
+        stats.queue_capacity = queue_->capacity();
+    }
+    stats.max_queue_depth = max_queue_depth_.load(std::memory_order_relaxed);
+    stats.enqueued = enqueued_count_.load(std::memory_order_relaxed);
+    stats.dropped = dropped_count_.load(std::memory_order_relaxed);
+    stats.flushes = flush_count_.load(std::memory_order_relaxed);
+    stats.flushed_records = flushed_records_.load(std::memory_order_relaxed);
+    stats.commands = command_count_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void RedisRecorder::writer_loop() {
+    const size_t batch_limit = std::max<size_t>(1, config_.flush_batch_size);
+    const auto flush_interval = std::chrono::milliseconds(std::max(1, config_.flush_interval_ms));
+
+    std::vector<RedisWriteTask> batch;
+    batch.reserve(batch_limit);
+    RedisWriteTask task;
+    auto deadline = std::chrono::steady_clock::now();
+
+    while (true) {
+        bool stopping = !writer_running_.load();
+
+        while (batch.size() < batch_limit && queue_->try_pop(task)) {
+            if (batch.empty()) {
+                deadline = std::chrono::steady_clock::now() + flush_interval;
+            }
+            batch.push_back(std::move(task));
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (!batch.empty() && (batch.size() >= batch_limit || now >= deadline || stopping)) {
+            flush_batch(batch);
+            batch.clear();
+            continue;
+        }
+        if (stopping && batch.empty() && queue_->size_approx() == 0) {
+            break;
+        }
+
+        // 空闲或攒批中：睡到截止时间，最长 1ms
+        auto wait = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::milliseconds(1));
+        if (!batch.empty()) {
+            wait = std::min(wait, deadline - now);
+        }
+        std::this_thread::sleep_for(wait);
+    }
+}
+
+bool RedisRecorder::ensure_connected() {
+    if (is_connected()) {
+        return true;
+    }
+    // Redis 不可用时每秒最多重连一次，期间到达的批次计为错误
+    auto now = std::chrono::steady_clock::now();
+    if (now < next_reconnect_time_) {
+        return false;
+    }
+    next_reconnect_time_ = now + std::chrono::seconds(1);
+    return reconnect();
+}
+
+void RedisRecorder::flush_batch(std::vector<RedisWriteTask>& batch) {
+    if (!ensure_connected()) {
+        error_count_ += batch.size();
         return;
     }
-    freeReplyObject(reply);
 
-    // 保持最近 100 条
-    reply = (redisReply*)redisCommand(
-        context_, "ZREMRANGEBYRANK %s 0 -101", key.c_str()
-    );
-    if (reply) freeReplyObject(reply);
-
-    // 设置过期时间
-    reply = (redisReply*)redisCommand(
-        context_, "EXPIRE %s %d", key.c_str(), config_.expire_seconds
-    );
-    if (reply) freeReplyObject(reply);
-
-    funding_rate_count_++;
+    // 按 key 分组（保持首次出现的顺序），同一 key 合并为一条写命令
+    struct Group {
+        const RedisWriteTask* first = nullptr;
+        std::vector<const RedisWriteTask*> items;
+    };
+    std::vector<Group> groups;
+    std::unordered_map<std::string_view, size_t> group_index;
+    groups.reserve(batch.size());
+    group_index.reserve(batch.size());
+
+    for (const auto& task : batch) {
+        auto [it, inserted] = group_index.emplace(task.key, groups.size());
+        if (inserted) {
+            groups.push_back(Group{&task, {}});
+        }
+        Group& group = groups[it->second];
+        if (task.kind == RedisWriteTask::Kind::ORDERBOOK) {
+            group.items.assign(1, &task);  // 深度只保留最新快照
+        } else {
+            group.items.push_back(&task);
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<const char*> argv;
+    std::vector<size_t> argvlen;
+    std::vector<std::string> numbers;  // score / 参数文本，需在 append 期间保持有效
+    std::vector<int> replies_per_group;
+    replies_per_group.reserve(groups.size());
+
+    auto append = [&]() {
+        redisAppendCommandArgv(context_, static_cast<int>(argv.size()), argv.data(), argvlen.data());
+        argv.clear();
+        argvlen.clear();
+    };
+    auto arg = [&](const std::string& s) {
+        argv.push_back(s.data());
+        argvlen.push_back(s.size());
+    };
+    auto lit = [&](const char* s) {
+        argv.push_back(s);
+        argvlen.push_back(std::strlen(s));
+    };
+    auto num = [&](long long v) {
+        numbers.push_back(std::to_string(v));
+    };
+
+    int total_commands = 0;
+    for (const auto& group : groups) {
+        const RedisWriteTask& head = *group.first;
+        const std::string& key = head.key;
+        numbers.clear();
+        numbers.reserve(group.items.size() + 3);
+        int commands = 0;
+
+        switch (head.kind) {
+            case RedisWriteTask::Kind::TRADE:
+                lit("LPUSH"); arg(key);
+                for (const auto* item : group.items) arg(item->value);
+                append();
+                num(head.max_count - 1);
+                lit("LTRIM"); arg(key); lit("0"); arg(numbers.back());
+                append();
+                commands = 2;
+                break;
+            case RedisWriteTask::Kind::KLINE:
+            case RedisWriteTask::Kind::FUNDING_RATE:
+                for (const auto* item : group.items) num(item->score);
+                lit("ZADD"); arg(key);
+                for (size_t i = 0; i < group.items.size(); ++i) {
+                    arg(numbers[i]);
+                    arg(group.items[i]->value);
+                }
+                append();
+                num(-(head.max_count + 1));
+                lit("ZREMRANGEBYRANK"); arg(key); lit("0"); arg(numbers.back());
+                append();
+                commands = 2;
+                break;
+            case RedisWriteTask::Kind::ORDERBOOK:
+                num(head.expire_seconds);
+                lit("SET"); arg(key); arg(group.items.front()->value); lit("EX"); arg(numbers.back());
+                append();
+                commands = 1;
+                break;
+        }
+        if (head.kind != RedisWriteTask::Kind::ORDERBOOK) {
+            num(head.expire_seconds);
+            lit("EXPIRE"); arg(key); arg(numbers.back());
+            append();
+            ++commands;
+        }
+        replies_per_group.push_back(commands);
+        total_commands += commands;
+    }
+
+    // 收齐回复：每组第一条（写入命令）失败计为错误，其余命令结果忽略
+    bool broken = false;
+    for (size_t g = 0; g < groups.size(); ++g) {
+        const Group& group = groups[g];
+        bool written = true;
+        for (int i = 0; i < replies_per_group[g]; ++i) {
+            redisReply* reply = nullptr;
+            if (broken || redisGetReply(context_, (void**)&reply) != REDIS_OK || reply == nullptr) {
+                broken = true;
+                written = false;
+                if (reply) freeReplyObject(reply);
+                continue;
+            }
+            if (i == 0 && reply->type == REDIS_REPLY_ERROR) {
+                written = false;
+            }
+            freeReplyObject(reply);
+        }
+
+        // 按记录条数统计（深度合并后只计写入的快照）
+        uint64_t n = group.items.size();
+        if (!written) {
+            error_count_ += n;
+            continue;
+        }
+        switch (group.first->kind) {
+            case RedisWriteTask::Kind::TRADE:        trade_count_ += n; break;
+            case RedisWriteTask::Kind::KLINE:        kline_count_ += n; break;
+            case RedisWriteTask::Kind::ORDERBOOK:    orderbook_count_ += n; break;
+            case RedisWriteTask::Kind::FUNDING_RATE: funding_rate_count_ += n; break;
+        }
+        flushed_records_.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    if (broken) {
+        log_error("[RedisRecorder] pipeline 中断，下次刷写时重连");
+        disconnect();
+        next_reconnect_time_ = std::chrono::steady_clock::time_point{};
+    }
+
+    flush_latency_.record(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count());
+    flush_count_.fetch_add(1, std::memory_order_relaxed);
+    command_count_.fetch_add(total_commands, std::memory_order_relaxed);
 }
 
 void RedisRecorder::log_info(const std::string& msg) {
@@ -486,25 +628,6 @@ void RedisRecorder::store_aggregated_kline(const std::string& symbol, const std:
     kline_data["symbol"] = symbol;
     kline_data["interval"] = interval;
 
-    std::string key = "kline:" + exchange + ":" + symbol + ":" + interval;
-    std::string value = kline_data.dump();
-
-    // 注意：这里不需要加锁，因为调用者已经持有 aggregate_mutex_
-    // 但需要确保 redis_mutex_ 已被持有（在 record_kline 中已加锁）
-
-    // ZADD 添加到有序集合
-    redisReply* reply = (redisReply*)redisCommand(
-        context_, "ZADD %s %lld %s",
-        key.c_str(), (long long)buffer.period_start, value.c_str()
-    );
-
-    if (reply == nullptr || reply->type == REDIS_REPLY_ERROR) {
-        error_count_++;
-        if (reply) freeReplyObject(reply);
-        return;
-    }
-    freeReplyObject(reply);
-
     // 根据周期获取保存配置
     int max_count = 43200;
     int expire_days = 30;
@@ -514,21 +637,14 @@ void RedisRecorder::store_aggregated_kline(const std::string& symbol, const std:
         expire_days = it->second.expire_days;
     }
 
-    // ZREMRANGEBYRANK 保持有序集合大小
-    reply = (redisReply*)redisCommand(
-        context_, "ZREMRANGEBYRANK %s 0 -%d",
-        key.c_str(), max_count + 1
-    );
-    if (reply) freeReplyObject(reply);
-
-    // 设置过期时间
-    int expire_seconds = expire_days * 24 * 60 * 60;
-    reply = (redisReply*)redisCommand(
-        context_, "EXPIRE %s %d", key.c_str(), expire_seconds
-    );
-    if (reply) freeReplyObject(reply);
-
-    kline_count_++;
+    RedisWriteTask task;
+    task.kind = RedisWriteTask::Kind::KLINE;
+    task.key = "kline:" + exchange + ":" + symbol + ":" + interval;
+    task.value = kline_data.dump();
+    task.score = buffer.period_start;
+    task.max_count = max_count;
+    task.expire_seconds = expire_days * 24 * 60 * 60;
+    enqueue(std::move(task), true);
 }
 
 } // namespace server
@@ -7,6 +7,12 @@
  * 2. 将数据存入 Redis（除订单数据外）
  * 3. 集成到主服务器，随服务器启动
  *
+ * 写入模型：
+ * - record_*() 在行情回调线程只做序列化 + 入队（有界无锁队列），不访问 Redis
+ * - 独立写线程按条数/时间阈值攒批，同一 key 的多条记录合并为一条命令
+ *   （LPUSH k v1 v2.. / ZADD k s1 m1 s2 m2..），整批一次 pipeline 往返
+ * - 队列满时：trades/深度立即丢弃；K线/资金费率短暂等待后丢弃（均计入 dropped）
+ *
  * Redis 数据结构：
  * - trades:{symbol} -> List (最近的 trades)
  * - kline:{symbol}:{interval} -> Sorted Set (score=timestamp)
@@ -28,11 +34,15 @@
 #include <map>
 #include <vector>
 #include <deque>
+#include <chrono>
+#include <cstdint>
 
 #ifdef HAS_HIREDIS
 #include <hiredis/hiredis.h>
 #endif
 #include <nlohmann/json.hpp>
+#include "../../core/mpsc_queue.h"
+#include "../../core/latency_histogram.h"
 
 namespace trading {
 namespace server {
@@ -50,6 +60,12 @@ struct RedisConfig {
     bool enabled = true;                      // 是否启用录制
     bool aggregate_on_receive = true;         // 收到1m K线时自动聚合生成其他周期
 
+    // 异步写入
+    size_t queue_capacity = 65536;            // 写入队列容量（条）
+    size_t flush_batch_size = 1024;           // 单次 pipeline 最多合并的记录数
+    int flush_interval_ms = 5;                // 最长攒批时间（毫秒）
+    int kline_enqueue_timeout_us = 2000;      // K线/资金费率队列满时最长等待（微秒，0=立即丢弃）
+
     // 不同周期的 K 线保存配置
     struct KlineRetention {
         int max_count;      // 最大保存数量
@@ -82,6 +98,39 @@ struct KlineAggregateBuffer {
     int bar_count = 0;           // 已聚合的 1m K 线数量
 };
 
+/**
+ * @brief 待写入 Redis 的一条记录（回调线程已完成序列化）
+ */
+struct RedisWriteTask {
+    enum class Kind : uint8_t {
+        TRADE,         // LIST:  LPUSH + LTRIM + EXPIRE
+        KLINE,         // ZSET:  ZADD + ZREMRANGEBYRANK + EXPIRE
+        ORDERBOOK,     // STRING: SET EX（同批次只写最新快照）
+        FUNDING_RATE   // ZSET
+    };
+
+    Kind kind = Kind::TRADE;
+    std::string key;
+    std::string value;
+    int64_t score = 0;          // ZSET score（毫秒时间戳）
+    int max_count = 0;          // LIST/ZSET 保留条数
+    int expire_seconds = 0;
+};
+
+/**
+ * @brief 异步写入统计
+ */
+struct RedisWriterStats {
+    size_t queue_depth = 0;
+    size_t max_queue_depth = 0;
+    size_t queue_capacity = 0;
+    uint64_t enqueued = 0;
+    uint64_t dropped = 0;          // 队列满被丢弃的记录
+    uint64_t flushes = 0;          // pipeline 次数
+    uint64_t flushed_records = 0;  // 已写入的记录
+    uint64_t commands = 0;         // 合并后的 Redis 命令数
+};
+
 /**
  * @brief Redis 数据录制器
  *
@@ -169,6 +218,14 @@ public:
     uint64_t get_orderbook_count() const { return orderbook_count_.load(); }
     uint64_t get_funding_rate_count() const { return funding_rate_count_.load(); }
     uint64_t get_error_count() const { return error_count_.load(); }
+    uint64_t get_dropped_count() const { return dropped_count_.load(); }
+
+    RedisWriterStats get_writer_stats() const;
+
+    /**
+     * @brief 单次 pipeline 刷写耗时（从发送到收齐回复）
+     */
+    const LatencyHistogram& flush_latency() const { return flush_latency_; }
 
 private:
     /**
@@ -187,9 +244,25 @@ private:
     bool reconnect();
 
     /**
-     * @brief 执行 Redis 命令（带重试）
+     * @brief 入队（回调线程调用）
+     * @param may_wait 队列满时是否短暂等待（K线/资金费率）
      */
-    bool execute_command(const char* format, ...);
+    bool enqueue(RedisWriteTask&& task, bool may_wait);
+
+    /**
+     * @brief 写线程主循环：攒批 -> flush_batch()
+     */
+    void writer_loop();
+
+    /**
+     * @brief 合并同 key 记录并以一次 pipeline 写入
+     */
+    void flush_batch(std::vector<RedisWriteTask>& batch);
+
+    /**
+     * @brief 写线程使用：确保连接可用（失败后限频重连）
+     */
+    bool ensure_connected();
 
     /**
      * @brief 日志输出
@@ -207,7 +280,7 @@ private:
                              const nlohmann::json& data);
 
     /**
-     * @brief 存储聚合后的 K 线
+     * @brief 存储聚合后的 K 线（入队）
      */
     void store_aggregated_kline(const std::string& symbol, const std::string& exchange,
                                 const std::string& interval, const KlineAggregateBuffer& buffer);
@@ -232,6 +305,12 @@ private:
     std::mutex redis_mutex_;
     std::atomic<bool> running_{false};
 
+    // 异步写入：回调线程入队，writer_thread_ 独占 context_
+    std::unique_ptr<BoundedMpscQueue<RedisWriteTask>> queue_;
+    std::thread writer_thread_;
+    std::atomic<bool> writer_running_{false};
+    std::chrono::steady_clock::time_point next_reconnect_time_{};
+
     // 聚合缓存: key = "symbol:exchange:interval"
     std::map<std::string, KlineAggregateBuffer> aggregate_buffers_;
     std::mutex aggregate_mutex_;
@@ -245,6 +324,13 @@ private:
     std::atomic<uint64_t> orderbook_count_{0};
     std::atomic<uint64_t> funding_rate_count_{0};
     std::atomic<uint64_t> error_count_{0};
+    std::atomic<uint64_t> dropped_count_{0};
+    std::atomic<uint64_t> enqueued_count_{0};
+    std::atomic<size_t> max_queue_depth_{0};
+    std::atomic<uint64_t> flush_count_{0};
+    std::atomic<uint64_t> flushed_records_{0};
+    std::atomic<uint64_t> command_count_{0};
+    LatencyHistogram flush_latency_;
 };
 
 // 全局 Redis 录制器实例
@@ -21,6 +21,7 @@
 #include <sys/wait.h>
 #include <fcntl.h>
 #include <mutex>
+#include <sstream>
 
 #ifdef __linux__
 #include <sched.h>
@@ -32,7 +33,10 @@
 #include "managers/account_manager.h"
 #include "managers/account_monitor.h"  // 账户监控模块
 #include "managers/redis_recorder.h"
+#include "managers/order_book_manager.h"
 #include "handlers/order_processor.h"
+#include "handlers/order_gateway.h"
+#include "handlers/ws_order_router.h"
 #include "handlers/query_handler.h"
 
 #include "handlers/frontend_command_handler.h"
@@ -42,6 +46,7 @@
 #include "../network/zmq_server.h"
 #include "../network/frontend_handler.h"
 #include "../network/websocket_server.h"
+#include "../network/market_push.h"
 #include "../trading/config_loader.h"
 #include "../trading/account_registry.h"
 #include "../trading/strategy_config_loader.h"
@@ -50,6 +55,7 @@
 #include "../adapters/binance/binance_websocket.h"
 #include "../adapters/binance/binance_rest_api.h"
 #include "../core/logger.h"
+#include "../core/idle_strategy.h"
 #include "../network/vpn_network_monitor.h"
 #include "managers/symbol_delist_monitor.h"
 #include <filesystem>
@@ -286,8 +292,22 @@ StrategyProcessManager g_strategy_manager;
 // 工作线程
 // ============================================================
 
+/**
+ * @brief 读取工作线程空闲策略（poll / spin / backoff，默认 poll）
+ */
+IdleMode idle_mode_from_env(const char* env_name) {
+    IdleMode mode = IdleMode::POLL;
+    if (const char* v = std::getenv(env_name)) {
+        if (!parse_idle_mode(v, mode)) {
+            std::cerr << "[警告] " << env_name << "=" << v << " 无效（可选 poll/spin/backoff），使用 poll\n";
+        }
+    }
+    return mode;
+}
+
 void order_thread(ZmqServer& server) {
-    std::cout << "[订单线程] 启动\n";
+    IdleStrategy idle(idle_mode_from_env("SEQ_ORDER_IDLE"));
+    std::cout << "[订单线程] 启动 (空闲策略: " << idle_mode_name(idle.mode()) << ")\n";
     pin_thread_to_cpu(2);
     set_realtime_priority(49);
 
@@ -295,19 +315,24 @@ void order_thread(ZmqServer& server) {
         int processed = 0;
         nlohmann::json order;
         while (server.recv_order_json(order)) {
+            // 策略端发送时间戳（system_clock 纳秒），用于统计发送到分发的延迟
+            auto ts = order.find("send_ts_ns");
+            if (ts != order.end() && ts->is_number_integer()) {
+                g_order_dispatch_latency.record(current_timestamp_ns() - ts->get<int64_t>());
+            }
             process_order_request(server, order);
             processed++;
         }
-        if (processed == 0) {
-            std::this_thread::sleep_for(microseconds(50));
-        }
+        idle.idle(processed, [&](int timeout_ms) { server.wait_orders(timeout_ms); });
     }
 
     std::cout << "[订单线程] 停止\n";
+    std::cout << "[订单线程] 发送->分发延迟: " << g_order_dispatch_latency.summary() << "\n";
 }
 
 void query_thread(ZmqServer& server) {
-    std::cout << "[查询线程] 启动\n";
+    IdleStrategy idle(idle_mode_from_env("SEQ_QUERY_IDLE"));
+    std::cout << "[查询线程] 启动 (空闲策略: " << idle_mode_name(idle.mode()) << ")\n";
     pin_thread_to_cpu(3);
 
     server.set_query_callback([](const nlohmann::json& request) -> nlohmann::json {
@@ -316,16 +341,18 @@ void query_thread(ZmqServer& server) {
 
     while (g_running.load()) {
         int processed = server.poll_queries();
-        if (processed == 0) {
-            std::this_thread::sleep_for(milliseconds(1));
-        }
+        idle.idle(processed, [&](int timeout_ms) { server.wait_queries(timeout_ms); });
     }
 
     std::cout << "[查询线程] 停止\n";
 }
 
 void subscription_thread(ZmqServer& server) {
-    std::cout << "[订阅线程] 启动\n";
+    IdleStrategy idle(idle_mode_from_env("SEQ_SUBSCRIBE_IDLE"));
+    std::cout << "[订阅线程] 启动 (空闲策略: " << idle_mode_name(idle.mode()) << ")\n";
+    if (idle.mode() == IdleMode::SPIN) {
+        pin_thread_to_cpu(4);  // 忙轮询必须独占核心
+    }
 
     server.set_subscribe_callback([](const nlohmann::json& request) {
         handle_subscription(request);
@@ -333,9 +360,7 @@ void subscription_thread(ZmqServer& server) {
 
     while (g_running.load()) {
         int processed = server.poll_subscriptions();
-        if (processed == 0) {
-            std::this_thread::sleep_for(milliseconds(5));
-        }
+        idle.idle(processed, [&](int timeout_ms) { server.wait_subscriptions(timeout_ms); });
     }
 
     std::cout << "[订阅线程] 停止\n";
@@ -389,6 +414,9 @@ int main(int argc, char* argv[]) {
     if (const char* v = std::getenv("REDIS_ENABLED")) {
         redis_config.enabled = (std::string(v) == "1" || std::string(v) == "true");
     }
+    if (const char* v = std::getenv("REDIS_QUEUE_CAPACITY")) redis_config.queue_capacity = std::stoul(v);
+    if (const char* v = std::getenv("REDIS_FLUSH_BATCH")) redis_config.flush_batch_size = std::stoul(v);
+    if (const char* v = std::getenv("REDIS_FLUSH_INTERVAL_MS")) redis_config.flush_interval_ms = std::stoi(v);
 
     g_redis_recorder->set_config(redis_config);
 
@@ -559,6 +587,37 @@ int main(int argc, char* argv[]) {
     std::cout << "  - 查询: " << IpcAddresses::QUERY << "\n";
     std::cout << "  - 订阅: " << IpcAddresses::SUBSCRIBE << "\n";
 
+    // 前端行情目标：复用 ZMQ 已序列化的 JSON（前端服务器稍后启动，调用时再检查）
+    zmq_server.set_frontend_sink([](const std::string& event_type, std::string_view json) {
+        if (g_frontend_server) {
+            g_frontend_server->send_event_raw(event_type, json);
+        }
+    });
+
+    // 行情二进制编码（按频道启用，逗号分隔，如 "trade,kline,orderbook"）
+    // 策略端自动识别二进制帧，未列出的频道继续使用 JSON
+    if (const char* v = std::getenv("ZMQ_MD_BINARY_CHANNELS")) {
+        std::stringstream ss(v);
+        std::string channel;
+        while (std::getline(ss, channel, ',')) {
+            if (!channel.empty()) {
+                zmq_server.set_market_encoding(channel, wire::WireEncoding::BINARY);
+            }
+        }
+    }
+
+    // 共享内存通道（同机策略低延迟），策略端同样设置 SEQ_SHM_TRANSPORT=1
+    if (const char* v = std::getenv("SEQ_SHM_TRANSPORT")) {
+        if (std::string(v) == "1" && !zmq_server.enable_shm_transport()) {
+            std::cerr << "[警告] 共享内存通道启用失败，继续使用 ipc 通道\n";
+        }
+    }
+
+    // 本地订单簿发布档位数（增量深度频道，0 = 发布完整订单簿）
+    if (const char* v = std::getenv("SEQ_BOOK_PUBLISH_DEPTH")) {
+        g_order_book_manager.set_publish_depth(static_cast<size_t>(std::max(0, std::atoi(v))));
+    }
+
     // ========================================
     // 初始化 OKX WebSocket (只订阅公共行情)
     // ========================================
@@ -633,6 +692,30 @@ int main(int argc, char* argv[]) {
     g_ws_public->set_auto_reconnect(true);
 
     // 设置 OKX Ticker 回调（必须在 g_ws_public 初始化后设置）
+    // 类型化快速路径：直接从原始报文提取字段，不构建 JSON DOM
+    g_ws_public->set_ticker_push_callback([&zmq_server](const core::TickerPush& t) {
+        g_okx_ticker_count++;
+
+        // 去掉 -SWAP 后缀
+        std::string_view symbol = t.symbol;
+        constexpr std::string_view suffix = "-SWAP";
+        if (symbol.size() > suffix.size() &&
+            symbol.compare(symbol.size() - suffix.size(), suffix.size(), suffix) == 0) {
+            symbol.remove_suffix(suffix.size());
+        }
+
+        nlohmann::json msg = {
+            {"type", "ticker"},
+            {"exchange", "okx"},
+            {"symbol", std::string(symbol)},
+            {"timestamp_ns", current_timestamp_ns()},
+            {"price", t.last},
+            {"timestamp", t.timestamp}
+        };
+        zmq_server.publish_market_fanout(msg, MessageType::TICKER, SINK_ALL);
+    });
+
+    // 通用路径（快速解析失败时回退）
     g_ws_public->set_ticker_callback([&zmq_server](const nlohmann::json& raw) {
         g_okx_ticker_count++;
 
@@ -670,14 +753,8 @@ int main(int argc, char* argv[]) {
             }
         }
 
-        // 发布到 ZMQ
-        zmq_server.publish_okx_market(msg, MessageType::TICKER);
-        zmq_server.publish_ticker(msg);
-
-        // 发送到前端
-        if (g_frontend_server) {
-            g_frontend_server->send_event("ticker", msg);
-        }
+        // 序列化一次，发布到 ZMQ（OKX 专用 + 统一通道）和前端
+        zmq_server.publish_market_fanout(msg, MessageType::TICKER, SINK_ALL);
     });
 
     if (!g_ws_public->connect()) {
@@ -1005,6 +1082,24 @@ int main(int argc, char* argv[]) {
     // ========================================
     // 启动工作线程
     // ========================================
+    // 订单网关：交易所 REST 调用按账户分派到工作线程（SEQ_ORDER_WORKERS=0 为同步执行）
+    size_t gateway_workers = 4;
+    if (const char* v = std::getenv("SEQ_ORDER_WORKERS")) {
+        gateway_workers = static_cast<size_t>(std::max(0, std::atoi(v)));
+    }
+    g_order_gateway.start(gateway_workers);
+
+    // 账户注册后预热的 REST 长连接数（SEQ_HTTP_WARMUP=0 关闭预热）
+    if (const char* v = std::getenv("SEQ_HTTP_WARMUP")) {
+        g_http_warmup_connections = std::max(0, std::atoi(v));
+    }
+
+    // 账户默认订单通道（SEQ_ORDER_ROUTE=ws 走交易所 WebSocket，REST 兜底）
+    if (const char* v = std::getenv("SEQ_ORDER_ROUTE")) {
+        g_default_order_route = v;
+    }
+    init_ws_order_routing(zmq_server);
+
     std::thread order_worker(order_thread, std::ref(zmq_server));
     std::thread query_worker(query_thread, std::ref(zmq_server));
     std::thread sub_worker(subscription_thread, std::ref(zmq_server));
@@ -1025,6 +1120,9 @@ int main(int argc, char* argv[]) {
         status_counter++;
         heartbeat_check_counter++;
 
+        // WebSocket 订单通道：超时未响应的请求回报 timeout
+        g_ws_order_router.expire_pending(5000);
+
         // 每10秒检查一次策略心跳
         if (heartbeat_check_counter >= 100) {
             heartbeat_check_counter = 0;
@@ -1042,6 +1140,51 @@ int main(int argc, char* argv[]) {
                << " | 查询:" << g_query_count
                << " | 账户:" << get_registered_strategy_count()
                << " | 策略(运行):" << g_strategy_manager.running_count();
+            auto gw = g_order_gateway.get_stats();
+            if (gw.submitted > 0) {
+                ss << " | 网关[排队:" << gw.pending << " 峰值:" << gw.max_queue_depth
+                   << " 账户:" << gw.accounts << "]";
+            }
+            if (g_order_dispatch_latency.count() > 0) {
+                ss << " | 订单延迟[" << g_order_dispatch_latency.summary() << "]";
+            }
+            auto ws = g_ws_order_router.get_stats();
+            if (ws.sessions > 0) {
+                ss << " | WS订单[会话:" << ws.active_sessions << "/" << ws.sessions
+                   << " 发送:" << ws.sent << " 回退REST:" << ws.fallbacks
+                   << " 超时:" << ws.timeouts;
+                if (g_ws_order_router.round_trip().count() > 0) {
+                    ss << " " << g_ws_order_router.round_trip().summary();
+                }
+                ss << "]";
+            }
+            auto http = core::HttpConnectionPool::global_stats();
+            if (http.requests > 0) {
+                ss << " | REST连接池[请求:" << http.requests
+                   << " 连接复用:" << static_cast<int>(http.conn_reuse_rate() * 100) << "%"
+                   << " 新建:" << http.conn_new
+                   << " 平均:" << static_cast<int>(http.avg_time_us() / 1000) << "ms]";
+            }
+            if (g_redis_recorder && g_redis_recorder->is_running()) {
+                auto rs = g_redis_recorder->get_writer_stats();
+                ss << " | Redis[队列:" << rs.queue_depth << "/" << rs.queue_capacity
+                   << " 峰值:" << rs.max_queue_depth << " 丢弃:" << rs.dropped;
+                if (rs.flushes > 0) {
+                    ss << " 批均:" << rs.flushed_records / rs.flushes
+                       << " 刷写p99:" << LatencyHistogram::format_ns(
+                              g_redis_recorder->flush_latency().percentile(0.99));
+                }
+                ss << "]";
+            }
+            auto push = core::get_push_parse_stats();
+            if (push.fast + push.fallback > 0) {
+                ss << " | 推送解析[快速:" << push.fast << " 回退:" << push.fallback << "]";
+            }
+            auto books = g_order_book_manager.stats();
+            if (books.published > 0) {
+                ss << " | 订单簿[发布:" << books.published << " OKX重订阅:" << books.okx_resyncs
+                   << " Binance快照:" << books.binance_resyncs << "]";
+            }
             Logger::instance().info("market", ss.str());
         }
     }
@@ -1105,6 +1248,8 @@ int main(int argc, char* argv[]) {
 
     std::cout << "[Server] 等待工作线程退出...\n";
     if (order_worker.joinable()) order_worker.join();
+    g_order_gateway.stop();  // 执行完已排队的订单请求
+    g_ws_order_router.stop();
     std::cout << "[Server] 订单线程已退出\n";
     if (query_worker.joinable()) query_worker.join();
     std::cout << "[Server] 查询线程已退出\n";
@@ -26,6 +26,8 @@
 
 #include <zmq.hpp>
 #include <nlohmann/json.hpp>
+
+#include "../../network/shm_ring.h"
 #include <unistd.h>  // getpid()
 #include <fstream>   // 读取 /proc/self/cmdline
 
@@ -131,6 +133,13 @@ public:
         order_push_ = order_push;
         report_sub_ = report_sub;
     }
+
+    /**
+     * @brief 设置共享内存订单队列（可选，nullptr 表示只用 ZMQ）
+     */
+    void set_shm_order_queue(trading::server::ShmMpscQueue* queue) {
+        shm_order_ = queue;
+    }
     
     /**
      * @brief 设置日志回调
@@ -141,6 +150,16 @@ public:
     
     // ==================== 账户注册/注销 ====================
 
+    /**
+     * @brief 设置订单通道（在注册账户前调用）
+     * @param route "ws"：经交易所 WebSocket 下单/撤单/改单（REST 兜底）；"rest"；空表示使用服务器默认
+     */
+    void set_order_route(const std::string& route) {
+        order_route_ = route;
+    }
+
+    const std::string& get_order_route() const { return order_route_; }
+
     /**
      * @brief 注册 OKX 账户
      */
@@ -172,10 +191,13 @@ public:
             {"work_dir", get_process_cwd()},
             {"timestamp", current_timestamp_ms()}
         };
+        if (!order_route_.empty()) {
+            request["order_route"] = order_route_;
+        }
 
         try {
             std::string msg = request.dump();
-            order_push_->send(zmq::buffer(msg), zmq::send_flags::none);
+            push_order(msg);
             log_info("已发送 OKX 账户注册请求");
             return true;
         } catch (const std::exception& e) {
@@ -217,10 +239,13 @@ public:
             {"work_dir", get_process_cwd()},
             {"timestamp", current_timestamp_ms()}
         };
+        if (!order_route_.empty()) {
+            request["order_route"] = order_route_;
+        }
 
         try {
             std::string msg = request.dump();
-            order_push_->send(zmq::buffer(msg), zmq::send_flags::none);
+            push_order(msg);
             log_info("已发送 Binance 账户注册请求");
             return true;
         } catch (const std::exception& e) {
@@ -247,7 +272,7 @@ public:
 
         try {
             std::string msg = request.dump();
-            order_push_->send(zmq::buffer(msg), zmq::send_flags::none);
+            push_order(msg);
             account_registered_ = false;
             log_info("已发送账户注销请求");
             return true;
@@ -272,7 +297,7 @@ public:
 
         try {
             std::string msg = request.dump();
-            order_push_->send(zmq::buffer(msg), zmq::send_flags::none);
+            push_order(msg);
             return true;
         } catch (const std::exception&) {
             return false;
@@ -294,7 +319,7 @@ public:
         
         try {
             std::string msg = request.dump();
-            order_push_->send(zmq::buffer(msg), zmq::send_flags::none);
+            push_order(msg);
             return true;
         } catch (const std::exception&) {
             return false;
@@ -736,6 +761,28 @@ private:
         }
     }
 
+    /**
+     * @brief 发送订单通道消息（共享内存优先，失败后回退 ZMQ）
+     *
+     * 一旦回退（服务端心跳超时、队列满、消息过大或槽位被跳过），之后一律走 ZMQ：
+     * 同一策略的订单只走一条通道，服务端按队列排空后再读 ZMQ 的顺序处理，不会乱序
+     */
+    void push_order(const std::string& msg) {
+        if (shm_order_) {
+            if (!shm_order_->consumer_alive()) {
+                std::cerr << "[Account] 共享内存订单队列心跳超时，回退到 ZMQ" << std::endl;
+                shm_order_->disable_push();
+                shm_order_ = nullptr;
+            } else if (shm_order_->try_push(msg.data(), msg.size())) {
+                return;
+            } else {
+                std::cerr << "[Account] 共享内存订单队列写入失败（队列满/消息过大/槽位超时），回退到 ZMQ" << std::endl;
+                shm_order_ = nullptr;
+            }
+        }
+        order_push_->send(zmq::buffer(msg), zmq::send_flags::none);
+    }
+
 private:
     std::string strategy_id_;
 
@@ -744,6 +791,7 @@ private:
     std::string secret_key_;
     std::string passphrase_;
     std::string exchange_ = "okx";  // "okx" or "binance"
+    std::string order_route_;        // 订单通道："ws" / "rest"，空表示服务器默认
     bool is_testnet_ = true;
     
     // 状态
@@ -752,6 +800,7 @@ private:
     // ZMQ sockets
     zmq::socket_t* order_push_ = nullptr;
     zmq::socket_t* report_sub_ = nullptr;
+    trading::server::ShmMpscQueue* shm_order_ = nullptr;  // 共享内存订单队列（可选）
     
     // 账户数据
     AccountSummary account_summary_;
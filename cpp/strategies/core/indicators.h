@@ -0,0 +1,510 @@
+/**
+ * @file indicators.h
+ * @brief 技术指标库 - 批量计算与流式增量更新
+ *
+ * 两种模式：
+ * 1. 批量：对整段序列计算，输入为连续 double 数组（可直接传 KlineBuffer 视图），
+ *    输出与输入等长，预热期为 NaN；内层循环无分支/无分配，便于编译器向量化
+ * 2. 流式：每根 K 线 O(1) 更新，同一时间戳的重复推送（未完结 K 线）按修正处理，
+ *    由 IndicatorEngine 按 (symbol, interval) 维护状态
+ *
+ * 支持的指标：sma / ema / std / zscore / volatility / rsi / atr
+ * - std: 滚动样本标准差（ddof=1）
+ * - volatility: 对数收益率的滚动样本标准差（需要 period+1 根 K 线）
+ * - rsi / atr: Wilder 平滑，首值为前 period 个样本的简单平均
+ *
+ * @author Sequence Team
+ * @date 2026-01
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace trading {
+namespace indicators {
+
+constexpr double NaN = std::numeric_limits<double>::quiet_NaN();
+
+enum class IndicatorType {
+    SMA,
+    EMA,
+    STD,
+    ZSCORE,
+    VOLATILITY,
+    RSI,
+    ATR
+};
+
+/**
+ * @brief 指标名（"ema"、"rsi" 等，小写）转类型
+ */
+inline bool parse_indicator_type(const std::string& name, IndicatorType& type) {
+    static const std::map<std::string, IndicatorType> names = {
+        {"sma", IndicatorType::SMA},
+        {"ema", IndicatorType::EMA},
+        {"std", IndicatorType::STD},
+        {"zscore", IndicatorType::ZSCORE},
+        {"volatility", IndicatorType::VOLATILITY},
+        {"rsi", IndicatorType::RSI},
+        {"atr", IndicatorType::ATR}
+    };
+    auto it = names.find(name);
+    if (it == names.end()) return false;
+    type = it->second;
+    return true;
+}
+
+// ============================================================
+// 批量计算
+// ============================================================
+
+inline void fill_nan(double* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) out[i] = NaN;
+}
+
+inline void sma(const double* x, size_t n, size_t period, double* out) {
+    fill_nan(out, n);
+    if (period == 0 || n < period) return;
+    double sum = 0.0;
+    for (size_t i = 0; i < period; ++i) sum += x[i];
+    const double inv = 1.0 / static_cast<double>(period);
+    out[period - 1] = sum * inv;
+    for (size_t i = period; i < n; ++i) {
+        sum += x[i] - x[i - period];
+        out[i] = sum * inv;
+    }
+}
+
+inline void ema(const double* x, size_t n, size_t period, double* out) {
+    fill_nan(out, n);
+    if (period == 0 || n < period) return;
+    double value = 0.0;
+    for (size_t i = 0; i < period; ++i) value += x[i];
+    value /= static_cast<double>(period);
+    out[period - 1] = value;
+    const double alpha = 2.0 / (static_cast<double>(period) + 1.0);
+    for (size_t i = period; i < n; ++i) {
+        value += alpha * (x[i] - value);
+        out[i] = value;
+    }
+}
+
+/**
+ * @brief 滚动均值与样本标准差（以窗口首值为偏移量累加，减小大数相消误差）
+ */
+inline void rolling_mean_std(const double* x, size_t n, size_t period,
+                             double* mean_out, double* std_out) {
+    fill_nan(mean_out, n);
+    fill_nan(std_out, n);
+    if (period < 2 || n < period) return;
+    const double shift = x[0];
+    double s1 = 0.0, s2 = 0.0;
+    for (size_t i = 0; i < period; ++i) {
+        const double d = x[i] - shift;
+        s1 += d;
+        s2 += d * d;
+    }
+    const double p = static_cast<double>(period);
+    for (size_t i = period - 1; i < n; ++i) {
+        if (i >= period) {
+            const double add = x[i] - shift;
+            const double sub = x[i - period] - shift;
+            s1 += add - sub;
+            s2 += add * add - sub * sub;
+        }
+        const double var = (s2 - s1 * s1 / p) / (p - 1.0);
+        mean_out[i] = shift + s1 / p;
+        std_out[i] = var > 0.0 ? std::sqrt(var) : 0.0;
+    }
+}
+
+inline void rolling_std(const double* x, size_t n, size_t period, double* out) {
+    std::vector<double> mean(n);
+    rolling_mean_std(x, n, period, mean.data(), out);
+}
+
+inline void zscore(const double* x, size_t n, size_t period, double* out) {
+    std::vector<double> mean(n), stdev(n);
+    rolling_mean_std(x, n, period, mean.data(), stdev.data());
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = stdev[i] > 0.0 ? (x[i] - mean[i]) / stdev[i] : NaN;
+    }
+}
+
+inline void volatility(const double* close, size_t n, size_t period, double* out) {
+    fill_nan(out, n);
+    if (n < 2) return;
+    std::vector<double> returns(n - 1);
+    for (size_t i = 1; i < n; ++i) {
+        returns[i - 1] = std::log(close[i] / close[i - 1]);
+    }
+    rolling_std(returns.data(), n - 1, period, out + 1);
+}
+
+inline double rsi_from(double avg_gain, double avg_loss) {
+    if (avg_loss == 0.0) return avg_gain == 0.0 ? 50.0 : 100.0;
+    return 100.0 - 100.0 / (1.0 + avg_gain / avg_loss);
+}
+
+inline void rsi(const double* x, size_t n, size_t period, double* out) {
+    fill_nan(out, n);
+    if (period == 0 || n <= period) return;
+    double gain = 0.0, loss = 0.0;
+    for (size_t i = 1; i <= period; ++i) {
+        const double d = x[i] - x[i - 1];
+        gain += d > 0.0 ? d : 0.0;
+        loss += d < 0.0 ? -d : 0.0;
+    }
+    const double p = static_cast<double>(period);
+    gain /= p;
+    loss /= p;
+    out[period] = rsi_from(gain, loss);
+    for (size_t i = period + 1; i < n; ++i) {
+        const double d = x[i] - x[i - 1];
+        gain = (gain * (p - 1.0) + (d > 0.0 ? d : 0.0)) / p;
+        loss = (loss * (p - 1.0) + (d < 0.0 ? -d : 0.0)) / p;
+        out[i] = rsi_from(gain, loss);
+    }
+}
+
+inline double true_range(double high, double low, double prev_close) {
+    return std::fmax(high - low, std::fmax(std::fabs(high - prev_close), std::fabs(low - prev_close)));
+}
+
+inline void atr(const double* high, const double* low, const double* close,
+                size_t n, size_t period, double* out) {
+    fill_nan(out, n);
+    if (period == 0 || n < period) return;
+    double value = high[0] - low[0];
+    for (size_t i = 1; i < period; ++i) {
+        value += true_range(high[i], low[i], close[i - 1]);
+    }
+    const double p = static_cast<double>(period);
+    value /= p;
+    out[period - 1] = value;
+    for (size_t i = period; i < n; ++i) {
+        value = (value * (p - 1.0) + true_range(high[i], low[i], close[i - 1])) / p;
+        out[i] = value;
+    }
+}
+
+// ============================================================
+// 流式计算
+// ============================================================
+
+/**
+ * @brief 流式指标输入（一根 K 线）
+ */
+struct BarInput {
+    double high = 0.0;
+    double low = 0.0;
+    double close = 0.0;
+};
+
+/**
+ * @brief 流式指标
+ *
+ * update() 追加一根新 K 线；revise() 用新值替换最近一根（同一时间戳的重复推送），
+ * 两者都是 O(1)
+ */
+class StreamingIndicator {
+public:
+    virtual ~StreamingIndicator() = default;
+    virtual void update(const BarInput& bar) = 0;
+    virtual void revise(const BarInput& bar) = 0;
+    virtual double value() const = 0;
+};
+
+/**
+ * @brief 基于小状态 + 纯函数 step 的指标：revise 从上一根的状态重新 step
+ */
+template <typename State>
+class SteppedIndicator : public StreamingIndicator {
+public:
+    explicit SteppedIndicator(size_t period) { base_.period = period; current_ = base_; }
+
+    void update(const BarInput& bar) override {
+        base_ = current_;
+        current_ = base_;
+        current_.step(bar);
+    }
+
+    void revise(const BarInput& bar) override {
+        current_ = base_;
+        current_.step(bar);
+    }
+
+    double value() const override { return current_.value; }
+
+private:
+    State base_;      // 最近一根之前的状态
+    State current_;   // 包含最近一根
+};
+
+struct EmaState {
+    size_t period = 0;
+    size_t count = 0;
+    double sum = 0.0;
+    double value = NaN;
+
+    void step(const BarInput& bar) {
+        ++count;
+        if (count < period) {
+            sum += bar.close;
+        } else if (count == period) {
+            value = (sum + bar.close) / static_cast<double>(period);
+        } else {
+            value += 2.0 / (static_cast<double>(period) + 1.0) * (bar.close - value);
+        }
+    }
+};
+
+struct RsiState {
+    size_t period = 0;
+    size_t count = 0;        // 已处理的 K 线数
+    double prev_close = 0.0;
+    double gain = 0.0;
+    double loss = 0.0;
+    double value = NaN;
+
+    void step(const BarInput& bar) {
+        if (count++ > 0) {
+            const double d = bar.close - prev_close;
+            const double g = d > 0.0 ? d : 0.0;
+            const double l = d < 0.0 ? -d : 0.0;
+            const double p = static_cast<double>(period);
+            if (count <= period + 1) {
+                gain += g / p;
+                loss += l / p;
+            } else {
+                gain = (gain * (p - 1.0) + g) / p;
+                loss = (loss * (p - 1.0) + l) / p;
+            }
+            if (count > period) value = rsi_from(gain, loss);
+        }
+        prev_close = bar.close;
+    }
+};
+
+struct AtrState {
+    size_t period = 0;
+    size_t count = 0;
+    double prev_close = 0.0;
+    double sum = 0.0;
+    double value = NaN;
+
+    void step(const BarInput& bar) {
+        const double tr = count == 0 ? bar.high - bar.low : true_range(bar.high, bar.low, prev_close);
+        const double p = static_cast<double>(period);
+        ++count;
+        if (count < period) {
+            sum += tr;
+        } else if (count == period) {
+            value = (sum + tr) / p;
+        } else {
+            value = (value * (p - 1.0) + tr) / p;
+        }
+        prev_close = bar.close;
+    }
+};
+
+/**
+ * @brief 固定窗口的滚动和（push / replace_last 均为 O(1)）
+ */
+class RollingWindow {
+public:
+    explicit RollingWindow(size_t period) : values_(period > 0 ? period : 1) {}
+
+    void push(double x) {
+        if (count_ == 0) shift_ = x;
+        if (count_ == values_.size()) remove(values_[pos_]);
+        else ++count_;
+        values_[pos_] = x;
+        add(x);
+        last_ = pos_;
+        pos_ = (pos_ + 1) % values_.size();
+    }
+
+    void replace_last(double x) {
+        if (count_ == 0) return push(x);
+        remove(values_[last_]);
+        values_[last_] = x;
+        add(x);
+    }
+
+    bool full() const { return count_ == values_.size(); }
+    double last() const { return values_[last_]; }
+    double mean() const { return shift_ + s1_ / static_cast<double>(count_); }
+
+    double stdev() const {
+        const double p = static_cast<double>(count_);
+        if (count_ < 2) return NaN;
+        const double var = (s2_ - s1_ * s1_ / p) / (p - 1.0);
+        return var > 0.0 ? std::sqrt(var) : 0.0;
+    }
+
+private:
+    void add(double x) { const double d = x - shift_; s1_ += d; s2_ += d * d; }
+    void remove(double x) { const double d = x - shift_; s1_ -= d; s2_ -= d * d; }
+
+    std::vector<double> values_;
+    size_t count_ = 0;
+    size_t pos_ = 0;
+    size_t last_ = 0;
+    double shift_ = 0.0;
+    double s1_ = 0.0;
+    double s2_ = 0.0;
+};
+
+class RollingIndicator : public StreamingIndicator {
+public:
+    RollingIndicator(IndicatorType type, size_t period) : type_(type), window_(period) {}
+
+    void update(const BarInput& bar) override {
+        if (type_ == IndicatorType::VOLATILITY) {
+            prev_close_ = last_close_;
+            last_close_ = bar.close;
+            if (++bars_ > 1) window_.push(std::log(bar.close / prev_close_));
+        } else {
+            window_.push(bar.close);
+        }
+    }
+
+    void revise(const BarInput& bar) override {
+        if (type_ == IndicatorType::VOLATILITY) {
+            last_close_ = bar.close;
+            if (bars_ > 1) window_.replace_last(std::log(bar.close / prev_close_));
+        } else {
+            window_.replace_last(bar.close);
+        }
+    }
+
+    double value() const override {
+        if (!window_.full()) return NaN;
+        switch (type_) {
+            case IndicatorType::SMA:
+                return window_.mean();
+            case IndicatorType::ZSCORE: {
+                const double sd = window_.stdev();
+                return sd > 0.0 ? (window_.last() - window_.mean()) / sd : NaN;
+            }
+            default:
+                return window_.stdev();
+        }
+    }
+
+private:
+    IndicatorType type_;
+    RollingWindow window_;
+    size_t bars_ = 0;
+    double prev_close_ = 0.0;
+    double last_close_ = 0.0;
+};
+
+inline std::unique_ptr<StreamingIndicator> make_streaming(IndicatorType type, size_t period) {
+    switch (type) {
+        case IndicatorType::EMA: return std::make_unique<SteppedIndicator<EmaState>>(period);
+        case IndicatorType::RSI: return std::make_unique<SteppedIndicator<RsiState>>(period);
+        case IndicatorType::ATR: return std::make_unique<SteppedIndicator<AtrState>>(period);
+        default: return std::make_unique<RollingIndicator>(type, period);
+    }
+}
+
+// ============================================================
+// 流式指标引擎（按 symbol/interval 维护状态）
+// ============================================================
+
+class IndicatorEngine {
+public:
+    /**
+     * @brief 注册流式指标，用已有 K 线预热；重复注册返回 true 且不重置
+     */
+    template <typename Bar>
+    bool add(const std::string& symbol, const std::string& interval,
+             IndicatorType type, size_t period, const std::vector<Bar>& history) {
+        if (period == 0) return false;
+        std::lock_guard<std::mutex> lock(mutex_);
+        Series& series = series_[series_key(symbol, interval)];
+        auto key = std::make_pair(type, period);
+        if (series.indicators.count(key)) return true;
+
+        auto indicator = make_streaming(type, period);
+        int64_t last_ts = std::numeric_limits<int64_t>::min();
+        for (const auto& bar : history) {
+            feed(*indicator, last_ts, bar.timestamp, {bar.high, bar.low, bar.close});
+        }
+        // 历史与实时推送的最后一根对齐（通常相同）
+        if (series.indicators.empty()) series.last_ts = last_ts;
+        series.indicators.emplace(key, std::move(indicator));
+        return true;
+    }
+
+    bool remove(const std::string& symbol, const std::string& interval,
+                IndicatorType type, size_t period) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = series_.find(series_key(symbol, interval));
+        if (it == series_.end()) return false;
+        return it->second.indicators.erase(std::make_pair(type, period)) > 0;
+    }
+
+    /**
+     * @brief 推送一根 K 线（新时间戳追加，同一时间戳修正）
+     */
+    void on_bar(const std::string& symbol, const std::string& interval,
+                int64_t timestamp, double high, double low, double close) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (series_.empty()) return;
+        auto it = series_.find(series_key(symbol, interval));
+        if (it == series_.end()) return;
+        Series& series = it->second;
+        const bool revise = timestamp == series.last_ts;
+        series.last_ts = timestamp;
+        const BarInput bar{high, low, close};
+        for (auto& entry : series.indicators) {
+            if (revise) entry.second->revise(bar);
+            else entry.second->update(bar);
+        }
+    }
+
+    /**
+     * @brief 当前值，未注册或预热中返回 NaN
+     */
+    double value(const std::string& symbol, const std::string& interval,
+                 IndicatorType type, size_t period) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = series_.find(series_key(symbol, interval));
+        if (it == series_.end()) return NaN;
+        auto ind = it->second.indicators.find(std::make_pair(type, period));
+        return ind == it->second.indicators.end() ? NaN : ind->second->value();
+    }
+
+private:
+    struct Series {
+        int64_t last_ts = std::numeric_limits<int64_t>::min();
+        std::map<std::pair<IndicatorType, size_t>, std::unique_ptr<StreamingIndicator>> indicators;
+    };
+
+    static std::string series_key(const std::string& symbol, const std::string& interval) {
+        return symbol + "|" + interval;
+    }
+
+    static void feed(StreamingIndicator& indicator, int64_t& last_ts, int64_t ts, const BarInput& bar) {
+        if (ts == last_ts) indicator.revise(bar);
+        else indicator.update(bar);
+        last_ts = ts;
+    }
+
+    mutable std::mutex mutex_;
+    std::map<std::string, Series> series_;
+};
+
+} // namespace indicators
+} // namespace trading
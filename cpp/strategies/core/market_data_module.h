@@ -4,7 +4,7 @@
  * 
  * 功能:
  * 1. K线数据订阅/取消订阅
- * 2. K线数据存储（环形缓冲区，支持2小时数据）
+ * 2. K线数据存储（列式缓冲区，支持2小时数据，可零拷贝暴露给 numpy）
  * 3. Trades数据订阅
  * 4. Ticker数据订阅（预留）
  * 5. OrderBook数据订阅（预留）
@@ -17,16 +17,28 @@
 
 #include <string>
 #include <vector>
+#include <algorithm>
 #include <map>
 #include <set>
 #include <memory>
 #include <mutex>
 #include <functional>
 #include <chrono>
+#include <cstring>
+#include <atomic>
+#include <string_view>
+#include <unordered_map>
 
 #include <zmq.hpp>
 #include <nlohmann/json.hpp>
 
+#include "../../core/id_interner.h"
+#include "../../core/instrument_registry.h"
+#include "../../core/seqlock.h"
+#include "../../network/market_wire_format.h"
+#include "../../network/shm_ring.h"
+#include "indicators.h"
+
 namespace trading {
 
 // ============================================================
@@ -109,166 +121,278 @@ struct FundingRateData {
 
 
 // ============================================================
-// K线缓冲区（环形缓冲区）
+// 缓冲区并发模型
+// ============================================================
+//
+// 所有缓冲区都是单写者：只有行情线程（process_market_data -> apply_*）写入。
+// 读者（策略回调、定时任务、Python 线程）不加锁：
+// - KlineBuffer 用顺序锁（SeqLock），读者拷贝后校验序号，冲突时重读
+// - Trades / OrderBook / FundingRate 用覆盖式环形缓冲区（OverwriteRing），
+//   读者拷贝后丢弃被写者覆盖的最旧部分
+// 币种 -> 缓冲区的索引使用 IdTable（无锁查找，缓冲区创建后不删除）。
+
+constexpr size_t MAX_MARKET_SYMBOLS = 2048;   // 每类缓冲区最多的交易对数（超出后不再缓存）
+constexpr size_t MAX_KLINE_INTERVALS = 64;    // 最多的 K 线周期数
+
+/**
+ * @brief 把字符串拷贝到定长字符数组（超长截断，保证以 '\0' 结尾）
+ */
+template <size_t N>
+inline void copy_fixed_text(char (&dst)[N], const std::string& src) {
+    size_t n = std::min(src.size(), N - 1);
+    std::memcpy(dst, src.data(), n);
+    dst[n] = '\0';
+}
+
+template <size_t N>
+inline std::string fixed_text(const char (&src)[N]) {
+    return std::string(src, strnlen(src, N));
+}
+
+
+// ============================================================
+// K线缓冲区（列式存储）
 // ============================================================
 
 /**
  * @brief 单个币种的 K 线缓冲区
+ *
+ * 列式（struct-of-arrays）存储：timestamp/open/high/low/close/volume 各占一列，
+ * 所有列放在同一块内存中，列间距为 capacity_。最近的 K 线在每列中始终连续，
+ * 可以直接作为 numpy 视图暴露（见 view()），不需要逐元素拷贝。
+ *
+ * 每列预留 max_bars 的 1/4 作为尾部余量：写满余量后把窗口整体搬回列首（memmove），
+ * 均摊每根 K 线约 4 次拷贝，内存只多 25%。
+ *
+ * 并发：update()/clear() 只由行情线程调用，读接口通过顺序锁无锁读取。
  */
 class KlineBuffer {
 public:
+    enum Column : size_t {
+        TIMESTAMP = 0,
+        OPEN,
+        HIGH,
+        LOW,
+        CLOSE,
+        VOLUME,
+        COLUMN_COUNT
+    };
+
+    /**
+     * @brief 最近 rows 根 K 线的列式视图
+     *
+     * data 指向 TIMESTAMP 列第一行，列 c 的起始地址为 data + c * column_stride。
+     * 视图引用缓冲区内部存储：最后一根 K 线会被原地更新，
+     * 下一次追加新 K 线后（可能触发搬移）视图内容不再有效，需要保留时请拷贝。
+     * 需要与写者一致的结果时使用 read_view()。
+     */
+    struct ColumnView {
+        const double* data = nullptr;
+        size_t rows = 0;
+        size_t column_stride = 0;   // 相邻两列的间距（元素个数）
+
+        const double* column(Column c) const { return data + c * column_stride; }
+    };
+
     explicit KlineBuffer(size_t max_bars = 7200)
-        : max_bars_(max_bars)
-        , data_(max_bars)
-        , head_(0)
-        , size_(0) {}
-    
+        : max_bars_(std::max<size_t>(max_bars, 1))
+        , capacity_(max_bars_ + std::max<size_t>(max_bars_ / 4, 64))
+        , store_(COLUMN_COUNT * capacity_) {}
+
     /**
-     * @brief 更新 K 线数据
+     * @brief 更新 K 线数据（行情线程）
      * @return true 如果追加了新 K 线, false 如果更新了现有 K 线
      */
-    bool update(int64_t timestamp, double open, double high, 
+    bool update(int64_t timestamp, double open, double high,
                 double low, double close, double volume) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        
-        if (size_ == 0) {
-            data_[0] = KlineBar(timestamp, open, high, low, close, volume);
-            size_ = 1;
-            return true;
-        }
-        
-        size_t last_idx = (head_ + size_ - 1) % max_bars_;
-        
-        if (data_[last_idx].timestamp == timestamp) {
-            data_[last_idx] = KlineBar(timestamp, open, high, low, close, volume);
+        size_t begin = begin_.load(std::memory_order_relaxed);
+        size_t size = size_.load(std::memory_order_relaxed);
+
+        if (size > 0 && store_[TIMESTAMP * capacity_ + begin + size - 1] == static_cast<double>(timestamp)) {
+            lock_.write_begin();
+            write(begin + size - 1, timestamp, open, high, low, close, volume);
+            lock_.write_end();
             return false;
-        } else {
-            if (size_ < max_bars_) {
-                size_t new_idx = (head_ + size_) % max_bars_;
-                data_[new_idx] = KlineBar(timestamp, open, high, low, close, volume);
-                size_++;
-            } else {
-                data_[head_] = KlineBar(timestamp, open, high, low, close, volume);
-                head_ = (head_ + 1) % max_bars_;
-            }
-            return true;
         }
-    }
-    
-    std::vector<KlineBar> get_all() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        std::vector<KlineBar> result;
-        result.reserve(size_);
-        for (size_t i = 0; i < size_; ++i) {
-            result.push_back(data_[(head_ + i) % max_bars_]);
+
+        lock_.write_begin();
+        if (size == max_bars_) {
+            begin++;
+            size--;
         }
-        return result;
-    }
-    
-    std::vector<double> get_closes() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        std::vector<double> result;
-        result.reserve(size_);
-        for (size_t i = 0; i < size_; ++i) {
-            result.push_back(data_[(head_ + i) % max_bars_].close);
+        if (begin + size == capacity_) {
+            // 尾部余量用完，把窗口搬回列首
+            for (size_t c = 0; c < COLUMN_COUNT; ++c) {
+                double* col = &store_[c * capacity_];
+                std::memmove(col, col + begin, size * sizeof(double));
+            }
+            begin = 0;
         }
-        return result;
+        write(begin + size, timestamp, open, high, low, close, volume);
+        size++;
+        begin_.store(begin, std::memory_order_relaxed);
+        size_.store(size, std::memory_order_relaxed);
+        lock_.write_end();
+        return true;
     }
-    
-    std::vector<double> get_opens() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        std::vector<double> result;
-        result.reserve(size_);
-        for (size_t i = 0; i < size_; ++i) {
-            result.push_back(data_[(head_ + i) % max_bars_].open);
-        }
-        return result;
+
+    std::vector<KlineBar> get_all() const {
+        return lock_.read([this] {
+            Window w = window();
+            return bars(w, 0, w.size);
+        });
     }
-    
-    std::vector<double> get_highs() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        std::vector<double> result;
-        result.reserve(size_);
-        for (size_t i = 0; i < size_; ++i) {
-            result.push_back(data_[(head_ + i) % max_bars_].high);
-        }
-        return result;
+
+    std::vector<double> get_closes() const { return get_column(CLOSE); }
+    std::vector<double> get_opens() const { return get_column(OPEN); }
+    std::vector<double> get_highs() const { return get_column(HIGH); }
+    std::vector<double> get_lows() const { return get_column(LOW); }
+    std::vector<double> get_volumes() const { return get_column(VOLUME); }
+
+    std::vector<int64_t> get_timestamps() const {
+        return lock_.read([this] {
+            Window w = window();
+            const double* col = &store_[TIMESTAMP * capacity_ + w.begin];
+            return std::vector<int64_t>(col, col + w.size);
+        });
     }
-    
-    std::vector<double> get_lows() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        std::vector<double> result;
-        result.reserve(size_);
-        for (size_t i = 0; i < size_; ++i) {
-            result.push_back(data_[(head_ + i) % max_bars_].low);
-        }
-        return result;
+
+    /**
+     * @brief 拷贝一列（整段 memcpy，无逐元素转换）
+     */
+    std::vector<double> get_column(Column c) const {
+        return lock_.read([this, c] {
+            Window w = window();
+            const double* col = &store_[c * capacity_ + w.begin];
+            return std::vector<double>(col, col + w.size);
+        });
     }
-    
-    std::vector<double> get_volumes() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        std::vector<double> result;
-        result.reserve(size_);
-        for (size_t i = 0; i < size_; ++i) {
-            result.push_back(data_[(head_ + i) % max_bars_].volume);
-        }
-        return result;
+
+    /**
+     * @brief 最近 n 根 K 线的视图（n=0 表示全部），不拷贝
+     */
+    ColumnView view(size_t n = 0) const {
+        return lock_.read([this, n] { return make_view(window(), n); });
     }
-    
-    std::vector<int64_t> get_timestamps() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        std::vector<int64_t> result;
-        result.reserve(size_);
-        for (size_t i = 0; i < size_; ++i) {
-            result.push_back(data_[(head_ + i) % max_bars_].timestamp);
-        }
-        return result;
+
+    /**
+     * @brief 在一致的视图上执行 fn（读取期间发生写入时重新执行，fn 需可重复执行）
+     */
+    template <typename Fn>
+    void read_view(size_t n, Fn&& fn) const {
+        lock_.read([&] {
+            fn(make_view(window(), n));
+            return true;
+        });
     }
-    
+
     bool get_last(KlineBar& bar) const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (size_ == 0) return false;
-        bar = data_[(head_ + size_ - 1) % max_bars_];
-        return true;
+        return get_at_from_end(0, bar);
     }
-    
+
     bool get_at(size_t index, KlineBar& bar) const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (index >= size_) return false;
-        bar = data_[(head_ + index) % max_bars_];
-        return true;
+        return lock_.read([&] {
+            Window w = window();
+            if (index >= w.size) return false;
+            bar = bar_at(w, index);
+            return true;
+        });
     }
-    
+
     std::vector<KlineBar> get_recent(size_t n) const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        n = std::min(n, size_);
-        std::vector<KlineBar> result;
-        result.reserve(n);
-        for (size_t i = size_ - n; i < size_; ++i) {
-            result.push_back(data_[(head_ + i) % max_bars_]);
-        }
-        return result;
+        return lock_.read([this, n] {
+            Window w = window();
+            size_t count = std::min(n, w.size);
+            return bars(w, w.size - count, w.size);
+        });
     }
-    
-    size_t size() const { 
-        std::lock_guard<std::mutex> lock(mutex_);
-        return size_; 
+
+    size_t size() const {
+        return lock_.read([this] { return window().size; });
     }
-    
+
     size_t max_size() const { return max_bars_; }
-    
+
+    /**
+     * @brief 清空（行情线程）
+     */
     void clear() {
-        std::lock_guard<std::mutex> lock(mutex_);
-        head_ = 0;
-        size_ = 0;
+        lock_.write_begin();
+        begin_.store(0, std::memory_order_relaxed);
+        size_.store(0, std::memory_order_relaxed);
+        lock_.write_end();
     }
 
 private:
+    struct Window {
+        size_t begin = 0;
+        size_t size = 0;
+    };
+
+    /**
+     * @brief 读取窗口位置（读者可能读到写到一半的值，越界时返回空窗口，随后由序号校验重读）
+     */
+    Window window() const {
+        Window w;
+        w.begin = begin_.load(std::memory_order_relaxed);
+        w.size = size_.load(std::memory_order_relaxed);
+        if (w.begin > capacity_ || w.size > capacity_ - w.begin) {
+            return Window();
+        }
+        return w;
+    }
+
+    ColumnView make_view(const Window& w, size_t n) const {
+        ColumnView v;
+        v.rows = (n == 0) ? w.size : std::min(n, w.size);
+        v.data = store_.data() + w.begin + (w.size - v.rows);
+        v.column_stride = capacity_;
+        return v;
+    }
+
+    bool get_at_from_end(size_t back, KlineBar& bar) const {
+        return lock_.read([&] {
+            Window w = window();
+            if (back >= w.size) return false;
+            bar = bar_at(w, w.size - 1 - back);
+            return true;
+        });
+    }
+
+    double at(const Window& w, Column c, size_t index) const {
+        return store_[c * capacity_ + w.begin + index];
+    }
+
+    KlineBar bar_at(const Window& w, size_t index) const {
+        return KlineBar(static_cast<int64_t>(at(w, TIMESTAMP, index)), at(w, OPEN, index),
+                        at(w, HIGH, index), at(w, LOW, index), at(w, CLOSE, index), at(w, VOLUME, index));
+    }
+
+    std::vector<KlineBar> bars(const Window& w, size_t from, size_t to) const {
+        std::vector<KlineBar> result;
+        result.reserve(to - from);
+        for (size_t i = from; i < to; ++i) {
+            result.push_back(bar_at(w, i));
+        }
+        return result;
+    }
+
+    void write(size_t pos, int64_t timestamp, double open, double high,
+               double low, double close, double volume) {
+        store_[TIMESTAMP * capacity_ + pos] = static_cast<double>(timestamp);  // 毫秒时间戳在 2^53 内精确
+        store_[OPEN * capacity_ + pos] = open;
+        store_[HIGH * capacity_ + pos] = high;
+        store_[LOW * capacity_ + pos] = low;
+        store_[CLOSE * capacity_ + pos] = close;
+        store_[VOLUME * capacity_ + pos] = volume;
+    }
+
     size_t max_bars_;
-    std::vector<KlineBar> data_;
-    size_t head_;
-    size_t size_;
-    mutable std::mutex mutex_;
+    size_t capacity_;               // 每列容量（max_bars_ + 余量）
+    std::vector<double> store_;     // COLUMN_COUNT 列，列 c 位于 [c * capacity_, (c + 1) * capacity_)
+    std::atomic<size_t> begin_{0};  // 窗口起点（每列相同）
+    std::atomic<size_t> size_{0};
+    SeqLock lock_;
 };
 
 // ============================================================
@@ -277,94 +401,80 @@ private:
 
 /**
  * @brief 单个币种的 Trades 缓冲区
+ *
+ * 槽位为定长结构（trade_id 超过 31 字符时截断），读取时转换为 TradeData
  */
 class TradeBuffer {
 public:
     explicit TradeBuffer(size_t max_trades = 10000)
-        : max_trades_(max_trades)
-        , data_(max_trades)
-        , head_(0)
-        , size_(0) {}
-    
+        : ring_(max_trades) {}
+
     /**
-     * @brief 添加新的成交数据
+     * @brief 添加新的成交数据（行情线程）
      */
     void add(int64_t timestamp, const std::string& trade_id,
              double price, double quantity, const std::string& side) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        
-        if (size_ < max_trades_) {
-            size_t new_idx = (head_ + size_) % max_trades_;
-            data_[new_idx] = TradeData(timestamp, trade_id, price, quantity, side);
-            size_++;
-        } else {
-            data_[head_] = TradeData(timestamp, trade_id, price, quantity, side);
-            head_ = (head_ + 1) % max_trades_;
-        }
+        Slot slot;
+        slot.timestamp = timestamp;
+        slot.price = price;
+        slot.quantity = quantity;
+        copy_fixed_text(slot.trade_id, trade_id);
+        copy_fixed_text(slot.side, side);
+        ring_.push(slot);
     }
-    
+
     std::vector<TradeData> get_all() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        std::vector<TradeData> result;
-        result.reserve(size_);
-        for (size_t i = 0; i < size_; ++i) {
-            result.push_back(data_[(head_ + i) % max_trades_]);
-        }
-        return result;
+        return get_recent(ring_.capacity());
     }
-    
+
     /**
      * @brief 获取最近 N 条成交
      */
     std::vector<TradeData> get_recent(size_t n) const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        n = std::min(n, size_);
+        std::vector<Slot> slots;
+        ring_.copy_recent(n, slots);
         std::vector<TradeData> result;
-        result.reserve(n);
-        for (size_t i = size_ - n; i < size_; ++i) {
-            result.push_back(data_[(head_ + i) % max_trades_]);
+        result.reserve(slots.size());
+        for (const auto& slot : slots) {
+            result.push_back(to_trade(slot));
         }
         return result;
     }
-    
+
     /**
      * @brief 获取最近 N 毫秒内的成交
      */
     std::vector<TradeData> get_recent_by_time(int64_t time_ms) const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (size_ == 0) return {};
-        
+        std::vector<Slot> slots;
+        ring_.copy_recent(ring_.capacity(), slots);
+
         int64_t now = current_timestamp_ms();
         int64_t cutoff = now - time_ms;
-        
+
         std::vector<TradeData> result;
-        for (size_t i = 0; i < size_; ++i) {
-            size_t idx = (head_ + i) % max_trades_;
-            if (data_[idx].timestamp >= cutoff) {
-                result.push_back(data_[idx]);
+        for (const auto& slot : slots) {
+            if (slot.timestamp >= cutoff) {
+                result.push_back(to_trade(slot));
             }
         }
         return result;
     }
-    
+
     bool get_last(TradeData& trade) const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (size_ == 0) return false;
-        trade = data_[(head_ + size_ - 1) % max_trades_];
+        Slot slot;
+        if (!ring_.copy_last(slot)) return false;
+        trade = to_trade(slot);
         return true;
     }
-    
+
     size_t size() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return size_;
+        return ring_.size();
     }
-    
+
     void clear() {
-        std::lock_guard<std::mutex> lock(mutex_);
-        head_ = 0;
-        size_ = 0;
+        ring_.clear();
     }
-    
+
     static int64_t current_timestamp_ms() {
         return std::chrono::duration_cast<std::chrono::milliseconds>(
             std::chrono::system_clock::now().time_since_epoch()
@@ -372,11 +482,20 @@ public:
     }
 
 private:
-    size_t max_trades_;
-    std::vector<TradeData> data_;
-    size_t head_;
-    size_t size_;
-    mutable std::mutex mutex_;
+    struct Slot {
+        int64_t timestamp;
+        double price;
+        double quantity;
+        char trade_id[32];
+        char side[8];
+    };
+
+    static TradeData to_trade(const Slot& slot) {
+        return TradeData(slot.timestamp, fixed_text(slot.trade_id), slot.price,
+                         slot.quantity, fixed_text(slot.side));
+    }
+
+    OverwriteRing<Slot> ring_;
 };
 
 // ============================================================
@@ -385,108 +504,105 @@ private:
 
 /**
  * @brief 单个币种的 OrderBook 缓冲区
+ *
+ * 快照头（最优价、档位数）和档位分别存放在两个环中，档位环按每个快照
+ * LEVELS_PER_SNAPSHOT 档预留：深度较大时可保留的历史快照数相应减少
  */
 class OrderBookBuffer {
 public:
+    static constexpr size_t LEVELS_PER_SNAPSHOT = 50;  // 档位环预留（买卖合计）
+
     explicit OrderBookBuffer(size_t max_snapshots = 1000)
-        : max_snapshots_(max_snapshots)
-        , data_(max_snapshots)
-        , head_(0)
-        , size_(0) {}
-    
+        : headers_(max_snapshots)
+        , levels_(std::max<size_t>(max_snapshots, 1) * LEVELS_PER_SNAPSHOT) {}
+
     /**
-     * @brief 添加新的深度快照
+     * @brief 添加新的深度快照（行情线程）
      */
     void add(int64_t timestamp, const std::vector<std::pair<double, double>>& bids,
              const std::vector<std::pair<double, double>>& asks,
              double best_bid_price, double best_bid_size,
              double best_ask_price, double best_ask_size,
              double mid_price, double spread) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        
-        OrderBookSnapshot snapshot;
-        snapshot.timestamp = timestamp;
-        snapshot.bids = bids;
-        snapshot.asks = asks;
-        snapshot.best_bid_price = best_bid_price;
-        snapshot.best_bid_size = best_bid_size;
-        snapshot.best_ask_price = best_ask_price;
-        snapshot.best_ask_size = best_ask_size;
-        snapshot.mid_price = mid_price;
-        snapshot.spread = spread;
-        
-        if (size_ < max_snapshots_) {
-            size_t new_idx = (head_ + size_) % max_snapshots_;
-            data_[new_idx] = snapshot;
-            size_++;
-        } else {
-            data_[head_] = snapshot;
-            head_ = (head_ + 1) % max_snapshots_;
-        }
+        // 单个快照的档位数不超过档位环容量
+        size_t bid_count = std::min(bids.size(), levels_.capacity());
+        size_t ask_count = std::min(asks.size(), levels_.capacity() - bid_count);
+        scratch_.clear();
+        for (size_t i = 0; i < bid_count; ++i) scratch_.push_back({bids[i].first, bids[i].second});
+        for (size_t i = 0; i < ask_count; ++i) scratch_.push_back({asks[i].first, asks[i].second});
+
+        Header header;
+        header.timestamp = timestamp;
+        header.best_bid_price = best_bid_price;
+        header.best_bid_size = best_bid_size;
+        header.best_ask_price = best_ask_price;
+        header.best_ask_size = best_ask_size;
+        header.mid_price = mid_price;
+        header.spread = spread;
+        header.bid_count = static_cast<uint32_t>(bid_count);
+        header.ask_count = static_cast<uint32_t>(ask_count);
+        header.level_begin = levels_.push(scratch_.data(), scratch_.size());
+        headers_.push(header);
     }
-    
+
     std::vector<OrderBookSnapshot> get_all() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        std::vector<OrderBookSnapshot> result;
-        result.reserve(size_);
-        for (size_t i = 0; i < size_; ++i) {
-            result.push_back(data_[(head_ + i) % max_snapshots_]);
-        }
-        return result;
+        return get_recent(headers_.capacity());
     }
-    
+
     /**
      * @brief 获取最近 N 个快照
      */
     std::vector<OrderBookSnapshot> get_recent(size_t n) const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        n = std::min(n, size_);
+        std::vector<Header> headers;
+        headers_.copy_recent(n, headers);
         std::vector<OrderBookSnapshot> result;
-        result.reserve(n);
-        for (size_t i = size_ - n; i < size_; ++i) {
-            result.push_back(data_[(head_ + i) % max_snapshots_]);
+        result.reserve(headers.size());
+        for (const auto& header : headers) {
+            result.push_back(to_snapshot(header));
+        }
+        // 档位可能在拷贝期间被覆盖（按写入顺序，只会是最旧的一段）
+        uint64_t valid = levels_.valid_from();
+        size_t dropped = 0;
+        while (dropped < headers.size() && headers[dropped].level_begin < valid) {
+            dropped++;
         }
+        result.erase(result.begin(), result.begin() + dropped);
         return result;
     }
-    
+
     /**
      * @brief 获取最近 N 毫秒内的快照
      */
     std::vector<OrderBookSnapshot> get_recent_by_time(int64_t time_ms) const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (size_ == 0) return {};
-        
         int64_t now = current_timestamp_ms();
         int64_t cutoff = now - time_ms;
-        
+
         std::vector<OrderBookSnapshot> result;
-        for (size_t i = 0; i < size_; ++i) {
-            size_t idx = (head_ + i) % max_snapshots_;
-            if (data_[idx].timestamp >= cutoff) {
-                result.push_back(data_[idx]);
+        for (auto& snapshot : get_all()) {
+            if (snapshot.timestamp >= cutoff) {
+                result.push_back(std::move(snapshot));
             }
         }
         return result;
     }
-    
+
     bool get_last(OrderBookSnapshot& snapshot) const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (size_ == 0) return false;
-        snapshot = data_[(head_ + size_ - 1) % max_snapshots_];
-        return true;
+        while (true) {
+            Header header;
+            if (!headers_.copy_last(header)) return false;
+            snapshot = to_snapshot(header);
+            if (header.level_begin >= levels_.valid_from()) return true;
+        }
     }
-    
+
     size_t size() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return size_;
+        return headers_.size();
     }
-    
+
     void clear() {
-        std::lock_guard<std::mutex> lock(mutex_);
-        head_ = 0;
-        size_ = 0;
+        headers_.clear();
     }
-    
+
     static int64_t current_timestamp_ms() {
         return std::chrono::duration_cast<std::chrono::milliseconds>(
             std::chrono::system_clock::now().time_since_epoch()
@@ -494,11 +610,50 @@ public:
     }
 
 private:
-    size_t max_snapshots_;
-    std::vector<OrderBookSnapshot> data_;
-    size_t head_;
-    size_t size_;
-    mutable std::mutex mutex_;
+    struct Level {
+        double price;
+        double size;
+    };
+
+    struct Header {
+        int64_t timestamp;
+        double best_bid_price;
+        double best_bid_size;
+        double best_ask_price;
+        double best_ask_size;
+        double mid_price;
+        double spread;
+        uint32_t bid_count;
+        uint32_t ask_count;
+        uint64_t level_begin;   // 档位环中第一个买档的序号（卖档紧随其后）
+    };
+
+    OrderBookSnapshot to_snapshot(const Header& header) const {
+        OrderBookSnapshot snapshot;
+        snapshot.timestamp = header.timestamp;
+        snapshot.best_bid_price = header.best_bid_price;
+        snapshot.best_bid_size = header.best_bid_size;
+        snapshot.best_ask_price = header.best_ask_price;
+        snapshot.best_ask_size = header.best_ask_size;
+        snapshot.mid_price = header.mid_price;
+        snapshot.spread = header.spread;
+        snapshot.bids.reserve(header.bid_count);
+        snapshot.asks.reserve(header.ask_count);
+        uint64_t index = header.level_begin;
+        for (uint32_t i = 0; i < header.bid_count; ++i, ++index) {
+            Level level = levels_.at(index);
+            snapshot.bids.emplace_back(level.price, level.size);
+        }
+        for (uint32_t i = 0; i < header.ask_count; ++i, ++index) {
+            Level level = levels_.at(index);
+            snapshot.asks.emplace_back(level.price, level.size);
+        }
+        return snapshot;
+    }
+
+    OverwriteRing<Header> headers_;
+    OverwriteRing<Level> levels_;
+    std::vector<Level> scratch_;   // 写者复用的档位缓冲
 };
 
 // ============================================================
@@ -511,89 +666,82 @@ private:
 class FundingRateBuffer {
 public:
     explicit FundingRateBuffer(size_t max_records = 100)
-        : max_records_(max_records)
-        , data_(max_records)
-        , head_(0)
-        , size_(0) {}
-    
+        : ring_(max_records) {}
+
     /**
-     * @brief 添加新的资金费率数据
+     * @brief 添加新的资金费率数据（行情线程）
      */
     void add(const FundingRateData& fr) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        
-        if (size_ < max_records_) {
-            size_t new_idx = (head_ + size_) % max_records_;
-            data_[new_idx] = fr;
-            size_++;
-        } else {
-            data_[head_] = fr;
-            head_ = (head_ + 1) % max_records_;
-        }
+        Slot slot;
+        slot.timestamp = fr.timestamp;
+        slot.funding_rate = fr.funding_rate;
+        slot.next_funding_rate = fr.next_funding_rate;
+        slot.funding_time = fr.funding_time;
+        slot.next_funding_time = fr.next_funding_time;
+        slot.min_funding_rate = fr.min_funding_rate;
+        slot.max_funding_rate = fr.max_funding_rate;
+        slot.interest_rate = fr.interest_rate;
+        slot.impact_value = fr.impact_value;
+        slot.premium = fr.premium;
+        slot.sett_funding_rate = fr.sett_funding_rate;
+        copy_fixed_text(slot.method, fr.method);
+        copy_fixed_text(slot.formula_type, fr.formula_type);
+        copy_fixed_text(slot.sett_state, fr.sett_state);
+        ring_.push(slot);
     }
-    
+
     std::vector<FundingRateData> get_all() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        std::vector<FundingRateData> result;
-        result.reserve(size_);
-        for (size_t i = 0; i < size_; ++i) {
-            result.push_back(data_[(head_ + i) % max_records_]);
-        }
-        return result;
+        return get_recent(ring_.capacity());
     }
-    
+
     /**
      * @brief 获取最近 N 条记录
      */
     std::vector<FundingRateData> get_recent(size_t n) const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        n = std::min(n, size_);
+        std::vector<Slot> slots;
+        ring_.copy_recent(n, slots);
         std::vector<FundingRateData> result;
-        result.reserve(n);
-        for (size_t i = size_ - n; i < size_; ++i) {
-            result.push_back(data_[(head_ + i) % max_records_]);
+        result.reserve(slots.size());
+        for (const auto& slot : slots) {
+            result.push_back(to_funding_rate(slot));
         }
         return result;
     }
-    
+
     /**
      * @brief 获取最近 N 毫秒内的记录
      */
     std::vector<FundingRateData> get_recent_by_time(int64_t time_ms) const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (size_ == 0) return {};
-        
+        std::vector<Slot> slots;
+        ring_.copy_recent(ring_.capacity(), slots);
+
         int64_t now = current_timestamp_ms();
         int64_t cutoff = now - time_ms;
-        
+
         std::vector<FundingRateData> result;
-        for (size_t i = 0; i < size_; ++i) {
-            size_t idx = (head_ + i) % max_records_;
-            if (data_[idx].timestamp >= cutoff) {
-                result.push_back(data_[idx]);
+        for (const auto& slot : slots) {
+            if (slot.timestamp >= cutoff) {
+                result.push_back(to_funding_rate(slot));
             }
         }
         return result;
     }
-    
+
     bool get_last(FundingRateData& fr) const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (size_ == 0) return false;
-        fr = data_[(head_ + size_ - 1) % max_records_];
+        Slot slot;
+        if (!ring_.copy_last(slot)) return false;
+        fr = to_funding_rate(slot);
         return true;
     }
-    
+
     size_t size() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return size_;
+        return ring_.size();
     }
-    
+
     void clear() {
-        std::lock_guard<std::mutex> lock(mutex_);
-        head_ = 0;
-        size_ = 0;
+        ring_.clear();
     }
-    
+
     static int64_t current_timestamp_ms() {
         return std::chrono::duration_cast<std::chrono::milliseconds>(
             std::chrono::system_clock::now().time_since_epoch()
@@ -601,11 +749,43 @@ public:
     }
 
 private:
-    size_t max_records_;
-    std::vector<FundingRateData> data_;
-    size_t head_;
-    size_t size_;
-    mutable std::mutex mutex_;
+    struct Slot {
+        int64_t timestamp;
+        double funding_rate;
+        double next_funding_rate;
+        int64_t funding_time;
+        int64_t next_funding_time;
+        double min_funding_rate;
+        double max_funding_rate;
+        double interest_rate;
+        double impact_value;
+        double premium;
+        double sett_funding_rate;
+        char method[24];
+        char formula_type[24];
+        char sett_state[24];
+    };
+
+    static FundingRateData to_funding_rate(const Slot& slot) {
+        FundingRateData fr;
+        fr.timestamp = slot.timestamp;
+        fr.funding_rate = slot.funding_rate;
+        fr.next_funding_rate = slot.next_funding_rate;
+        fr.funding_time = slot.funding_time;
+        fr.next_funding_time = slot.next_funding_time;
+        fr.min_funding_rate = slot.min_funding_rate;
+        fr.max_funding_rate = slot.max_funding_rate;
+        fr.interest_rate = slot.interest_rate;
+        fr.impact_value = slot.impact_value;
+        fr.premium = slot.premium;
+        fr.sett_funding_rate = slot.sett_funding_rate;
+        fr.method = fixed_text(slot.method);
+        fr.formula_type = fixed_text(slot.formula_type);
+        fr.sett_state = fixed_text(slot.sett_state);
+        return fr;
+    }
+
+    OverwriteRing<Slot> ring_;
 };
 
 
@@ -630,99 +810,85 @@ public:
         else if (interval == "1D") interval_ms_ = 86400000;
         else interval_ms_ = 60000;
     }
-    
+
+    /**
+     * @brief 更新 K 线（行情线程），交易对数超过 MAX_MARKET_SYMBOLS 时忽略
+     */
     bool update(const std::string& symbol, int64_t timestamp,
                 double open, double high, double low, double close, double volume) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        
-        auto it = buffers_.find(symbol);
-        if (it == buffers_.end()) {
-            buffers_[symbol] = std::make_unique<KlineBuffer>(max_bars_);
-            it = buffers_.find(symbol);
-        }
-        return it->second->update(timestamp, open, high, low, close, volume);
+        KlineBuffer* buffer = buffers_.get_or_create(symbol, max_bars_);
+        if (!buffer) return false;
+        return buffer->update(timestamp, open, high, low, close, volume);
     }
-    
+
+    /**
+     * @brief 无锁查找币种缓冲区（未收到过该币种的 K 线返回 nullptr）
+     */
+    const KlineBuffer* find(const std::string& symbol) const {
+        return buffers_.find(symbol);
+    }
+
     std::vector<KlineBar> get_all(const std::string& symbol) const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = buffers_.find(symbol);
-        if (it == buffers_.end()) return {};
-        return it->second->get_all();
+        const KlineBuffer* buffer = find(symbol);
+        return buffer ? buffer->get_all() : std::vector<KlineBar>();
     }
-    
+
     std::vector<double> get_closes(const std::string& symbol) const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = buffers_.find(symbol);
-        if (it == buffers_.end()) return {};
-        return it->second->get_closes();
+        const KlineBuffer* buffer = find(symbol);
+        return buffer ? buffer->get_closes() : std::vector<double>();
     }
-    
+
     std::vector<double> get_opens(const std::string& symbol) const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = buffers_.find(symbol);
-        if (it == buffers_.end()) return {};
-        return it->second->get_opens();
+        const KlineBuffer* buffer = find(symbol);
+        return buffer ? buffer->get_opens() : std::vector<double>();
     }
-    
+
     std::vector<double> get_highs(const std::string& symbol) const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = buffers_.find(symbol);
-        if (it == buffers_.end()) return {};
-        return it->second->get_highs();
+        const KlineBuffer* buffer = find(symbol);
+        return buffer ? buffer->get_highs() : std::vector<double>();
     }
-    
+
     std::vector<double> get_lows(const std::string& symbol) const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = buffers_.find(symbol);
-        if (it == buffers_.end()) return {};
-        return it->second->get_lows();
+        const KlineBuffer* buffer = find(symbol);
+        return buffer ? buffer->get_lows() : std::vector<double>();
     }
-    
+
     std::vector<double> get_volumes(const std::string& symbol) const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = buffers_.find(symbol);
-        if (it == buffers_.end()) return {};
-        return it->second->get_volumes();
+        const KlineBuffer* buffer = find(symbol);
+        return buffer ? buffer->get_volumes() : std::vector<double>();
     }
-    
+
     std::vector<int64_t> get_timestamps(const std::string& symbol) const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = buffers_.find(symbol);
-        if (it == buffers_.end()) return {};
-        return it->second->get_timestamps();
+        const KlineBuffer* buffer = find(symbol);
+        return buffer ? buffer->get_timestamps() : std::vector<int64_t>();
     }
-    
+
     bool get_last(const std::string& symbol, KlineBar& bar) const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = buffers_.find(symbol);
-        if (it == buffers_.end()) return false;
-        return it->second->get_last(bar);
+        const KlineBuffer* buffer = find(symbol);
+        return buffer && buffer->get_last(bar);
     }
-    
+
     std::vector<KlineBar> get_recent(const std::string& symbol, size_t n) const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = buffers_.find(symbol);
-        if (it == buffers_.end()) return {};
-        return it->second->get_recent(n);
+        const KlineBuffer* buffer = find(symbol);
+        return buffer ? buffer->get_recent(n) : std::vector<KlineBar>();
     }
-    
+
+    bool get_view(const std::string& symbol, size_t n, KlineBuffer::ColumnView& view) const {
+        const KlineBuffer* buffer = find(symbol);
+        if (!buffer) return false;
+        view = buffer->view(n);
+        return true;
+    }
+
     size_t get_bar_count(const std::string& symbol) const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = buffers_.find(symbol);
-        if (it == buffers_.end()) return 0;
-        return it->second->size();
+        const KlineBuffer* buffer = find(symbol);
+        return buffer ? buffer->size() : 0;
     }
-    
+
     std::vector<std::string> get_symbols() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        std::vector<std::string> result;
-        result.reserve(buffers_.size());
-        for (const auto& pair : buffers_) {
-            result.push_back(pair.first);
-        }
-        return result;
+        return buffers_.names();
     }
-    
+
     const std::string& interval() const { return interval_; }
     int64_t interval_ms() const { return interval_ms_; }
     size_t max_bars() const { return max_bars_; }
@@ -731,8 +897,166 @@ private:
     size_t max_bars_;
     std::string interval_;
     int64_t interval_ms_;
-    std::map<std::string, std::unique_ptr<KlineBuffer>> buffers_;
-    mutable std::mutex mutex_;
+    IdTable<KlineBuffer, MAX_MARKET_SYMBOLS> buffers_;
+};
+
+
+// ============================================================
+// 行情合并（慢消费者）
+// ============================================================
+
+/**
+ * @brief 行情合并统计
+ */
+struct ConflationStats {
+    bool enabled = false;
+    uint64_t received = 0;              // 合并模式下收到的帧数
+    uint64_t conflated = 0;             // 被同主题新帧覆盖而丢弃的帧数
+    uint64_t conflated_orderbooks = 0;
+    uint64_t conflated_tickers = 0;
+};
+
+/**
+ * @brief 按主题合并一轮排空内的行情帧
+ *
+ * 同一主题（{exchange}.{type}.{symbol}，深度再区分 channel）的 orderbook 快照与 ticker
+ * 只保留最后一帧，并在最后一帧的位置分发；trades、K线、资金费率以及增量深度
+ * （action=update）逐条保留，相对顺序不变。
+ *
+ * 帧内容拷贝到复用槽位（字符串容量跨轮复用），单线程使用（行情处理线程）
+ */
+class MarketConflator {
+public:
+    static constexpr size_t MAX_BATCH = 4096;  // 单轮最多缓存的帧数，满后先分发
+
+    bool full() const { return count_ >= MAX_BATCH; }
+
+    void push(const char* data, size_t size) {
+        if (count_ == slots_.size()) slots_.emplace_back();
+        Slot& slot = slots_[count_];
+        slot.bytes.assign(data, size);
+        slot.dropped = false;
+        received_.fetch_add(1, std::memory_order_relaxed);
+
+        Kind kind = classify(slot.bytes, key_);
+        if (kind != Kind::LOSSLESS) {
+            auto it = latest_.find(key_);
+            if (it == latest_.end()) {
+                latest_.emplace(key_, count_);
+            } else {
+                slots_[it->second].dropped = true;
+                it->second = count_;
+                conflated_.fetch_add(1, std::memory_order_relaxed);
+                auto& counter = (kind == Kind::ORDERBOOK) ? conflated_orderbooks_ : conflated_tickers_;
+                counter.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        count_++;
+    }
+
+    /**
+     * @brief 按到达顺序分发保留的帧并清空本轮
+     */
+    template <typename Fn>
+    void flush(Fn&& dispatch) {
+        for (size_t i = 0; i < count_; ++i) {
+            if (!slots_[i].dropped) {
+                dispatch(slots_[i].bytes.data(), slots_[i].bytes.size());
+            }
+        }
+        count_ = 0;
+        latest_.clear();
+    }
+
+    ConflationStats stats() const {
+        ConflationStats s;
+        s.received = received_.load(std::memory_order_relaxed);
+        s.conflated = conflated_.load(std::memory_order_relaxed);
+        s.conflated_orderbooks = conflated_orderbooks_.load(std::memory_order_relaxed);
+        s.conflated_tickers = conflated_tickers_.load(std::memory_order_relaxed);
+        return s;
+    }
+
+private:
+    enum class Kind { LOSSLESS, ORDERBOOK, TICKER };
+
+    struct Slot {
+        std::string bytes;
+        bool dropped = false;
+    };
+
+    /**
+     * @brief 判断帧是否可合并，可合并时输出合并键
+     */
+    static Kind classify(const std::string& frame, std::string& key) {
+        size_t pipe = frame.find('|');
+        if (pipe == std::string::npos) return Kind::LOSSLESS;
+
+        // 主题: {exchange}.{type}.{symbol}[.{interval}]
+        size_t type_begin = frame.find('.');
+        if (type_begin >= pipe) return Kind::LOSSLESS;
+        type_begin++;
+        size_t type_end = frame.find('.', type_begin);
+        if (type_end >= pipe) return Kind::LOSSLESS;
+        std::string_view type(frame.data() + type_begin, type_end - type_begin);
+
+        Kind kind;
+        if (type == "orderbook") {
+            kind = Kind::ORDERBOOK;
+        } else if (type == "ticker") {
+            kind = Kind::TICKER;
+        } else {
+            return Kind::LOSSLESS;
+        }
+        key.assign(frame, 0, pipe);
+        if (kind == Kind::TICKER) return kind;
+
+        // 深度：同一 symbol 可能同时订阅多个 channel，增量推送不能合并
+        const char* payload = frame.data() + pipe + 1;
+        size_t payload_size = frame.size() - pipe - 1;
+        std::string_view channel;
+        std::string_view action;
+        server::wire::WireHeader header;
+        server::wire::WireOrderBook body;
+        if (server::wire::is_binary_frame(payload, payload_size)) {
+            if (!server::wire::read_header(payload, payload_size, header) ||
+                !server::wire::read_body(payload, header, body)) {
+                return Kind::LOSSLESS;
+            }
+            channel = std::string_view(body.channel, strnlen(body.channel, sizeof(body.channel)));
+            action = std::string_view(body.action, strnlen(body.action, sizeof(body.action)));
+        } else {
+            std::string_view json(payload, payload_size);
+            channel = json_string_field(json, "\"channel\":\"");
+            action = json_string_field(json, "\"action\":\"");
+        }
+        if (action == "update") return Kind::LOSSLESS;
+        key += '|';
+        key.append(channel.data(), channel.size());
+        return kind;
+    }
+
+    /**
+     * @brief 在紧凑 JSON（nlohmann dump 输出）中查找字符串字段值
+     */
+    static std::string_view json_string_field(std::string_view json, std::string_view prefix) {
+        size_t begin = json.find(prefix);
+        if (begin == std::string_view::npos) return {};
+        begin += prefix.size();
+        size_t end = json.find('"', begin);
+        if (end == std::string_view::npos) return {};
+        return json.substr(begin, end - begin);
+    }
+
+    std::vector<Slot> slots_;
+    size_t count_ = 0;
+    std::string key_;                                  // 复用的合并键缓冲
+    std::unordered_map<std::string, size_t> latest_;   // 合并键 -> 本轮最后一帧的槽位
+
+    std::atomic<uint64_t> received_{0};
+    std::atomic<uint64_t> conflated_{0};
+    std::atomic<uint64_t> conflated_orderbooks_{0};
+    std::atomic<uint64_t> conflated_tickers_{0};
 };
 
 
@@ -784,6 +1108,23 @@ public:
         market_sub_ = market_sub;
         subscribe_push_ = subscribe_push;
     }
+
+    /**
+     * @brief 设置共享内存行情读者（由策略基类调用）
+     *
+     * 设置后行情从共享内存广播环读取，market_sub_ 不再接收行情；
+     * 服务端关闭广播环时自动回退到 ZMQ 通道
+     */
+    void set_shm_reader(server::ShmBroadcastReader* reader) {
+        shm_reader_ = reader;
+    }
+
+    /**
+     * @brief 共享内存读取过慢被覆盖丢失的槽位数
+     */
+    uint64_t shm_lost_count() const {
+        return shm_reader_ ? shm_reader_->lost_count() : 0;
+    }
     
     // ==================== 订阅管理 ====================
     
@@ -796,12 +1137,10 @@ public:
             return false;
         }
         
-        // 创建或更新 K 线管理器
-        {
-            std::lock_guard<std::mutex> lock(kline_managers_mutex_);
-            if (kline_managers_.find(interval) == kline_managers_.end()) {
-                kline_managers_[interval] = std::make_unique<KlineManager>(max_kline_bars_, interval);
-            }
+        // 创建 K 线管理器
+        if (!kline_managers_.get_or_create(interval, max_kline_bars_, interval)) {
+            std::cerr << "[MarketData] K线周期数超过上限 " << MAX_KLINE_INTERVALS << ": " << interval << std::endl;
+            return false;
         }
         
         // 记录订阅
@@ -809,6 +1148,7 @@ public:
             std::lock_guard<std::mutex> lock(subscriptions_mutex_);
             subscribed_klines_[symbol].insert(interval);
         }
+        topics_dirty_ = true;
         
         nlohmann::json request = {
             {"action", "subscribe"},
@@ -842,6 +1182,7 @@ public:
                 it->second.erase(interval);
             }
         }
+        topics_dirty_ = true;
         
         nlohmann::json request = {
             {"action", "unsubscribe"},
@@ -871,6 +1212,7 @@ public:
             std::lock_guard<std::mutex> lock(subscriptions_mutex_);
             subscribed_trades_.insert(symbol);
         }
+        topics_dirty_ = true;
         
         nlohmann::json request = {
             {"action", "subscribe"},
@@ -899,6 +1241,7 @@ public:
             std::lock_guard<std::mutex> lock(subscriptions_mutex_);
             subscribed_trades_.erase(symbol);
         }
+        topics_dirty_ = true;
         
         nlohmann::json request = {
             {"action", "unsubscribe"},
@@ -927,20 +1270,15 @@ public:
                             const std::string& strategy_id) {
         if (!subscribe_push_) return false;
         
-        // 创建或更新 OrderBook 缓冲区
-        {
-            std::lock_guard<std::mutex> lock(orderbook_buffers_mutex_);
-            std::string key = symbol + "_" + channel;
-            if (orderbook_buffers_.find(key) == orderbook_buffers_.end()) {
-                orderbook_buffers_[key] = std::make_unique<OrderBookBuffer>(max_orderbook_snapshots_);
-            }
-        }
+        // 创建 OrderBook 缓冲区
+        orderbook_buffers_.get_or_create(symbol + "_" + channel, max_orderbook_snapshots_);
         
         // 记录订阅
         {
             std::lock_guard<std::mutex> lock(subscriptions_mutex_);
             subscribed_orderbooks_[symbol].insert(channel);
         }
+        topics_dirty_ = true;
         
         nlohmann::json request = {
             {"action", "subscribe"},
@@ -973,6 +1311,7 @@ public:
                 it->second.erase(channel);
             }
         }
+        topics_dirty_ = true;
         
         nlohmann::json request = {
             {"action", "unsubscribe"},
@@ -999,19 +1338,15 @@ public:
     bool subscribe_funding_rate(const std::string& symbol, const std::string& strategy_id) {
         if (!subscribe_push_) return false;
         
-        // 创建或更新 FundingRate 缓冲区
-        {
-            std::lock_guard<std::mutex> lock(funding_rate_buffers_mutex_);
-            if (funding_rate_buffers_.find(symbol) == funding_rate_buffers_.end()) {
-                funding_rate_buffers_[symbol] = std::make_unique<FundingRateBuffer>(max_funding_rate_records_);
-            }
-        }
+        // 创建 FundingRate 缓冲区
+        funding_rate_buffers_.get_or_create(symbol, max_funding_rate_records_);
         
         // 记录订阅
         {
             std::lock_guard<std::mutex> lock(subscriptions_mutex_);
             subscribed_funding_rates_.insert(symbol);
         }
+        topics_dirty_ = true;
         
         nlohmann::json request = {
             {"action", "subscribe"},
@@ -1040,6 +1375,7 @@ public:
             std::lock_guard<std::mutex> lock(subscriptions_mutex_);
             subscribed_funding_rates_.erase(symbol);
         }
+        topics_dirty_ = true;
         
         nlohmann::json request = {
             {"action", "unsubscribe"},
@@ -1066,37 +1402,200 @@ public:
     void process_market_data() {
         if (!market_sub_) return;
 
+        // 合并模式：先排空再分发（回调中重入 poll_messages 时直接逐条分发）
+        const bool conflate = conflation_enabled_.load(std::memory_order_relaxed) && !conflator_flushing_;
+        auto deliver = [this, conflate](const char* data, size_t size) {
+            if (!conflate) {
+                dispatch_frame(data, size);
+                return;
+            }
+            conflator_.push(data, size);
+            if (conflator_.full()) flush_conflated();
+        };
+
+        sync_topic_filters();
+
+        // 共享内存通道：与 ZMQ 帧格式相同，共用解析逻辑
+        // 广播环不支持按主题过滤，在解析前按订阅主题丢弃无关帧
+        if (shm_reader_) {
+            if (shm_reader_->writer_alive()) {
+                while (shm_reader_->read(shm_frame_)) {
+                    if (accepts_topic(shm_frame_.data(), shm_frame_.size())) {
+                        deliver(shm_frame_.data(), shm_frame_.size());
+                    }
+                }
+                if (conflate) flush_conflated();
+                return;
+            }
+            // 服务端已停止，或崩溃/重启导致心跳超时：回退到 ZMQ 通道
+            std::cerr << "[MarketData] 共享内存行情已关闭或心跳超时，回退到 ZMQ" << std::endl;
+            shm_reader_ = nullptr;
+            for (const auto& topic : active_topics_) {
+                set_sub_filter(zmq::sockopt::subscribe, topic);
+            }
+        }
+
         zmq::message_t message;
         while (market_sub_->recv(message, zmq::recv_flags::dontwait)) {
-            try {
-                std::string msg_str(static_cast<char*>(message.data()), message.size());
-
-                // 消息格式: topic|json_data
-                // 需要分离主题和JSON数据
-                std::string json_str = msg_str;
-                size_t pipe_pos = msg_str.find('|');
-                if (pipe_pos != std::string::npos) {
-                    // 有主题前缀，提取JSON部分
-                    json_str = msg_str.substr(pipe_pos + 1);
-                }
+            deliver(static_cast<const char*>(message.data()), message.size());
+        }
+        if (conflate) flush_conflated();
+    }
+
+    /**
+     * @brief 启用/关闭行情合并（慢消费者只处理每个主题的最新深度/ticker）
+     */
+    void set_conflation(bool enabled) {
+        conflation_enabled_ = enabled;
+    }
+
+    bool conflation_enabled() const {
+        return conflation_enabled_.load();
+    }
+
+    ConflationStats conflation_stats() const {
+        ConflationStats stats = conflator_.stats();
+        stats.enabled = conflation_enabled_.load();
+        return stats;
+    }
 
-                auto data = nlohmann::json::parse(json_str);
+    // ==================== 主题过滤 ====================
 
-                std::string msg_type = data.value("type", "");
+    /**
+     * @brief 订阅变化后同步 SUB 前缀（行情线程调用，zmq socket 非线程安全）
+     *
+     * 前缀为完整主题加分隔符（"{exchange}.{type}.{symbol}[.{interval}]|"），
+     * 避免 BTC-USDT 误匹配 BTC-USDT-SWAP。PUB 端按订阅前缀过滤，未订阅的主题不会发送到本进程
+     */
+    void sync_topic_filters() {
+        if (!topics_dirty_.exchange(false)) return;
 
-                if (msg_type == "kline") {
-                    handle_kline(data);
-                } else if (msg_type == "trades" || msg_type == "trade") {
-                    handle_trades(data);
-                } else if (msg_type == "orderbook") {
-                    handle_orderbook(data);
-                } else if (msg_type == "funding_rate") {
-                    handle_funding_rate(data);
+        auto desired = build_topic_filters();
+        if (!shm_reader_) {
+            for (const auto& topic : active_topics_) {
+                if (desired.find(topic) == desired.end()) {
+                    set_sub_filter(zmq::sockopt::unsubscribe, topic);
+                }
+            }
+            for (const auto& topic : desired) {
+                if (active_topics_.find(topic) == active_topics_.end()) {
+                    set_sub_filter(zmq::sockopt::subscribe, topic);
                 }
+            }
+        }
+        active_topics_ = std::move(desired);
+    }
 
-            } catch (const std::exception&) {
-                // 忽略解析错误
+    /**
+     * @brief 按订阅记录计算需要接收的主题
+     *
+     * 订阅请求不带交易所，按 TOPIC_EXCHANGES 逐个展开（与用户态按 symbol 过滤的行为一致）
+     */
+    std::set<std::string, std::less<>> build_topic_filters() const {
+        std::set<std::string, std::less<>> topics;
+        auto add = [&topics](const char* type, const std::string& symbol, const std::string& interval) {
+            for (const char* exchange : TOPIC_EXCHANGES) {
+                std::string topic;
+                topic.reserve(64);
+                topic += exchange;
+                topic += '.';
+                topic += type;
+                topic += '.';
+                topic += symbol;
+                if (!interval.empty()) {
+                    topic += '.';
+                    topic += interval;
+                }
+                topic += '|';
+                topics.insert(std::move(topic));
             }
+        };
+
+        std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+        for (const auto& [symbol, intervals] : subscribed_klines_) {
+            for (const auto& interval : intervals) {
+                add("kline", symbol, interval);
+            }
+        }
+        for (const auto& symbol : subscribed_trades_) {
+            add("trade", symbol, "");
+            add("trades", symbol, "");
+        }
+        for (const auto& [symbol, channels] : subscribed_orderbooks_) {
+            if (!channels.empty()) add("orderbook", symbol, "");
+        }
+        for (const auto& symbol : subscribed_funding_rates_) {
+            add("funding_rate", symbol, "");
+        }
+        return topics;
+    }
+
+    /**
+     * @brief 帧的主题是否在订阅集合中（共享内存通道使用）
+     */
+    bool accepts_topic(const char* data, size_t size) const {
+        const void* pipe = std::memchr(data, '|', size);
+        if (!pipe) return true;  // 无主题前缀的帧交给解析逻辑处理
+        size_t topic_size = static_cast<const char*>(pipe) - data + 1;
+        return active_topics_.find(std::string_view(data, topic_size)) != active_topics_.end();
+    }
+
+    template <typename Option>
+    void set_sub_filter(Option option, const std::string& topic) {
+        try {
+            market_sub_->set(option, topic);
+        } catch (const std::exception& e) {
+            std::cerr << "[MarketData] 设置订阅前缀失败: " << topic << " " << e.what() << std::endl;
+        }
+    }
+
+    /**
+     * @brief 分发本轮合并后保留的帧
+     */
+    void flush_conflated() {
+        conflator_flushing_ = true;
+        conflator_.flush([this](const char* data, size_t size) { dispatch_frame(data, size); });
+        conflator_flushing_ = false;
+    }
+
+    /**
+     * @brief 解析并分发一帧行情（topic|json_data 或 topic|binary）
+     */
+    void dispatch_frame(const char* msg_data, size_t msg_size) {
+        try {
+            // 消息格式: topic|json_data 或 topic|binary
+            // 需要分离主题和数据部分
+            const char* payload = msg_data;
+            size_t payload_size = msg_size;
+            const void* pipe = std::memchr(msg_data, '|', msg_size);
+            if (pipe) {
+                // 有主题前缀，提取数据部分
+                payload = static_cast<const char*>(pipe) + 1;
+                payload_size = msg_size - (payload - msg_data);
+            }
+
+            // 二进制帧：直接按定长结构解码
+            if (server::wire::is_binary_frame(payload, payload_size)) {
+                handle_binary(payload, payload_size);
+                return;
+            }
+
+            auto data = nlohmann::json::parse(payload, payload + payload_size);
+
+            std::string msg_type = data.value("type", "");
+
+            if (msg_type == "kline") {
+                handle_kline(data);
+            } else if (msg_type == "trades" || msg_type == "trade") {
+                handle_trades(data);
+            } else if (msg_type == "orderbook") {
+                handle_orderbook(data);
+            } else if (msg_type == "funding_rate") {
+                handle_funding_rate(data);
+            }
+
+        } catch (const std::exception&) {
+            // 忽略解析错误
         }
     }
     
@@ -1106,60 +1605,54 @@ public:
      * @brief 获取所有 K 线数据
      */
     std::vector<KlineBar> get_klines(const std::string& symbol, const std::string& interval) const {
-        std::lock_guard<std::mutex> lock(kline_managers_mutex_);
-        auto it = kline_managers_.find(interval);
-        if (it == kline_managers_.end()) return {};
-        return it->second->get_all(symbol);
+        const KlineManager* manager = kline_managers_.find(interval);
+        if (!manager) return {};
+        return manager->get_all(symbol);
     }
     
     /**
      * @brief 获取收盘价数组
      */
     std::vector<double> get_closes(const std::string& symbol, const std::string& interval) const {
-        std::lock_guard<std::mutex> lock(kline_managers_mutex_);
-        auto it = kline_managers_.find(interval);
-        if (it == kline_managers_.end()) return {};
-        return it->second->get_closes(symbol);
+        const KlineManager* manager = kline_managers_.find(interval);
+        if (!manager) return {};
+        return manager->get_closes(symbol);
     }
     
     /**
      * @brief 获取开盘价数组
      */
     std::vector<double> get_opens(const std::string& symbol, const std::string& interval) const {
-        std::lock_guard<std::mutex> lock(kline_managers_mutex_);
-        auto it = kline_managers_.find(interval);
-        if (it == kline_managers_.end()) return {};
-        return it->second->get_opens(symbol);
+        const KlineManager* manager = kline_managers_.find(interval);
+        if (!manager) return {};
+        return manager->get_opens(symbol);
     }
     
     /**
      * @brief 获取最高价数组
      */
     std::vector<double> get_highs(const std::string& symbol, const std::string& interval) const {
-        std::lock_guard<std::mutex> lock(kline_managers_mutex_);
-        auto it = kline_managers_.find(interval);
-        if (it == kline_managers_.end()) return {};
-        return it->second->get_highs(symbol);
+        const KlineManager* manager = kline_managers_.find(interval);
+        if (!manager) return {};
+        return manager->get_highs(symbol);
     }
     
     /**
      * @brief 获取最低价数组
      */
     std::vector<double> get_lows(const std::string& symbol, const std::string& interval) const {
-        std::lock_guard<std::mutex> lock(kline_managers_mutex_);
-        auto it = kline_managers_.find(interval);
-        if (it == kline_managers_.end()) return {};
-        return it->second->get_lows(symbol);
+        const KlineManager* manager = kline_managers_.find(interval);
+        if (!manager) return {};
+        return manager->get_lows(symbol);
     }
     
     /**
      * @brief 获取成交量数组
      */
     std::vector<double> get_volumes(const std::string& symbol, const std::string& interval) const {
-        std::lock_guard<std::mutex> lock(kline_managers_mutex_);
-        auto it = kline_managers_.find(interval);
-        if (it == kline_managers_.end()) return {};
-        return it->second->get_volumes(symbol);
+        const KlineManager* manager = kline_managers_.find(interval);
+        if (!manager) return {};
+        return manager->get_volumes(symbol);
     }
     
     /**
@@ -1168,30 +1661,92 @@ public:
     std::vector<KlineBar> get_recent_klines(const std::string& symbol, 
                                             const std::string& interval, 
                                             size_t n) const {
-        std::lock_guard<std::mutex> lock(kline_managers_mutex_);
-        auto it = kline_managers_.find(interval);
-        if (it == kline_managers_.end()) return {};
-        return it->second->get_recent(symbol, n);
+        const KlineManager* manager = kline_managers_.find(interval);
+        if (!manager) return {};
+        return manager->get_recent(symbol, n);
+    }
+    
+    /**
+     * @brief 获取最近 n 根 K 线的列式视图（n=0 表示全部，不拷贝，见 KlineBuffer::ColumnView）
+     */
+    bool get_kline_view(const std::string& symbol, const std::string& interval,
+                        size_t n, KlineBuffer::ColumnView& view) const {
+        const KlineManager* manager = kline_managers_.find(interval);
+        if (!manager) return false;
+        return manager->get_view(symbol, n, view);
+    }
+    
+    // ==================== 技术指标 ====================
+    
+    /**
+     * @brief 对 K 线缓冲区整段计算指标（批量模式，直接读取列存储，不拷贝输入）
+     * @param out 与缓冲区等长，预热期为 NaN
+     */
+    bool compute_indicator(const std::string& symbol, const std::string& interval,
+                           indicators::IndicatorType type, size_t period,
+                           std::vector<double>& out) const {
+        const KlineManager* manager = kline_managers_.find(interval);
+        if (!manager) return false;
+        const KlineBuffer* buffer = manager->find(symbol);
+        if (!buffer) return false;
+
+        // 计算期间行情线程写入时重新计算（保证结果对应同一时刻的缓冲区）
+        buffer->read_view(0, [&](const KlineBuffer::ColumnView& view) {
+            const double* close = view.column(KlineBuffer::CLOSE);
+            out.assign(view.rows, indicators::NaN);
+            switch (type) {
+                case indicators::IndicatorType::SMA: indicators::sma(close, view.rows, period, out.data()); break;
+                case indicators::IndicatorType::EMA: indicators::ema(close, view.rows, period, out.data()); break;
+                case indicators::IndicatorType::STD: indicators::rolling_std(close, view.rows, period, out.data()); break;
+                case indicators::IndicatorType::ZSCORE: indicators::zscore(close, view.rows, period, out.data()); break;
+                case indicators::IndicatorType::VOLATILITY: indicators::volatility(close, view.rows, period, out.data()); break;
+                case indicators::IndicatorType::RSI: indicators::rsi(close, view.rows, period, out.data()); break;
+                case indicators::IndicatorType::ATR:
+                    indicators::atr(view.column(KlineBuffer::HIGH), view.column(KlineBuffer::LOW), close,
+                                    view.rows, period, out.data());
+                    break;
+            }
+        });
+        return true;
+    }
+    
+    /**
+     * @brief 注册流式指标（用已缓存的 K 线预热，之后每根 K 线 O(1) 更新）
+     */
+    bool add_indicator(const std::string& symbol, const std::string& interval,
+                       indicators::IndicatorType type, size_t period) {
+        return indicator_engine_.add(symbol, interval, type, period, get_klines(symbol, interval));
+    }
+    
+    bool remove_indicator(const std::string& symbol, const std::string& interval,
+                          indicators::IndicatorType type, size_t period) {
+        return indicator_engine_.remove(symbol, interval, type, period);
+    }
+    
+    /**
+     * @brief 流式指标当前值（未注册或预热中返回 NaN）
+     */
+    double get_indicator(const std::string& symbol, const std::string& interval,
+                         indicators::IndicatorType type, size_t period) const {
+        return indicator_engine_.value(symbol, interval, type, period);
     }
     
     /**
      * @brief 获取最后一根 K 线
      */
     bool get_last_kline(const std::string& symbol, const std::string& interval, KlineBar& bar) const {
-        std::lock_guard<std::mutex> lock(kline_managers_mutex_);
-        auto it = kline_managers_.find(interval);
-        if (it == kline_managers_.end()) return false;
-        return it->second->get_last(symbol, bar);
+        const KlineManager* manager = kline_managers_.find(interval);
+        if (!manager) return false;
+        return manager->get_last(symbol, bar);
     }
     
     /**
      * @brief 获取 K 线数量
      */
     size_t get_kline_count(const std::string& symbol, const std::string& interval) const {
-        std::lock_guard<std::mutex> lock(kline_managers_mutex_);
-        auto it = kline_managers_.find(interval);
-        if (it == kline_managers_.end()) return 0;
-        return it->second->get_bar_count(symbol);
+        const KlineManager* manager = kline_managers_.find(interval);
+        if (!manager) return 0;
+        return manager->get_bar_count(symbol);
     }
     
     /**
@@ -1212,50 +1767,45 @@ public:
      * @brief 获取所有成交数据
      */
     std::vector<TradeData> get_trades(const std::string& symbol) const {
-        std::lock_guard<std::mutex> lock(trade_buffers_mutex_);
-        auto it = trade_buffers_.find(symbol);
-        if (it == trade_buffers_.end()) return {};
-        return it->second->get_all();
+        const TradeBuffer* buffer = trade_buffers_.find(symbol);
+        if (!buffer) return {};
+        return buffer->get_all();
     }
     
     /**
      * @brief 获取最近 N 条成交
      */
     std::vector<TradeData> get_recent_trades(const std::string& symbol, size_t n) const {
-        std::lock_guard<std::mutex> lock(trade_buffers_mutex_);
-        auto it = trade_buffers_.find(symbol);
-        if (it == trade_buffers_.end()) return {};
-        return it->second->get_recent(n);
+        const TradeBuffer* buffer = trade_buffers_.find(symbol);
+        if (!buffer) return {};
+        return buffer->get_recent(n);
     }
     
     /**
      * @brief 获取最近 N 毫秒内的成交
      */
     std::vector<TradeData> get_trades_by_time(const std::string& symbol, int64_t time_ms) const {
-        std::lock_guard<std::mutex> lock(trade_buffers_mutex_);
-        auto it = trade_buffers_.find(symbol);
-        if (it == trade_buffers_.end()) return {};
-        return it->second->get_recent_by_time(time_ms);
+        const TradeBuffer* buffer = trade_buffers_.find(symbol);
+        if (!buffer) return {};
+        return buffer->get_recent_by_time(time_ms);
     }
     
     /**
      * @brief 获取最后一条成交
      */
     bool get_last_trade(const std::string& symbol, TradeData& trade) const {
-        std::lock_guard<std::mutex> lock(trade_buffers_mutex_);
-        auto it = trade_buffers_.find(symbol);
-        if (it == trade_buffers_.end()) return false;
-        return it->second->get_last(trade);
+        const TradeBuffer* buffer = trade_buffers_.find(symbol);
+        if (!buffer) return false;
+        return buffer->get_last(trade);
     }
     
     /**
      * @brief 获取成交数量
      */
     size_t get_trade_count(const std::string& symbol) const {
-        std::lock_guard<std::mutex> lock(trade_buffers_mutex_);
-        auto it = trade_buffers_.find(symbol);
-        if (it == trade_buffers_.end()) return 0;
-        return it->second->size();
+        const TradeBuffer* buffer = trade_buffers_.find(symbol);
+        if (!buffer) return 0;
+        return buffer->size();
     }
     
     // ==================== OrderBook 数据查询 ====================
@@ -1265,11 +1815,9 @@ public:
      */
     std::vector<OrderBookSnapshot> get_orderbooks(const std::string& symbol, 
                                                   const std::string& channel = "books5") const {
-        std::lock_guard<std::mutex> lock(orderbook_buffers_mutex_);
-        std::string key = symbol + "_" + channel;
-        auto it = orderbook_buffers_.find(key);
-        if (it == orderbook_buffers_.end()) return {};
-        return it->second->get_all();
+        const OrderBookBuffer* buffer = orderbook_buffers_.find(symbol + "_" + channel);
+        if (!buffer) return {};
+        return buffer->get_all();
     }
     
     /**
@@ -1278,11 +1826,9 @@ public:
     std::vector<OrderBookSnapshot> get_recent_orderbooks(const std::string& symbol, 
                                                          size_t n,
                                                          const std::string& channel = "books5") const {
-        std::lock_guard<std::mutex> lock(orderbook_buffers_mutex_);
-        std::string key = symbol + "_" + channel;
-        auto it = orderbook_buffers_.find(key);
-        if (it == orderbook_buffers_.end()) return {};
-        return it->second->get_recent(n);
+        const OrderBookBuffer* buffer = orderbook_buffers_.find(symbol + "_" + channel);
+        if (!buffer) return {};
+        return buffer->get_recent(n);
     }
     
     /**
@@ -1291,11 +1837,9 @@ public:
     std::vector<OrderBookSnapshot> get_orderbooks_by_time(const std::string& symbol,
                                                           int64_t time_ms,
                                                           const std::string& channel = "books5") const {
-        std::lock_guard<std::mutex> lock(orderbook_buffers_mutex_);
-        std::string key = symbol + "_" + channel;
-        auto it = orderbook_buffers_.find(key);
-        if (it == orderbook_buffers_.end()) return {};
-        return it->second->get_recent_by_time(time_ms);
+        const OrderBookBuffer* buffer = orderbook_buffers_.find(symbol + "_" + channel);
+        if (!buffer) return {};
+        return buffer->get_recent_by_time(time_ms);
     }
     
     /**
@@ -1303,22 +1847,18 @@ public:
      */
     bool get_last_orderbook(const std::string& symbol, OrderBookSnapshot& snapshot,
                           const std::string& channel = "books5") const {
-        std::lock_guard<std::mutex> lock(orderbook_buffers_mutex_);
-        std::string key = symbol + "_" + channel;
-        auto it = orderbook_buffers_.find(key);
-        if (it == orderbook_buffers_.end()) return false;
-        return it->second->get_last(snapshot);
+        const OrderBookBuffer* buffer = orderbook_buffers_.find(symbol + "_" + channel);
+        if (!buffer) return false;
+        return buffer->get_last(snapshot);
     }
     
     /**
      * @brief 获取快照数量
      */
     size_t get_orderbook_count(const std::string& symbol, const std::string& channel = "books5") const {
-        std::lock_guard<std::mutex> lock(orderbook_buffers_mutex_);
-        std::string key = symbol + "_" + channel;
-        auto it = orderbook_buffers_.find(key);
-        if (it == orderbook_buffers_.end()) return 0;
-        return it->second->size();
+        const OrderBookBuffer* buffer = orderbook_buffers_.find(symbol + "_" + channel);
+        if (!buffer) return 0;
+        return buffer->size();
     }
     
     // ==================== FundingRate 数据查询 ====================
@@ -1327,50 +1867,45 @@ public:
      * @brief 获取所有资金费率数据
      */
     std::vector<FundingRateData> get_funding_rates(const std::string& symbol) const {
-        std::lock_guard<std::mutex> lock(funding_rate_buffers_mutex_);
-        auto it = funding_rate_buffers_.find(symbol);
-        if (it == funding_rate_buffers_.end()) return {};
-        return it->second->get_all();
+        const FundingRateBuffer* buffer = funding_rate_buffers_.find(symbol);
+        if (!buffer) return {};
+        return buffer->get_all();
     }
     
     /**
      * @brief 获取最近 N 条记录
      */
     std::vector<FundingRateData> get_recent_funding_rates(const std::string& symbol, size_t n) const {
-        std::lock_guard<std::mutex> lock(funding_rate_buffers_mutex_);
-        auto it = funding_rate_buffers_.find(symbol);
-        if (it == funding_rate_buffers_.end()) return {};
-        return it->second->get_recent(n);
+        const FundingRateBuffer* buffer = funding_rate_buffers_.find(symbol);
+        if (!buffer) return {};
+        return buffer->get_recent(n);
     }
     
     /**
      * @brief 获取最近 N 毫秒内的记录
      */
     std::vector<FundingRateData> get_funding_rates_by_time(const std::string& symbol, int64_t time_ms) const {
-        std::lock_guard<std::mutex> lock(funding_rate_buffers_mutex_);
-        auto it = funding_rate_buffers_.find(symbol);
-        if (it == funding_rate_buffers_.end()) return {};
-        return it->second->get_recent_by_time(time_ms);
+        const FundingRateBuffer* buffer = funding_rate_buffers_.find(symbol);
+        if (!buffer) return {};
+        return buffer->get_recent_by_time(time_ms);
     }
     
     /**
      * @brief 获取最后一条记录
      */
     bool get_last_funding_rate(const std::string& symbol, FundingRateData& fr) const {
-        std::lock_guard<std::mutex> lock(funding_rate_buffers_mutex_);
-        auto it = funding_rate_buffers_.find(symbol);
-        if (it == funding_rate_buffers_.end()) return false;
-        return it->second->get_last(fr);
+        const FundingRateBuffer* buffer = funding_rate_buffers_.find(symbol);
+        if (!buffer) return false;
+        return buffer->get_last(fr);
     }
     
     /**
      * @brief 获取记录数量
      */
     size_t get_funding_rate_count(const std::string& symbol) const {
-        std::lock_guard<std::mutex> lock(funding_rate_buffers_mutex_);
-        auto it = funding_rate_buffers_.find(symbol);
-        if (it == funding_rate_buffers_.end()) return 0;
-        return it->second->size();
+        const FundingRateBuffer* buffer = funding_rate_buffers_.find(symbol);
+        if (!buffer) return 0;
+        return buffer->size();
     }
     
     // ==================== 回调设置 ====================
@@ -1402,6 +1937,8 @@ public:
     int64_t total_trade_count() const { return trade_count_.load(); }
     int64_t total_orderbook_count() const { return orderbook_count_.load(); }
     int64_t total_funding_rate_count() const { return funding_rate_count_.load(); }
+    int64_t total_binary_count() const { return binary_count_.load(); }
+    int64_t total_binary_rejected_count() const { return binary_rejected_count_.load(); }
 
 private:
     void handle_kline(const nlohmann::json& data) {
@@ -1427,19 +1964,22 @@ private:
         bar.close = data.value("close", 0.0);
         bar.volume = data.value("volume", 0.0);
         
+        apply_kline(symbol, interval, bar);
+    }
+    
+    void apply_kline(const std::string& symbol, const std::string& interval, const KlineBar& bar) {
         // 存储
-        {
-            std::lock_guard<std::mutex> lock(kline_managers_mutex_);
-            auto it = kline_managers_.find(interval);
-            if (it != kline_managers_.end()) {
-                bool is_new = it->second->update(symbol, bar.timestamp, bar.open, bar.high, 
-                                                  bar.low, bar.close, bar.volume);
-                if (is_new) {
-                    kline_count_++;
-                }
+        if (KlineManager* manager = kline_managers_.find(interval)) {
+            bool is_new = manager->update(symbol, bar.timestamp, bar.open, bar.high,
+                                          bar.low, bar.close, bar.volume);
+            if (is_new) {
+                kline_count_++;
             }
         }
         
+        // 流式指标在回调前更新，on_kline 中读到的是包含本根 K 线的值
+        indicator_engine_.on_bar(symbol, interval, bar.timestamp, bar.high, bar.low, bar.close);
+        
         // 回调
         if (kline_callback_) {
             kline_callback_(symbol, interval, bar);
@@ -1464,16 +2004,14 @@ private:
         trade.quantity = data.value("quantity", 0.0);
         trade.side = data.value("side", "");
         
+        apply_trade(symbol, trade);
+    }
+    
+    void apply_trade(const std::string& symbol, const TradeData& trade) {
         // 存储
-        {
-            std::lock_guard<std::mutex> lock(trade_buffers_mutex_);
-            auto it = trade_buffers_.find(symbol);
-            if (it == trade_buffers_.end()) {
-                trade_buffers_[symbol] = std::make_unique<TradeBuffer>(max_trades_);
-                it = trade_buffers_.find(symbol);
-            }
-            it->second->add(trade.timestamp, trade.trade_id, trade.price, 
-                          trade.quantity, trade.side);
+        if (TradeBuffer* buffer = trade_buffers_.get_or_create(symbol, max_trades_)) {
+            buffer->add(trade.timestamp, trade.trade_id, trade.price,
+                        trade.quantity, trade.side);
             trade_count_++;
         }
         
@@ -1547,34 +2085,34 @@ private:
             spread = best_ask_price - best_bid_price;
         }
         
-        int64_t timestamp = data.value("timestamp", current_timestamp_ms());
+        OrderBookSnapshot snapshot;
+        snapshot.timestamp = data.value("timestamp", current_timestamp_ms());
+        snapshot.bids = std::move(bids);
+        snapshot.asks = std::move(asks);
+        snapshot.best_bid_price = best_bid_price;
+        snapshot.best_bid_size = best_bid_size;
+        snapshot.best_ask_price = best_ask_price;
+        snapshot.best_ask_size = best_ask_size;
+        snapshot.mid_price = mid_price;
+        snapshot.spread = spread;
         
+        apply_orderbook(symbol, channel, snapshot);
+    }
+    
+    void apply_orderbook(const std::string& symbol, const std::string& channel,
+                         const OrderBookSnapshot& snapshot) {
         // 存储（使用正确的 channel）
-        {
-            std::lock_guard<std::mutex> lock(orderbook_buffers_mutex_);
-            std::string key = symbol + "_" + channel;
-            auto it = orderbook_buffers_.find(key);
-            if (it == orderbook_buffers_.end()) {
-                orderbook_buffers_[key] = std::make_unique<OrderBookBuffer>(max_orderbook_snapshots_);
-                it = orderbook_buffers_.find(key);
-            }
-            it->second->add(timestamp, bids, asks, best_bid_price, best_bid_size,
-                           best_ask_price, best_ask_size, mid_price, spread);
+        if (OrderBookBuffer* buffer = orderbook_buffers_.get_or_create(symbol + "_" + channel,
+                                                                       max_orderbook_snapshots_)) {
+            buffer->add(snapshot.timestamp, snapshot.bids, snapshot.asks,
+                        snapshot.best_bid_price, snapshot.best_bid_size,
+                        snapshot.best_ask_price, snapshot.best_ask_size,
+                        snapshot.mid_price, snapshot.spread);
             orderbook_count_++;
         }
         
         // 回调
         if (orderbook_callback_) {
-            OrderBookSnapshot snapshot;
-            snapshot.timestamp = timestamp;
-            snapshot.bids = bids;
-            snapshot.asks = asks;
-            snapshot.best_bid_price = best_bid_price;
-            snapshot.best_bid_size = best_bid_size;
-            snapshot.best_ask_price = best_ask_price;
-            snapshot.best_ask_size = best_ask_size;
-            snapshot.mid_price = mid_price;
-            snapshot.spread = spread;
             orderbook_callback_(symbol, snapshot);
         }
     }
@@ -1606,15 +2144,13 @@ private:
         fr.formula_type = data.value("formula_type", "");
         fr.sett_state = data.value("sett_state", "");
         
+        apply_funding_rate(symbol, fr);
+    }
+    
+    void apply_funding_rate(const std::string& symbol, const FundingRateData& fr) {
         // 存储
-        {
-            std::lock_guard<std::mutex> lock(funding_rate_buffers_mutex_);
-            auto it = funding_rate_buffers_.find(symbol);
-            if (it == funding_rate_buffers_.end()) {
-                funding_rate_buffers_[symbol] = std::make_unique<FundingRateBuffer>(max_funding_rate_records_);
-                it = funding_rate_buffers_.find(symbol);
-            }
-            it->second->add(fr);
+        if (FundingRateBuffer* buffer = funding_rate_buffers_.get_or_create(symbol, max_funding_rate_records_)) {
+            buffer->add(fr);
             funding_rate_count_++;
         }
         
@@ -1624,6 +2160,181 @@ private:
         }
     }
     
+    // ==================== 二进制帧解码 ====================
+    
+    /**
+     * @brief 处理二进制行情帧（见 market_wire_format.h）
+     *
+     * 与 JSON 路径共用订阅检查和 apply_* 存储逻辑，只是跳过了 json::parse
+     */
+    void handle_binary(const char* payload, size_t size) {
+        namespace wire = server::wire;
+        
+        wire::WireHeader header;
+        if (!wire::read_header(payload, size, header)) {
+            binary_rejected_count_++;  // 版本不匹配或帧不完整
+            return;
+        }
+        binary_count_++;
+        
+        const std::string& symbol = wire_symbol(header);
+        
+        switch (static_cast<wire::WireMsgType>(header.msg_type)) {
+            case wire::WireMsgType::KLINE: {
+                wire::WireKline body;
+                if (!wire::read_body(payload, header, body)) break;
+                std::string interval = wire::read_fixed(body.interval, sizeof(body.interval));
+                if (symbol.empty() || interval.empty()) break;
+                {
+                    std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+                    auto it = subscribed_klines_.find(symbol);
+                    if (it == subscribed_klines_.end() || it->second.find(interval) == it->second.end()) {
+                        break;
+                    }
+                }
+                apply_kline(symbol, interval,
+                            KlineBar(body.timestamp, body.open, body.high, body.low, body.close, body.volume));
+                break;
+            }
+            case wire::WireMsgType::TRADE: {
+                wire::WireTrade body;
+                if (!wire::read_body(payload, header, body)) break;
+                {
+                    std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+                    if (subscribed_trades_.find(symbol) == subscribed_trades_.end()) {
+                        break;
+                    }
+                }
+                apply_trade(symbol, TradeData(body.timestamp,
+                                              wire::read_fixed(body.trade_id, sizeof(body.trade_id)),
+                                              body.price, body.quantity,
+                                              wire::read_fixed(body.side, sizeof(body.side))));
+                break;
+            }
+            case wire::WireMsgType::ORDERBOOK: {
+                wire::WireOrderBook body;
+                if (!wire::read_body(payload, header, body)) break;
+                std::string channel = wire::read_fixed(body.channel, sizeof(body.channel));
+                if (channel.empty()) channel = "books5";
+                {
+                    std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+                    auto it = subscribed_orderbooks_.find(symbol);
+                    if (it == subscribed_orderbooks_.end() ||
+                        it->second.find(channel) == it->second.end()) {
+                        break;
+                    }
+                }
+                
+                size_t level_count = static_cast<size_t>(body.bid_count) + body.ask_count;
+                if (header.body_size < sizeof(body) + level_count * sizeof(wire::WireLevel)) {
+                    binary_rejected_count_++;
+                    break;
+                }
+                
+                OrderBookSnapshot snapshot;
+                snapshot.timestamp = body.timestamp != 0 ? body.timestamp : current_timestamp_ms();
+                snapshot.bids.reserve(body.bid_count);
+                snapshot.asks.reserve(body.ask_count);
+                for (size_t i = 0; i < level_count; ++i) {
+                    wire::WireLevel level = wire::read_level(payload, i);
+                    if (level.size <= 0) continue;
+                    if (i < body.bid_count) {
+                        snapshot.bids.emplace_back(level.price, level.size);
+                    } else {
+                        snapshot.asks.emplace_back(level.price, level.size);
+                    }
+                }
+                
+                snapshot.best_bid_price = body.best_bid_price;
+                snapshot.best_bid_size = body.best_bid_size;
+                snapshot.best_ask_price = body.best_ask_price;
+                snapshot.best_ask_size = body.best_ask_size;
+                snapshot.mid_price = body.mid_price;
+                snapshot.spread = body.spread;
+                if (snapshot.best_bid_price == 0 && !snapshot.bids.empty()) {
+                    snapshot.best_bid_price = snapshot.bids[0].first;
+                    snapshot.best_bid_size = snapshot.bids[0].second;
+                }
+                if (snapshot.best_ask_price == 0 && !snapshot.asks.empty()) {
+                    snapshot.best_ask_price = snapshot.asks[0].first;
+                    snapshot.best_ask_size = snapshot.asks[0].second;
+                }
+                if (snapshot.mid_price == 0 && snapshot.best_bid_price > 0 && snapshot.best_ask_price > 0) {
+                    snapshot.mid_price = (snapshot.best_bid_price + snapshot.best_ask_price) / 2.0;
+                    snapshot.spread = snapshot.best_ask_price - snapshot.best_bid_price;
+                }
+                
+                apply_orderbook(symbol, channel, snapshot);
+                break;
+            }
+            case wire::WireMsgType::FUNDING_RATE: {
+                wire::WireFundingRate body;
+                if (!wire::read_body(payload, header, body)) break;
+                {
+                    std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+                    if (subscribed_funding_rates_.find(symbol) == subscribed_funding_rates_.end()) {
+                        break;
+                    }
+                }
+                
+                FundingRateData fr;
+                fr.timestamp = body.timestamp != 0 ? body.timestamp : current_timestamp_ms();
+                fr.funding_rate = body.funding_rate;
+                fr.next_funding_rate = body.next_funding_rate;
+                fr.funding_time = body.funding_time;
+                fr.next_funding_time = body.next_funding_time;
+                fr.min_funding_rate = body.min_funding_rate;
+                fr.max_funding_rate = body.max_funding_rate;
+                fr.interest_rate = body.interest_rate;
+                fr.impact_value = body.impact_value;
+                fr.premium = body.premium;
+                fr.sett_funding_rate = body.sett_funding_rate;
+                fr.method = wire::read_fixed(body.method, sizeof(body.method));
+                fr.formula_type = wire::read_fixed(body.formula_type, sizeof(body.formula_type));
+                fr.sett_state = wire::read_fixed(body.sett_state, sizeof(body.sett_state));
+                
+                apply_funding_rate(symbol, fr);
+                break;
+            }
+            default:
+                // ticker 等类型策略端暂不处理（与 JSON 路径一致）
+                break;
+        }
+    }
+    
+    /**
+     * @brief 二进制帧头 -> 本地品种代码（不构造临时字符串）
+     *
+     * 帧头的 instrument_id 是服务端注册表的ID，只用作本地缓存下标；
+     * 命中后仍校验 exchange/symbol，服务端重启导致ID变化时按名称重新登记。
+     */
+    const std::string& wire_symbol(const server::wire::WireHeader& header) {
+        std::string_view exchange(header.exchange, strnlen(header.exchange, sizeof(header.exchange)));
+        std::string_view symbol(header.symbol, strnlen(header.symbol, sizeof(header.symbol)));
+        
+        int32_t wire_id = header.instrument_id;
+        bool cacheable = wire_id >= 0 && static_cast<size_t>(wire_id) < InstrumentRegistry::CAPACITY;
+        if (cacheable && static_cast<size_t>(wire_id) < wire_instruments_.size()) {
+            const Instrument* cached = wire_instruments_[wire_id];
+            if (cached && cached->symbol == symbol && cached->exchange == exchange) {
+                return cached->symbol;
+            }
+        }
+        
+        const Instrument* instrument = InstrumentRegistry::instance().resolve(exchange, symbol);
+        if (!instrument) {
+            wire_symbol_fallback_.assign(symbol.data(), symbol.size());
+            return wire_symbol_fallback_;
+        }
+        if (cacheable) {
+            if (static_cast<size_t>(wire_id) >= wire_instruments_.size()) {
+                wire_instruments_.resize(wire_id + 1, nullptr);
+            }
+            wire_instruments_[wire_id] = instrument;
+        }
+        return instrument->symbol;
+    }
+    
     static int64_t current_timestamp_ms() {
         return std::chrono::duration_cast<std::chrono::milliseconds>(
             std::chrono::system_clock::now().time_since_epoch()
@@ -1639,22 +2350,39 @@ private:
     // ZMQ sockets（由策略基类设置）
     zmq::socket_t* market_sub_ = nullptr;
     zmq::socket_t* subscribe_push_ = nullptr;
+
+    // 共享内存行情（可选，由策略基类设置）
+    server::ShmBroadcastReader* shm_reader_ = nullptr;
+    std::string shm_frame_;  // 复用的读取缓冲
+
+    // 二进制帧品种缓存（服务端 instrument_id -> 本地注册表条目，行情线程维护）
+    std::vector<const Instrument*> wire_instruments_;
+    std::string wire_symbol_fallback_;
+
+    // 主题过滤（SUB 前缀，行情线程维护）
+    static constexpr const char* TOPIC_EXCHANGES[] = {"okx", "binance"};  // 与服务端主题的 {exchange} 一致
+    std::atomic<bool> topics_dirty_{false};
+    std::set<std::string, std::less<>> active_topics_;
+
+    // 行情合并（慢消费者）
+    std::atomic<bool> conflation_enabled_{false};
+    bool conflator_flushing_ = false;
+    MarketConflator conflator_;
     
     // K线管理器
-    std::map<std::string, std::unique_ptr<KlineManager>> kline_managers_;
-    mutable std::mutex kline_managers_mutex_;
+    IdTable<KlineManager, MAX_KLINE_INTERVALS> kline_managers_;  // key = interval
+    
+    // 流式指标
+    indicators::IndicatorEngine indicator_engine_;
     
     // Trades 缓冲区
-    std::map<std::string, std::unique_ptr<TradeBuffer>> trade_buffers_;
-    mutable std::mutex trade_buffers_mutex_;
+    IdTable<TradeBuffer, MAX_MARKET_SYMBOLS> trade_buffers_;
     
     // OrderBook 缓冲区
-    std::map<std::string, std::unique_ptr<OrderBookBuffer>> orderbook_buffers_;  // key = symbol_channel
-    mutable std::mutex orderbook_buffers_mutex_;
+    IdTable<OrderBookBuffer, MAX_MARKET_SYMBOLS> orderbook_buffers_;  // key = symbol_channel
     
     // FundingRate 缓冲区
-    std::map<std::string, std::unique_ptr<FundingRateBuffer>> funding_rate_buffers_;
-    mutable std::mutex funding_rate_buffers_mutex_;
+    IdTable<FundingRateBuffer, MAX_MARKET_SYMBOLS> funding_rate_buffers_;
     
     // 订阅记录
     std::map<std::string, std::set<std::string>> subscribed_klines_;  // symbol -> intervals
@@ -1674,6 +2402,8 @@ private:
     std::atomic<int64_t> trade_count_;
     std::atomic<int64_t> orderbook_count_;
     std::atomic<int64_t> funding_rate_count_;
+    std::atomic<int64_t> binary_count_{0};
+    std::atomic<int64_t> binary_rejected_count_{0};
 };
 
 } // namespace trading
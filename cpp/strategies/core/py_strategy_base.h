@@ -18,6 +18,8 @@
 #pragma once
 
 #include <string>
+#include <tuple>
+#include <vector>
 #include <memory>
 #include <atomic>
 #include <thread>
@@ -77,6 +79,41 @@ struct ScheduledTask {
         , run_count(0) {}
 };
 
+// ============================================================
+// 批量分发的行情事件
+// ============================================================
+
+/**
+ * @brief 一轮 process_market_data 收集的行情事件（batch 分发模式）
+ *
+ * 同类事件保持到达顺序；不同类事件按 K线、trades、深度、资金费率的顺序分发
+ */
+struct MarketEventBatch {
+    std::vector<std::tuple<std::string, std::string, KlineBar>> klines;   // (symbol, interval, bar)
+    std::vector<std::pair<std::string, TradeData>> trades;                // (symbol, trade)
+    std::vector<std::pair<std::string, OrderBookSnapshot>> orderbooks;    // (symbol, snapshot)
+    std::vector<std::pair<std::string, FundingRateData>> funding_rates;   // (symbol, fr)
+
+    bool empty() const {
+        return klines.empty() && trades.empty() && orderbooks.empty() && funding_rates.empty();
+    }
+
+    // clear 保留容量，稳定状态下不再分配
+    void clear() {
+        klines.clear();
+        trades.clear();
+        orderbooks.clear();
+        funding_rates.clear();
+    }
+
+    void swap(MarketEventBatch& other) noexcept {
+        klines.swap(other.klines);
+        trades.swap(other.trades);
+        orderbooks.swap(other.orderbooks);
+        funding_rates.swap(other.funding_rates);
+    }
+};
+
 /**
  * @brief Python 策略基类
  *
@@ -143,6 +180,11 @@ public:
         };
         trading_.set_log_callback(log_cb);
         account_.set_log_callback(log_cb);
+
+        // 主循环模式（SEQ_LOOP_MODE=spin 启用忙轮询）
+        if (const char* mode = std::getenv("SEQ_LOOP_MODE")) {
+            set_loop_mode(mode);
+        }
     }
     
     /**
@@ -175,9 +217,21 @@ public:
             // 行情订阅 (SUB)
             market_sub_ = std::make_unique<zmq::socket_t>(*context_, zmq::socket_type::sub);
             market_sub_->connect(MARKET_DATA_IPC);
-            market_sub_->set(zmq::sockopt::subscribe, "");
             market_sub_->set(zmq::sockopt::rcvtimeo, 100);
 
+            // 共享内存通道（SEQ_SHM_TRANSPORT=1，需服务端同样启用）
+            const char* shm_env = std::getenv("SEQ_SHM_TRANSPORT");
+            if (shm_env && std::string(shm_env) == "1") {
+                connect_shm();
+            }
+            // 订阅前缀由 MarketDataModule 按 subscribe_* 调用设置（只接收已订阅的主题）
+
+            // 行情合并（SEQ_MARKET_CONFLATE=1，也可由策略调用 set_conflation）
+            const char* conflate_env = std::getenv("SEQ_MARKET_CONFLATE");
+            if (conflate_env && std::string(conflate_env) == "1") {
+                market_data_.set_conflation(true);
+            }
+
             // 订单发送 (PUSH)
             order_push_ = std::make_unique<zmq::socket_t>(*context_, zmq::socket_type::push);
             order_push_->connect(ORDER_IPC);
@@ -196,6 +250,9 @@ public:
             market_data_.set_sockets(market_sub_.get(), subscribe_push_.get());
             trading_.set_sockets(order_push_.get(), report_sub_.get());
             account_.set_sockets(order_push_.get(), report_sub_.get());
+            market_data_.set_shm_reader(shm_market_.get());
+            trading_.set_shm_order_queue(shm_order_.get());
+            account_.set_shm_order_queue(shm_order_.get());
 
             running_ = true;
             log_info("已连接到实盘服务器");
@@ -221,6 +278,33 @@ public:
         if (order_push_) order_push_->close();
         if (report_sub_) report_sub_->close();
         if (subscribe_push_) subscribe_push_->close();
+
+        market_data_.set_shm_reader(nullptr);
+        trading_.set_shm_order_queue(nullptr);
+        account_.set_shm_order_queue(nullptr);
+        shm_market_.reset();
+        shm_order_.reset();
+    }
+
+    /**
+     * @brief 连接共享内存通道（失败时保持 ipc 通道）
+     */
+    void connect_shm() {
+        auto reader = std::make_unique<server::ShmBroadcastReader>();
+        if (reader->attach(server::ShmAddresses::MARKET_DATA) && reader->writer_alive()) {
+            shm_market_ = std::move(reader);
+            log_info("行情使用共享内存通道");
+        } else {
+            log_info("共享内存行情不可用，使用 ipc 通道");
+        }
+
+        auto queue = std::make_unique<server::ShmMpscQueue>();
+        if (queue->attach(server::ShmAddresses::ORDER) && queue->consumer_alive()) {
+            shm_order_ = std::move(queue);
+            log_info("订单使用共享内存通道");
+        } else {
+            log_info("共享内存订单队列不可用，使用 ipc 通道");
+        }
     }
     
     // ============================================================
@@ -313,9 +397,50 @@ public:
         return market_data_.get_last_kline(symbol, interval, bar);
     }
     
+    bool get_kline_view(const std::string& symbol, const std::string& interval,
+                        size_t n, KlineBuffer::ColumnView& view) const {
+        return market_data_.get_kline_view(symbol, interval, n, view);
+    }
+    
     size_t get_kline_count(const std::string& symbol, const std::string& interval) const {
         return market_data_.get_kline_count(symbol, interval);
     }
+
+    // --- 技术指标 ---
+
+    /**
+     * @brief 对 K 线缓冲区整段计算指标（name: sma/ema/std/zscore/volatility/rsi/atr）
+     */
+    bool compute_indicator(const std::string& symbol, const std::string& interval,
+                           const std::string& name, size_t period, std::vector<double>& out) const {
+        indicators::IndicatorType type;
+        if (!parse_indicator_type(name, type)) return false;
+        return market_data_.compute_indicator(symbol, interval, type, period, out);
+    }
+
+    /**
+     * @brief 注册流式指标，之后每根 K 线在 on_kline 之前 O(1) 更新
+     */
+    bool add_indicator(const std::string& symbol, const std::string& interval,
+                       const std::string& name, size_t period) {
+        indicators::IndicatorType type;
+        if (!parse_indicator_type(name, type)) return false;
+        return market_data_.add_indicator(symbol, interval, type, period);
+    }
+
+    bool remove_indicator(const std::string& symbol, const std::string& interval,
+                          const std::string& name, size_t period) {
+        indicators::IndicatorType type;
+        if (!parse_indicator_type(name, type)) return false;
+        return market_data_.remove_indicator(symbol, interval, type, period);
+    }
+
+    double get_indicator(const std::string& symbol, const std::string& interval,
+                         const std::string& name, size_t period) const {
+        indicators::IndicatorType type;
+        if (!parse_indicator_type(name, type)) return indicators::NaN;
+        return market_data_.get_indicator(symbol, interval, type, period);
+    }
     
     // --- Trades 数据查询 ---
     
@@ -839,6 +964,13 @@ public:
         return account_.unregister_account();
     }
 
+    /**
+     * @brief 设置订单通道（在注册账户前调用）："ws" 或 "rest"
+     */
+    void set_order_route(const std::string& route) {
+        account_.set_order_route(route);
+    }
+
     bool is_account_registered() const {
         return account_.is_registered();
     }
@@ -1035,15 +1167,21 @@ public:
 
         log_info("策略运行中...");
 
+        log_info(std::string("主循环模式: ") + (busy_spin_ ? "spin" : "event"));
+
         // 心跳计时（每5秒发送一次心跳给服务器）
         auto last_heartbeat_time = std::chrono::steady_clock::now();
+        auto last_signal_check = std::chrono::steady_clock::time_point{};
 
         try {
             while (running_) {
                 // 让 Python 及时处理挂起的信号（例如 Ctrl-C / SIGINT）
                 // 否则 run() 长时间停留在 C++ 循环中时，Python 的 signal handler 可能无法及时执行。
                 // 注意：PyErr_CheckSignals() 是 Python C API，需要 GIL
-                {
+                // 按 signal_check_interval_ms_ 限频，避免每轮循环都抢 GIL
+                auto now_sig = std::chrono::steady_clock::now();
+                if (now_sig - last_signal_check >= std::chrono::milliseconds(signal_check_interval_ms_.load())) {
+                    last_signal_check = now_sig;
                     py::gil_scoped_acquire gil;
                     if (PyErr_CheckSignals() != 0) {
                         running_ = false;
@@ -1051,8 +1189,14 @@ public:
                     }
                 }
 
-                // 处理行情数据
+                // 等待事件：event 模式阻塞到有消息或下一个定时点，spin 模式不等待
+                if (!busy_spin_) {
+                    wait_for_events(next_wakeup_ms(last_heartbeat_time));
+                }
+
+                // 处理行情数据（batch 模式下只解码并缓存，随后一次性分发）
                 market_data_.process_market_data();
+                flush_market_batch();
                 
                 // 处理账户回报（必须先处理，因为它会分发所有回报类型）
                 process_account_reports();
@@ -1084,8 +1228,6 @@ public:
                     }
                 }
 
-                // 短暂休眠
-                std::this_thread::sleep_for(std::chrono::microseconds(100));
             }
         } catch (const std::exception& e) {
             log_error("策略异常: " + std::string(e.what()));
@@ -1108,6 +1250,95 @@ public:
         running_ = false;
     }
 
+    /**
+     * @brief 设置主循环模式
+     *
+     * - "event"（默认）: zmq::poll 阻塞等待行情/回报 socket，
+     *   超时取下一个定时任务、心跳与空闲上限中的最早者，空闲时不占 CPU
+     * - "spin": 忙轮询，不做任何等待，独占一个核心换取最低延迟
+     *
+     * @return false 未知模式
+     */
+    bool set_loop_mode(const std::string& mode) {
+        if (mode == "event") {
+            busy_spin_ = false;
+        } else if (mode == "spin") {
+            busy_spin_ = true;
+        } else {
+            log_error("未知的主循环模式: " + mode + "（可选 event / spin）");
+            return false;
+        }
+        return true;
+    }
+
+    std::string get_loop_mode() const {
+        return busy_spin_ ? "spin" : "event";
+    }
+
+    /**
+     * @brief 设置行情回调分发模式
+     *
+     * - "direct"（默认）: 每条行情解码后立即回调，每次回调单独获取 GIL
+     * - "batch": 一轮内的行情先在释放 GIL 的状态下解码并缓存，
+     *   然后只获取一次 GIL，依次调用 on_klines_batch / on_trades_batch /
+     *   on_orderbook / on_funding_rate。batch 回调的默认实现逐条调用
+     *   on_kline / on_trade，未重写 batch 回调的策略行为不变
+     *
+     * 注意：batch 模式下回调时 K 线缓冲区和流式指标已包含本轮的所有 K 线
+     *
+     * @return false 未知模式
+     */
+    bool set_dispatch_mode(const std::string& mode) {
+        if (mode == "direct") {
+            batch_dispatch_ = false;
+        } else if (mode == "batch") {
+            batch_dispatch_ = true;
+        } else {
+            log_error("未知的行情分发模式: " + mode + "（可选 direct / batch）");
+            return false;
+        }
+        return true;
+    }
+
+    std::string get_dispatch_mode() const {
+        return batch_dispatch_ ? "batch" : "direct";
+    }
+
+    /**
+     * @brief 启用/关闭行情合并
+     *
+     * 策略处理跟不上行情时，每轮先排空 socket，同一主题的深度快照/ticker 只分发最新一帧；
+     * trades、K线（含已确认 K 线）、资金费率和增量深度仍逐条分发
+     */
+    void set_conflation(bool enabled) {
+        market_data_.set_conflation(enabled);
+    }
+
+    bool get_conflation() const {
+        return market_data_.conflation_enabled();
+    }
+
+    /**
+     * @brief 本策略的行情合并统计
+     */
+    ConflationStats get_conflation_stats() const {
+        return market_data_.conflation_stats();
+    }
+
+    /**
+     * @brief 设置主循环检查 Python 信号（Ctrl-C）的最小间隔（毫秒）
+     */
+    void set_signal_check_interval_ms(int interval_ms) {
+        signal_check_interval_ms_ = std::max(1, interval_ms);
+    }
+
+    /**
+     * @brief 设置 event 模式下的最长等待时间（毫秒），即无消息时 on_tick 的最低调用频率
+     */
+    void set_idle_timeout_ms(int timeout_ms) {
+        idle_timeout_ms_ = std::max(1, timeout_ms);
+    }
+
     /**
      * @brief 手动处理一轮 ZMQ 消息（供 Python 在等待期间调用）
      *
@@ -1124,6 +1355,7 @@ public:
     void poll_messages() {
         // 处理行情数据
         market_data_.process_market_data();
+        flush_market_batch();
         // 处理账户回报（持仓、余额、注册等）
         process_account_reports();
         // 处理订单回报
@@ -1154,6 +1386,34 @@ public:
     virtual void on_trade(const std::string& symbol, const TradeData& trade) {
         (void)symbol; (void)trade;
     }
+
+    /**
+     * @brief 批量 K 线回调（batch 分发模式），默认逐条调用 on_kline
+     */
+    virtual void on_klines_batch(const std::vector<std::tuple<std::string, std::string, KlineBar>>& klines) {
+        for (const auto& k : klines) {
+            on_kline(std::get<0>(k), std::get<1>(k), std::get<2>(k));
+        }
+    }
+
+    /**
+     * @brief 批量 Trades 回调（batch 分发模式），默认逐条调用 on_trade
+     */
+    virtual void on_trades_batch(const std::vector<std::pair<std::string, TradeData>>& trades) {
+        for (const auto& t : trades) {
+            on_trade(t.first, t.second);
+        }
+    }
+
+    /**
+     * @brief 分发一轮缓存的行情（Python 子类在此处一次性获取 GIL）
+     */
+    virtual void dispatch_market_batch(const MarketEventBatch& batch) {
+        if (!batch.klines.empty()) on_klines_batch(batch.klines);
+        if (!batch.trades.empty()) on_trades_batch(batch.trades);
+        for (const auto& o : batch.orderbooks) on_orderbook(o.first, o.second);
+        for (const auto& f : batch.funding_rates) on_funding_rate(f.first, f.second);
+    }
     
     /**
      * @brief OrderBook回调
@@ -1278,10 +1538,12 @@ public:
         const char* redis_host = std::getenv("REDIS_HOST");
         const char* redis_port = std::getenv("REDIS_PORT");
         const char* redis_password = std::getenv("REDIS_PASSWORD");
+        const char* cache_mb = std::getenv("KLINE_CACHE_MB");
 
         if (redis_host) config.host = redis_host;
         if (redis_port) config.port = std::stoi(redis_port);
         if (redis_password) config.password = redis_password;
+        if (cache_mb) config.cache_max_bytes = static_cast<size_t>(std::stoll(cache_mb)) << 20;
 
         historical_data_.set_config(config);
         bool result = historical_data_.connect();
@@ -1416,6 +1678,52 @@ public:
         return historical_data_.get_kline_count(symbol, exchange, interval);
     }
 
+    /**
+     * @brief 批量查询多个币种的历史 K 线（Pipeline，单次Redis往返，并行解析）
+     * @return {symbol: K 线列表} 字典，无数据的币种为空列表
+     */
+    std::map<std::string, std::vector<server::KlineBar>> get_historical_klines_batch(
+        const std::vector<std::string>& symbols,
+        const std::string& exchange,
+        const std::string& interval,
+        int64_t start_time,
+        int64_t end_time
+    ) {
+        auto series = historical_data_.get_klines_batch(symbols, exchange, interval, start_time, end_time);
+        std::map<std::string, std::vector<server::KlineBar>> result;
+        for (size_t i = 0; i < symbols.size(); i++) {
+            result[symbols[i]] = std::move(series[i]);
+        }
+        return result;
+    }
+
+    /**
+     * @brief 批量查询并按时间戳对齐成面板（截面策略一次加载整个币池）
+     */
+    server::KlinePanel get_historical_kline_panel(
+        const std::vector<std::string>& symbols,
+        const std::string& exchange,
+        const std::string& interval,
+        int64_t start_time,
+        int64_t end_time
+    ) {
+        return historical_data_.get_kline_panel(symbols, exchange, interval, start_time, end_time);
+    }
+
+    /**
+     * @brief 历史 K 线缓存统计
+     */
+    server::KlineCacheStats get_historical_cache_stats() const {
+        return historical_data_.get_cache_stats();
+    }
+
+    /**
+     * @brief 清空历史 K 线缓存（补录数据后重新从 Redis 加载）
+     */
+    void clear_historical_cache() {
+        historical_data_.clear_cache();
+    }
+
     /**
      * @brief 批量获取多个币种最新K线时间戳（Pipeline，单次Redis往返，<1ms）
      * @param symbols 交易对列表
@@ -1466,31 +1774,48 @@ protected:
 
 private:
     void setup_callbacks() {
+        // 行情回调：batch 模式下只缓存，由 flush_market_batch 统一分发
         // 设置 K 线回调
         market_data_.set_kline_callback(
             [this](const std::string& symbol, const std::string& interval, const KlineBar& bar) {
-                on_kline(symbol, interval, bar);
+                if (batch_dispatch_) {
+                    pending_batch_.klines.emplace_back(symbol, interval, bar);
+                } else {
+                    on_kline(symbol, interval, bar);
+                }
             }
         );
         
         // 设置 trades 回调
         market_data_.set_trades_callback(
             [this](const std::string& symbol, const TradeData& trade) {
-                on_trade(symbol, trade);
+                if (batch_dispatch_) {
+                    pending_batch_.trades.emplace_back(symbol, trade);
+                } else {
+                    on_trade(symbol, trade);
+                }
             }
         );
         
         // 设置 orderbook 回调
         market_data_.set_orderbook_callback(
             [this](const std::string& symbol, const OrderBookSnapshot& snapshot) {
-                on_orderbook(symbol, snapshot);
+                if (batch_dispatch_) {
+                    pending_batch_.orderbooks.emplace_back(symbol, snapshot);
+                } else {
+                    on_orderbook(symbol, snapshot);
+                }
             }
         );
         
         // 设置 funding_rate 回调
         market_data_.set_funding_rate_callback(
             [this](const std::string& symbol, const FundingRateData& fr) {
-                on_funding_rate(symbol, fr);
+                if (batch_dispatch_) {
+                    pending_batch_.funding_rates.emplace_back(symbol, fr);
+                } else {
+                    on_funding_rate(symbol, fr);
+                }
             }
         );
         
@@ -1515,6 +1840,25 @@ private:
         );
     }
     
+    /**
+     * @brief 分发 batch 模式下缓存的行情
+     *
+     * 先把 pending_batch_ 换到局部变量再分发：回调内调用 poll_messages() 时，
+     * 重入的 process_market_data() 写入的是新的 pending_batch_，嵌套的 flush
+     * 只分发新到的行情，不会在外层遍历期间扩容或清空正在分发的 vector。
+     */
+    void flush_market_batch() {
+        if (pending_batch_.empty()) return;
+        MarketEventBatch batch;
+        batch.swap(pending_batch_);
+        dispatch_market_batch(batch);
+        // 没有重入写入时把容量还回去，稳定状态下不再分配
+        if (pending_batch_.empty()) {
+            batch.clear();
+            batch.swap(pending_batch_);
+        }
+    }
+    
     /**
      * @brief 处理账户回报（需要单独处理，因为共享 report_sub_）
      * 
@@ -1779,6 +2123,13 @@ private:
                  std::to_string(kline_count()) + " | 订单: " +
                  std::to_string(order_count()) + " | 回报: " +
                  std::to_string(report_count()));
+        auto conflation = market_data_.conflation_stats();
+        if (conflation.conflated > 0) {
+            log_info("[退出] 行情合并 " + std::to_string(conflation.conflated) + "/" +
+                     std::to_string(conflation.received) + " 帧（深度: " +
+                     std::to_string(conflation.conflated_orderbooks) + " | ticker: " +
+                     std::to_string(conflation.conflated_tickers) + "）");
+        }
     }
     
     // ============================================================
@@ -1874,6 +2225,56 @@ private:
         return target_ms;
     }
     
+    /**
+     * @brief 计算 event 模式下的等待时间（毫秒）
+     *
+     * 取最早的定时任务、下一次心跳、空闲上限三者中的最小值
+     */
+    int next_wakeup_ms(std::chrono::steady_clock::time_point last_heartbeat_time) const {
+        int64_t timeout = idle_timeout_ms_;
+
+        auto hb_elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - last_heartbeat_time).count();
+        timeout = std::min<int64_t>(timeout, 5000 - hb_elapsed);
+
+        int64_t now_ms = current_timestamp_ms();
+        {
+            std::lock_guard<std::mutex> lock(tasks_mutex_);
+            for (const auto& pair : scheduled_tasks_) {
+                if (pair.second.enabled) {
+                    timeout = std::min(timeout, pair.second.next_run_time_ms - now_ms);
+                }
+            }
+        }
+        return static_cast<int>(std::max<int64_t>(0, timeout));
+    }
+
+    /**
+     * @brief 阻塞等待行情/回报 socket 可读（或超时）
+     *
+     * 共享内存行情无法被 poll 唤醒，启用时只做非阻塞检查并短暂让出 CPU
+     */
+    void wait_for_events(int timeout_ms) {
+        if (!market_sub_ || !report_sub_) return;
+
+        zmq::pollitem_t items[] = {
+            {market_sub_->handle(), 0, ZMQ_POLLIN, 0},
+            {report_sub_->handle(), 0, ZMQ_POLLIN, 0}
+        };
+
+        try {
+            if (shm_market_) {
+                if (zmq::poll(items, 2, std::chrono::milliseconds(0)) == 0) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(20));
+                }
+                return;
+            }
+            zmq::poll(items, 2, std::chrono::milliseconds(timeout_ms));
+        } catch (const zmq::error_t&) {
+            // EINTR（信号）：直接返回，由主循环检查信号
+        }
+    }
+
     /**
      * @brief 处理定时任务（在主循环中调用）
      */
@@ -1994,6 +2395,12 @@ private:
         }
     }
 
+    bool parse_indicator_type(const std::string& name, indicators::IndicatorType& type) const {
+        if (indicators::parse_indicator_type(name, type)) return true;
+        log_error("[指标] 不支持的指标: " + name);
+        return false;
+    }
+
 private:
     // 策略配置
     std::string strategy_id_;
@@ -2006,6 +2413,10 @@ private:
     std::unique_ptr<zmq::socket_t> report_sub_;
     std::unique_ptr<zmq::socket_t> subscribe_push_;
 
+    // 共享内存通道（可选）
+    std::unique_ptr<server::ShmBroadcastReader> shm_market_;
+    std::unique_ptr<server::ShmMpscQueue> shm_order_;
+
     // 三个独立模块
     MarketDataModule market_data_;
     TradingModule trading_;
@@ -2018,6 +2429,15 @@ private:
     std::map<std::string, ScheduledTask> scheduled_tasks_;
     mutable std::mutex tasks_mutex_;
 
+    // 主循环模式
+    std::atomic<bool> busy_spin_{false};   // true: 忙轮询；false: zmq::poll 事件驱动
+    std::atomic<int> idle_timeout_ms_{100}; // event 模式最长等待（毫秒）
+    std::atomic<int> signal_check_interval_ms_{10};  // PyErr_CheckSignals 最小间隔（毫秒）
+
+    // 行情分发
+    std::atomic<bool> batch_dispatch_{false};  // true: 一轮行情缓存后一次性分发
+    MarketEventBatch pending_batch_;
+
     // Python 对象引用（用于直接调用 Python 方法）
     py::object python_self_;
 
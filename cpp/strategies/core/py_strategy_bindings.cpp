@@ -15,6 +15,7 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 #include <pybind11/functional.h>
+#include <pybind11/numpy.h>
 
 #include "py_strategy_base.h"
 
@@ -55,6 +56,108 @@ public:
 }} // namespace pybind11::detail
 
 
+// ============================================================
+// numpy 零拷贝辅助
+// ============================================================
+
+namespace {
+
+constexpr py::ssize_t OHLCV_WIDTH = static_cast<py::ssize_t>(KlineBuffer::COLUMN_COUNT);
+
+/**
+ * @brief 只读 numpy 视图，base 持有底层内存的所有者
+ */
+py::array_t<double> readonly_view(std::vector<py::ssize_t> shape, std::vector<py::ssize_t> strides,
+                                  const double* data, py::handle base) {
+    py::array_t<double> arr(std::move(shape), std::move(strides), data, base);
+    py::detail::array_proxy(arr.ptr())->flags &= ~py::detail::npy_api::NPY_ARRAY_WRITEABLE_;
+    return arr;
+}
+
+/**
+ * @brief KlineBuffer 视图 -> (rows, 6) 数组，列顺序 timestamp/open/high/low/close/volume
+ */
+py::array_t<double> ohlcv_view(const KlineBuffer::ColumnView& view, py::handle base) {
+    const auto stride = static_cast<py::ssize_t>(view.column_stride * sizeof(double));
+    return readonly_view({static_cast<py::ssize_t>(view.rows), OHLCV_WIDTH},
+                         {static_cast<py::ssize_t>(sizeof(double)), stride}, view.data, base);
+}
+
+/**
+ * @brief 从 KlineBuffer 取单列视图（self 为策略对象，保证缓冲区存活）
+ */
+py::array_t<double> kline_column_view(py::object self, const std::string& symbol,
+                                      const std::string& interval, size_t n,
+                                      KlineBuffer::Column column) {
+    KlineBuffer::ColumnView view;
+    if (!self.cast<const PyStrategyBase&>().get_kline_view(symbol, interval, n, view)) {
+        return py::array_t<double>(0);
+    }
+    return readonly_view({static_cast<py::ssize_t>(view.rows)}, {static_cast<py::ssize_t>(sizeof(double))},
+                         view.column(column), self);
+}
+
+/**
+ * @brief 历史 K 线 -> (n, 6) 列式数组（一次遍历写入 numpy 拥有的内存）
+ */
+py::array_t<double> historical_ohlcv_array(const std::vector<server::KlineBar>& bars) {
+    const size_t n = bars.size();
+    std::vector<double> columns(n * KlineBuffer::COLUMN_COUNT);
+    for (size_t i = 0; i < n; ++i) {
+        columns[KlineBuffer::TIMESTAMP * n + i] = static_cast<double>(bars[i].timestamp);
+        columns[KlineBuffer::OPEN * n + i] = bars[i].open;
+        columns[KlineBuffer::HIGH * n + i] = bars[i].high;
+        columns[KlineBuffer::LOW * n + i] = bars[i].low;
+        columns[KlineBuffer::CLOSE * n + i] = bars[i].close;
+        columns[KlineBuffer::VOLUME * n + i] = bars[i].volume;
+    }
+    auto* owned = new std::vector<double>(std::move(columns));
+    py::capsule free_when_done(owned, [](void* p) { delete static_cast<std::vector<double>*>(p); });
+    return py::array_t<double>({static_cast<py::ssize_t>(n), OHLCV_WIDTH},
+                               {static_cast<py::ssize_t>(sizeof(double)), static_cast<py::ssize_t>(n * sizeof(double))},
+                               owned->data(), free_when_done);
+}
+
+/**
+ * @brief KlinePanel 字段 -> (rows, cols) 只读视图，base 为 panel 的 Python 对象
+ */
+py::array_t<double> panel_field(py::object self, std::vector<double> server::KlinePanel::*field) {
+    const auto& panel = self.cast<const server::KlinePanel&>();
+    const auto cols = static_cast<py::ssize_t>(panel.cols());
+    return readonly_view({static_cast<py::ssize_t>(panel.rows()), cols},
+                         {static_cast<py::ssize_t>(cols * sizeof(double)), static_cast<py::ssize_t>(sizeof(double))},
+                         (panel.*field).data(), self);
+}
+
+/**
+ * @brief 指标输入（一维 float64，非连续或其他 dtype 时 pybind11 自动转换拷贝）
+ */
+using IndicatorInput = py::array_t<double, py::array::c_style | py::array::forcecast>;
+
+size_t indicator_length(const IndicatorInput& x) {
+    if (x.ndim() != 1) throw py::value_error("indicator input must be 1-D");
+    return static_cast<size_t>(x.shape(0));
+}
+
+/**
+ * @brief 单序列批量指标，计算期间释放 GIL
+ */
+py::array_t<double> batch_indicator(const IndicatorInput& x, size_t period,
+                                    void (*fn)(const double*, size_t, size_t, double*)) {
+    const size_t n = indicator_length(x);
+    py::array_t<double> out(static_cast<py::ssize_t>(n));
+    const double* in = x.data();
+    double* dst = out.mutable_data();
+    {
+        py::gil_scoped_release release;
+        fn(in, n, period, dst);
+    }
+    return out;
+}
+
+} // namespace
+
+
 // ============================================================
 // PyStrategyBase 的 trampoline 类（允许 Python 继承）
 // ============================================================
@@ -92,6 +195,22 @@ public:
         PYBIND11_OVERRIDE(void, PyStrategyBase, on_trade, symbol, trade);
     }
     
+    void on_klines_batch(const std::vector<std::tuple<std::string, std::string, KlineBar>>& klines) override {
+        py::gil_scoped_acquire gil;
+        PYBIND11_OVERRIDE(void, PyStrategyBase, on_klines_batch, klines);
+    }
+    
+    void on_trades_batch(const std::vector<std::pair<std::string, TradeData>>& trades) override {
+        py::gil_scoped_acquire gil;
+        PYBIND11_OVERRIDE(void, PyStrategyBase, on_trades_batch, trades);
+    }
+    
+    void dispatch_market_batch(const MarketEventBatch& batch) override {
+        // 整批只获取一次 GIL，内部各回调的 gil_scoped_acquire 为重入，不再切换线程状态
+        py::gil_scoped_acquire gil;
+        PyStrategyBase::dispatch_market_batch(batch);
+    }
+    
     void on_orderbook(const std::string& symbol, const OrderBookSnapshot& snapshot) override {
         py::gil_scoped_acquire gil;
         PYBIND11_OVERRIDE(void, PyStrategyBase, on_orderbook, symbol, snapshot);
@@ -162,7 +281,52 @@ PYBIND11_MODULE(strategy_base, m) {
             strategy.register_account(api_key, secret_key, passphrase)
             strategy.run()
     )doc";
-    
+
+    // ==================== 技术指标（批量） ====================
+    auto ind = m.def_submodule("indicators", R"doc(
+        批量技术指标：输入一维数组（如 get_closes_array 的零拷贝视图），
+        返回等长 float64 数组，预热期为 NaN
+
+            from strategy_base import indicators
+            ema = indicators.ema(self.get_closes_array("BTC-USDT-SWAP", "1m"), 20)
+    )doc");
+    ind.def("sma", [](const IndicatorInput& x, size_t period) {
+        return batch_indicator(x, period, &indicators::sma);
+    }, py::arg("x"), py::arg("period"), "简单移动平均");
+    ind.def("ema", [](const IndicatorInput& x, size_t period) {
+        return batch_indicator(x, period, &indicators::ema);
+    }, py::arg("x"), py::arg("period"), "指数移动平均（alpha=2/(period+1)，首值为 SMA）");
+    ind.def("std", [](const IndicatorInput& x, size_t period) {
+        return batch_indicator(x, period, &indicators::rolling_std);
+    }, py::arg("x"), py::arg("period"), "滚动样本标准差（ddof=1）");
+    ind.def("zscore", [](const IndicatorInput& x, size_t period) {
+        return batch_indicator(x, period, &indicators::zscore);
+    }, py::arg("x"), py::arg("period"), "滚动 z-score，标准差为 0 时为 NaN");
+    ind.def("volatility", [](const IndicatorInput& close, size_t period) {
+        return batch_indicator(close, period, &indicators::volatility);
+    }, py::arg("close"), py::arg("period"), "对数收益率的滚动样本标准差（未年化）");
+    ind.def("rsi", [](const IndicatorInput& close, size_t period) {
+        return batch_indicator(close, period, &indicators::rsi);
+    }, py::arg("close"), py::arg("period") = 14, "RSI（Wilder 平滑）");
+    ind.def("atr", [](const IndicatorInput& high, const IndicatorInput& low,
+                      const IndicatorInput& close, size_t period) {
+        const size_t n = indicator_length(close);
+        if (indicator_length(high) != n || indicator_length(low) != n) {
+            throw py::value_error("high/low/close length mismatch");
+        }
+        py::array_t<double> out(static_cast<py::ssize_t>(n));
+        const double* h = high.data();
+        const double* l = low.data();
+        const double* c = close.data();
+        double* dst = out.mutable_data();
+        {
+            py::gil_scoped_release release;
+            indicators::atr(h, l, c, n, period, dst);
+        }
+        return out;
+    }, py::arg("high"), py::arg("low"), py::arg("close"), py::arg("period") = 14,
+       "ATR（Wilder 平滑）");
+
     // ==================== KlineBar ====================
     py::class_<KlineBar>(m, "KlineBar", "K线数据结构")
         .def(py::init<>())
@@ -315,7 +479,72 @@ PYBIND11_MODULE(strategy_base, m) {
                    ", ts=" + std::to_string(k.timestamp) +
                    ", c=" + std::to_string(k.close) + ")";
         });
+
+    py::class_<server::KlinePanel>(m, "HistoricalKlinePanel", R"doc(
+多币种对齐的历史 K 线面板
+
+行 = 所有币种时间戳的并集（升序），列 = symbols。
+open/high/low/close/volume/turnover 为 (rows, cols) 的只读 numpy 数组（直接引用面板内存），
+缺失为 NaN。
+    )doc")
+        .def_readonly("symbols", &server::KlinePanel::symbols, "列（交易对）")
+        .def_property_readonly("timestamps", [](const server::KlinePanel& p) {
+            return py::array_t<int64_t>(static_cast<py::ssize_t>(p.timestamps.size()), p.timestamps.data());
+        }, "行（时间戳，毫秒，int64 数组）")
+        .def_property_readonly("open", [](py::object self) {
+            return panel_field(self, &server::KlinePanel::open);
+        }, "开盘价")
+        .def_property_readonly("high", [](py::object self) {
+            return panel_field(self, &server::KlinePanel::high);
+        }, "最高价")
+        .def_property_readonly("low", [](py::object self) {
+            return panel_field(self, &server::KlinePanel::low);
+        }, "最低价")
+        .def_property_readonly("close", [](py::object self) {
+            return panel_field(self, &server::KlinePanel::close);
+        }, "收盘价")
+        .def_property_readonly("volume", [](py::object self) {
+            return panel_field(self, &server::KlinePanel::volume);
+        }, "成交量")
+        .def_property_readonly("turnover", [](py::object self) {
+            return panel_field(self, &server::KlinePanel::turnover);
+        }, "成交额")
+        .def_property_readonly("rows", &server::KlinePanel::rows, "行数（时间戳个数）")
+        .def_property_readonly("cols", &server::KlinePanel::cols, "列数（交易对个数）")
+        .def("__repr__", [](const server::KlinePanel& p) {
+            return "HistoricalKlinePanel(rows=" + std::to_string(p.rows()) +
+                   ", cols=" + std::to_string(p.cols()) + ")";
+        });
+
+    py::class_<server::KlineCacheStats>(m, "HistoricalCacheStats", "历史 K 线缓存统计")
+        .def_readonly("hits", &server::KlineCacheStats::hits, "完全命中次数")
+        .def_readonly("partial_hits", &server::KlineCacheStats::partial_hits, "部分命中（补取头部/尾部）次数")
+        .def_readonly("misses", &server::KlineCacheStats::misses, "未命中次数")
+        .def_readonly("evictions", &server::KlineCacheStats::evictions, "LRU 淘汰次数")
+        .def_readonly("entries", &server::KlineCacheStats::entries, "缓存条目数")
+        .def_readonly("bytes", &server::KlineCacheStats::bytes, "估算内存占用（字节）")
+        .def_readonly("max_bytes", &server::KlineCacheStats::max_bytes, "内存上限（字节）")
+        .def_property_readonly("hit_rate", &server::KlineCacheStats::hit_rate, "命中率")
+        .def("__repr__", [](const server::KlineCacheStats& s) {
+            return "HistoricalCacheStats(hits=" + std::to_string(s.hits) +
+                   ", partial=" + std::to_string(s.partial_hits) +
+                   ", misses=" + std::to_string(s.misses) +
+                   ", entries=" + std::to_string(s.entries) +
+                   ", bytes=" + std::to_string(s.bytes) + ")";
+        });
     
+    py::class_<ConflationStats>(m, "ConflationStats", "行情合并统计")
+        .def_readonly("enabled", &ConflationStats::enabled, "是否启用合并")
+        .def_readonly("received", &ConflationStats::received, "合并模式下收到的帧数")
+        .def_readonly("conflated", &ConflationStats::conflated, "被同主题新帧覆盖而丢弃的帧数")
+        .def_readonly("conflated_orderbooks", &ConflationStats::conflated_orderbooks, "丢弃的深度快照数")
+        .def_readonly("conflated_tickers", &ConflationStats::conflated_tickers, "丢弃的 ticker 数")
+        .def("__repr__", [](const ConflationStats& s) {
+            return "ConflationStats(enabled=" + std::string(s.enabled ? "True" : "False") +
+                   ", received=" + std::to_string(s.received) +
+                   ", conflated=" + std::to_string(s.conflated) + ")";
+        });
+
     // ==================== StrategyBase ====================
     py::class_<PyStrategyBase, PyStrategyTrampoline>(m, "StrategyBase", R"doc(
         策略基类
@@ -391,6 +620,11 @@ Args:
         - "books-l2-tbt": 400档，推送频率10ms
         - "books50-l2-tbt": 50档，推送频率10ms
         - "books-elp": 增强限价单深度
+
+Note:
+    books / books-l2-tbt / books50-l2-tbt / books-elp 为增量频道，服务端维护本地订单簿
+    （seqId 与 checksum 校验，失败自动重新同步），前 N 档（SEQ_BOOK_PUBLISH_DEPTH，默认 20）
+    变化时推送完整快照
              )doc")
         .def("unsubscribe_orderbook", &PyStrategyBase::unsubscribe_orderbook,
              py::arg("symbol"), py::arg("channel") = "books5",
@@ -424,6 +658,84 @@ Args:
         .def("get_recent_klines", &PyStrategyBase::get_recent_klines,
              py::arg("symbol"), py::arg("interval"), py::arg("n"),
              "获取最近n根K线")
+        
+        // K线数据 numpy 视图（零拷贝，只读）
+        .def("get_ohlcv_array", [](py::object self, const std::string& symbol,
+                                   const std::string& interval, size_t n) {
+            KlineBuffer::ColumnView view;
+            if (!self.cast<const PyStrategyBase&>().get_kline_view(symbol, interval, n, view)) {
+                return py::array_t<double>(std::vector<py::ssize_t>{0, OHLCV_WIDTH});
+            }
+            return ohlcv_view(view, self);
+        }, py::arg("symbol"), py::arg("interval"), py::arg("n") = 0,
+           R"doc(
+获取最近 n 根 K 线的 (n, 6) numpy 只读视图（n=0 表示全部），不拷贝数据
+
+列顺序: timestamp, open, high, low, close, volume
+
+Note:
+    视图直接引用 K 线缓冲区：最后一根 K 线会原地更新，收到新 K 线后内容失效，
+    需要跨回调保留时请使用 .copy()
+             )doc")
+        .def("get_closes_array", [](py::object self, const std::string& symbol,
+                                    const std::string& interval, size_t n) {
+            return kline_column_view(self, symbol, interval, n, KlineBuffer::CLOSE);
+        }, py::arg("symbol"), py::arg("interval"), py::arg("n") = 0,
+           "收盘价 numpy 只读视图（零拷贝，有效期同 get_ohlcv_array）")
+        .def("get_opens_array", [](py::object self, const std::string& symbol,
+                                   const std::string& interval, size_t n) {
+            return kline_column_view(self, symbol, interval, n, KlineBuffer::OPEN);
+        }, py::arg("symbol"), py::arg("interval"), py::arg("n") = 0,
+           "开盘价 numpy 只读视图（零拷贝，有效期同 get_ohlcv_array）")
+        .def("get_highs_array", [](py::object self, const std::string& symbol,
+                                   const std::string& interval, size_t n) {
+            return kline_column_view(self, symbol, interval, n, KlineBuffer::HIGH);
+        }, py::arg("symbol"), py::arg("interval"), py::arg("n") = 0,
+           "最高价 numpy 只读视图（零拷贝，有效期同 get_ohlcv_array）")
+        .def("get_lows_array", [](py::object self, const std::string& symbol,
+                                  const std::string& interval, size_t n) {
+            return kline_column_view(self, symbol, interval, n, KlineBuffer::LOW);
+        }, py::arg("symbol"), py::arg("interval"), py::arg("n") = 0,
+           "最低价 numpy 只读视图（零拷贝，有效期同 get_ohlcv_array）")
+        .def("get_volumes_array", [](py::object self, const std::string& symbol,
+                                     const std::string& interval, size_t n) {
+            return kline_column_view(self, symbol, interval, n, KlineBuffer::VOLUME);
+        }, py::arg("symbol"), py::arg("interval"), py::arg("n") = 0,
+           "成交量 numpy 只读视图（零拷贝，有效期同 get_ohlcv_array）")
+        .def("get_timestamps_array", [](py::object self, const std::string& symbol,
+                                        const std::string& interval, size_t n) {
+            return kline_column_view(self, symbol, interval, n, KlineBuffer::TIMESTAMP);
+        }, py::arg("symbol"), py::arg("interval"), py::arg("n") = 0,
+           "时间戳（毫秒，float64）numpy 只读视图（零拷贝，有效期同 get_ohlcv_array）")
+        
+        // 技术指标
+        .def("compute_indicator", [](const PyStrategyBase& self, const std::string& symbol,
+                                     const std::string& interval, const std::string& name,
+                                     size_t period) {
+            auto* values = new std::vector<double>();
+            py::capsule free_when_done(values, [](void* p) { delete static_cast<std::vector<double>*>(p); });
+            self.compute_indicator(symbol, interval, name, period, *values);
+            return py::array_t<double>({static_cast<py::ssize_t>(values->size())},
+                                       {static_cast<py::ssize_t>(sizeof(double))},
+                                       values->data(), free_when_done);
+        }, py::arg("symbol"), py::arg("interval"), py::arg("name"), py::arg("period"),
+           R"doc(
+对 K 线缓冲区整段计算指标（直接读取缓冲区，不拷贝输入），返回与缓冲区等长的数组，预热期为 NaN
+
+name: sma / ema / std / zscore / volatility / rsi / atr
+             )doc")
+        .def("add_indicator", &PyStrategyBase::add_indicator,
+             py::arg("symbol"), py::arg("interval"), py::arg("name"), py::arg("period"),
+             R"doc(
+注册流式指标：用已缓存的 K 线预热，之后每根 K 线在 on_kline 之前 O(1) 更新
+（同一时间戳的重复推送按修正处理），通过 get_indicator 读取当前值
+             )doc")
+        .def("remove_indicator", &PyStrategyBase::remove_indicator,
+             py::arg("symbol"), py::arg("interval"), py::arg("name"), py::arg("period"),
+             "注销流式指标")
+        .def("get_indicator", &PyStrategyBase::get_indicator,
+             py::arg("symbol"), py::arg("interval"), py::arg("name"), py::arg("period"),
+             "流式指标当前值，未注册或预热中返回 NaN")
         .def("get_last_kline", [](const PyStrategyBase& self, 
                                   const std::string& symbol, 
                                   const std::string& interval) -> py::object {
@@ -711,6 +1023,9 @@ Returns:
              )doc")
         .def("unregister_account", &PyStrategyBase::unregister_account,
              "注销账户")
+        .def("set_order_route", &PyStrategyBase::set_order_route,
+             py::arg("route"),
+             "设置订单通道（在注册账户前调用）：'ws' 经交易所 WebSocket 下单（REST 兜底），'rest' 仅 REST")
         .def("is_account_registered", &PyStrategyBase::is_account_registered,
              "账户是否已注册")
         
@@ -940,6 +1255,71 @@ Returns:
     K 线数量
              )doc")
 
+        .def("get_historical_ohlcv_array", [](PyStrategyBase& self, const std::string& symbol,
+                                              const std::string& exchange, const std::string& interval,
+                                              int64_t start_time, int64_t end_time) {
+            std::vector<server::KlineBar> bars;
+            {
+                py::gil_scoped_release release;
+                bars = self.get_historical_klines(symbol, exchange, interval, start_time, end_time);
+            }
+            return historical_ohlcv_array(bars);
+        }, py::arg("symbol"), py::arg("exchange"), py::arg("interval"),
+           py::arg("start_time"), py::arg("end_time"),
+           R"doc(
+查询历史 K 线并以 (n, 6) numpy 数组返回（不创建逐根 HistoricalKline 对象）
+
+列顺序: timestamp, open, high, low, close, volume（与 get_ohlcv_array 一致）
+             )doc")
+
+        .def("get_historical_klines_batch", &PyStrategyBase::get_historical_klines_batch,
+             py::arg("symbols"), py::arg("exchange"), py::arg("interval"),
+             py::arg("start_time"), py::arg("end_time"),
+             py::call_guard<py::gil_scoped_release>(),
+             R"doc(
+批量查询多个币种的历史 K 线（Redis Pipeline，单次往返，并行解析）
+
+Args:
+    symbols: 交易对列表
+    exchange: 交易所
+    interval: 时间周期
+    start_time: 开始时间戳（毫秒）
+    end_time: 结束时间戳（毫秒）
+
+Returns:
+    dict: {symbol: [HistoricalKline, ...]}，无数据的币种为空列表
+             )doc")
+        .def("get_historical_kline_panel", &PyStrategyBase::get_historical_kline_panel,
+             py::arg("symbols"), py::arg("exchange"), py::arg("interval"),
+             py::arg("start_time"), py::arg("end_time"),
+             py::call_guard<py::gil_scoped_release>(),
+             R"doc(
+批量查询并按时间戳对齐成面板（截面策略一次加载整个币池）
+
+Args:
+    symbols: 交易对列表
+    exchange: 交易所
+    interval: 时间周期
+    start_time: 开始时间戳（毫秒）
+    end_time: 结束时间戳（毫秒）
+
+Returns:
+    HistoricalKlinePanel（rows x cols，缺失为 NaN）
+             )doc")
+
+        .def("get_historical_cache_stats", &PyStrategyBase::get_historical_cache_stats,
+             R"doc(
+获取历史 K 线缓存统计
+
+Returns:
+    HistoricalCacheStats（hits/partial_hits/misses/evictions/entries/bytes/hit_rate）
+
+Note:
+    缓存上限由环境变量 KLINE_CACHE_MB 设置（默认 256，0 禁用）
+             )doc")
+        .def("clear_historical_cache", &PyStrategyBase::clear_historical_cache,
+             "清空历史 K 线缓存（补录历史数据后调用，下次查询重新从 Redis 加载）")
+
         .def("batch_get_latest_kline_timestamps", &PyStrategyBase::batch_get_latest_kline_timestamps,
              py::arg("symbols"), py::arg("exchange"), py::arg("interval"),
              R"doc(
@@ -986,6 +1366,32 @@ Returns:
         .def("run", &PyStrategyBase::run, py::call_guard<py::gil_scoped_release>(),
              "运行策略（主循环）")
         .def("stop", &PyStrategyBase::stop, "停止策略")
+        .def("set_loop_mode", &PyStrategyBase::set_loop_mode, py::arg("mode"),
+             "设置主循环模式: 'event'（默认，事件驱动）或 'spin'（忙轮询，最低延迟）")
+        .def("get_loop_mode", &PyStrategyBase::get_loop_mode, "获取主循环模式")
+        .def("set_idle_timeout_ms", &PyStrategyBase::set_idle_timeout_ms, py::arg("timeout_ms"),
+             "设置 event 模式无消息时的最长等待（毫秒），默认 100")
+        .def("set_dispatch_mode", &PyStrategyBase::set_dispatch_mode, py::arg("mode"),
+             R"doc(
+设置行情回调分发模式: 'direct'（默认，逐条回调）或 'batch'
+
+batch 模式下每轮行情在释放 GIL 的状态下解码缓存，之后只获取一次 GIL，
+依次调用 on_klines_batch / on_trades_batch / on_orderbook / on_funding_rate
+             )doc")
+        .def("get_dispatch_mode", &PyStrategyBase::get_dispatch_mode, "获取行情回调分发模式")
+        .def("set_conflation", &PyStrategyBase::set_conflation, py::arg("enabled"),
+             R"doc(
+启用/关闭行情合并（也可通过环境变量 SEQ_MARKET_CONFLATE=1 启用）
+
+策略处理跟不上行情时，每轮先排空行情 socket，同一主题
+（exchange.type.symbol，深度再区分 channel）的深度快照和 ticker 只分发最新一帧；
+trades、K线、资金费率和增量深度仍逐条分发。统计见 get_conflation_stats()
+             )doc")
+        .def("get_conflation", &PyStrategyBase::get_conflation, "是否启用行情合并")
+        .def("get_conflation_stats", &PyStrategyBase::get_conflation_stats, "获取本策略的行情合并统计")
+        .def("set_signal_check_interval_ms", &PyStrategyBase::set_signal_check_interval_ms,
+             py::arg("interval_ms"),
+             "设置主循环检查 Ctrl-C 等 Python 信号的最小间隔（毫秒），默认 10")
         .def("poll_messages", &PyStrategyBase::poll_messages,
              py::call_guard<py::gil_scoped_release>(),
              "手动处理一轮ZMQ消息（在等待期间调用，避免sleep阻塞主循环）")
@@ -1000,6 +1406,12 @@ Returns:
         .def("on_trade", &PyStrategyBase::on_trade,
              py::arg("symbol"), py::arg("trade"),
              "逐笔成交回调")
+        .def("on_klines_batch", &PyStrategyBase::on_klines_batch,
+             py::arg("klines"),
+             "批量K线回调（batch 分发模式），参数为 [(symbol, interval, bar), ...]，默认逐条调用 on_kline")
+        .def("on_trades_batch", &PyStrategyBase::on_trades_batch,
+             py::arg("trades"),
+             "批量逐笔成交回调（batch 分发模式），参数为 [(symbol, trade), ...]，默认逐条调用 on_trade")
         .def("on_orderbook", &PyStrategyBase::on_orderbook,
              py::arg("symbol"), py::arg("snapshot"),
              "深度数据回调")
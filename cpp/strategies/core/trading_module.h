@@ -27,6 +27,8 @@
 #include <zmq.hpp>
 #include <nlohmann/json.hpp>
 
+#include "../../network/shm_ring.h"
+
 namespace trading {
 
 // ============================================================
@@ -122,6 +124,13 @@ public:
         order_push_ = order_push;
         report_sub_ = report_sub;
     }
+
+    /**
+     * @brief 设置共享内存订单队列（可选，nullptr 表示只用 ZMQ）
+     */
+    void set_shm_order_queue(trading::server::ShmMpscQueue* queue) {
+        shm_order_ = queue;
+    }
     
     /**
      * @brief 设置日志回调
@@ -170,8 +179,9 @@ public:
 
         try {
             int64_t send_ts = current_timestamp_ns();
+            order["send_ts_ns"] = send_ts;
             std::string msg = order.dump();
-            order_push_->send(zmq::buffer(msg), zmq::send_flags::none);
+            push_order(msg);
             order_count_++;
 
             // 记录活跃订单
@@ -243,8 +253,9 @@ public:
 
         try {
             int64_t send_ts = current_timestamp_ns();
+            order["send_ts_ns"] = send_ts;
             std::string msg = order.dump();
-            order_push_->send(zmq::buffer(msg), zmq::send_flags::none);
+            push_order(msg);
             order_count_++;
 
             // 记录活跃订单
@@ -306,8 +317,9 @@ public:
 
         try {
             int64_t send_ts = current_timestamp_ns();
+            order["send_ts_ns"] = send_ts;
             std::string msg = order.dump();
-            order_push_->send(zmq::buffer(msg), zmq::send_flags::none);
+            push_order(msg);
             order_count_++;
 
             // 记录活跃订单
@@ -368,8 +380,9 @@ public:
         };
 
         try {
+            order["send_ts_ns"] = current_timestamp_ns();
             std::string msg = order.dump();
-            order_push_->send(zmq::buffer(msg), zmq::send_flags::none);
+            push_order(msg);
             order_count_++;
 
             // 记录活跃订单
@@ -436,8 +449,9 @@ public:
 
         try {
             int64_t send_ts = current_timestamp_ns();
+            order["send_ts_ns"] = send_ts;
             std::string msg = order.dump();
-            order_push_->send(zmq::buffer(msg), zmq::send_flags::none);
+            push_order(msg);
             order_count_++;
 
             // 记录活跃订单
@@ -503,8 +517,9 @@ public:
         };
 
         try {
+            order["send_ts_ns"] = current_timestamp_ns();
             std::string msg = order.dump();
-            order_push_->send(zmq::buffer(msg), zmq::send_flags::none);
+            push_order(msg);
             order_count_++;
 
             // 记录活跃订单
@@ -598,8 +613,9 @@ public:
         }
         
         try {
+            order["send_ts_ns"] = current_timestamp_ns();
             std::string msg = order.dump();
-            order_push_->send(zmq::buffer(msg), zmq::send_flags::none);
+            push_order(msg);
             order_count_++;
             
             // 记录活跃订单
@@ -694,8 +710,9 @@ public:
         }
         
         try {
+            order["send_ts_ns"] = current_timestamp_ns();
             std::string msg = order.dump();
-            order_push_->send(zmq::buffer(msg), zmq::send_flags::none);
+            push_order(msg);
             order_count_++;
             
             // 记录活跃订单
@@ -771,8 +788,9 @@ public:
         }
         
         try {
+            order["send_ts_ns"] = current_timestamp_ns();
             std::string msg = order.dump();
-            order_push_->send(zmq::buffer(msg), zmq::send_flags::none);
+            push_order(msg);
             order_count_++;
             
             // 记录活跃订单
@@ -894,8 +912,9 @@ public:
         }
 
         try {
+            batch_request["send_ts_ns"] = current_timestamp_ns();
             std::string msg = batch_request.dump();
-            order_push_->send(zmq::buffer(msg), zmq::send_flags::none);
+            push_order(msg);
             order_count_ += orders.size();
 
             log_info("[批量下单] 提交 " + std::to_string(orders.size()) + " 个订单到 " + exchange);
@@ -930,8 +949,9 @@ public:
         };
 
         try {
+            request["send_ts_ns"] = current_timestamp_ns();
             std::string msg = request.dump();
-            order_push_->send(zmq::buffer(msg), zmq::send_flags::none);
+            push_order(msg);
             log_info("[杠杆调整] 发送请求: " + symbol + " -> " + std::to_string(leverage) + "x");
             return true;
         } catch (const std::exception& e) {
@@ -958,8 +978,9 @@ public:
         };
         
         try {
+            cancel_req["send_ts_ns"] = current_timestamp_ns();
             std::string msg = cancel_req.dump();
-            order_push_->send(zmq::buffer(msg), zmq::send_flags::none);
+            push_order(msg);
             log_info("[撤单] " + symbol + " 订单ID: " + client_order_id);
             return true;
         } catch (const std::exception& e) {
@@ -985,8 +1006,9 @@ public:
         };
         
         try {
+            cancel_req["send_ts_ns"] = current_timestamp_ns();
             std::string msg = cancel_req.dump();
-            order_push_->send(zmq::buffer(msg), zmq::send_flags::none);
+            push_order(msg);
             log_info("[撤销全部] " + (symbol.empty() ? "所有订单" : symbol));
             return true;
         } catch (const std::exception& e) {
@@ -1286,9 +1308,10 @@ private:
         ).count();
     }
     
+    // system_clock：与服务端 current_timestamp_ns() 同一时钟源，可跨进程比较
     static int64_t current_timestamp_ns() {
         return std::chrono::duration_cast<std::chrono::nanoseconds>(
-            std::chrono::high_resolution_clock::now().time_since_epoch()
+            std::chrono::system_clock::now().time_since_epoch()
         ).count();
     }
     
@@ -1308,12 +1331,35 @@ private:
         }
     }
 
+    /**
+     * @brief 发送订单通道消息（共享内存优先，失败后回退 ZMQ）
+     *
+     * 一旦回退（服务端心跳超时、队列满、消息过大或槽位被跳过），之后一律走 ZMQ：
+     * 同一策略的订单只走一条通道，服务端按队列排空后再读 ZMQ 的顺序处理，不会乱序
+     */
+    void push_order(const std::string& msg) {
+        if (shm_order_) {
+            if (!shm_order_->consumer_alive()) {
+                std::cerr << "[Trading] 共享内存订单队列心跳超时，回退到 ZMQ" << std::endl;
+                shm_order_->disable_push();
+                shm_order_ = nullptr;
+            } else if (shm_order_->try_push(msg.data(), msg.size())) {
+                return;
+            } else {
+                std::cerr << "[Trading] 共享内存订单队列写入失败（队列满/消息过大/槽位超时），回退到 ZMQ" << std::endl;
+                shm_order_ = nullptr;
+            }
+        }
+        order_push_->send(zmq::buffer(msg), zmq::send_flags::none);
+    }
+
 private:
     std::string strategy_id_;
     
     // ZMQ sockets
     zmq::socket_t* order_push_ = nullptr;
     zmq::socket_t* report_sub_ = nullptr;
+    trading::server::ShmMpscQueue* shm_order_ = nullptr;  // 共享内存订单队列（可选）
     
     // 订单管理
     std::map<std::string, OrderInfo> active_orders_;
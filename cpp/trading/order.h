@@ -53,7 +53,7 @@ enum class OrderState {
  */
 class Order : public Event {
 public:
-    using Ptr = std::shared_ptr<Order>;
+    using Ptr = IntrusivePtr<Order>;
     
     // 订单ID生成器（全局唯一）
     static int64_t next_order_id() {
@@ -153,7 +153,7 @@ public:
         double price,
         const std::string& exchange = "okx"
     ) {
-        return std::make_shared<Order>(symbol, OrderType::LIMIT, side, quantity, price, exchange);
+        return make_event<Order>(symbol, OrderType::LIMIT, side, quantity, price, exchange);
     }
     
     static Ptr create_market_order(
@@ -162,7 +162,7 @@ public:
         double quantity,
         const std::string& exchange = "okx"
     ) {
-        return std::make_shared<Order>(symbol, OrderType::MARKET, side, quantity, 0.0, exchange);
+        return make_event<Order>(symbol, OrderType::MARKET, side, quantity, 0.0, exchange);
     }
     
     static Ptr buy_limit(const std::string& symbol, double quantity, double price) {
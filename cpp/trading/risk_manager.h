@@ -20,12 +20,16 @@
 #include <cstdlib>
 #include <filesystem>
 #include <fstream>
+#include <chrono>
+#include <memory>
+#include <vector>
 #include <deque>
 #include <iostream>
 #include <nlohmann/json.hpp>
 #include "data.h"
 #include "order.h"
 #include "logger.h"
+#include "id_interner.h"
 
 namespace trading {
 
@@ -367,14 +371,97 @@ struct RiskCheckResult {
     }
 };
 
+/**
+ * @brief 无锁令牌桶（GCRA 实现，状态为单个原子变量）
+ *
+ * 每 period 补充 limit 个令牌、桶容量 limit：任意 period 窗口内最多通过 limit 次。
+ * 状态只有“理论到达时间”（TAT），try_acquire() 为一次 CAS，不分配内存。
+ */
+class TokenBucket {
+public:
+    /**
+     * @brief 尝试取一个令牌
+     * @param limit 每个周期的令牌数（<= 0 时总是失败）
+     * @param period_ns 周期（纳秒）
+     * @param now_ns 当前 steady_clock 时间（纳秒）
+     */
+    bool try_acquire(int limit, int64_t period_ns, int64_t now_ns) {
+        if (limit <= 0) {
+            return false;
+        }
+        const int64_t interval = period_ns / limit;
+        const int64_t tolerance = period_ns - interval;
+
+        int64_t tat = tat_.load(std::memory_order_relaxed);
+        while (true) {
+            int64_t base = tat > now_ns ? tat : now_ns;
+            if (base - now_ns > tolerance) {
+                return false;
+            }
+            if (tat_.compare_exchange_weak(tat, base + interval, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+    }
+
+    /**
+     * @brief 归还一个令牌（多级限流中后一级失败时回滚前一级）
+     */
+    void release(int limit, int64_t period_ns) {
+        if (limit > 0) {
+            tat_.fetch_sub(period_ns / limit, std::memory_order_relaxed);
+        }
+    }
+
+    void reset() {
+        tat_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<int64_t> tat_{0};
+};
+
 /**
  * @brief 风险管理器
+ *
+ * 热路径（check_order_with_value）无锁、不分配内存：
+ * - 风控限制为不可变快照，set_limits() 整体替换指针（RCU），读者一次 acquire 读取；
+ *   旧快照在宽限期（LIMITS_GRACE_PERIOD_NS）过后由下一次 set_limits() 回收
+ * - symbol / strategy_id 驻留为整数ID，持仓和计数存放在预分配的原子槽位中
+ * - 总敞口随 update_position() 增量维护，不再遍历持仓
+ * - 频率限制为每秒/每分钟两个令牌桶，检查通过即扣除令牌（检查与计数原子完成）
+ *
+ * 只有拒单路径（拼接原因、发送告警）和回撤/联系人等低频接口会加锁或分配内存。
  */
 class RiskManager {
 public:
+    static constexpr size_t MAX_SYMBOLS = 4096;     // 可跟踪持仓的品种数上限
+    static constexpr size_t MAX_STRATEGIES = 1024;  // 可单独计数的策略数上限
+    // 被替换的风控快照至少保留这么久才释放；读者只在单次调用内持有快照引用
+    static constexpr int64_t LIMITS_GRACE_PERIOD_NS = 60LL * 1000000000LL;
+
+    /**
+     * @brief 单个策略的风控计数
+     */
+    struct StrategyCounters {
+        uint64_t checks = 0;   // 风控检查次数
+        uint64_t rejects = 0;  // 被拒次数
+    };
+
     RiskManager(const RiskLimits& limits = RiskLimits(),
                 const AlertConfig& alert_config = AlertConfig())
-        : limits_(limits), kill_switch_(false), alert_service_(alert_config) {}
+        : kill_switch_(false),
+          positions_(new std::atomic<double>[MAX_SYMBOLS]),
+          strategy_counters_(new CounterSlot[MAX_STRATEGIES]),
+          alert_service_(alert_config) {
+        for (size_t i = 0; i < MAX_SYMBOLS; ++i) {
+            positions_[i].store(0.0, std::memory_order_relaxed);
+        }
+        publish_limits(limits);
+    }
+
+    RiskManager(const RiskManager&) = delete;
+    RiskManager& operator=(const RiskManager&) = delete;
 
     /**
      * @brief 订单前置风险检查
@@ -391,6 +478,8 @@ public:
     /**
      * @brief 订单前置风险检查（指定订单金额，避免OKX张数/Binance币数计算问题）
      * @param strategy_id 策略ID，用于风控告警时发送到对应策略邮箱
+     *
+     * 通过时同时占用一次频率配额，无需再单独加锁计数
      */
     RiskCheckResult check_order_with_value(const std::string& symbol,
                                             OrderSide side,
@@ -398,68 +487,74 @@ public:
                                             double quantity,
                                             double order_value,
                                             const std::string& strategy_id = "") {
-        std::lock_guard<std::mutex> lock(mutex_);
+        (void)price;
+        const RiskLimits& limits = *limits_ptr_.load(std::memory_order_acquire);
+
+        CounterSlot* counters = nullptr;
+        if (!strategy_id.empty()) {
+            int sid = strategy_ids_.intern(strategy_id);
+            if (sid >= 0) {
+                counters = &strategy_counters_[sid];
+                counters->checks.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
 
         // Kill Switch 检查
-        if (kill_switch_) {
-            return RiskCheckResult::reject("Kill switch activated");
+        if (kill_switch_.load(std::memory_order_acquire)) {
+            return reject(counters, strategy_id, "Kill switch activated", nullptr);
         }
 
         // 订单金额检查（使用传入的 order_value）
-        if (order_value > limits_.max_order_value) {
-            std::string reason = "Order value " + std::to_string(order_value) +
-                                " exceeds limit " + std::to_string(limits_.max_order_value);
-            // 发送风控告警到策略邮箱
-            send_risk_alert_to_strategy(strategy_id, reason, "订单金额超限");
-            return RiskCheckResult::reject(reason);
+        if (order_value > limits.max_order_value) {
+            return reject(counters, strategy_id,
+                          "Order value " + std::to_string(order_value) +
+                          " exceeds limit " + std::to_string(limits.max_order_value),
+                          "订单金额超限");
         }
 
         // 订单数量检查
-        if (quantity > limits_.max_order_quantity) {
-            std::string reason = "Order quantity " + std::to_string(quantity) +
-                                " exceeds limit " + std::to_string(limits_.max_order_quantity);
-            send_risk_alert_to_strategy(strategy_id, reason, "订单数量超限");
-            return RiskCheckResult::reject(reason);
+        if (quantity > limits.max_order_quantity) {
+            return reject(counters, strategy_id,
+                          "Order quantity " + std::to_string(quantity) +
+                          " exceeds limit " + std::to_string(limits.max_order_quantity),
+                          "订单数量超限");
         }
 
         // 挂单数量检查
-        if (open_order_count_ >= limits_.max_open_orders) {
-            std::string reason = "Open orders " + std::to_string(open_order_count_) +
-                                " exceeds limit " + std::to_string(limits_.max_open_orders);
-            send_risk_alert_to_strategy(strategy_id, reason, "挂单数量超限");
-            return RiskCheckResult::reject(reason);
+        int open_orders = open_order_count_.load(std::memory_order_relaxed);
+        if (open_orders >= limits.max_open_orders) {
+            return reject(counters, strategy_id,
+                          "Open orders " + std::to_string(open_orders) +
+                          " exceeds limit " + std::to_string(limits.max_open_orders),
+                          "挂单数量超限");
         }
 
         // 持仓限制检查
         double current_position = get_position_value(symbol);
         double new_position = current_position + (side == OrderSide::BUY ? order_value : -order_value);
 
-        if (std::abs(new_position) > limits_.max_position_value) {
-            std::string reason = "Position value would exceed limit for " + symbol;
-            send_risk_alert_to_strategy(strategy_id, reason, "持仓限制超限");
-            return RiskCheckResult::reject(reason);
+        if (std::abs(new_position) > limits.max_position_value) {
+            return reject(counters, strategy_id,
+                          "Position value would exceed limit for " + symbol,
+                          "持仓限制超限");
         }
 
         // 总敞口检查
-        double total_exposure = calculate_total_exposure();
-        if (total_exposure + order_value > limits_.max_total_exposure) {
-            std::string reason = "Total exposure would exceed limit";
-            send_risk_alert_to_strategy(strategy_id, reason, "总敞口超限");
-            return RiskCheckResult::reject(reason);
+        if (calculate_total_exposure() + order_value > limits.max_total_exposure) {
+            return reject(counters, strategy_id, "Total exposure would exceed limit", "总敞口超限");
         }
 
         // 单日亏损检查
-        if (daily_pnl_ < -limits_.daily_loss_limit) {
-            std::string reason = "Daily loss limit reached: " + std::to_string(daily_pnl_);
-            send_risk_alert_to_strategy(strategy_id, reason, "单日亏损超限");
-            return RiskCheckResult::reject(reason);
+        double daily_pnl = daily_pnl_.load(std::memory_order_relaxed);
+        if (daily_pnl < -limits.daily_loss_limit) {
+            return reject(counters, strategy_id,
+                          "Daily loss limit reached: " + std::to_string(daily_pnl),
+                          "单日亏损超限");
         }
 
-        // 频率限制检查
-        if (!check_rate_limit()) {
-            std::string reason = "Order rate limit exceeded";
-            send_risk_alert_to_strategy(strategy_id, reason, "订单频率超限");
-            return RiskCheckResult::reject(reason);
+        // 频率限制检查（放在最后：通过即扣除令牌）
+        if (!acquire_rate_tokens(limits)) {
+            return reject(counters, strategy_id, "Order rate limit exceeded", "订单频率超限");
         }
 
         return RiskCheckResult::ok();
@@ -469,24 +564,27 @@ public:
      * @brief 更新持仓
      */
     void update_position(const std::string& symbol, double value) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        position_values_[symbol] = value;
+        int id = symbol_ids_.intern(symbol);
+        if (id < 0) {
+            std::cerr << "[风控] 品种数超过上限 " << MAX_SYMBOLS << "，忽略持仓: " << symbol << "\n";
+            return;
+        }
+        double old_value = positions_[id].exchange(value, std::memory_order_relaxed);
+        atomic_add(total_exposure_, std::abs(value) - std::abs(old_value));
     }
 
     /**
      * @brief 更新挂单数量
      */
     void set_open_order_count(int count) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        open_order_count_ = count;
+        open_order_count_.store(count, std::memory_order_relaxed);
     }
 
     /**
      * @brief 更新每日盈亏（仅用于统计，不触发Kill Switch）
      */
     void update_daily_pnl(double pnl) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        daily_pnl_ = pnl;
+        daily_pnl_.store(pnl, std::memory_order_relaxed);
         // 注意：这里不检查回撤，因为 pnl 可能是未实现盈亏（负数）
         // 回撤检查应该使用账户总权益，见 update_account_equity()
     }
@@ -503,6 +601,8 @@ public:
             return;  // 必须提供策略ID
         }
 
+        const RiskLimits& limits = this->limits();
+
         // 获取当前日期
         auto now = std::chrono::system_clock::now();
         auto now_time_t = std::chrono::system_clock::to_time_t(now);
@@ -523,7 +623,7 @@ public:
             last_reset_date = current_date;
             std::cout << "[风控] [" << strategy_id << "] 每日重置: 日期=" << current_date
                       << ", 初始权益=" << equity << " USDT"
-                      << ", 回撤模式=" << limits_.drawdown_mode << "\n";
+                      << ", 回撤模式=" << limits.drawdown_mode << "\n";
             return;
         }
 
@@ -533,13 +633,13 @@ public:
             initial_equity = equity;
             last_reset_date = current_date;
             std::cout << "[风控] [" << strategy_id << "] 初始化账户权益: " << equity << " USDT"
-                      << ", 回撤模式=" << limits_.drawdown_mode << "\n";
+                      << ", 回撤模式=" << limits.drawdown_mode << "\n";
             return;
         }
 
         // 根据回撤模式计算回撤
         double drawdown_pct = 0.0;
-        if (limits_.drawdown_mode == "daily_initial") {
+        if (limits.drawdown_mode == "daily_initial") {
             // 模式1: 当日初值回撤
             if (initial_equity > 0) {
                 drawdown_pct = (initial_equity - equity) / initial_equity;
@@ -550,13 +650,13 @@ public:
         }
 
         // 检查最大回撤（仅告警，不触发kill switch）
-        if (drawdown_pct > limits_.max_drawdown_pct) {
-            std::string reason = "[" + strategy_id + "][" + limits_.drawdown_mode + "] 峰值=" +
+        if (drawdown_pct > limits.max_drawdown_pct) {
+            std::string reason = "[" + strategy_id + "][" + limits.drawdown_mode + "] 峰值=" +
                                 std::to_string(peak_pnl) + " USDT, 初值=" +
                                 std::to_string(initial_equity) + " USDT, 当前=" +
                                 std::to_string(equity) + " USDT, 回撤=" +
                                 std::to_string(drawdown_pct * 100) + "% (限制=" +
-                                std::to_string(limits_.max_drawdown_pct * 100) + "%)";
+                                std::to_string(limits.max_drawdown_pct * 100) + "%)";
 
             std::cout << "[风控] ⚠️  回撤超限 " << reason << "\n";
 
@@ -622,27 +722,47 @@ public:
      * @brief 获取风险统计
      */
     nlohmann::json get_risk_stats() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-
         // 汇总所有策略的峰值（用于统计）
         nlohmann::json strategy_stats = nlohmann::json::object();
-        for (const auto& [strategy_id, peak] : strategy_peak_pnl_) {
-            strategy_stats[strategy_id] = {
-                {"peak_pnl", peak},
-                {"initial_equity", strategy_initial_equity_.count(strategy_id) ? strategy_initial_equity_.at(strategy_id) : 0.0}
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (const auto& [strategy_id, peak] : strategy_peak_pnl_) {
+                strategy_stats[strategy_id] = {
+                    {"peak_pnl", peak},
+                    {"initial_equity", strategy_initial_equity_.count(strategy_id) ? strategy_initial_equity_.at(strategy_id) : 0.0}
+                };
+            }
+        }
+
+        // 各策略的检查/拒单计数
+        nlohmann::json strategy_checks = nlohmann::json::object();
+        size_t strategy_count = strategy_ids_.size();
+        for (size_t i = 0; i < strategy_count; ++i) {
+            StrategyCounters counters = get_strategy_counters(static_cast<int>(i));
+            strategy_checks[strategy_ids_.name(static_cast<int>(i))] = {
+                {"checks", counters.checks},
+                {"rejects", counters.rejects}
             };
         }
 
         return {
             {"kill_switch", kill_switch_.load()},
-            {"open_orders", open_order_count_},
-            {"daily_pnl", daily_pnl_},
+            {"open_orders", open_order_count_.load()},
+            {"daily_pnl", daily_pnl_.load()},
             {"strategy_stats", strategy_stats},
+            {"strategy_checks", strategy_checks},
             {"total_exposure", calculate_total_exposure()},
-            {"position_count", position_values_.size()}
+            {"position_count", symbol_ids_.size()}
         };
     }
 
+    /**
+     * @brief 获取单个策略的风控计数（未登记的策略返回全 0）
+     */
+    StrategyCounters get_strategy_counters(const std::string& strategy_id) const {
+        return get_strategy_counters(strategy_ids_.find(strategy_id));
+    }
+
     /**
      * @brief 获取告警服务（用于手动发送告警）
      */
@@ -662,16 +782,24 @@ public:
      * @brief 设置风控限制
      */
     void set_limits(const RiskLimits& limits) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        limits_ = limits;
+        publish_limits(limits);
     }
 
     /**
-     * @brief 获取风控限制
+     * @brief 获取风控限制（副本）
      */
     RiskLimits get_limits() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return limits_;
+        return limits();
+    }
+
+    /**
+     * @brief 当前风控限制快照（无锁、不拷贝）
+     *
+     * 快照不可变，set_limits() 发布新快照后旧快照至少再保留 LIMITS_GRACE_PERIOD_NS，
+     * 返回的引用只应在当前调用内使用，不能长期保存；可能不是最新配置。
+     */
+    const RiskLimits& limits() const {
+        return *limits_ptr_.load(std::memory_order_acquire);
     }
 
     /**
@@ -680,7 +808,7 @@ public:
      * @param email 策略负责人邮箱
      */
     void register_strategy_email(const std::string& strategy_id, const std::string& email) {
-        std::lock_guard<std::mutex> lock(mutex_);
+        std::lock_guard<std::mutex> lock(contacts_mutex_);
         if (!email.empty() && email.find("@") != std::string::npos) {
             strategy_emails_[strategy_id] = email;
             core::Logger::instance().info(strategy_id, "[风控] 已注册策略邮箱: " + strategy_id + " -> " + email);
@@ -691,7 +819,7 @@ public:
      * @brief 注册策略飞书邮箱（用于 Open API 私信）
      */
     void register_strategy_lark_email(const std::string& strategy_id, const std::string& lark_email) {
-        std::lock_guard<std::mutex> lock(mutex_);
+        std::lock_guard<std::mutex> lock(contacts_mutex_);
         if (!lark_email.empty() && lark_email.find("@") != std::string::npos) {
             strategy_lark_emails_[strategy_id] = lark_email;
             core::Logger::instance().info(strategy_id, "[风控] 已注册策略飞书邮箱: " + strategy_id + " -> " + lark_email);
@@ -764,35 +892,34 @@ public:
      * @brief 重置每日统计（每天开盘时调用）
      */
     void reset_daily_stats() {
-        std::lock_guard<std::mutex> lock(mutex_);
-        daily_pnl_ = 0.0;
+        daily_pnl_.store(0.0, std::memory_order_relaxed);
         // 注意：不再重置 peak_pnl_，因为现在由 update_account_equity() 自动检测日期变化并重置
         std::cout << "[风控] 每日统计已重置\n";
     }
 
     /**
      * @brief 记录订单执行（用于频率统计）
+     *
+     * 频率配额已在 check_order_with_value() 通过时扣除，这里只累计当前秒的下单数
      */
     void record_order_execution() {
-        std::lock_guard<std::mutex> lock(mutex_);
-        order_timestamps_.push_back(std::chrono::steady_clock::now());
+        const uint64_t now_sec = static_cast<uint64_t>(steady_now_ns() / 1000000000LL);
+        uint64_t window = order_rate_window_.load(std::memory_order_relaxed);
+        while (true) {
+            uint64_t next = (window >> 32) == now_sec ? window + 1 : (now_sec << 32) | 1;
+            if (order_rate_window_.compare_exchange_weak(window, next, std::memory_order_relaxed)) {
+                return;
+            }
+        }
     }
 
     /**
-     * @brief 获取当前订单频率（每秒）
+     * @brief 获取当前订单频率（当前秒内已下单数）
      */
     int get_current_order_rate() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto now = std::chrono::steady_clock::now();
-        int count = 0;
-        for (auto it = order_timestamps_.rbegin(); it != order_timestamps_.rend(); ++it) {
-            if (std::chrono::duration_cast<std::chrono::seconds>(now - *it).count() < 1) {
-                count++;
-            } else {
-                break;
-            }
-        }
-        return count;
+        const uint64_t now_sec = static_cast<uint64_t>(steady_now_ns() / 1000000000LL);
+        uint64_t window = order_rate_window_.load(std::memory_order_relaxed);
+        return (window >> 32) == now_sec ? static_cast<int>(window & 0xFFFFFFFFu) : 0;
     }
 
 public:
@@ -815,16 +942,30 @@ public:
         // 写入告警日志
         alert_service_.alert_log("[风控告警] 策略=" + strategy_id + ", 标题=" + title + ", 内容=" + AlertService::safe_truncate(message, 200));
 
+        // 拷贝联系人后释放锁（可能在 update_account_equity() 持有 mutex_ 时调用）
+        std::string email;
+        std::string lark_email;
+        {
+            std::lock_guard<std::mutex> lock(contacts_mutex_);
+            auto it = strategy_emails_.find(strategy_id);
+            if (it != strategy_emails_.end()) {
+                email = it->second;
+            }
+            auto lark_it = strategy_lark_emails_.find(strategy_id);
+            if (lark_it != strategy_lark_emails_.end()) {
+                lark_email = lark_it->second;
+            }
+        }
+
         // 发送邮件告警
-        auto it = strategy_emails_.find(strategy_id);
-        if (it != strategy_emails_.end() && !it->second.empty()) {
-            core::Logger::instance().info(strategy_id, "[邮件通知] 向 " + it->second + " 发送告警: " + title);
-            alert_service_.alert_log("[邮件通知] 策略=" + strategy_id + ", 收件人=" + it->second + ", 标题=" + title);
+        if (!email.empty()) {
+            core::Logger::instance().info(strategy_id, "[邮件通知] 向 " + email + " 发送告警: " + title);
+            alert_service_.alert_log("[邮件通知] 策略=" + strategy_id + ", 收件人=" + email + ", 标题=" + title);
             alert_service_.send_email_alert(
                 full_message,
                 AlertLevel::CRITICAL,
                 full_title,
-                it->second,
+                email,
                 "risk_" + strategy_id,
                 true
             );
@@ -834,10 +975,7 @@ public:
         }
 
         // 发送飞书告警（群通知 + 私信）
-        std::string lark_email;
-        auto lark_it = strategy_lark_emails_.find(strategy_id);
-        if (lark_it != strategy_lark_emails_.end()) {
-            lark_email = lark_it->second;
+        if (!lark_email.empty()) {
             core::Logger::instance().info(strategy_id, "[飞书通知] 向 " + lark_email + " 发送告警: " + title);
             alert_service_.alert_log("[飞书通知] 策略=" + strategy_id + ", 收件人=" + lark_email + ", 标题=" + title);
         } else {
@@ -872,69 +1010,143 @@ public:
         );
     }
 
-
+    /**
+     * @brief 品种当前持仓金额（无锁）
+     */
     double get_position_value(const std::string& symbol) const {
-        auto it = position_values_.find(symbol);
-        return it != position_values_.end() ? it->second : 0.0;
+        int id = symbol_ids_.find(symbol);
+        return id >= 0 ? positions_[id].load(std::memory_order_relaxed) : 0.0;
     }
 
+    /**
+     * @brief 总敞口（各品种持仓金额绝对值之和，增量维护）
+     */
     double calculate_total_exposure() const {
-        double total = 0.0;
-        for (const auto& [symbol, value] : position_values_) {
-            total += std::abs(value);
+        return total_exposure_.load(std::memory_order_relaxed);
+    }
+
+private:
+    // 独占缓存行，避免不同策略的计数互相干扰
+    struct alignas(64) CounterSlot {
+        std::atomic<uint64_t> checks{0};
+        std::atomic<uint64_t> rejects{0};
+    };
+
+    static int64_t steady_now_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    static void atomic_add(std::atomic<double>& target, double delta) {
+        double current = target.load(std::memory_order_relaxed);
+        while (!target.compare_exchange_weak(current, current + delta, std::memory_order_relaxed)) {
         }
-        return total;
     }
 
-    bool check_rate_limit() {
-        auto now = std::chrono::steady_clock::now();
+    /**
+     * @brief 发布新的风控限制快照
+     *
+     * 被替换的快照放入 retired_limits_，超过宽限期后在这里释放，
+     * 历史快照数量以宽限期内 set_limits() 的调用次数为上限
+     */
+    void publish_limits(const RiskLimits& limits) {
+        std::lock_guard<std::mutex> lock(limits_mutex_);
+        const int64_t now = steady_now_ns();
+        while (!retired_limits_.empty() &&
+               now - retired_limits_.front().retired_at_ns >= LIMITS_GRACE_PERIOD_NS) {
+            retired_limits_.pop_front();
+        }
+        std::unique_ptr<const RiskLimits> previous = std::move(current_limits_);
+        current_limits_ = std::make_unique<const RiskLimits>(limits);
+        limits_ptr_.store(current_limits_.get(), std::memory_order_release);
+        if (previous) {
+            retired_limits_.push_back(RetiredLimits{std::move(previous), now});
+        }
+    }
 
-        // 清理过期记录
-        while (!order_timestamps_.empty() &&
-               std::chrono::duration_cast<std::chrono::seconds>(
-                   now - order_timestamps_.front()).count() > 60) {
-            order_timestamps_.pop_front();
+    StrategyCounters get_strategy_counters(int id) const {
+        StrategyCounters counters;
+        if (id >= 0 && static_cast<size_t>(id) < MAX_STRATEGIES) {
+            counters.checks = strategy_counters_[id].checks.load(std::memory_order_relaxed);
+            counters.rejects = strategy_counters_[id].rejects.load(std::memory_order_relaxed);
         }
+        return counters;
+    }
 
-        // 检查限制
-        int count_last_second = 0;
-        for (auto it = order_timestamps_.rbegin(); it != order_timestamps_.rend(); ++it) {
-            if (std::chrono::duration_cast<std::chrono::seconds>(now - *it).count() < 1) {
-                count_last_second++;
-            }
+    /**
+     * @brief 拒单（冷路径：计数、拼接原因、发送策略告警）
+     * @param title 告警标题，为空时不发送告警
+     */
+    RiskCheckResult reject(CounterSlot* counters, const std::string& strategy_id,
+                           const std::string& reason, const char* title) {
+        if (counters) {
+            counters->rejects.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (title) {
+            send_risk_alert_to_strategy(strategy_id, reason, title);
         }
+        return RiskCheckResult::reject(reason);
+    }
 
-        if (count_last_second >= limits_.max_orders_per_second) {
+    /**
+     * @brief 占用频率配额（每秒 + 每分钟），任一不足则不占用
+     */
+    bool acquire_rate_tokens(const RiskLimits& limits) {
+        constexpr int64_t SECOND_NS = 1000000000LL;
+        constexpr int64_t MINUTE_NS = 60 * SECOND_NS;
+        const int64_t now = steady_now_ns();
+
+        if (!second_bucket_.try_acquire(limits.max_orders_per_second, SECOND_NS, now)) {
             return false;
         }
-
-        if (order_timestamps_.size() >= static_cast<size_t>(limits_.max_orders_per_minute)) {
+        if (!minute_bucket_.try_acquire(limits.max_orders_per_minute, MINUTE_NS, now)) {
+            second_bucket_.release(limits.max_orders_per_second, SECOND_NS);
             return false;
         }
-
-        // 不在这里记录时间戳，由 record_order_execution() 负责
         return true;
     }
 
-private:
-    RiskLimits limits_;
-    mutable std::mutex mutex_;
+    struct RetiredLimits {
+        std::unique_ptr<const RiskLimits> limits;
+        int64_t retired_at_ns;  // 被替换的时间（steady clock）
+    };
+
+    // 风控限制（RCU：不可变快照，被替换后保留宽限期再释放）
+    std::atomic<const RiskLimits*> limits_ptr_{nullptr};
+    std::unique_ptr<const RiskLimits> current_limits_;
+    std::deque<RetiredLimits> retired_limits_;  // 按替换时间排序
+    std::mutex limits_mutex_;
 
     std::atomic<bool> kill_switch_;
-    std::map<std::string, double> position_values_;
+
+    // 持仓：symbol -> 槽位ID -> 持仓金额
+    IdInterner<MAX_SYMBOLS> symbol_ids_;
+    std::unique_ptr<std::atomic<double>[]> positions_;
+    std::atomic<double> total_exposure_{0.0};
+
+    // 策略计数：strategy_id -> 槽位ID -> 检查/拒单数
+    IdInterner<MAX_STRATEGIES> strategy_ids_;
+    std::unique_ptr<CounterSlot[]> strategy_counters_;
+
+    std::atomic<int> open_order_count_{0};
+    std::atomic<double> daily_pnl_{0.0};
+
+    // 频率限制
+    TokenBucket second_bucket_;
+    TokenBucket minute_bucket_;
+    std::atomic<uint64_t> order_rate_window_{0};  // (秒 << 32) | 当前秒下单数
+
+    // 联系人（告警路径读取）
+    mutable std::mutex contacts_mutex_;
     std::map<std::string, std::string> strategy_emails_;  // 策略ID -> 邮箱映射
     std::map<std::string, std::string> strategy_lark_emails_;  // 策略ID -> 飞书邮箱映射
 
-    // 每个策略独立的回撤追踪数据
+    // 每个策略独立的回撤追踪数据（mutex_ 保护）
+    mutable std::mutex mutex_;
     std::map<std::string, double> strategy_peak_pnl_;           // 策略ID -> 峰值权益
     std::map<std::string, double> strategy_initial_equity_;     // 策略ID -> 当日初始权益
     std::map<std::string, int> strategy_last_reset_date_;       // 策略ID -> 上次重置日期(YYYYMMDD)
 
-    int open_order_count_ = 0;
-    double daily_pnl_ = 0.0;
-
-    std::deque<std::chrono::steady_clock::time_point> order_timestamps_;
-
     AlertService alert_service_;  // 告警服务
 };
 